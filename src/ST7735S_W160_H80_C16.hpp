@@ -60,10 +60,340 @@ namespace Longan_nano
 **	TYPEDEFS
 **********************************************************************************/
 
+//! @brief Commands of the panel controllers. The ST7789 shares the ST7735S command set and adds its own power and timing registers
+typedef enum _Panel_command
+{           
+    //  SETUP_NORMAL_MODE
+    //Frame rate=850kHz/((RTNA x 2 + 40) x (LINE + FPA + BPA +2))
+    //Frame Rate = 850Khz/( (5*2+40)*(80+56+56+2) )= 87.6[Hz]
+    //RTNA | FPA | BPA
+    SETUP_NORMAL_MODE           = 0xB1,
+    //  SETUP_IDLE_MODE
+    //Frame rate=850kHz/((RTNA x 2 + 40) x (LINE + FPA + BPA +2))
+    //Frame Rate = 850Khz/( (5*2+40)*(80+56+56+2) )= 87.6[Hz]
+    //RTNA | FPA | BPA
+    SETUP_IDLE_MODE             = 0xB2,
+
+    SETUP_PARTIAL_MODE          = 0xB3,
+    //  DISPLAY_INVERSION_CONTROL
+    //false  Dot Inversion | true = Normal Mode Column Inversion
+    //Bit 0	| Normal Mode
+    //Bit 1	| idle Mode
+    //Bit 2 | partial mode/full colors
+    DISPLAY_INVERSION_CONTROL   = 0xB4, 
+
+    POWER_GVDD                  = 0xC0,
+    POWER_VGH_VGL               = 0xC1,
+    POWER_VCOM1                 = 0xC5,
+
+    POWER_MODE_NORMAL           = 0xC2,
+    POWER_MODE_IDLE             = 0xC3,
+    POWER_MODE_PARTIAL          = 0xC4,
+
+    ADJUST_GAMMA_PLUS           = 0xE0,
+    ADJUST_GAMMA_MINUS          = 0xE1,
+    
+    //  COLOR_FORMAT
+    //0x03	|	12b |4R4G|4B...4R|4G4B| 3 bytes transfer 2 color
+    //0x05	|	16b |5R3G|3G5B|			2 bytes transfer 1 color
+    //0x06	|	18b |6R..|6G..|6b..|	3 bytes transfer 1 color
+    COLOR_FORMAT                = 0x3A,
+
+    MEMORY_DATA_ACCESS_CONTROL  = 0x36,
+
+    DISPLAY_ON                  = 0x29,
+    DISPLAY_OFF                 = 0x28,		//The panel shows a blank screen. The memory is kept and can still be written
+    IDLE_MODE_OFF               = 0x38,
+    IDLE_MODE_ON                = 0x39,		//Eight colors. Only the MSB of each channel is shown. Lower power
+    SLEEP_OUT_BOOSTER_ON        = 0x11,
+
+    NORMAL_DISPLAY_ON           = 0x13,
+    DISABLE_DISPLAY_INVERSION	= 0x20,
+    ENABLE_DISPLAY_INVERSION	= 0x21,
+    SEND_ROW_ADDRESS 			= 0x2A,		//Column address (ST7735S datasheet page 128/201)
+    SEND_COL_ADDRESS 			= 0x2B,		//Row Address (ST7735S datasheet page 131/201)
+    WRITE_MEM					= 0x2C,		//Memory Write. After this command, the display expects pixel data (ST7735S datasheet page 132/201)
+    SCROLL_AREA					= 0x33,		//Vertical Scroll Definition. Top fixed lines, scroll lines, bottom fixed lines (ST7735S datasheet page 145/201)
+    SCROLL_START				= 0x37,		//Vertical Scroll Start Address. Memory line shown on the first line of the scroll area (ST7735S datasheet page 150/201)
+    //ST7789 only. Share their codes with ST7735S commands of different meaning
+    ST7789_PORCH_CONTROL		= 0xB2,
+    ST7789_GATE_CONTROL			= 0xB7,
+    ST7789_VCOM					= 0xBB,
+    ST7789_LCM_CONTROL			= 0xC0,
+    ST7789_VDV_VRH_ENABLE		= 0xC2,
+    ST7789_VRH					= 0xC3,
+    ST7789_VDV					= 0xC4,
+    ST7789_FRAME_RATE			= 0xC6,
+    ST7789_POWER				= 0xD0,
+    TERMINATOR					= 0xFF,		//Special terminator for the command parser FSM
+} Panel_command;
+
 /**********************************************************************************
 **	PROTOTYPE: STRUCTURES
 **********************************************************************************/
 
+/************************************************************************************/
+//! @struct		Panel_st7735s_w160_h80
+/************************************************************************************/
+//! @brief		Embedded 160x80 0.96' IPS LCD of the longan nano. ST7735S controller
+//! @details
+//!	\n Panel traits of the Display template. Geometry, address offsets, color depth, wiring and initialization sequence
+//!	\n SPI0 and DMA0 channel 2. The 160x80 window sits in the 132x162 memory of the ST7735S
+/************************************************************************************/
+
+struct Panel_st7735s_w160_h80
+{
+    //! @brief Geometry and wiring of the panel
+    typedef enum _Config
+    {
+        //Screen physical configuration
+        WIDTH				= 160,				//Width of the LCD display
+        HEIGHT				= 80,				//Height of the LCD display
+        ROW_ADDRESS_OFFSET	= 1,				//Offset to be applied to the row address (physical pixels do not begin in 0,0)
+        COL_ADDRESS_OFFSET	= 26,				//Offset to be applied to the col address (physical pixels do not begin in 0,0)
+        PANEL_LINES			= 162,				//Lines of the ST7735S memory. With MADCTL MV set the lines run along the width. The hardware scroll rotates lines
+        PANEL_COLUMNS		= 132,				//Columns of the ST7735S memory. With MADCTL MV set the columns run along the height
+        MADCTL				= 0x78,				//Memory data access control. MV set, landscape. MX and MY are toggled to turn the image upside down
+        INVERSION			= true,				//Display inversion that shows normal colors. Programmed by the initialization sequence
+        COLOR_DEPTH			= 16,				//Color depth of the transfers. The controller allows 12, 16 and 18. Driver supports 16 = RGB565 | 12 = RGB444, two pixels packed in three bytes
+        //Screen GPIO Configuration
+        RS_GPIO			= GPIOB,			//RS pin of the LCD
+        RS_PIN			= GPIO_PIN_0,		//RS pin of the LCD
+        RST_GPIO		= GPIOB,			//Reset pin of the LCD
+        RST_PIN			= GPIO_PIN_1,		//Reset pin of the LCD
+        //SPI Configuration
+        SPI_RCU			= RCU_SPI0,			//Clock of the SPI
+        SPI_CH			= SPI0,				//SPI used for the LCD
+        SPI_CS_GPIO		= GPIOB,			//SPI Chip Select pin of the LCD
+        SPI_CS_PIN		= GPIO_PIN_2,		//SPI Chip Select pin of the LCD
+        SPI_CLK_GPIO	= GPIOA,			//SPI Clock pin of the LCD
+        SPI_CLK_PIN		= GPIO_PIN_5,		//SPI Clock pin of the LCD
+        SPI_MISO_GPIO	= GPIOA,			//SPI MISO In pin of the LCD
+        SPI_MISO_PIN	= GPIO_PIN_6,		//SPI MISO In pin of the LCD
+        SPI_MOSI_GPIO	= GPIOA,			//SPI MOSI In pin of the LCD
+        SPI_MOSI_PIN	= GPIO_PIN_7,		//SPI MOSI In pin of the LCD
+        //DMA Configuration
+        DMA_SPI_TX_RCU  = RCU_DMA0,         //Clock of the DMA
+        DMA_SPI_TX      = DMA0,             //DMA pheriperal used for the SPI transmit
+        DMA_SPI_TX_CH   = (dma_channel_enum)DMA_CH2,          //DMA channel used for the SPI transmit. Fixed by the SPI
+        DMA_SPI_TX_IRQ  = DMA0_Channel2_IRQn,   //Interrupt of the DMA channel used for the SPI transmit
+        SPI_IRQ         = SPI0_IRQn,            //Interrupt of the SPI. Its receive buffer not empty event tells the ISR the SPI is done with a frame
+    } Config;
+    //! @brief Initialization sequence. Stored in flash memory. The color format is sent by the Display
+    static constexpr uint8_t g_init_sequence[] =
+    {
+        Panel_command::ENABLE_DISPLAY_INVERSION,          Panel_command::TERMINATOR,
+        Panel_command::SETUP_NORMAL_MODE,                 0x05, 0x3a, 0x3a, Panel_command::TERMINATOR,
+        Panel_command::SETUP_IDLE_MODE,                   0x05, 0x3a, 0x3a, Panel_command::TERMINATOR,
+        Panel_command::SETUP_PARTIAL_MODE,                0x05, 0x3a, 0x3a, 0x05, 0x3a, 0x3a, Panel_command::TERMINATOR,
+        Panel_command::DISPLAY_INVERSION_CONTROL,         0x03, Panel_command::TERMINATOR,
+        Panel_command::POWER_GVDD,                        0x62, 0x02, 0x04, Panel_command::TERMINATOR,
+        Panel_command::POWER_VGH_VGL,                     0xc0, Panel_command::TERMINATOR,
+        Panel_command::POWER_MODE_NORMAL,                 0x0d, 0x00, Panel_command::TERMINATOR,
+        Panel_command::POWER_MODE_IDLE,                   0x8d, 0x6a, Panel_command::TERMINATOR,
+        Panel_command::POWER_MODE_PARTIAL,                0x8d, 0xee, Panel_command::TERMINATOR,
+        Panel_command::POWER_VCOM1,                       0x0e, Panel_command::TERMINATOR,
+        Panel_command::ADJUST_GAMMA_PLUS,                 0x10, 0x0e, 0x02, 0x03, 0x0e, 0x07, 0x02, 0x07, 0x0a, 0x12, 0x27, 0x37, 0x00, 0x0d, 0x0e, 0x10, Panel_command::TERMINATOR,
+        Panel_command::ADJUST_GAMMA_MINUS,                0x10, 0x0e, 0x03, 0x03, 0x0f, 0x06, 0x02, 0x08, 0x0a, 0x13, 0x26, 0x36, 0x00, 0x0d, 0x0e, 0x10, Panel_command::TERMINATOR,
+        Panel_command::MEMORY_DATA_ACCESS_CONTROL,        Config::MADCTL, Panel_command::TERMINATOR,
+        Panel_command::DISPLAY_ON,                        Panel_command::TERMINATOR,
+        Panel_command::SLEEP_OUT_BOOSTER_ON,              Panel_command::TERMINATOR,
+        Panel_command::TERMINATOR,
+    };
+};	//End struct: Panel_st7735s_w160_h80
+
+/************************************************************************************/
+//! @struct		Panel_st7735s_w160_h128
+/************************************************************************************/
+//! @brief		1.8' 128x160 TN LCD module. ST7735S controller. Used in landscape
+//! @details
+//!	\n Module wired to the SPI1 pins of the longan nano header. SPI1 transmit is served by DMA0 channel 4
+//!	\n The 160x128 window sits at the origin of the 132x162 memory of the ST7735S
+/************************************************************************************/
+
+struct Panel_st7735s_w160_h128
+{
+    //! @brief Geometry and wiring of the panel
+    typedef enum _Config
+    {
+        //Screen physical configuration
+        WIDTH				= 160,				//Width of the LCD display
+        HEIGHT				= 128,				//Height of the LCD display
+        ROW_ADDRESS_OFFSET	= 0,				//Offset to be applied to the row address (physical pixels do not begin in 0,0)
+        COL_ADDRESS_OFFSET	= 0,				//Offset to be applied to the col address (physical pixels do not begin in 0,0)
+        PANEL_LINES			= 162,				//Lines of the ST7735S memory. With MADCTL MV set the lines run along the width. The hardware scroll rotates lines
+        PANEL_COLUMNS		= 132,				//Columns of the ST7735S memory. With MADCTL MV set the columns run along the height
+        MADCTL				= 0x68,				//Memory data access control. MV set, landscape. MX and MY are toggled to turn the image upside down
+        INVERSION			= false,				//Display inversion that shows normal colors. Programmed by the initialization sequence
+        COLOR_DEPTH			= 16,				//Color depth of the transfers. The controller allows 12, 16 and 18. Driver supports 16 = RGB565 | 12 = RGB444, two pixels packed in three bytes
+        //Screen GPIO Configuration
+        RS_GPIO			= GPIOB,			//RS pin of the LCD
+        RS_PIN			= GPIO_PIN_10,		//RS pin of the LCD
+        RST_GPIO		= GPIOB,			//Reset pin of the LCD
+        RST_PIN			= GPIO_PIN_11,		//Reset pin of the LCD
+        //SPI Configuration
+        SPI_RCU			= RCU_SPI1,			//Clock of the SPI
+        SPI_CH			= SPI1,				//SPI used for the LCD
+        SPI_CS_GPIO		= GPIOB,			//SPI Chip Select pin of the LCD
+        SPI_CS_PIN		= GPIO_PIN_12,		//SPI Chip Select pin of the LCD
+        SPI_CLK_GPIO	= GPIOB,			//SPI Clock pin of the LCD
+        SPI_CLK_PIN		= GPIO_PIN_13,		//SPI Clock pin of the LCD
+        SPI_MISO_GPIO	= GPIOB,			//SPI MISO In pin of the LCD
+        SPI_MISO_PIN	= GPIO_PIN_14,		//SPI MISO In pin of the LCD
+        SPI_MOSI_GPIO	= GPIOB,			//SPI MOSI In pin of the LCD
+        SPI_MOSI_PIN	= GPIO_PIN_15,		//SPI MOSI In pin of the LCD
+        //DMA Configuration
+        DMA_SPI_TX_RCU  = RCU_DMA0,         //Clock of the DMA
+        DMA_SPI_TX      = DMA0,             //DMA pheriperal used for the SPI transmit
+        DMA_SPI_TX_CH   = (dma_channel_enum)DMA_CH4,          //DMA channel used for the SPI transmit. Fixed by the SPI
+        DMA_SPI_TX_IRQ  = DMA0_Channel4_IRQn,   //Interrupt of the DMA channel used for the SPI transmit
+        SPI_IRQ         = SPI1_IRQn,            //Interrupt of the SPI. Its receive buffer not empty event tells the ISR the SPI is done with a frame
+    } Config;
+    //! @brief Initialization sequence. Stored in flash memory. The color format is sent by the Display
+    static constexpr uint8_t g_init_sequence[] =
+    {
+        Panel_command::DISABLE_DISPLAY_INVERSION,         Panel_command::TERMINATOR,
+        Panel_command::SETUP_NORMAL_MODE,                 0x01, 0x2c, 0x2d, Panel_command::TERMINATOR,
+        Panel_command::SETUP_IDLE_MODE,                   0x01, 0x2c, 0x2d, Panel_command::TERMINATOR,
+        Panel_command::SETUP_PARTIAL_MODE,                0x01, 0x2c, 0x2d, 0x01, 0x2c, 0x2d, Panel_command::TERMINATOR,
+        Panel_command::DISPLAY_INVERSION_CONTROL,         0x07, Panel_command::TERMINATOR,
+        Panel_command::POWER_GVDD,                        0xa2, 0x02, 0x84, Panel_command::TERMINATOR,
+        Panel_command::POWER_VGH_VGL,                     0xc5, Panel_command::TERMINATOR,
+        Panel_command::POWER_MODE_NORMAL,                 0x0a, 0x00, Panel_command::TERMINATOR,
+        Panel_command::POWER_MODE_IDLE,                   0x8a, 0x2a, Panel_command::TERMINATOR,
+        Panel_command::POWER_MODE_PARTIAL,                0x8a, 0xee, Panel_command::TERMINATOR,
+        Panel_command::POWER_VCOM1,                       0x0e, Panel_command::TERMINATOR,
+        Panel_command::ADJUST_GAMMA_PLUS,                 0x02, 0x1c, 0x07, 0x12, 0x37, 0x32, 0x29, 0x2d, 0x29, 0x25, 0x2b, 0x39, 0x00, 0x01, 0x03, 0x10, Panel_command::TERMINATOR,
+        Panel_command::ADJUST_GAMMA_MINUS,                0x03, 0x1d, 0x07, 0x06, 0x2e, 0x2c, 0x29, 0x2d, 0x2e, 0x2e, 0x37, 0x3f, 0x00, 0x00, 0x02, 0x10, Panel_command::TERMINATOR,
+        Panel_command::MEMORY_DATA_ACCESS_CONTROL,        Config::MADCTL, Panel_command::TERMINATOR,
+        Panel_command::NORMAL_DISPLAY_ON,                 Panel_command::TERMINATOR,
+        Panel_command::DISPLAY_ON,                        Panel_command::TERMINATOR,
+        Panel_command::SLEEP_OUT_BOOSTER_ON,              Panel_command::TERMINATOR,
+        Panel_command::TERMINATOR,
+    };
+};	//End struct: Panel_st7735s_w160_h128
+
+/************************************************************************************/
+//! @struct		Panel_st7789_w240_h135
+/************************************************************************************/
+//! @brief		1.14' 135x240 IPS LCD module. ST7789 controller. Used in landscape
+//! @details
+//!	\n Module wired to the SPI1 pins of the longan nano header. SPI1 transmit is served by DMA0 channel 4
+//!	\n The 240x135 window sits in the middle of the 240x320 memory of the ST7789
+/************************************************************************************/
+
+struct Panel_st7789_w240_h135
+{
+    //! @brief Geometry and wiring of the panel
+    typedef enum _Config
+    {
+        //Screen physical configuration
+        WIDTH				= 240,				//Width of the LCD display
+        HEIGHT				= 135,				//Height of the LCD display
+        ROW_ADDRESS_OFFSET	= 40,				//Offset to be applied to the row address (physical pixels do not begin in 0,0)
+        COL_ADDRESS_OFFSET	= 53,				//Offset to be applied to the col address (physical pixels do not begin in 0,0)
+        PANEL_LINES			= 320,				//Lines of the ST7789 memory. With MADCTL MV set the lines run along the width. The hardware scroll rotates lines
+        PANEL_COLUMNS		= 240,				//Columns of the ST7789 memory. With MADCTL MV set the columns run along the height
+        MADCTL				= 0x60,				//Memory data access control. MV set, landscape. MX and MY are toggled to turn the image upside down
+        INVERSION			= true,				//Display inversion that shows normal colors. Programmed by the initialization sequence
+        COLOR_DEPTH			= 16,				//Color depth of the transfers. The controller allows 12, 16 and 18. Driver supports 16 = RGB565 | 12 = RGB444, two pixels packed in three bytes
+        //Screen GPIO Configuration
+        RS_GPIO			= GPIOB,			//RS pin of the LCD
+        RS_PIN			= GPIO_PIN_10,		//RS pin of the LCD
+        RST_GPIO		= GPIOB,			//Reset pin of the LCD
+        RST_PIN			= GPIO_PIN_11,		//Reset pin of the LCD
+        //SPI Configuration
+        SPI_RCU			= RCU_SPI1,			//Clock of the SPI
+        SPI_CH			= SPI1,				//SPI used for the LCD
+        SPI_CS_GPIO		= GPIOB,			//SPI Chip Select pin of the LCD
+        SPI_CS_PIN		= GPIO_PIN_12,		//SPI Chip Select pin of the LCD
+        SPI_CLK_GPIO	= GPIOB,			//SPI Clock pin of the LCD
+        SPI_CLK_PIN		= GPIO_PIN_13,		//SPI Clock pin of the LCD
+        SPI_MISO_GPIO	= GPIOB,			//SPI MISO In pin of the LCD
+        SPI_MISO_PIN	= GPIO_PIN_14,		//SPI MISO In pin of the LCD
+        SPI_MOSI_GPIO	= GPIOB,			//SPI MOSI In pin of the LCD
+        SPI_MOSI_PIN	= GPIO_PIN_15,		//SPI MOSI In pin of the LCD
+        //DMA Configuration
+        DMA_SPI_TX_RCU  = RCU_DMA0,         //Clock of the DMA
+        DMA_SPI_TX      = DMA0,             //DMA pheriperal used for the SPI transmit
+        DMA_SPI_TX_CH   = (dma_channel_enum)DMA_CH4,          //DMA channel used for the SPI transmit. Fixed by the SPI
+        DMA_SPI_TX_IRQ  = DMA0_Channel4_IRQn,   //Interrupt of the DMA channel used for the SPI transmit
+        SPI_IRQ         = SPI1_IRQn,            //Interrupt of the SPI. Its receive buffer not empty event tells the ISR the SPI is done with a frame
+    } Config;
+    //! @brief Initialization sequence. Stored in flash memory. The color format is sent by the Display
+    static constexpr uint8_t g_init_sequence[] =
+    {
+        Panel_command::ST7789_PORCH_CONTROL,              0x0c, 0x0c, 0x00, 0x33, 0x33, Panel_command::TERMINATOR,
+        Panel_command::ST7789_GATE_CONTROL,               0x35, Panel_command::TERMINATOR,
+        Panel_command::ST7789_VCOM,                       0x19, Panel_command::TERMINATOR,
+        Panel_command::ST7789_LCM_CONTROL,                0x2c, Panel_command::TERMINATOR,
+        Panel_command::ST7789_VDV_VRH_ENABLE,             0x01, Panel_command::TERMINATOR,
+        Panel_command::ST7789_VRH,                        0x12, Panel_command::TERMINATOR,
+        Panel_command::ST7789_VDV,                        0x20, Panel_command::TERMINATOR,
+        Panel_command::ST7789_FRAME_RATE,                 0x0f, Panel_command::TERMINATOR,
+        Panel_command::ST7789_POWER,                      0xa4, 0xa1, Panel_command::TERMINATOR,
+        Panel_command::ADJUST_GAMMA_PLUS,                 0xd0, 0x04, 0x0d, 0x11, 0x13, 0x2b, 0x3f, 0x54, 0x4c, 0x18, 0x0d, 0x0b, 0x1f, 0x23, Panel_command::TERMINATOR,
+        Panel_command::ADJUST_GAMMA_MINUS,                0xd0, 0x04, 0x0c, 0x11, 0x13, 0x2c, 0x3f, 0x44, 0x51, 0x2f, 0x1f, 0x1f, 0x20, 0x23, Panel_command::TERMINATOR,
+        Panel_command::ENABLE_DISPLAY_INVERSION,          Panel_command::TERMINATOR,
+        Panel_command::MEMORY_DATA_ACCESS_CONTROL,        Config::MADCTL, Panel_command::TERMINATOR,
+        Panel_command::NORMAL_DISPLAY_ON,                 Panel_command::TERMINATOR,
+        Panel_command::DISPLAY_ON,                        Panel_command::TERMINATOR,
+        Panel_command::SLEEP_OUT_BOOSTER_ON,              Panel_command::TERMINATOR,
+        Panel_command::TERMINATOR,
+    };
+};	//End struct: Panel_st7789_w240_h135
+
+/************************************************************************************/
+//! @struct		Panel_st7735s_w160_h80_spi1
+/************************************************************************************/
+//! @brief		Second 160x80 0.96' IPS LCD module. ST7735S controller. Same glass as the embedded display
+//! @details
+//!	\n Module wired to the SPI1 pins of the longan nano header. SPI1 transmit is served by DMA0 channel 4
+//!	\n Driven together with the embedded display, the two DMA channels send sprites in parallel. See Screen_scheduler
+/************************************************************************************/
+
+struct Panel_st7735s_w160_h80_spi1
+{
+    //! @brief Geometry and wiring of the panel
+    typedef enum _Config
+    {
+        //Screen physical configuration
+        WIDTH				= Panel_st7735s_w160_h80::Config::WIDTH,				//Width of the LCD display
+        HEIGHT				= Panel_st7735s_w160_h80::Config::HEIGHT,				//Height of the LCD display
+        ROW_ADDRESS_OFFSET	= Panel_st7735s_w160_h80::Config::ROW_ADDRESS_OFFSET,	//Offset to be applied to the row address (physical pixels do not begin in 0,0)
+        COL_ADDRESS_OFFSET	= Panel_st7735s_w160_h80::Config::COL_ADDRESS_OFFSET,	//Offset to be applied to the col address (physical pixels do not begin in 0,0)
+        PANEL_LINES			= Panel_st7735s_w160_h80::Config::PANEL_LINES,			//Lines of the ST7735S memory
+        PANEL_COLUMNS		= Panel_st7735s_w160_h80::Config::PANEL_COLUMNS,		//Columns of the ST7735S memory
+        MADCTL				= Panel_st7735s_w160_h80::Config::MADCTL,				//Memory data access control. MV set, landscape
+        INVERSION			= Panel_st7735s_w160_h80::Config::INVERSION,			//Display inversion that shows normal colors
+        COLOR_DEPTH			= Panel_st7735s_w160_h80::Config::COLOR_DEPTH,			//Color depth of the transfers
+        //Screen GPIO Configuration
+        RS_GPIO			= GPIOB,			//RS pin of the LCD
+        RS_PIN			= GPIO_PIN_10,		//RS pin of the LCD
+        RST_GPIO		= GPIOB,			//Reset pin of the LCD
+        RST_PIN			= GPIO_PIN_11,		//Reset pin of the LCD
+        //SPI Configuration
+        SPI_RCU			= RCU_SPI1,			//Clock of the SPI
+        SPI_CH			= SPI1,				//SPI used for the LCD
+        SPI_CS_GPIO		= GPIOB,			//SPI Chip Select pin of the LCD
+        SPI_CS_PIN		= GPIO_PIN_12,		//SPI Chip Select pin of the LCD
+        SPI_CLK_GPIO	= GPIOB,			//SPI Clock pin of the LCD
+        SPI_CLK_PIN		= GPIO_PIN_13,		//SPI Clock pin of the LCD
+        SPI_MISO_GPIO	= GPIOB,			//SPI MISO In pin of the LCD
+        SPI_MISO_PIN	= GPIO_PIN_14,		//SPI MISO In pin of the LCD
+        SPI_MOSI_GPIO	= GPIOB,			//SPI MOSI In pin of the LCD
+        SPI_MOSI_PIN	= GPIO_PIN_15,		//SPI MOSI In pin of the LCD
+        //DMA Configuration
+        DMA_SPI_TX_RCU  = RCU_DMA0,         //Clock of the DMA
+        DMA_SPI_TX      = DMA0,             //DMA pheriperal used for the SPI transmit
+        DMA_SPI_TX_CH   = (dma_channel_enum)DMA_CH4,          //DMA channel used for the SPI transmit. Fixed by the SPI
+        DMA_SPI_TX_IRQ  = DMA0_Channel4_IRQn,   //Interrupt of the DMA channel used for the SPI transmit
+        SPI_IRQ         = SPI1_IRQn,            //Interrupt of the SPI. Its receive buffer not empty event tells the ISR the SPI is done with a frame
+    } Config;
+    //! @brief Initialization sequence. Same glass as the embedded display
+    static constexpr const uint8_t *g_init_sequence = Panel_st7735s_w160_h80::g_init_sequence;
+};	//End struct: Panel_st7735s_w160_h80_spi1
+
 /**********************************************************************************
 **	PROTOTYPE: GLOBAL VARIABILES
 **********************************************************************************/
@@ -73,7 +403,7 @@ namespace Longan_nano
 **********************************************************************************/
 
 /************************************************************************************/
-//! @class 		Display
+//! @class 		Display_panel
 /************************************************************************************/
 //!	@author		Orso Eric
 //! @version	2020-08-08
@@ -118,9 +448,31 @@ namespace Longan_nano
 //!	\n  Full support for USE_DMA=false. screen updates much slower at the same CPU use
 //! \n      2020-08-07
 //! \n  Bugfix: Solid color draw was bugged
+//! \n      2020-08-10
+//! \n  Sprite queue. register_sprite pushes a sprite descriptor in a ring buffer instead of overwriting the only sprite
+//! \n  update_sprite loads the next queued sprite as soon as the SPI is done with the previous one, sprites are sent back to back
+//! \n  Queue status is exposed so that the Screen class can stop registering when the queue is full
+//! \n  Count the bytes spent opening address windows and the bytes of pixel data. Used to profile the cost of each sprite
+//! \n  USE_ISR. The DMA transfer complete interrupt advances the FSM. Sprites are sent at bus speed without polling update_sprite
+//! \n  Address window cache. The address in width or in height is sent only if it differs from the one the display already has
+//! \n  Clipping. Sprites partially outside the screen are cut to the visible part. A pixel map clipped in width is sent by the DMA one row per transfer
+//! \n  COLOR_DEPTH 12. RGB444 sends two pixels every three bytes. Pixel maps are packed by the caller. Solid colors are sent from a packed pattern buffer
+//! \n  Hardware scroll. set_scroll_area and set_scroll rotate a band of columns inside the panel memory. In landscape the vertical scroll of the ST7735S moves the image in width
+//! \n  Non blocking init. update_sprite runs a bring-up FSM that waits the reset delays with a timer and sends the data runs of the initialization sequence with the DMA
+//! \n  Burst. Without DMA, set_burst lets update_sprite send up to a number of SPI frames or spend up to a time per call instead of one frame
+//! \n  Panel traits. The class is a template over a struct with geometry, address offsets, wiring and initialization sequence of the panel
+//! \n  Display is the longan nano panel. Display_panel< Panel_st7735s_w160_h128 > and Display_panel< Panel_st7789_w240_h135 > drive external modules
+//! \n  Flip. set_flip turns the image upside down by toggling MX and MY of MADCTL. The address offsets follow the screen inside the panel memory
+//! \n  Primitives. fill_rect, draw_hline, draw_vline and draw_frame queue solid rectangles. Each one is an address window and a solid color DMA run
+//! \n  RLE565 images. register_image decodes a compressed image from flash a chunk at a time into two staging buffers. Long runs are sent as solid color sprites
+//! \n  Pixel maps are const. A map pre-rendered in flash is sent by the DMA in place. color is constexpr so that maps can be rendered by the compiler
+//! \n  SPI_SINGLE_FRAME. The SPI stays in 8b frames. Addresses are sent as big endian bytes. RGB565 pixels are a byte stream, color returns the bytes swapped and pack_rgb565 swaps raw maps. Off by default only for polled RGB565
+//! \n  Whole screen effects. set_invert, set_blank and set_idle send a single command to the panel and no pixel
+//! \n  USE_ISR waits for the SPI in the SPI interrupt. The ISR arms the receive buffer not empty event instead of spinning on the busy flag
 /************************************************************************************/
 
-class Display
+template <class Panel>
+class Display_panel
 {
     //Visible to all
     public:
@@ -131,7 +483,7 @@ class Display
         *********************************************************************************************************************************************************/
 
         //Empty Constructor
-        Display( void );
+        Display_panel( void );
         
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -140,7 +492,7 @@ class Display
         *********************************************************************************************************************************************************/
 
         //Empty Destructor
-        ~Display( void );
+        ~Display_panel( void );
 
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -148,7 +500,7 @@ class Display
         **********************************************************************************************************************************************************
         *********************************************************************************************************************************************************/
 
-        //Initialize the longan nano display and related peripherals
+        //Initialize the longan nano peripherals and start the bring-up of the display. Non blocking. update_sprite runs the bring-up
         bool init( void );
 
         /*********************************************************************************************************************************************************
@@ -157,22 +509,74 @@ class Display
         **********************************************************************************************************************************************************
         *********************************************************************************************************************************************************/
 
-        //convert from 24b 8R8G8B space to 16bit 5R6G5B space
-        static uint16_t color( uint8_t r, uint8_t g, uint8_t b );
-        //Register a sprite for the driver to draw. Complex pixel map.
-        int register_sprite( int origin_h, int origin_w, int size_h, int size_w, uint16_t* sprite_ptr );
+        //convert from 24b 8R8G8B space to the color space of the display. 5R6G5B or 4R4G4B
+        static constexpr uint16_t color( uint8_t r, uint8_t g, uint8_t b );
+        //RGB444. Pack a pixel map in place, two pixels in three bytes. Return the number of bytes
+        static uint32_t pack_rgb444( uint16_t *pixel_ptr, uint32_t size );
+        //RGB565 byte stream. Swap the bytes of a raw RGB565 pixel map in place. Does nothing with 16b frames
+        static void pack_rgb565( uint16_t *pixel_ptr, uint32_t size );
+        //Bytes needed to send a number of pixels
+        static uint32_t get_transfer_bytes( uint32_t size );
+        //Register a sprite for the driver to draw. Complex pixel map. In RAM or pre-rendered in flash
+        int register_sprite( int origin_h, int origin_w, int size_h, int size_w, const uint16_t *sprite_ptr );
         //Register a sprite for the driver to draw. Solid color.
         int register_sprite( int origin_h, int origin_w, int size_h, int size_w, uint16_t sprite_color );
         //Core method. FSM that physically updates the screen. Return: false = IDLE | true = BUSY
         bool update_sprite( void );
+        //ISR hook. Call from the DMA transfer complete interrupt of the SPI transmit channel and from the SPI interrupt when USE_ISR is true
+        void update_sprite_isr( void );
+        //USE_DMA false. Budget of a call of update_sprite in SPI frames and in microseconds. 0 = no limit. Default is one step per call
+        bool set_burst( uint16_t max_frames, uint16_t max_time_us );
+        //true = the display is brought up. Sprites registered before are queued and sent once the display is ready
+        bool is_ready( void );
+        //true = no more sprites can be registered until the FSM sends one
+        bool is_sprite_queue_full( void );
+        //true = no sprites are waiting in the queue. The FSM may still be sending the last one
+        bool is_sprite_queue_empty( void );
+        //Number of sprites registered and not yet sent. Includes the sprite being sent
+        int get_sprite_queue_depth( void );
+        //true = a sprite registered and not yet sent uses this pixel buffer. The buffer must not be changed
+        bool is_sprite_buffer_used( const uint16_t *buffer_ptr );
+        //Bytes of commands and addresses sent to open the address windows of the sprites
+        uint32_t get_command_bytes( void );
+        //Bytes of pixel data sent inside the address windows of the sprites
+        uint32_t get_pixel_bytes( void );
+        //Address commands not sent because the display already had the address
+        uint32_t get_skipped_commands( void );
         //Draw a sprite. Complex color map. Blocking Method.
-        int draw_sprite( int origin_h, int origin_w, int size_h, int size_w, uint16_t* sprite_ptr );
+        int draw_sprite( int origin_h, int origin_w, int size_h, int size_w, const uint16_t *sprite_ptr );
         //Draw a sprite. Solid color. Blocking Method.
         int draw_sprite( int origin_h, int origin_w, int size_h, int size_w, uint16_t sprite_color );
         //Clear the screen to black. Blocking method.
         int clear( void );
         //Clear the screen to a given color. Blocking method.
         int clear( uint16_t color );
+        //Register a solid rectangle. One address window and one solid color run. Non blocking
+        int fill_rect( int origin_h, int origin_w, int size_h, int size_w, uint16_t color );
+        //Register a horizontal line one pixel tall. Non blocking
+        int draw_hline( int origin_h, int origin_w, int size_w, uint16_t color );
+        //Register a vertical line one pixel wide. Non blocking
+        int draw_vline( int origin_h, int origin_w, int size_h, uint16_t color );
+        //Register the border of a rectangle. At most four solid rectangles. Non blocking
+        int draw_frame( int origin_h, int origin_w, int size_h, int size_w, int thickness, uint16_t color );
+        //Register a RLE565 compressed image stored in flash. update_sprite decodes it a chunk at a time. Non blocking
+        int register_image( int origin_h, int origin_w, const uint8_t *image_ptr );
+        //true = the image registered is still being decoded
+        bool is_image_busy( void );
+        //Draw a RLE565 compressed image stored in flash. Blocking method.
+        int draw_image( int origin_h, int origin_w, const uint8_t *image_ptr );
+        //Define the columns of the screen the panel rotates with its hardware scroll. Blocking method.
+        bool set_scroll_area( int origin_w, int size_w );
+        //Rotate the scroll area left by a number of columns. Blocking method.
+        bool set_scroll( int offset_w );
+        //Turn the image upside down by reprogramming MADCTL. Clears the scroll area. Blocking method.
+        bool set_flip( bool f_flip );
+        //Invert the colors of the whole screen with the display inversion of the panel. Blocking method.
+        bool set_invert( bool f_invert );
+        //Blank the whole screen by turning the display off. The panel memory is kept. Blocking method.
+        bool set_blank( bool f_blank );
+        //Show the whole screen in eight colors with the idle mode of the panel. Blocking method.
+        bool set_idle( bool f_idle );
     
     protected:
         /*********************************************************************************************************************************************************
@@ -184,35 +588,65 @@ class Display
         //! @brief Configuration parameters of the LCD Display class
         typedef enum _Config
         {
-            //Screen physical configuration
-            WIDTH				= 160,				//WIdth of the LCD display
-            HEIGHT				= 80,				//Height of the LCD display
+            //Screen physical configuration. From the panel
+            WIDTH				= Panel::Config::WIDTH,					//WIdth of the LCD display
+            HEIGHT				= Panel::Config::HEIGHT,				//Height of the LCD display
             PIXEL_COUNT			= WIDTH *HEIGHT,	//Number of pixels
-            COLOR_DEPTH			= 16,				//Color depth. Screen allows 12, 16 and 18
-            ROW_ADDRESS_OFFSET	= 1,				//Offset to be applied to the row address (physical pixels do not begin in 0,0)
-            COL_ADDRESS_OFFSET	= 26,				//Offset to be applied to the col address (physical pixels do not begin in 0,0)
-            //Screen GPIO Configuration
-            RS_GPIO			= GPIOB,			//RS pin of the LCD
-            RS_PIN			= GPIO_PIN_0,		//RS pin of the LCD
-            RST_GPIO		= GPIOB,			//Reset pin of the LCD
-            RST_PIN			= GPIO_PIN_1,		//Reset pin of the LCD
+            COLOR_DEPTH			= Panel::Config::COLOR_DEPTH,			//Color depth. Screen allows 12, 16 and 18. Driver supports 16 = RGB565 | 12 = RGB444, two pixels packed in three bytes
+            ROW_ADDRESS_OFFSET	= Panel::Config::ROW_ADDRESS_OFFSET,	//Offset to be applied to the row address (physical pixels do not begin in 0,0)
+            COL_ADDRESS_OFFSET	= Panel::Config::COL_ADDRESS_OFFSET,	//Offset to be applied to the col address (physical pixels do not begin in 0,0)
+            PANEL_LINES			= Panel::Config::PANEL_LINES,			//Lines of the panel memory. With MADCTL MV set the lines run along the width. The hardware scroll rotates lines
+            PANEL_COLUMNS		= Panel::Config::PANEL_COLUMNS,			//Columns of the panel memory. With MADCTL MV set the columns run along the height
+            //Flip. The image is turned upside down by mirroring both memory addresses. The screen moves to the other side of the panel memory
+            MADCTL					= Panel::Config::MADCTL,				//Memory data access control of the panel
+            MADCTL_FLIP				= Panel::Config::MADCTL ^0xC0,			//MX and MY toggled
+            ROW_ADDRESS_OFFSET_FLIP	= PANEL_LINES -WIDTH -ROW_ADDRESS_OFFSET,	//Row address offset of the flipped screen
+            COL_ADDRESS_OFFSET_FLIP	= PANEL_COLUMNS -HEIGHT -COL_ADDRESS_OFFSET,	//Col address offset of the flipped screen
+            INVERSION				= Panel::Config::INVERSION,				//Display inversion that shows normal colors. set_invert toggles it
+            //Screen GPIO Configuration. From the panel
+            RS_GPIO			= Panel::Config::RS_GPIO,			//RS pin of the LCD
+            RS_PIN			= Panel::Config::RS_PIN,			//RS pin of the LCD
+            RST_GPIO		= Panel::Config::RST_GPIO,			//Reset pin of the LCD
+            RST_PIN			= Panel::Config::RST_PIN,			//Reset pin of the LCD
             RESET_DELAY     = 1,                //TIme needed for the reset to take effect in milliseconds
-            //SPI Configuration
-            SPI_CH			= SPI0,				//SPI used for the ST7735S
-            SPI_CS_GPIO		= GPIOB,			//SPI Chip Select pin of the LCD
-            SPI_CS_PIN		= GPIO_PIN_2,		//SPI Chip Select pin of the LCD
-            SPI_CLK_GPIO	= GPIOA,			//SPI Clock pin of the LCD
-            SPI_CLK_PIN		= GPIO_PIN_5,		//SPI Clock pin of the LCD
-            SPI_MISO_GPIO	= GPIOA,			//SPI MISO In pin of the LCD
-            SPI_MISO_PIN	= GPIO_PIN_6,		//SPI MISO In pin of the LCD
-            SPI_MOSI_GPIO	= GPIOA,			//SPI MOSI In pin of the LCD
-            SPI_MOSI_PIN	= GPIO_PIN_7,		//SPI MOSI In pin of the LCD
+            //SPI Configuration. From the panel
+            SPI_RCU			= Panel::Config::SPI_RCU,			//Clock of the SPI
+            SPI_CH			= Panel::Config::SPI_CH,			//SPI used for the LCD
+            SPI_CS_GPIO		= Panel::Config::SPI_CS_GPIO,		//SPI Chip Select pin of the LCD
+            SPI_CS_PIN		= Panel::Config::SPI_CS_PIN,		//SPI Chip Select pin of the LCD
+            SPI_CLK_GPIO	= Panel::Config::SPI_CLK_GPIO,		//SPI Clock pin of the LCD
+            SPI_CLK_PIN		= Panel::Config::SPI_CLK_PIN,		//SPI Clock pin of the LCD
+            SPI_MISO_GPIO	= Panel::Config::SPI_MISO_GPIO,		//SPI MISO In pin of the LCD
+            SPI_MISO_PIN	= Panel::Config::SPI_MISO_PIN,		//SPI MISO In pin of the LCD
+            SPI_MOSI_GPIO	= Panel::Config::SPI_MOSI_GPIO,		//SPI MOSI In pin of the LCD
+            SPI_MOSI_PIN	= Panel::Config::SPI_MOSI_PIN,		//SPI MOSI In pin of the LCD
             //DMA Configuration
             USE_DMA         = true,            	//With DMA acceleration disabled, CPU use is the same, but the screen takes a lot longer to refresh as there are 74 update/sprite instead of 8 update/sprite
-            DMA_SPI_TX      = DMA0,             //DMA pheriperal used for the SPI transmit
-            DMA_SPI_TX_CH   = (dma_channel_enum)DMA_CH2,          //DMA channel used for the SPI transmit
-            //DMA_SPI_RX      = DMA0,             //DMA pheriperal used for the SPI receive
-            //DMA_SPI_RX_CH   = (dma_channel_enum)DMA_CH1,          //DMA channel used for the SPI receive
+            DMA_SPI_TX_RCU  = Panel::Config::DMA_SPI_TX_RCU,	//Clock of the DMA
+            DMA_SPI_TX      = Panel::Config::DMA_SPI_TX,		//DMA pheriperal used for the SPI transmit
+            DMA_SPI_TX_CH   = Panel::Config::DMA_SPI_TX_CH,		//DMA channel used for the SPI transmit
+            //Interrupt Configuration
+            USE_ISR         = true,             //The DMA transfer complete and SPI receive ISR advance the FSM and update_sprite only reports the status. Requires USE_DMA. Application must call update_sprite_isr from both ISR
+            DMA_SPI_TX_IRQ  = Panel::Config::DMA_SPI_TX_IRQ,	//Interrupt of the DMA channel used for the SPI transmit
+            DMA_SPI_TX_IRQ_LEVEL    = 1,        //ECLIC level of the DMA interrupt
+            DMA_SPI_TX_IRQ_PRIORITY = 1,        //ECLIC priority of the DMA interrupt
+            SPI_IRQ         = Panel::Config::SPI_IRQ,	//Interrupt of the SPI. Ends the waits for the SPI to be idle when USE_ISR is true
+            SPI_IRQ_LEVEL   = 1,                //ECLIC level of the SPI interrupt. Same as the DMA interrupt, the two never nest
+            SPI_IRQ_PRIORITY = 1,               //ECLIC priority of the SPI interrupt
+            //Sprite queue
+            SPRITE_QUEUE_SIZE	= 8,				//Number of sprites that can be registered while the FSM is busy sending
+            //SPI frame size
+            SPI_SINGLE_FRAME	= ((COLOR_DEPTH == 12) || (USE_DMA == true)),	//true = the SPI stays in 8b frames. Addresses are sent as big endian bytes. RGB565 pixels are sent as bytes, color() returns them swapped | false = addresses and RGB565 pixels are sent in 16b frames. Off for polled RGB565, that would take a step per byte instead of per pixel
+            PIXEL_BYTE_STREAM	= ((COLOR_DEPTH == 12) || (SPI_SINGLE_FRAME == true)),	//The pixels are sent in 8b frames
+            //Cost of a sprite on the SPI
+            SPRITE_COMMAND_BYTES	= 3 +8,			//Bytes needed to open the address window of a sprite. CASET(1+4) RASET(1+4) RAMWR(1). Worst case
+            ADDRESS_COMMAND_BYTES	= 1 +4,			//Bytes of an address command and its start and stop addresses. Saved when the display already has the address
+            //Byte stream
+            SOLID_PATTERN_PIXELS	= WIDTH,		//A solid color can't be repeated by the DMA one byte at a time. The DMA sends a pattern buffer of this many pixels over and over
+            //RLE565 compressed images
+            IMAGE_HEADER_BYTES		= 4,			//Height and width of the image. 16b big endian
+            IMAGE_BUFFER_PIXELS		= WIDTH,		//Pixels of each of the two staging buffers. A chunk is decoded in one while the DMA sends the other
+            IMAGE_SOLID_RUN			= 16,			//A run of the same color at least this long is sent as a solid color sprite instead of being expanded in a staging buffer
         } Config;
 
     private:
@@ -222,56 +656,17 @@ class Display
         **********************************************************************************************************************************************************
         *********************************************************************************************************************************************************/
         
-        //! @brief ST7735S Commands
-        typedef enum _Command
-        {           
-            //  SETUP_NORMAL_MODE
-            //Frame rate=850kHz/((RTNA x 2 + 40) x (LINE + FPA + BPA +2))
-            //Frame Rate = 850Khz/( (5*2+40)*(80+56+56+2) )= 87.6[Hz]
-            //RTNA | FPA | BPA
-            SETUP_NORMAL_MODE           = 0xB1,
-            //  SETUP_IDLE_MODE
-            //Frame rate=850kHz/((RTNA x 2 + 40) x (LINE + FPA + BPA +2))
-            //Frame Rate = 850Khz/( (5*2+40)*(80+56+56+2) )= 87.6[Hz]
-            //RTNA | FPA | BPA
-            SETUP_IDLE_MODE             = 0xB2,
-
-            SETUP_PARTIAL_MODE          = 0xB3,
-            //  DISPLAY_INVERSION_CONTROL
-            //false  Dot Inversion | true = Normal Mode Column Inversion
-            //Bit 0	| Normal Mode
-            //Bit 1	| idle Mode
-            //Bit 2 | partial mode/full colors
-            DISPLAY_INVERSION_CONTROL   = 0xB4, 
-
-            POWER_GVDD                  = 0xC0,
-            POWER_VGH_VGL               = 0xC1,
-            POWER_VCOM1                 = 0xC5,
-
-            POWER_MODE_NORMAL           = 0xC2,
-            POWER_MODE_IDLE             = 0xC3,
-            POWER_MODE_PARTIAL          = 0xC4,
-
-            ADJUST_GAMMA_PLUS           = 0xE0,
-            ADJUST_GAMMA_MINUS          = 0xE1,
-            
-            //  COLOR_FORMAT
-            //0x03	|	12b |4R4G|4B...4R|4G4B| 3 bytes transfer 2 color
-            //0x05	|	16b |5R3G|3G5B|			2 bytes transfer 1 color
-            //0x06	|	18b |6R..|6G..|6b..|	3 bytes transfer 1 color
-            COLOR_FORMAT                = 0x3A,
-
-            MEMORY_DATA_ACCESS_CONTROL  = 0x36,
-
-            DISPLAY_ON                  = 0x29,
-            SLEEP_OUT_BOOSTER_ON        = 0x11,
-
-            ENABLE_DISPLAY_INVERSION	= 0x21,
-            SEND_ROW_ADDRESS 			= 0x2A,		//Column address (ST7735S datasheet page 128/201)
-            SEND_COL_ADDRESS 			= 0x2B,		//Row Address (ST7735S datasheet page 131/201)
-            WRITE_MEM					= 0x2C,		//Memory Write. After this command, the display expects pixel data (ST7735S datasheet page 132/201)
-            TERMINATOR					= 0xFF,		//Special terminator for the command parser FSM
-        } Command;
+        //! @brief Commands of the panel controller
+        typedef Panel_command Command;
+        
+        //! @brief Tokens of the RLE565 stream. Colors are RGB565, 16b big endian
+        typedef enum _Image_token
+        {
+            TOKEN_RUN		= 0x80,		//0nnnnnnn literal. n+1 colors follow
+            TOKEN_LONG		= 0x40,		//10nnnnnn run of n+1 pixels. 11nnnnnn nnnnnnnn run of n+1 pixels. One color follows
+            LITERAL_MASK	= 0x7F,
+            RUN_MASK		= 0x3F,
+        } Image_token;
     
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -289,17 +684,55 @@ class Display
             uint16_t size_h;
             uint16_t size_w;
             uint32_t size;
+            //Pixel map of a clipped sprite. Index of the first visible pixel and pixels between two rows inside the user buffer
+            uint16_t offset;
+            uint16_t stride;
             //false = sprite pixel buffer | true = solid color
             bool b_solid_color;
             //I do not use the sprite map and the solid color at the same time
             union
             {
                 //pointer to the sprite pixel buffer
-                uint16_t *sprite_ptr;
+                const uint16_t *sprite_ptr;
                 //When in solid color mode, save the color to be applied to the full sprite
                 uint16_t solid_color;
             };
         } Sprite;
+        
+        //! @brief RLE565 image being decoded
+        typedef struct _Image
+        {
+            //Next byte of the compressed stream. nullptr = no image
+            const uint8_t *data_ptr;
+            //Position of the image on the screen and its size
+            int16_t origin_h;
+            int16_t origin_w;
+            uint16_t size_h;
+            uint16_t size_w;
+            //Next pixel of the image to be decoded
+            uint16_t cursor_h;
+            uint16_t cursor_w;
+            //Pixels left in the current token. A run repeats its color, a literal reads one color per pixel from the stream
+            uint16_t token_cnt;
+            bool f_run;
+            uint16_t run_color;
+            //Staging buffer being filled, image pixel where its strip starts and pixels decoded in it
+            uint8_t buffer_index;
+            uint16_t strip_h;
+            uint16_t strip_w;
+            uint16_t strip_cnt;
+        } Image;
+        
+        //! @brief Address window last programmed in the display. An address is not sent again if it didn't change
+        typedef struct _Window_cache
+        {
+            //false = the address of the display is unknown and must be sent
+            bool f_valid_w;
+            bool f_valid_h;
+            //Start and stop address in width and in height, offset included
+            uint16_t start_w, stop_w;
+            uint16_t start_h, stop_h;
+        } Window_cache;
     
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -313,8 +746,48 @@ class Display
         bool init_spi( void );
         //Initialize DMA that accelerates the SPI. Skipped if Config::USE_DMA is set to false
         bool init_dma( void );
-        //Send ST7735 init sequence
-        bool init_st7735( void );
+        //Initialize the sprite queue
+        bool init_sprite_queue( void );
+        //Forget the address window of the display
+        bool init_window_cache( void );
+        
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PRIVATE METHODS
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //Clip a sprite against the screen and fill its descriptor. Return the number of visible pixels
+        int clip_sprite( int origin_h, int origin_w, int size_h, int size_w, Sprite &sprite );
+        //Color of a pixel of the sprite being sent. Index counts the visible pixels
+        uint16_t get_sprite_pixel( uint32_t index );
+        //Byte stream. Byte of the pixels of the sprite being sent
+        uint8_t get_sprite_byte( uint32_t index );
+        //Byte stream. Fill the pattern buffer with a solid color
+        void fill_solid_pattern( uint16_t color );
+        //Address offsets of the screen inside the panel memory. They move when the image is flipped
+        uint16_t get_row_address_offset( void );
+        uint16_t get_col_address_offset( void );
+        //Execute a step of the bring-up FSM. Return: false = READY | true = BUSY
+        bool step_init( void );
+        //Execute a step of the FSM. Return: false = IDLE | true = BUSY
+        bool step_sprite( void );
+        //Execute steps of the FSM until a DMA transfer is started or the FSM is IDLE
+        void chain_sprite( void );
+        //USE_DMA false. Execute steps of the FSM until the burst budget is spent or the FSM is IDLE
+        void burst_sprite( void );
+        //Decode the image into solid color sprites and staging buffers until the queue is full. Return: false = no image | true = BUSY
+        bool step_image( void );
+        //Register the strip of the staging buffer being filled as a pixel map sprite
+        void close_image_strip( void );
+        //Convert a RGB565 color of the image to the color depth of the display
+        static uint16_t convert_rgb565( uint16_t color );
+        //Push a sprite in the sprite queue. false = OK | true = queue full
+        bool push_sprite( Sprite &sprite );
+        //Load the oldest sprite in the queue as the sprite being sent. false = OK | true = queue empty
+        bool pop_sprite( void );
+        //Send a command and its parameters once the FSM is done with the sprite queue. Blocking
+        void send_command( uint8_t command, const uint8_t *data_ptr, uint8_t data_size );
         
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -324,6 +797,8 @@ class Display
 
         //return true when the SPI is IDLE
         bool is_spi_idle( void );
+        //ISR mode. Arm the receive buffer not empty interrupt of the SPI. false = the SPI went idle meanwhile, nothing armed
+        bool arm_spi_event( void );
         //Return true when the SPI is done TX
         bool is_spi_done_tx( void );
         //wait until SPI is idle. Blocking function.
@@ -346,10 +821,20 @@ class Display
         void spi_set_8bit( void );
         //Configure the SPI to 16b
         void spi_set_16bit( void );
+        //Send a command byte. Configure the SPI to 8b
+        void spi_send_command( uint8_t command );
         //Use the DMA to send a 16b memory through the SPI
-        void dma_send_map16( uint16_t *data_ptr, uint16_t data_size );
+        void dma_send_map16( const uint16_t *data_ptr, uint16_t data_size );
         //Use the DMA to send a 16b data through the SPI a number of times
         void dma_send_solid16( uint16_t *data_ptr, uint16_t data_size );
+        //Use the DMA to send a 8b memory through the SPI
+        void dma_send_map8( const uint8_t *data_ptr, uint16_t data_size );
+        //return true while the DMA is moving data to the SPI
+        bool is_dma_busy( void );
+        //Keep the DMA ISR from running the FSM while the main loop changes the sprite queue
+        void isr_lock( void );
+        //Allow the DMA ISR to run the FSM
+        void isr_unlock( void );
 
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -357,40 +842,63 @@ class Display
         **********************************************************************************************************************************************************
         *********************************************************************************************************************************************************/
 
-        //! @brief ST7735S initialization sequence. Stored in flash memory
-        static constexpr uint8_t g_st7735s_init_sequence[] =
+        //! @brief Color format of the panel. Sent before the initialization sequence of the panel. Stored in flash memory
+        static constexpr uint8_t g_color_format_sequence[] =
         {
-            Command::ENABLE_DISPLAY_INVERSION,      Command::TERMINATOR,
-            Command::SETUP_NORMAL_MODE,             0x05, 0x3a, 0x3a, Command::TERMINATOR,
-            Command::SETUP_IDLE_MODE,               0x05, 0x3a, 0x3a, Command::TERMINATOR,
-            Command::SETUP_PARTIAL_MODE,            0x05, 0x3a, 0x3a, 0x05, 0x3a, 0x3a, Command::TERMINATOR,
-            Command::DISPLAY_INVERSION_CONTROL,     0x03, Command::TERMINATOR,
-            Command::POWER_GVDD,                    0x62, 0x02, 0x04, Command::TERMINATOR,
-            Command::POWER_VGH_VGL,                 0xc0, Command::TERMINATOR,
-            Command::POWER_MODE_NORMAL,             0x0d, 0x00, Command::TERMINATOR,
-            Command::POWER_MODE_IDLE,               0x8d, 0x6a, Command::TERMINATOR,
-            Command::POWER_MODE_PARTIAL,            0x8d, 0xee, Command::TERMINATOR,
-            Command::POWER_VCOM1,                   0x0e, Command::TERMINATOR,
-            Command::ADJUST_GAMMA_PLUS,             0x10, 0x0e, 0x02, 0x03, 0x0e, 0x07, 0x02, 0x07, 0x0a, 0x12, 0x27, 0x37, 0x00, 0x0d, 0x0e, 0x10, Command::TERMINATOR,
-            Command::ADJUST_GAMMA_MINUS,            0x10, 0x0e, 0x03, 0x03, 0x0f, 0x06, 0x02, 0x08, 0x0a, 0x13, 0x26, 0x36, 0x00, 0x0d, 0x0e, 0x10, Command::TERMINATOR,
-            Command::COLOR_FORMAT,                  0x55, Command::TERMINATOR,
-            Command::MEMORY_DATA_ACCESS_CONTROL,    0x78, Command::TERMINATOR,
-            Command::DISPLAY_ON,                    Command::TERMINATOR,
-            Command::SLEEP_OUT_BOOSTER_ON,          Command::TERMINATOR,
+            Command::COLOR_FORMAT,                  ((Config::COLOR_DEPTH == 12)?(0x03):(0x55)), Command::TERMINATOR,
             Command::TERMINATOR,
         };
-        //! @brief Runtime sprite informations
+        //! @brief Sprite being sent by the FSM. The solid color must stay put while the DMA reads it
         Sprite g_sprite;
+        //! @brief Sprites registered and waiting for the FSM. Ring buffer
+        Sprite g_sprite_queue[ Config::SPRITE_QUEUE_SIZE ];
+        //! @brief Index of the oldest sprite in the queue
+        uint8_t g_queue_head;
+        //! @brief Number of sprites waiting in the queue. Pushed by the main loop, popped by the FSM that may run in the ISR
+        volatile uint8_t g_queue_cnt;
+        //! @brief Profile the SPI traffic. Bytes spent opening address windows and bytes of pixel data
+        uint32_t g_command_bytes;
+        uint32_t g_pixel_bytes;
+        //! @brief Address commands not sent because the display already had the address
+        uint32_t g_skipped_commands;
+        //! @brief Address window last programmed in the display
+        Window_cache g_window_cache;
+        //! @brief Rows of a clipped pixel map already given to the DMA. A strided map is sent one row per transfer. Patterns already sent for a byte stream solid color
+        uint16_t g_sprite_row;
+        //! @brief Byte stream. Solid color packed over and over. Read by the DMA
+        uint8_t g_solid_pattern[ (Config::PIXEL_BYTE_STREAM == true)?(Config::SOLID_PATTERN_PIXELS *Config::COLOR_DEPTH /8):(1) ];
         //! @brief Buffer to send address data using DMA
         uint16_t g_address_buffer[2];
-        //! @brief FSM status
-        uint32_t g_sprite_status;
+        //! @brief Columns of the screen rotated by the hardware scroll. Size zero means the scroll area is not defined
+        uint16_t g_scroll_origin_w;
+        uint16_t g_scroll_size_w;
+        //! @brief true = the image is upside down. MADCTL_FLIP is programmed
+        bool g_f_flip;
+        //! @brief FSM status. Changed by the ISR when USE_ISR is true
+        volatile uint32_t g_sprite_status;
+        //! @brief Bring-up FSM status. Zero when the display is ready. Always advanced by update_sprite
+        uint8_t g_init_status;
+        //! @brief Sequence being sent by the bring-up FSM and index of its next byte
+        const uint8_t *g_init_sequence_ptr;
+        uint16_t g_init_index;
+        //! @brief Time the reset line has been held or released
+        Longan_nano::Chrono g_init_timer;
+        //! @brief USE_DMA false. SPI frames and SysTick ticks a call of update_sprite may spend. 0 = no limit
+        uint16_t g_burst_frames;
+        uint32_t g_burst_ticks;
+        //! @brief RLE565 image being decoded
+        Image g_image;
+        //! @brief Staging buffers of the image. Read by the DMA
+        uint16_t g_image_buffer[2][ Config::IMAGE_BUFFER_PIXELS ];
 
     //--------------------------------------------------------------------------
     //	End Private
     //--------------------------------------------------------------------------
 };	//End class: Lcd
 
+//! @brief Driver of the display embedded in the longan nano
+typedef Display_panel<Panel_st7735s_w160_h80> Display;
+
     /*********************************************************************************************************************************************************
     **********************************************************************************************************************************************************
     **	CONSTRUCTORS
@@ -406,7 +914,8 @@ class Display
 //!	\n will NOT initialize the peripherals
 /***************************************************************************/
 
-Display::Display( void )
+template <class Panel>
+Display_panel<Panel>::Display_panel( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -415,6 +924,28 @@ Display::Display( void )
     
     //FSM to idle
     this -> g_sprite_status = 0;
+    this -> g_sprite_row = 0;
+    //No bring-up in progress
+    this -> g_init_status = 0;
+    this -> g_init_sequence_ptr = this -> g_color_format_sequence;
+    this -> g_init_index = 0;
+    //One step of the FSM per call
+    this -> g_burst_frames = 1;
+    this -> g_burst_ticks = 0;
+    //No image being decoded
+    this -> g_image.data_ptr = nullptr;
+    //Empty sprite queue
+    this -> init_sprite_queue();
+    //Address window of the display is unknown
+    this -> init_window_cache();
+    //Clear the SPI traffic profile
+    this -> g_command_bytes = 0;
+    this -> g_pixel_bytes = 0;
+    this -> g_skipped_commands = 0;
+    //No scroll area
+    this -> g_scroll_origin_w = 0;
+    this -> g_scroll_size_w = 0;
+    this -> g_f_flip = false;
 
     //----------------------------------------------------------------
     //	RETURN
@@ -434,7 +965,8 @@ Display::Display( void )
 //!	~Display | void |
 /***************************************************************************/
 
-Display::~Display( void )
+template <class Panel>
+Display_panel<Panel>::~Display_panel( void )
 {
     
     //----------------------------------------------------------------
@@ -456,10 +988,13 @@ Display::~Display( void )
 /***************************************************************************/
 //! @return bool | false = OK | true = ERR
 //! @details
-//!	\n initialize the longan nano display and related peripherals
+//!	\n initialize the longan nano peripherals and start the bring-up of the display. Non blocking.
+//!	\n The reset delays and the initialization sequence are executed by update_sprite, the same loop that draws the sprites
+//!	\n Sprites can be registered right away. They are sent once is_ready is true
 /***************************************************************************/
 
-bool Display::init( void )
+template <class Panel>
+bool Display_panel<Panel>::init( void )
 {
     //----------------------------------------------------------------
     //	VARS
@@ -475,22 +1010,28 @@ bool Display::init( void )
     //Initialize GPIO configuration
     f_ret |= this -> init_gpio();
 
-    //Reset the ST7735 display
+    //Reset the ST7735 display. The bring-up FSM releases the reset when RESET_DELAY is elapsed
     this -> rs_mode_data();
     this -> rst_active();	
     this -> cs_inactive();
-    Longan_nano::Chrono::delay( Longan_nano::Chrono::Unit::milliseconds, Config::RESET_DELAY );
-
-    //Activate the ST7735 display
-    this -> rst_inactive();
-    Longan_nano::Chrono::delay( Longan_nano::Chrono::Unit::milliseconds, Config::RESET_DELAY );
+    this -> g_init_timer.start();
 
     //Initialize SPI that communicates with the display
     f_ret |= this -> init_spi();
     //Initialize the DMA that accelerates the SPI
     f_ret |= this -> init_dma();
-    //Send ST7735 Initialization sequence
-    f_ret |= this -> init_st7735();
+    //Start the bring-up FSM. The color format and the initialization sequence of the panel are sent by update_sprite
+    this -> g_init_sequence_ptr = this -> g_color_format_sequence;
+    this -> g_init_index = 0;
+    this -> g_init_status = 1;
+    //The display reset its address window
+    f_ret |= this -> init_window_cache();
+    //The display reset its scroll area. The initialization sequence programs MADCTL
+    this -> g_scroll_origin_w = 0;
+    this -> g_scroll_size_w = 0;
+    this -> g_f_flip = false;
+    //Drop the image being decoded
+    this -> g_image.data_ptr = nullptr;
     
     //----------------------------------------------------------------
     //	RETURN
@@ -512,66 +1053,216 @@ bool Display::init( void )
 //! @param r | uint8_t | 8bit red color channel
 //! @param g | uint8_t | 8bit green color channel
 //! @param b | uint8_t | 8bit blue color channel
-//! @return uint16_t | RGB565 color compatible with ST7735 display color space
+//! @return uint16_t | RGB565 or RGB444 color compatible with ST7735 display color space
 //! @details
 //!	\n	convert from 24b 8R8G8B space to 16bit 5R6G5B space
 //!	\n          RRRRRRRR
 //!	\n          GGGGGGGG
 //!	\n          BBBBBBBB
 //!	\n	RRRRRGGGGGGBBBBB
+//!	\n	With COLOR_DEPTH 12, convert to 12bit 4R4G4B space
+//!	\n	0000RRRRGGGGBBBB
+//!	\n	With SPI_SINGLE_FRAME the RGB565 pixels are sent as a byte stream. The bytes are swapped so that the memory holds them big endian
+//!	\n	GGGBBBBBRRRRRGGG
 /***************************************************************************/
 
-uint16_t Display::color( uint8_t r, uint8_t g, uint8_t b )
+template <class Panel>
+constexpr uint16_t Display_panel<Panel>::color( uint8_t r, uint8_t g, uint8_t b )
 {
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
     
+    //If: RGB444
+    if (Config::COLOR_DEPTH == 12)
+    {
+        return ( ((uint16_t)0) | ((r & 0xF0) << 4) | ((g & 0xF0) << 0) | ((b & 0xF0) >> 4) );
+    }
+    //If: RGB565 byte stream
+    else if (Config::SPI_SINGLE_FRAME == true)
+    {
+        return ( ((uint16_t)0) | ((r & 0xF8) << 0) | ((g & 0xE0) >> 5) | ((g & 0x1C) << 11) | ((b & 0xF8) << 5) );
+    }
     return ( ((uint16_t)0) | ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | ((b & 0xF8) >> 3) );
 }	//End Public Method: color | uint8_t | uint8_t | uint8_t |
 
+/***************************************************************************/
+//!	@brief Public Method
+//!	pack_rgb444 | uint16_t * | uint32_t |
+/***************************************************************************/
+//! @param pixel_ptr | uint16_t * | pixel map of RGB444 colors from Display::color. Packed in place
+//! @param size | uint32_t | number of pixels
+//! @return uint32_t | number of bytes of the packed pixel map
+//! @details
+//!	\n	RGB444 is sent two pixels every three bytes. The pixel map given to register_sprite must be packed
+//!	\n	0000RRRRGGGGBBBB 0000rrrrggggbbbb -> RRRRGGGG BBBBrrrr ggggbbbb
+//!	\n	The packed map is smaller, the bytes of a pair are written after the pair is read
+/***************************************************************************/
+
+template <class Panel>
+uint32_t Display_panel<Panel>::pack_rgb444( uint16_t *pixel_ptr, uint32_t size )
+{
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Packed map
+    uint8_t *byte_ptr = (uint8_t *)pixel_ptr;
+    //Index of the packed byte
+    uint32_t index = 0;
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //For: each pair of pixels
+    for (uint32_t t = 0;t < size;t += 2)
+    {
+        uint16_t first = pixel_ptr[ t ];
+        uint16_t second = (t +1 < size)?(pixel_ptr[ t +1 ]):(0);
+        byte_ptr[ index++ ] = (uint8_t)(first >> 4);
+        byte_ptr[ index++ ] = (uint8_t)(((first & 0x0F) << 4) | (second >> 8));
+        //If: odd pixel count. The last pixel ends in the middle of a byte
+        if (t +1 < size)
+        {
+            byte_ptr[ index++ ] = (uint8_t)(second & 0xFF);
+        }
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return index;
+}	//End Public Method: pack_rgb444 | uint16_t * | uint32_t |
+
+/***************************************************************************/
+//!	@brief Public Method
+//!	pack_rgb565 | uint16_t * | uint32_t |
+/***************************************************************************/
+//! @param pixel_ptr | uint16_t * | pixel map of raw RGB565 colors. Swapped in place
+//! @param size | uint32_t | number of pixels
+//! @details
+//!	\n	With SPI_SINGLE_FRAME the RGB565 pixels are sent by the DMA as a byte stream. The most significant byte goes first
+//!	\n	RRRRRGGGGGGBBBBB -> GGGBBBBBRRRRRGGG
+//!	\n	Maps made with Display::color are already swapped. The swap is its own inverse
+//!	\n	Does nothing with RGB444 or with 16b frames
+/***************************************************************************/
+
+template <class Panel>
+void Display_panel<Panel>::pack_rgb565( uint16_t *pixel_ptr, uint32_t size )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: the pixels are not a RGB565 byte stream
+    if ((Config::COLOR_DEPTH != 16) || (Config::SPI_SINGLE_FRAME == false))
+    {
+        return;
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //For: each pixel
+    for (uint32_t t = 0;t < size;t++)
+    {
+        pixel_ptr[ t ] = (uint16_t)((pixel_ptr[ t ] << 8) | (pixel_ptr[ t ] >> 8));
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return;
+}	//End Public Method: pack_rgb565 | uint16_t * | uint32_t |
+
+/***************************************************************************/
+//!	@brief Public Method
+//!	get_transfer_bytes | uint32_t |
+/***************************************************************************/
+//! @param size | uint32_t | number of pixels
+//! @return uint32_t | bytes needed to send the pixels to the display
+/***************************************************************************/
+
+template <class Panel>
+inline uint32_t Display_panel<Panel>::get_transfer_bytes( uint32_t size )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return (size *Config::COLOR_DEPTH +7) /8;
+}	//End Public Method: get_transfer_bytes | uint32_t |
+
 /***************************************************************************/
 //!	@brief public method
-//!	register_sprite | int | int | int | int | uint16_t * |
+//!	register_sprite | int | int | int | int | const uint16_t * |
 /***************************************************************************/
 //! @param origin_h | int | starting top left corner height of the sprite
 //! @param origin_w | int | starting top left corner height of the sprite
 //! @param size_h | int | height size of the sprite
 //! @param size_w | int | width size of the sprite
-//! @param sprite_ptr | uint16_t * | pointer to RGB565 pixel color map
-//! @return int | number of pixels queued for draw
+//! @param sprite_ptr | const uint16_t * | pointer to pixel color map from Display::color. Raw RGB565 maps go through pack_rgb565. RGB444: pointer to the map packed by pack_rgb444. Can be in flash, the DMA reads it in place
+//! @return int | number of pixels queued for draw | 0 sprite is outside the screen | -1 the sprite queue is full or RGB444 map can't be clipped
 //! @details
 //!	\n	Ask the driver to draw a sprite
-//!	\n	The draw method handles sprites that fill only part of the screen
-//!	\n	If reworked, the buffer stays the same or is smaller than user buffer
+//!	\n	The sprite is pushed in the sprite queue. The pixel buffer must stay untouched until is_sprite_buffer_used says otherwise
+//!	\n	The draw method handles sprites that fill only part of the screen. Origin can be negative
 //!	\n	1) Sprite fully inside screen area: the sprite is queued for draw
 //!	\n	2) Sprite is fully outside screen area: no pixels are queued for draw
-//!	\n	3) sprite is partially outside screen area: the method rework the buffer to include only pixel that can be drawn
+//!	\n	3) sprite is partially outside screen area: only the visible sub rectangle of the buffer is queued for draw
+//!	\n	If the width is clipped, the rows of the visible sub rectangle are not contiguous and the DMA sends them one row per transfer
+//!	\n	A packed RGB444 map can only be clipped in height
+//!	\n	A map pre-rendered in flash is sent by the DMA straight from flash. No RAM buffer and no expansion
 /***************************************************************************/
 
-int Display::register_sprite( int origin_h, int origin_w, int size_h, int size_w, uint16_t* sprite_ptr )
+template <class Panel>
+int Display_panel<Panel>::register_sprite( int origin_h, int origin_w, int size_h, int size_w, const uint16_t *sprite_ptr )
 {
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Descriptor of the new sprite
+    Sprite sprite_tmp;
+
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
-    //! @todo handle partial sprite draw
     
-    this -> g_sprite.origin_w		= origin_w;
-    this -> g_sprite.origin_h		= origin_h;
-    this -> g_sprite.size_w			= size_w;
-    this -> g_sprite.size_h			= size_h;
-    this -> g_sprite.size			= size_w *size_h;
-    this -> g_sprite.b_solid_color	= false;
-    this -> g_sprite.sprite_ptr		= sprite_ptr;
-    //Start the FSM
-    this -> g_sprite_status		= 1;
+    //Clip the sprite against the screen
+    int pixel_count = this -> clip_sprite( origin_h, origin_w, size_h, size_w, sprite_tmp );
+    //If: no pixel is visible
+    if (pixel_count == 0)
+    {
+        //Nothing to draw
+        return 0;
+    }
+    //If: RGB444 and the visible pixels don't start on a byte or aren't contiguous in the packed map
+    if ((Config::COLOR_DEPTH == 12) && ((sprite_tmp.stride != sprite_tmp.size_w) || ((sprite_tmp.offset & 0x01) != 0)))
+    {
+        //Packed pixel maps can only be clipped in height, by an even number of pixels
+        return -1;
+    }
+    //Draw a pixel map. Clipping moved the first pixel inside the user buffer
+    sprite_tmp.b_solid_color	= false;
+    sprite_tmp.sprite_ptr		= sprite_ptr;
+    //If: the queue is full
+    if (this -> push_sprite( sprite_tmp ) == true)
+    {
+        //The caller is supposed to check is_sprite_queue_full before registering
+        return -1;
+    }
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
     
-    return (size_w *size_h);
-}	//End Public Method: register_sprite | int | int | int | int | uint16_t * |
+    return pixel_count;
+}	//End Public Method: register_sprite | int | int | int | int | const uint16_t * |
 
 /***************************************************************************/
 //!	@brief public method
@@ -581,196 +1272,1864 @@ int Display::register_sprite( int origin_h, int origin_w, int size_h, int size_w
 //! @param origin_w | int | starting top left corner height of the sprite
 //! @param size_h | int | height size of the sprite
 //! @param size_w | int | width size of the sprite
-//! @param sprite_color | uint16_t | RGB565 pixel solid color for the full sprite
-//! @return int | number of pixels queued for draw
+//! @param sprite_color | uint16_t | RGB565 or RGB444 pixel solid color for the full sprite
+//! @return int | number of pixels queued for draw | 0 sprite is outside the screen | -1 the sprite queue is full
 //! @details
 //!	\n	Ask the driver to draw a sprite with a solid color
-//!	\n	The draw method handles sprites that fill only part of the screen
-//!	\n	If reworked, the buffer stays the same or is smaller than user buffer
+//!	\n	The sprite is pushed in the sprite queue. The color is copied in the queue
+//!	\n	The draw method handles sprites that fill only part of the screen. Origin can be negative
 //!	\n	1) Sprite fully inside screen area: the sprite is queued for draw
 //!	\n	2) Sprite is fully outside screen area: no pixels are queued for draw
-//!	\n	3) sprite is partially outside screen area: the method rework the buffer to include only pixel that can be drawn
+//!	\n	3) sprite is partially outside screen area: only the visible part is queued for draw
 /***************************************************************************/
 
-int Display::register_sprite( int origin_h, int origin_w, int size_h, int size_w, uint16_t sprite_color )
+template <class Panel>
+int Display_panel<Panel>::register_sprite( int origin_h, int origin_w, int size_h, int size_w, uint16_t sprite_color )
 {
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Descriptor of the new sprite
+    Sprite sprite_tmp;
+
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
-    //! @todo handle partial sprite draw
     
-    //Size of the sprite
-    this -> g_sprite.origin_w		= origin_w;
-    this -> g_sprite.origin_h		= origin_h;
-    this -> g_sprite.size_w			= size_w;
-    this -> g_sprite.size_h			= size_h;
-    this -> g_sprite.size			= size_w *size_h;
+    //Clip the sprite against the screen
+    int pixel_count = this -> clip_sprite( origin_h, origin_w, size_h, size_w, sprite_tmp );
+    //If: no pixel is visible
+    if (pixel_count == 0)
+    {
+        //Nothing to draw
+        return 0;
+    }
     //Draw a solid color
-    this -> g_sprite.b_solid_color	= true;
-    this -> g_sprite.solid_color	= sprite_color;
-    //Start the FSM
-    this -> g_sprite_status			= 1;
+    sprite_tmp.b_solid_color	= true;
+    sprite_tmp.solid_color		= sprite_color;
+    //If: the queue is full
+    if (this -> push_sprite( sprite_tmp ) == true)
+    {
+        //The caller is supposed to check is_sprite_queue_full before registering
+        return -1;
+    }
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
     
-    return (this -> g_sprite.size);
-}	//End Public Method: register_sprite | int | int | int | int | uint16_t * |
+    return pixel_count;
+}	//End Public Method: register_sprite | int | int | int | int | uint16_t |
 
 /***************************************************************************/
 //!	@brief public method
-//!	update_sprite | void |
+//!	update_sprite | void
 /***************************************************************************/
 //! @return bool | false = IDLE | true = BUSY
 //! @details
-//!	\n	Execute a step of the FSM that interfaces with the physical display
-//!	\n	Handle both solid color and color map
-//!	\n	sprite data must already be valid before execution
+//!	\n	Polled mode: execute a step of the FSM that interfaces with the physical display
+//!	\n	ISR mode: the DMA transfer complete ISR advances the FSM. Just report the status
+//!	\n	An image registered by register_image is decoded into the free slots of the queue first. The image keeps the driver BUSY
 /***************************************************************************/
 
-bool Display::update_sprite( void )
+template <class Panel>
+bool Display_panel<Panel>::update_sprite( void )
 {
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
-    
-    //Switch: FSM status
-    switch (this -> g_sprite_status)
+
+    //If: the display is being brought up
+    if (this -> g_init_status != 0)
     {
-        //IDLE
-        case 0:
-        {
-            //Do Nothing
-            
-            break;
-        }
-        //Row address
-        case 1:
-        {
-            if (this -> is_spi_idle() == true)
-            {
-                //Commands are 8b
-                this -> spi_set_8bit();
-                this -> rs_mode_cmd();
-                spi_i2s_data_transmit(Config::SPI_CH, Command::SEND_ROW_ADDRESS);
-                //Next state
-                this -> g_sprite_status++;
-            }
-            break;
-        }
-        //Row Address start
-        case 2:
-        {
-            //If: user wants to use the DMA
-            if (Config::USE_DMA == true)
-            {
-                if (this -> is_spi_idle() == true)
-                {
-                    //Configure Data are 16b
-                    this -> rs_mode_data();
-                    this -> spi_set_16bit();
-                    //Load addresses on the address buffer
-                    this -> g_address_buffer[ 0 ] = this -> g_sprite.origin_w +Config::ROW_ADDRESS_OFFSET;
-                    this -> g_address_buffer[ 1 ] = this -> g_sprite.origin_w +Config::ROW_ADDRESS_OFFSET +this -> g_sprite.size_w -1;
-                    //Program the DMA to send the address
-                    this -> dma_send_map16( this -> g_address_buffer, 2 );
-                    //Next state. Skip second SPI transfer
-                    this -> g_sprite_status += 2;
-                }
-            }
-            //End If: user doesn't want to use the DMA
-            else
-            {
-                if (this -> is_spi_idle() == true)
-                {
-                    this -> spi_set_16bit();
-                    this -> rs_mode_data();
-                    spi_i2s_data_transmit(Config::SPI_CH, this -> g_sprite.origin_w +Config::ROW_ADDRESS_OFFSET);
-                    //Next state 
-                    this -> g_sprite_status++;
-                }
-            }
-            break;
-        }
-        //Row Address stop
-        case 3:
-        {
-            if (this -> is_spi_done_tx() == true)
-            {
-                spi_i2s_data_transmit(Config::SPI_CH, this -> g_sprite.origin_w +Config::ROW_ADDRESS_OFFSET +this -> g_sprite.size_w -1);	
-                //Next state
-                this -> g_sprite_status++;
-            }
-            break;
-        }	
-        //Col Address
-        case 4:
-        {
-            if (this -> is_spi_idle() == true)
-            {
-                //Commands are 8b
-                this -> spi_set_8bit();
-                this -> rs_mode_cmd();
-                spi_i2s_data_transmit(Config::SPI_CH, Command::SEND_COL_ADDRESS);
-                //Next state
-                this -> g_sprite_status++;
-            }
-            break;
-        }	
-        //Col Address Start
-        case 5:
+        //Execute a step of the bring-up. The sprite FSM starts when the display is ready
+        this -> step_init();
+        return true;	//BUSY
+    }
+    //If: an image is being decoded
+    if (this -> g_image.data_ptr != nullptr)
+    {
+        //Decode the next chunks while the FSM sends the previous ones
+        this -> step_image();
+    }
+
+    //If: the FSM sends the pixels without DMA and the caller gave it a burst budget
+    if ((Config::USE_DMA == false) && ((this -> g_burst_frames != 1) || (this -> g_burst_ticks != 0)))
+    {
+        //Keep the SPI fed until the budget is spent
+        this -> burst_sprite();
+    }
+    //If: the FSM is advanced by the main loop
+    else if ((Config::USE_ISR == false) || (Config::USE_DMA == false))
+    {
+        //Execute a step of the FSM
+        this -> step_sprite();
+    }
+    //If: the FSM is advanced by the ISR
+    else
+    {
+        //Keep the ISR from running while the flag is checked
+        this -> isr_lock();
+        //If: a transfer completed or the SPI is done with the frame the FSM waits for, and the ISR did not serve it (interrupts globally disabled)
+        if ((dma_interrupt_flag_get( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, DMA_INT_FLAG_FTF ) == SET) || (spi_i2s_interrupt_flag_get( Config::SPI_CH, SPI_I2S_INT_FLAG_RBNE ) == SET))
         {
-            //If: user wants to use the DMA
-            if (Config::USE_DMA == true)
-            {
-                if (this -> is_spi_idle() == true)
-                {
-                    //Configure HW
-                    this -> rs_mode_data();
-                    this -> spi_set_16bit();
-                    //Load addresses on the address buffer
-                    this -> g_address_buffer[ 0 ] = this -> g_sprite.origin_h +Config::COL_ADDRESS_OFFSET;
-                    this -> g_address_buffer[ 1 ] = this -> g_sprite.origin_h +Config::COL_ADDRESS_OFFSET +this -> g_sprite.size_h -1;
-                    //Program the DMA to send the address
-                    this -> dma_send_map16( this -> g_address_buffer, 2 );
-                    //Next state. Skip second SPI transfer
-                    this -> g_sprite_status += 2;
-                }
-            }
-            //End If: user doesn't want to use the DMA
-            else
-            {
-                if (this -> is_spi_idle() == true)
-                {
-                    this -> spi_set_16bit();
-                    this -> rs_mode_data();
-                    spi_i2s_data_transmit(Config::SPI_CH, this -> g_sprite.origin_h +Config::COL_ADDRESS_OFFSET);
-                    //Next state 
-                    this -> g_sprite_status++;
-                }
-            }
-            break;
+            //Serve it from the main loop
+            this -> update_sprite_isr();
         }
-        //Col Address Stop
-        case 6:
+        this -> isr_unlock();
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return ((this -> g_sprite_status != 0) || (this -> g_image.data_ptr != nullptr));
+}	//End public method: update_sprite | void |
+
+/***************************************************************************/
+//!	@brief public method
+//!	update_sprite_isr | void
+/***************************************************************************/
+//! @details
+//!	\n	ISR hook. Application calls it from the DMA transfer complete interrupt of the SPI transmit channel and from the SPI interrupt
+//!	\n	A DMA transfer is done or the SPI is done with a frame. Execute FSM steps until the next DMA transfer is started, the FSM waits for the SPI or the queue is empty
+//!	\n	The ISR never waits for the SPI. Each wait ends in the receive buffer not empty interrupt of the SPI
+/***************************************************************************/
+
+template <class Panel>
+void Display_panel<Panel>::update_sprite_isr( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Clear the interrupt flags of the channel
+    dma_interrupt_flag_clear( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, DMA_INT_FLAG_G );
+    //The SPI event is served. chain_sprite arms it again if the FSM has to wait
+    spi_i2s_interrupt_disable( Config::SPI_CH, SPI_I2S_INT_RBNE );
+    //Resume the FSM
+    this -> chain_sprite();
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return;
+}	//End public method: update_sprite_isr | void
+
+/***************************************************************************/
+//!	@brief public method
+//!	set_burst | uint16_t | uint16_t |
+/***************************************************************************/
+//! @param max_frames | uint16_t | SPI frames a call of update_sprite may send. 0 = no limit
+//! @param max_time_us | uint16_t | microseconds a call of update_sprite may spend. 0 = no limit
+//! @return bool | false = OK | true = ERR the driver uses the DMA or both budgets are unlimited
+//! @details
+//!	\n	USE_DMA false. The polled FSM sends one SPI frame per call of update_sprite. A sprite takes as many calls as it has pixels
+//!	\n	With a budget, update_sprite keeps feeding the SPI each time the TX buffer is empty until it sent max_frames or max_time_us elapsed
+//!	\n	The caller trades CPU time for refresh rate. max_frames 1 and max_time_us 0 is the default, one step per call
+/***************************************************************************/
+
+template <class Panel>
+bool Display_panel<Panel>::set_burst( uint16_t max_frames, uint16_t max_time_us )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: the DMA sends the pixels or the budget is unlimited
+    if ((Config::USE_DMA == true) || ((max_frames == 0) && (max_time_us == 0)))
+    {
+        return true;	//FAIL
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    this -> g_burst_frames = max_frames;
+    this -> g_burst_ticks = (uint32_t)max_time_us *(Longan_nano::Chrono::get_systick_freq() /1000000);
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return false;	//OK
+}	//End public method: set_burst | uint16_t | uint16_t |
+
+/***************************************************************************/
+//!	@brief public method
+//!	is_ready | void |
+/***************************************************************************/
+//! @return bool | false = the display is being brought up | true = the display is ready
+//! @details
+//!	\n	The bring-up is executed by update_sprite. Sprites registered before are sent once the display is ready
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::is_ready( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return (this -> g_init_status == 0);
+}	//End public method: is_ready | void |
+
+/***************************************************************************/
+//!	@brief public method
+//!	is_sprite_queue_full | void |
+/***************************************************************************/
+//! @return bool | false = there is room for at least one sprite | true = queue is full
+//! @details
+//!	\n	A sprite registered with the queue full is refused
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::is_sprite_queue_full( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return (this -> g_queue_cnt >= Config::SPRITE_QUEUE_SIZE);
+}	//End public method: is_sprite_queue_full | void |
+
+/***************************************************************************/
+//!	@brief public method
+//!	is_sprite_queue_empty | void |
+/***************************************************************************/
+//! @return bool | false = sprites are waiting in the queue | true = queue is empty
+//! @details
+//!	\n	The FSM may still be busy sending the last sprite loaded from the queue
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::is_sprite_queue_empty( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return (this -> g_queue_cnt == 0);
+}	//End public method: is_sprite_queue_empty | void |
+
+/***************************************************************************/
+//!	@brief public method
+//!	get_sprite_queue_depth | void |
+/***************************************************************************/
+//! @return int | number of sprites registered and not yet sent
+//! @details
+//!	\n	Count the sprites waiting in the queue and the sprite the FSM is sending, if any
+/***************************************************************************/
+
+template <class Panel>
+inline int Display_panel<Panel>::get_sprite_queue_depth( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return this -> g_queue_cnt +((this -> g_sprite_status != 0)?(1):(0));
+}	//End public method: get_sprite_queue_depth | void |
+
+/***************************************************************************/
+//!	@brief public method
+//!	is_sprite_buffer_used | const uint16_t * |
+/***************************************************************************/
+//! @param buffer_ptr | const uint16_t * | pixel buffer previously registered with a sprite
+//! @return bool | false = buffer can be written | true = the FSM still has to send pixels from the buffer
+//! @details
+//!	\n	The driver doesn't copy pixel maps. The caller uses this method to know when a pixel buffer can be reused
+//!	\n	Check the sprite being sent and the sprites waiting in the queue
+/***************************************************************************/
+
+template <class Panel>
+bool Display_panel<Panel>::is_sprite_buffer_used( const uint16_t *buffer_ptr )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //The ISR may be popping sprites
+    this -> isr_lock();
+    //If: the FSM is sending a pixel map from the buffer
+    bool f_used = ((this -> g_sprite_status != 0) && (this -> g_sprite.b_solid_color == false) && (this -> g_sprite.sprite_ptr == buffer_ptr));
+    //Index of the queued sprite
+    uint8_t index = this -> g_queue_head;
+    //For: each queued sprite
+    for (uint8_t t = 0;(f_used == false) && (t < this -> g_queue_cnt);t++)
+    {
+        //If: the queued sprite is a pixel map from the buffer
+        if ((this -> g_sprite_queue[ index ].b_solid_color == false) && (this -> g_sprite_queue[ index ].sprite_ptr == buffer_ptr))
+        {
+            f_used = true;
+        }
+        //Next queued sprite
+        index = (index < Config::SPRITE_QUEUE_SIZE -1)?(index +1):(0);
+    }	//End For: each queued sprite
+    this -> isr_unlock();
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return f_used;
+}	//End public method: is_sprite_buffer_used | const uint16_t * |
+
+/***************************************************************************/
+//!	@brief public getter
+//!	get_command_bytes | void |
+/***************************************************************************/
+//! @return uint32_t | bytes of commands and addresses sent to open the address windows of the sprites
+//! @details
+//!	\n	Overhead of the sprites. Each sprite costs Config::SPRITE_COMMAND_BYTES no matter its size
+//!	\n	Compare with get_pixel_bytes to know how much of the SPI bandwidth goes in pixels
+/***************************************************************************/
+
+template <class Panel>
+inline uint32_t Display_panel<Panel>::get_command_bytes( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return this -> g_command_bytes;
+}	//End public getter: get_command_bytes | void |
+
+/***************************************************************************/
+//!	@brief public getter
+//!	get_pixel_bytes | void |
+/***************************************************************************/
+//! @return uint32_t | bytes of pixel data sent inside the address windows of the sprites
+//! @details
+//!	\n	A solid color sprite is counted as if each pixel was sent. The DMA does send the color once per pixel
+/***************************************************************************/
+
+template <class Panel>
+inline uint32_t Display_panel<Panel>::get_pixel_bytes( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return this -> g_pixel_bytes;
+}	//End public getter: get_pixel_bytes | void |
+
+/***************************************************************************/
+//!	@brief public getter
+//!	get_skipped_commands | void |
+/***************************************************************************/
+//! @return uint32_t | address commands not sent because the display already had the address
+//! @details
+//!	\n	Each skipped command saves Config::ADDRESS_COMMAND_BYTES on the SPI. Without SPI_SINGLE_FRAME it also saves two changes of the SPI data size
+//!	\n	Sprites side by side in the same row of the screen only need the address in width
+/***************************************************************************/
+
+template <class Panel>
+inline uint32_t Display_panel<Panel>::get_skipped_commands( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return this -> g_skipped_commands;
+}	//End public getter: get_skipped_commands | void |
+
+/***************************************************************************/
+//!	@brief public method
+//!	draw_sprite | int | int | int | int | const uint16_t * |
+/***************************************************************************/
+//! @param origin_h | int | starting top left corner height of the sprite
+//! @param origin_w | int | starting top left corner height of the sprite
+//! @param size_h | int | height size of the sprite
+//! @param size_w | int | width size of the sprite
+//! @param sprite_ptr | const uint16_t * | pointer to RGB565 pixel color map
+//! @return int | number of pixels drawn
+//! @details
+//!	\n	Draw a sprite
+//!	\n Blocking method
+//!	\n Draw a color map, requires a user buffer of the proper size
+/***************************************************************************/
+
+template <class Panel>
+int Display_panel<Panel>::draw_sprite( int origin_h, int origin_w, int size_h, int size_w, const uint16_t *sprite_ptr )
+{
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+    
+    //temp return
+    bool f_ret;
+    //Number of pixels drawn by the method
+    int pixel_count;
+    
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //While: the sprite queue is full
+    while (this -> is_sprite_queue_full() == true)
+    {
+        //Execute a step of the FSM
+        this -> update_sprite();
+    }
+    //Register the sprite to be drawn. Authorize the update FSM to draw the sprite through the "update_sprite" non blocking method
+    pixel_count = this -> register_sprite( origin_h, origin_w, size_h, size_w, sprite_ptr );
+    //Allow FSM to run if I have at least one pixel to draw
+    f_ret = (pixel_count > 0);
+    //While: the driver FSM is busy
+    while (f_ret == true)
+    {
+        //Execute a step of the FSM
+        f_ret = this -> update_sprite();
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return pixel_count;
+}	//End Public Method: draw_sprite | int | int | int | int | const uint16_t * |
+
+/***************************************************************************/
+//!	@brief public method
+//!	draw_sprite | int | int | int | int | uint16_t |
+/***************************************************************************/
+//! @param origin_h | int | starting top left corner height of the sprite
+//! @param origin_w | int | starting top left corner height of the sprite
+//! @param size_h | int | height size of the sprite
+//! @param size_w | int | width size of the sprite
+//! @param sprite_color | uint16_t | RGB565 pixel solid color for the full sprite
+//! @return int | number of pixels drawn
+//! @details
+//!	\n Draw a sprite
+//!	\n Blocking method
+//!	\n Draw a solid color sprite and doesn't require a color map
+/***************************************************************************/
+
+template <class Panel>
+int Display_panel<Panel>::draw_sprite( int origin_h, int origin_w, int size_h, int size_w, uint16_t sprite_color )
+{
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+    
+    //temp return
+    bool f_ret;
+    //Number of pixels drawn by the method
+    int pixel_count;
+    
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //While: the sprite queue is full
+    while (this -> is_sprite_queue_full() == true)
+    {
+        //Execute a step of the FSM
+        this -> update_sprite();
+    }
+    //Register the sprite to be drawn. Authorize the update FSM to draw the sprite through the "update_sprite" non blocking method
+    pixel_count = this -> register_sprite( origin_h, origin_w, size_h, size_w, sprite_color );
+    //Allow FSM to run if I have at least one pixel to draw
+    f_ret = (pixel_count > 0);
+    //While: the driver FSM is busy
+    while (f_ret == true)
+    {
+        //Execute a step of the FSM
+        f_ret = this -> update_sprite();
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return pixel_count;
+}	//End Public Method: draw_sprite | int | int | int | int | uint16_t |
+
+/***************************************************************************/
+//!	@brief public method
+//!	clear | void |
+/***************************************************************************/
+//! @return int | number of pixels drawn
+//! @details
+//!	\n Clear the screen. Blocking method.
+//!	\n Draw a black sprite the size of the screen
+/***************************************************************************/
+
+template <class Panel>
+inline int Display_panel<Panel>::clear( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //blocking draw sprite
+    int pixel_count = this -> draw_sprite( 0, 0, Config::HEIGHT, Config::WIDTH, Display_panel::color( 0, 0, 0 ) );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return pixel_count;
+}	//End public method: clear | void |
+
+/***************************************************************************/
+//!	@brief public method
+//!	clear | void |
+/***************************************************************************/
+//! @param color | uint16_t | clear the display to a solid color
+//! @return int | number of pixels drawn
+//! @details
+//!	\n Clear the screen. Blocking method.
+//!	\n Draw a black sprite the size of the screen
+/***************************************************************************/
+
+template <class Panel>
+inline int Display_panel<Panel>::clear( uint16_t color )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    int pixel_count = this -> draw_sprite( 0, 0, Config::HEIGHT, Config::WIDTH, color );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return pixel_count;
+}	//End public method: clear | void |
+
+/***************************************************************************/
+//!	@brief public method
+//!	fill_rect | int | int | int | int | uint16_t |
+/***************************************************************************/
+//! @param origin_h | int | top left corner height of the rectangle
+//! @param origin_w | int | top left corner width of the rectangle
+//! @param size_h | int | height of the rectangle
+//! @param size_w | int | width of the rectangle
+//! @param color | uint16_t | RGB565 or RGB444 solid color
+//! @return int | number of pixels queued for draw | 0 rectangle is outside the screen | -1 the sprite queue is full
+//! @details
+//!	\n Non blocking. The rectangle is a solid color sprite scheduled by update_sprite
+//!	\n It costs one address window and one DMA run of the solid color whatever its size
+//!	\n The rectangle is clipped against the screen
+/***************************************************************************/
+
+template <class Panel>
+inline int Display_panel<Panel>::fill_rect( int origin_h, int origin_w, int size_h, int size_w, uint16_t color )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return this -> register_sprite( origin_h, origin_w, size_h, size_w, color );
+}	//End public method: fill_rect | int | int | int | int | uint16_t |
+
+/***************************************************************************/
+//!	@brief public method
+//!	draw_hline | int | int | int | uint16_t |
+/***************************************************************************/
+//! @param origin_h | int | height of the line
+//! @param origin_w | int | leftmost pixel of the line
+//! @param size_w | int | length of the line
+//! @param color | uint16_t | RGB565 or RGB444 solid color
+//! @return int | number of pixels queued for draw | 0 line is outside the screen | -1 the sprite queue is full
+//! @details
+//!	\n Non blocking. A rectangle one pixel tall
+/***************************************************************************/
+
+template <class Panel>
+inline int Display_panel<Panel>::draw_hline( int origin_h, int origin_w, int size_w, uint16_t color )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return this -> fill_rect( origin_h, origin_w, 1, size_w, color );
+}	//End public method: draw_hline | int | int | int | uint16_t |
+
+/***************************************************************************/
+//!	@brief public method
+//!	draw_vline | int | int | int | uint16_t |
+/***************************************************************************/
+//! @param origin_h | int | topmost pixel of the line
+//! @param origin_w | int | width of the line
+//! @param size_h | int | length of the line
+//! @param color | uint16_t | RGB565 or RGB444 solid color
+//! @return int | number of pixels queued for draw | 0 line is outside the screen | -1 the sprite queue is full
+//! @details
+//!	\n Non blocking. A rectangle one pixel wide
+/***************************************************************************/
+
+template <class Panel>
+inline int Display_panel<Panel>::draw_vline( int origin_h, int origin_w, int size_h, uint16_t color )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return this -> fill_rect( origin_h, origin_w, size_h, 1, color );
+}	//End public method: draw_vline | int | int | int | uint16_t |
+
+/***************************************************************************/
+//!	@brief public method
+//!	draw_frame | int | int | int | int | int | uint16_t |
+/***************************************************************************/
+//! @param origin_h | int | top left corner height of the frame
+//! @param origin_w | int | top left corner width of the frame
+//! @param size_h | int | outer height of the frame
+//! @param size_w | int | outer width of the frame
+//! @param thickness | int | pixels of the border. Less than one draws nothing
+//! @param color | uint16_t | RGB565 or RGB444 solid color
+//! @return int | number of pixels queued for draw | 0 frame is outside the screen | -1 the sprite queue doesn't have room for the frame
+//! @details
+//!	\n Non blocking. The border is split in at most four solid rectangles that don't overlap
+//!	\n Top and bottom span the full width, left and right fill the height between them
+//!	\n They are queued top, bottom, left, right so that each pair shares a range and the window cache skips one address command per pair
+//!	\n A border thick enough to cover the inside is sent as a single rectangle
+//!	\n Nothing is queued unless the queue has room for all the rectangles
+/***************************************************************************/
+
+template <class Panel>
+int Display_panel<Panel>::draw_frame( int origin_h, int origin_w, int size_h, int size_w, int thickness, uint16_t color )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: nothing to draw
+    if ((thickness < 1) || (size_h < 1) || (size_w < 1))
+    {
+        return 0;
+    }
+
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //true = the border covers the inside of the frame
+    bool f_solid = ((2 *thickness >= size_h) || (2 *thickness >= size_w));
+    //Sprites needed by the frame
+    int sprite_cnt = (f_solid == true)?(1):(4);
+    //Number of pixels queued
+    int pixel_count;
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: the queue can't take all the rectangles. The ISR can only make room
+    if (Config::SPRITE_QUEUE_SIZE -this -> g_queue_cnt < sprite_cnt)
+    {
+        return -1;
+    }
+    //If: the frame is a rectangle
+    if (f_solid == true)
+    {
+        return this -> fill_rect( origin_h, origin_w, size_h, size_w, color );
+    }
+    //Top and bottom share the range in width
+    pixel_count = this -> fill_rect( origin_h, origin_w, thickness, size_w, color );
+    pixel_count += this -> fill_rect( origin_h +size_h -thickness, origin_w, thickness, size_w, color );
+    //Left and right share the range in height
+    pixel_count += this -> fill_rect( origin_h +thickness, origin_w, size_h -2 *thickness, thickness, color );
+    pixel_count += this -> fill_rect( origin_h +thickness, origin_w +size_w -thickness, size_h -2 *thickness, thickness, color );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return pixel_count;
+}	//End public method: draw_frame | int | int | int | int | int | uint16_t |
+
+/***************************************************************************/
+//!	@brief public method
+//!	register_image | int | int | const uint8_t * |
+/***************************************************************************/
+//! @param origin_h | int | top left corner height of the image
+//! @param origin_w | int | top left corner width of the image
+//! @param image_ptr | const uint8_t * | RLE565 compressed image. Generated by tools/image_encoder. Usually stored in flash
+//! @return int | number of pixels of the image | -1 an image is already being decoded
+//! @details
+//!	\n Non blocking. update_sprite decodes the image a chunk at a time and sends it through the sprite queue
+//!	\n The whole image is never in RAM. Two staging buffers of IMAGE_BUFFER_PIXELS are decoded while the DMA sends the other
+//!	\n A run of at least IMAGE_SOLID_RUN pixels is sent as a solid color sprite straight from its color, runs covering full rows as a single rectangle
+//!	\n Stream: height and width 16b big endian, then tokens until every pixel is decoded
+//!	\n 0nnnnnnn literal. n+1 RGB565 colors follow, 16b big endian
+//!	\n 10nnnnnn run of n+1 pixels. 11nnnnnn nnnnnnnn run of n+1 pixels. One RGB565 color follows
+//!	\n The image is clipped against the screen. RGB444: the image must not be clipped in width, those chunks are dropped
+//!	\n The stream is read until the image is done and must stay put
+/***************************************************************************/
+
+template <class Panel>
+int Display_panel<Panel>::register_image( int origin_h, int origin_w, const uint8_t *image_ptr )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: no image or the decoder is busy with another image
+    if ((image_ptr == nullptr) || (this -> g_image.data_ptr != nullptr))
+    {
+        return -1;
+    }
+
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Size of the image
+    uint16_t size_h = (uint16_t)((image_ptr[0] << 8) | image_ptr[1]);
+    uint16_t size_w = (uint16_t)((image_ptr[2] << 8) | image_ptr[3]);
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: the image is empty
+    if ((size_h == 0) || (size_w == 0))
+    {
+        return 0;
+    }
+    //Start the decoder at the first pixel
+    this -> g_image.origin_h = origin_h;
+    this -> g_image.origin_w = origin_w;
+    this -> g_image.size_h = size_h;
+    this -> g_image.size_w = size_w;
+    this -> g_image.cursor_h = 0;
+    this -> g_image.cursor_w = 0;
+    this -> g_image.token_cnt = 0;
+    this -> g_image.f_run = false;
+    this -> g_image.run_color = 0;
+    this -> g_image.strip_h = 0;
+    this -> g_image.strip_w = 0;
+    this -> g_image.strip_cnt = 0;
+    this -> g_image.data_ptr = &image_ptr[ Config::IMAGE_HEADER_BYTES ];
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return (int)size_h *size_w;
+}	//End public method: register_image | int | int | const uint8_t * |
+
+/***************************************************************************/
+//!	@brief public method
+//!	is_image_busy | void |
+/***************************************************************************/
+//! @return bool | false = no image is being decoded | true = the decoder still has pixels of the image to send
+//! @details
+//!	\n The last sprites of the image may still be in the queue once the decoder is done
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::is_image_busy( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return (this -> g_image.data_ptr != nullptr);
+}	//End public method: is_image_busy | void |
+
+/***************************************************************************/
+//!	@brief public method
+//!	draw_image | int | int | const uint8_t * |
+/***************************************************************************/
+//! @param origin_h | int | top left corner height of the image
+//! @param origin_w | int | top left corner width of the image
+//! @param image_ptr | const uint8_t * | RLE565 compressed image
+//! @return int | number of pixels of the image | -1 an image is already being decoded
+//! @details
+//!	\n Draw a compressed image. Blocking method
+/***************************************************************************/
+
+template <class Panel>
+int Display_panel<Panel>::draw_image( int origin_h, int origin_w, const uint8_t *image_ptr )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Register the image. update_sprite decodes it
+    int pixel_count = this -> register_image( origin_h, origin_w, image_ptr );
+    //Allow FSM to run if I have at least one pixel to draw
+    bool f_ret = (pixel_count > 0);
+    //While: the image is being decoded or the driver FSM is busy
+    while (f_ret == true)
+    {
+        //Execute a step of the FSM
+        f_ret = this -> update_sprite();
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return pixel_count;
+}	//End public method: draw_image | int | int | const uint8_t * |
+
+/***************************************************************************/
+//!	@brief public method
+//!	set_scroll_area | int | int |
+/***************************************************************************/
+//! @param origin_w | int | first column of the scroll area
+//! @param size_w | int | number of columns in the scroll area
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Define the columns of the screen the panel rotates with its hardware scroll. Blocking method.
+//!	\n The ST7735S scrolls the lines of its memory. MADCTL 0x78 exchanges rows and columns (MV)
+//!	\n so that in landscape the lines of the panel run along the width and the scroll moves the image left and right
+//!	\n The columns before and after the area are fixed. The scroll offset is reset to zero
+/***************************************************************************/
+
+template <class Panel>
+bool Display_panel<Panel>::set_scroll_area( int origin_w, int size_w )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: the area is not inside the screen
+    if ((origin_w < 0) || (size_w < 1) || (origin_w +size_w > Config::WIDTH))
+    {
+        return true;	//FAIL
+    }
+
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Panel lines before the area, inside the area and after the area. The panel has lines outside the screen on both sides. Flipped, the columns run backward along the lines
+    uint16_t top = (this -> g_f_flip == false)?(origin_w +this -> get_row_address_offset()):(Config::PANEL_LINES -this -> get_row_address_offset() -origin_w -size_w);
+    uint16_t bottom = Config::PANEL_LINES -top -size_w;
+    //Parameters of the command. 16b big endian
+    uint8_t data[6] =
+    {
+        (uint8_t)(top >> 8), (uint8_t)(top & 0xFF),
+        (uint8_t)(size_w >> 8), (uint8_t)(size_w & 0xFF),
+        (uint8_t)(bottom >> 8), (uint8_t)(bottom & 0xFF),
+    };
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Define the area
+    this -> send_command( Command::SCROLL_AREA, data, 6 );
+    this -> g_scroll_origin_w = origin_w;
+    this -> g_scroll_size_w = size_w;
+    //Start from a still image
+    this -> set_scroll( 0 );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return false;	//OK
+}	//End public method: set_scroll_area | int | int |
+
+/***************************************************************************/
+//!	@brief public method
+//!	set_scroll | int |
+/***************************************************************************/
+//! @param offset_w | int | columns of rotation of the scroll area. From 0 to size of the area -1
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Rotate the scroll area left by a number of columns. Blocking method.
+//!	\n The panel memory is not changed. The column shown at origin_w +w is the memory column origin_w +(w +offset_w) %size_w
+//!	\n Sprites are registered at memory columns. The caller remaps the columns of the scroll area
+/***************************************************************************/
+
+template <class Panel>
+bool Display_panel<Panel>::set_scroll( int offset_w )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: the scroll area is not defined or the offset is outside the area
+    if ((this -> g_scroll_size_w == 0) || (offset_w < 0) || (offset_w >= this -> g_scroll_size_w))
+    {
+        return true;	//FAIL
+    }
+
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Panel line shown on the first line of the area. Flipped, the area rotates the other way along the lines
+    uint16_t start = (this -> g_f_flip == false)?(this -> g_scroll_origin_w +this -> get_row_address_offset() +offset_w):(Config::PANEL_LINES -this -> get_row_address_offset() -this -> g_scroll_origin_w -this -> g_scroll_size_w +(this -> g_scroll_size_w -offset_w) %this -> g_scroll_size_w);
+    //Parameters of the command. 16b big endian
+    uint8_t data[2] = { (uint8_t)(start >> 8), (uint8_t)(start & 0xFF) };
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    this -> send_command( Command::SCROLL_START, data, 2 );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return false;	//OK
+}	//End public method: set_scroll | int |
+
+/***************************************************************************/
+//!	@brief public method
+//!	set_flip | bool |
+/***************************************************************************/
+//! @param f_flip | bool | false = image as set by the panel initialization sequence | true = image upside down
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Turn the image upside down by reprogramming MADCTL. Blocking method.
+//!	\n MX and MY are toggled. The screen moves to the other side of the panel memory and the address offsets follow it
+//!	\n The content of the panel is not redrawn. The caller redraws the screen
+//!	\n The lines of a scroll area are mirrored by the flip. The scroll area is cleared
+/***************************************************************************/
+
+template <class Panel>
+bool Display_panel<Panel>::set_flip( bool f_flip )
+{
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Parameter of the command
+    uint8_t madctl = (f_flip == false)?((uint8_t)Config::MADCTL):((uint8_t)Config::MADCTL_FLIP);
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: a scroll area is defined
+    if (this -> g_scroll_size_w != 0)
+    {
+        //The whole panel memory becomes the scroll area, with no rotation
+        uint8_t area[6] = { 0, 0, (uint8_t)(Config::PANEL_LINES >> 8), (uint8_t)(Config::PANEL_LINES & 0xFF), 0, 0 };
+        uint8_t start[2] = { 0, 0 };
+        this -> send_command( Command::SCROLL_AREA, area, 6 );
+        this -> send_command( Command::SCROLL_START, start, 2 );
+        this -> g_scroll_origin_w = 0;
+        this -> g_scroll_size_w = 0;
+    }
+    //Program the scan direction
+    this -> send_command( Command::MEMORY_DATA_ACCESS_CONTROL, &madctl, 1 );
+    this -> g_f_flip = f_flip;
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return false;	//OK
+}	//End public method: set_flip | bool |
+
+/***************************************************************************/
+//!	@brief public method
+//!	set_invert | bool |
+/***************************************************************************/
+//! @param f_invert | bool | false = normal colors | true = inverted colors
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Invert the colors of the whole screen. Blocking method.
+//!	\n The panel inverts the pixels as they are shown. The memory is not changed and no pixel is sent
+//!	\n Some glasses need the inversion on to show normal colors. Config::INVERSION holds the one set by the initialization sequence
+/***************************************************************************/
+
+template <class Panel>
+bool Display_panel<Panel>::set_invert( bool f_invert )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: the panel is to show the opposite of its normal inversion
+    if (f_invert != (Config::INVERSION != 0))
+    {
+        this -> send_command( Command::ENABLE_DISPLAY_INVERSION, nullptr, 0 );
+    }
+    else
+    {
+        this -> send_command( Command::DISABLE_DISPLAY_INVERSION, nullptr, 0 );
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return false;	//OK
+}	//End public method: set_invert | bool |
+
+/***************************************************************************/
+//!	@brief public method
+//!	set_blank | bool |
+/***************************************************************************/
+//! @param f_blank | bool | false = the display shows its memory | true = blank screen
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Turn the display off and on. Blocking method.
+//!	\n The panel memory is kept. Sprites sent while blank are shown when the display is turned on
+/***************************************************************************/
+
+template <class Panel>
+bool Display_panel<Panel>::set_blank( bool f_blank )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    this -> send_command( (f_blank == true)?((uint8_t)Command::DISPLAY_OFF):((uint8_t)Command::DISPLAY_ON), nullptr, 0 );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return false;	//OK
+}	//End public method: set_blank | bool |
+
+/***************************************************************************/
+//!	@brief public method
+//!	set_idle | bool |
+/***************************************************************************/
+//! @param f_idle | bool | false = full colors | true = idle mode, eight colors
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Enter and leave the idle mode of the panel. Blocking method.
+//!	\n In idle mode only the MSB of each channel is shown. The panel refreshes with the idle frame rate and draws less power
+/***************************************************************************/
+
+template <class Panel>
+bool Display_panel<Panel>::set_idle( bool f_idle )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    this -> send_command( (f_idle == true)?((uint8_t)Command::IDLE_MODE_ON):((uint8_t)Command::IDLE_MODE_OFF), nullptr, 0 );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return false;	//OK
+}	//End public method: set_idle | bool |
+
+    /*********************************************************************************************************************************************************
+    **********************************************************************************************************************************************************
+    **	PRIVATE INIT
+    **********************************************************************************************************************************************************
+    *********************************************************************************************************************************************************/
+
+/***************************************************************************/
+//!	@brief Private init
+//!	init_gpio | void |
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n HAL method
+//!	\n initialize GPIO configuration
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::init_gpio( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+    
+    //Clock the GPIOs
+    rcu_periph_clock_enable( RCU_GPIOA );
+    rcu_periph_clock_enable( RCU_GPIOB );
+    rcu_periph_clock_enable( RCU_AF );
+        
+    //LCD RS command pin
+    gpio_init( Config::RS_GPIO, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, Config::RS_PIN );
+    //LCD RST reset pin
+    gpio_init( Config::RST_GPIO, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, Config::RST_PIN );
+    //LCD CS chip select pin
+    gpio_init( Config::SPI_CS_GPIO, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, Config::SPI_CS_PIN );
+    //Set the SPI pins to Alternate Functions
+    gpio_init( Config::SPI_CLK_GPIO, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, Config::SPI_CLK_PIN );
+    gpio_init( Config::SPI_MISO_GPIO, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, Config::SPI_MISO_PIN );
+    gpio_init( Config::SPI_MOSI_GPIO, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, Config::SPI_MOSI_PIN );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return false; //OK
+}	//End Private init: init_gpio | void |
+
+/***************************************************************************/
+//!	@brief Private init
+//!	init_spi | void |
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n HAL method
+//!	\n Initialize SPI that communicates with the Display
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::init_spi( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Clock the SPI
+    rcu_periph_clock_enable( (rcu_periph_enum)Config::SPI_RCU );
+    spi_i2s_deinit( Config::SPI_CH );
+    SPI_CTL0( Config::SPI_CH ) = (uint32_t)(SPI_MASTER | SPI_TRANSMODE_FULLDUPLEX | SPI_FRAMESIZE_8BIT | SPI_NSS_SOFT | SPI_ENDIAN_MSB | SPI_CK_PL_LOW_PH_1EDGE | SPI_PSC_8);
+    //If: DMA is accelerating the SPI
+    if (Config::USE_DMA == true)
+    {
+        SPI_CTL1( Config::SPI_CH ) = (uint32_t)(SPI_CTL1_DMATEN);
+    }
+    spi_enable( Config::SPI_CH );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return false; //OK
+}	//End Private init: init_spi | void |
+
+/***************************************************************************/
+//!	@brief Private init
+//!	init_dma | void |
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Initialize DMA that accelerates the SPI
+//!	\n In ISR mode enable the transfer complete interrupt. The application enables the global interrupts
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::init_dma( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+    
+    //CLock the DMA
+    rcu_periph_clock_enable( (rcu_periph_enum)Config::DMA_SPI_TX_RCU );
+    dma_deinit( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH );
+    DMA_CHCTL( Config::DMA_SPI_TX, Config::DMA_SPI_TX_CH ) = (uint32_t)(DMA_PRIORITY_ULTRA_HIGH | DMA_CHXCTL_DIR);
+    DMA_CHPADDR( Config::DMA_SPI_TX, Config::DMA_SPI_TX_CH ) = (uint32_t)&SPI_DATA(Config::SPI_CH);
+    //If: the DMA ISR advances the FSM
+    if ((Config::USE_ISR == true) && (Config::USE_DMA == true))
+    {
+        //Interrupt when a transfer is complete
+        dma_interrupt_enable( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, DMA_INT_FTF );
+        eclic_irq_enable( Config::DMA_SPI_TX_IRQ, Config::DMA_SPI_TX_IRQ_LEVEL, Config::DMA_SPI_TX_IRQ_PRIORITY );
+        //The SPI interrupt source is armed by chain_sprite only while the FSM waits for the SPI to be idle
+        eclic_irq_enable( Config::SPI_IRQ, Config::SPI_IRQ_LEVEL, Config::SPI_IRQ_PRIORITY );
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return false; //OK
+}	//End Private init: init_dma | void |
+
+/***************************************************************************/
+//!	@brief Private init
+//!	init_sprite_queue | void |
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Initialize the sprite queue to empty
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::init_sprite_queue( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+    
+    this -> g_queue_head = 0;
+    this -> g_queue_cnt = 0;
+    
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return false; //OK
+}	//End Private init: init_sprite_queue | void |
+
+/***************************************************************************/
+//!	@brief Private init
+//!	init_window_cache | void |
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Forget the address window of the display. The next sprite sends both addresses
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::init_window_cache( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+    
+    this -> g_window_cache.f_valid_w = false;
+    this -> g_window_cache.f_valid_h = false;
+    
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return false; //OK
+}	//End Private init: init_window_cache | void |
+
+    /*********************************************************************************************************************************************************
+    **********************************************************************************************************************************************************
+    **	PRIVATE METHODS
+    **********************************************************************************************************************************************************
+    *********************************************************************************************************************************************************/
+
+/***************************************************************************/
+//!	@brief Private Method
+//!	clip_sprite | int | int | int | int | Sprite & |
+/***************************************************************************/
+//! @param origin_h | int | starting top left corner height of the sprite. Can be negative
+//! @param origin_w | int | starting top left corner width of the sprite. Can be negative
+//! @param size_h | int | height size of the sprite
+//! @param size_w | int | width size of the sprite
+//! @param sprite | Sprite & | descriptor. Position, size, offset and stride of the visible part are written
+//! @return int | number of visible pixels. 0 = sprite is outside the screen
+//! @details
+//!	\n Clip a sprite against WIDTH and HEIGHT
+//!	\n offset is the index of the first visible pixel inside a pixel map of size_h x size_w
+//!	\n stride is the width of the pixel map. The visible rows are contiguous only if the width was not clipped
+/***************************************************************************/
+
+template <class Panel>
+int Display_panel<Panel>::clip_sprite( int origin_h, int origin_w, int size_h, int size_w, Sprite &sprite )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: sprite is empty or fully outside the screen
+    if ((size_h <= 0) || (size_w <= 0) || (origin_h >= Config::HEIGHT) || (origin_w >= Config::WIDTH) || (origin_h +size_h <= 0) || (origin_w +size_w <= 0))
+    {
+        return 0;
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Rows and columns of the pixel map that are above or left of the screen
+    int skip_h = (origin_h < 0)?(-origin_h):(0);
+    int skip_w = (origin_w < 0)?(-origin_w):(0);
+    //Visible part
+    int start_h = origin_h +skip_h;
+    int start_w = origin_w +skip_w;
+    int stop_h = (origin_h +size_h < Config::HEIGHT)?(origin_h +size_h):((int)Config::HEIGHT);
+    int stop_w = (origin_w +size_w < Config::WIDTH)?(origin_w +size_w):((int)Config::WIDTH);
+    //Fill the descriptor
+    sprite.origin_h = start_h;
+    sprite.origin_w = start_w;
+    sprite.size_h = stop_h -start_h;
+    sprite.size_w = stop_w -start_w;
+    sprite.size = sprite.size_h *sprite.size_w;
+    sprite.offset = skip_h *size_w +skip_w;
+    sprite.stride = size_w;
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return sprite.size;
+}	//End Private Method: clip_sprite | int | int | int | int | Sprite & |
+
+/***************************************************************************/
+//!	@brief Private Method
+//!	get_sprite_pixel | uint32_t |
+/***************************************************************************/
+//! @param index | uint32_t | index of the pixel among the visible pixels of the sprite being sent
+//! @return uint16_t | color of the pixel
+//! @details
+//!	\n Polled mode. Find the pixel inside the user buffer of a clipped pixel map
+/***************************************************************************/
+
+template <class Panel>
+inline uint16_t Display_panel<Panel>::get_sprite_pixel( uint32_t index )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: solid color
+    if (this -> g_sprite.b_solid_color == true)
+    {
+        return this -> g_sprite.solid_color;
+    }
+    //If: the rows of the pixel map are contiguous in the buffer
+    else if (this -> g_sprite.stride == this -> g_sprite.size_w)
+    {
+        return this -> g_sprite.sprite_ptr[ this -> g_sprite.offset +index ];
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    //Skip the clipped pixels of the rows above
+    return this -> g_sprite.sprite_ptr[ this -> g_sprite.offset +(index /this -> g_sprite.size_w) *this -> g_sprite.stride +(index %this -> g_sprite.size_w) ];
+}	//End Private Method: get_sprite_pixel | uint32_t |
+
+/***************************************************************************/
+//!	@brief Private Method
+//!	get_sprite_byte | uint32_t |
+/***************************************************************************/
+//! @param index | uint32_t | index of the byte among the packed bytes of the sprite being sent
+//! @return uint8_t | packed byte
+//! @details
+//!	\n Polled mode with a byte stream. RGB444: three bytes every two pixels
+//!	\n RGB565: two bytes per pixel in the order they sit in memory. The colors are already swapped
+/***************************************************************************/
+
+template <class Panel>
+inline uint8_t Display_panel<Panel>::get_sprite_byte( uint32_t index )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: RGB565. The even byte is the least significant byte of the swapped color
+    if (Config::COLOR_DEPTH == 16)
+    {
+        uint16_t color = this -> get_sprite_pixel( index >> 1 );
+        return ((index & 0x01) == 0)?((uint8_t)(color & 0xFF)):((uint8_t)(color >> 8));
+    }
+    //If: solid color. Both pixels of a pair are the same
+    if (this -> g_sprite.b_solid_color == true)
+    {
+        uint16_t color = this -> g_sprite.solid_color;
+        //Position inside the pair
+        uint8_t pos = index %3;
+        return (pos == 0)?((uint8_t)(color >> 4)):((pos == 1)?((uint8_t)(((color & 0x0F) << 4) | (color >> 8))):((uint8_t)(color & 0xFF)));
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    //The first visible pixel starts on a byte
+    return ((const uint8_t *)this -> g_sprite.sprite_ptr)[ this -> g_sprite.offset *3 /2 +index ];
+}	//End Private Method: get_sprite_byte | uint32_t |
+
+/***************************************************************************/
+//!	@brief Private Method
+//!	fill_solid_pattern | uint16_t |
+/***************************************************************************/
+//! @param color | uint16_t | color from Display::color
+//! @details
+//!	\n Byte stream. Pack the color SOLID_PATTERN_PIXELS times in the pattern buffer
+/***************************************************************************/
+
+template <class Panel>
+void Display_panel<Panel>::fill_solid_pattern( uint16_t color )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: RGB565. The swapped color is copied as it sits in memory
+    if (Config::COLOR_DEPTH == 16)
+    {
+        //For: each pixel
+        for (uint16_t t = 0;(uint32_t)(t +1) < sizeof(this -> g_solid_pattern);t += 2)
+        {
+            this -> g_solid_pattern[ t +0 ] = (uint8_t)(color & 0xFF);
+            this -> g_solid_pattern[ t +1 ] = (uint8_t)(color >> 8);
+        }
+        return;
+    }
+    //For: each pair of pixels
+    for (uint16_t t = 0;(uint32_t)(t +2) < sizeof(this -> g_solid_pattern);t += 3)
+    {
+        this -> g_solid_pattern[ t +0 ] = (uint8_t)(color >> 4);
+        this -> g_solid_pattern[ t +1 ] = (uint8_t)(((color & 0x0F) << 4) | (color >> 8));
+        this -> g_solid_pattern[ t +2 ] = (uint8_t)(color & 0xFF);
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return;
+}	//End Private Method: fill_solid_pattern | uint16_t |
+
+/***************************************************************************/
+//!	@brief Private Method
+//!	get_row_address_offset | void |
+/***************************************************************************/
+//! @return uint16_t | offset between a column of the screen and the line of the panel memory that holds it
+//! @details
+//!	\n The flip moves the screen to the other side of the panel memory
+//!	\n When the screen is centered in the panel memory the offset is a constant
+/***************************************************************************/
+
+template <class Panel>
+inline uint16_t Display_panel<Panel>::get_row_address_offset( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return ((Config::ROW_ADDRESS_OFFSET != Config::ROW_ADDRESS_OFFSET_FLIP) && (this -> g_f_flip == true))?((uint16_t)Config::ROW_ADDRESS_OFFSET_FLIP):((uint16_t)Config::ROW_ADDRESS_OFFSET);
+}	//End Private Method: get_row_address_offset | void |
+
+/***************************************************************************/
+//!	@brief Private Method
+//!	get_col_address_offset | void |
+/***************************************************************************/
+//! @return uint16_t | offset between a row of the screen and the column of the panel memory that holds it
+//! @details
+//!	\n The flip moves the screen to the other side of the panel memory
+//!	\n When the screen is centered in the panel memory the offset is a constant
+/***************************************************************************/
+
+template <class Panel>
+inline uint16_t Display_panel<Panel>::get_col_address_offset( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return ((Config::COL_ADDRESS_OFFSET != Config::COL_ADDRESS_OFFSET_FLIP) && (this -> g_f_flip == true))?((uint16_t)Config::COL_ADDRESS_OFFSET_FLIP):((uint16_t)Config::COL_ADDRESS_OFFSET);
+}	//End Private Method: get_col_address_offset | void |
+
+/***************************************************************************/
+//!	@brief Private Method
+//!	step_init | void |
+/***************************************************************************/
+//! @return bool | false = READY | true = BUSY
+//! @details
+//!	\n	Execute a step of the bring-up FSM. Called by update_sprite until the display is ready
+//!	\n	1) Hold the reset for RESET_DELAY 2) Wait RESET_DELAY after the reset is released
+//!	\n	3) Send a command of the initialization sequence 4) Send its data. The DMA sends the data run in one transfer
+//!	\n	Every step returns instead of waiting. The CPU is free during the delays and the transfers
+//!	\n	When the sequence is done, the sprites registered during the bring-up are started
+/***************************************************************************/
+
+template <class Panel>
+bool Display_panel<Panel>::step_init( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Switch: bring-up status
+    switch (this -> g_init_status)
+    {
+        //Display is ready
+        case 0:
+        {
+            //Do Nothing
+            break;
+        }
+        //Reset is held
+        case 1:
+        {
+            //If: the reset took effect
+            if (this -> g_init_timer.stop( Longan_nano::Chrono::Unit::microseconds ) >= Config::RESET_DELAY *1000)
+            {
+                //Activate the ST7735 display
+                this -> rst_inactive();
+                this -> g_init_timer.start();
+                this -> g_init_status = 2;
+            }
+            break;
+        }
+        //Display is waking up
+        case 2:
+        {
+            //If: the display is out of reset
+            if (this -> g_init_timer.stop( Longan_nano::Chrono::Unit::microseconds ) >= Config::RESET_DELAY *1000)
+            {
+                //Configure SPI and select display
+                this -> cs_active();
+                this -> spi_set_8bit();
+                this -> g_init_status = 3;
+            }
+            break;
+        }
+        //Command
+        case 3:
+        {
+            //If: the SPI and the DMA are done with the previous data
+            if ((this -> is_spi_idle() == true) && ((Config::USE_DMA == false) || (this -> is_dma_busy() == false)))
+            {
+                //If: the color format is sent
+                if ((this -> g_init_sequence_ptr[ this -> g_init_index ] == Command::TERMINATOR) && (this -> g_init_sequence_ptr == this -> g_color_format_sequence))
+                {
+                    //The initialization sequence of the panel follows
+                    this -> g_init_sequence_ptr = Panel::g_init_sequence;
+                    this -> g_init_index = 0;
+                }
+                //If: the sequence is complete
+                if (this -> g_init_sequence_ptr[ this -> g_init_index ] == Command::TERMINATOR)
+                {
+                    //Keep the DMA ISR from running the sprite FSM while it starts
+                    this -> isr_lock();
+                    this -> g_init_status = 0;
+                    //If: sprites were registered during the bring-up
+                    if (this -> pop_sprite() == false)
+                    {
+                        //Start the FSM
+                        this -> g_sprite_status = 1;
+                        //If: the DMA ISR advances the FSM
+                        if ((Config::USE_ISR == true) && (Config::USE_DMA == true))
+                        {
+                            //Start the first transfer. The ISR takes over from there
+                            this -> chain_sprite();
+                        }
+                    }
+                    this -> isr_unlock();
+                }
+                //If: there is a command to send
+                else
+                {
+                    //Send command
+                    this -> rs_mode_cmd();
+                    spi_i2s_data_transmit( Config::SPI_CH, this -> g_init_sequence_ptr[ this -> g_init_index ] );
+                    this -> g_init_index++;
+                    this -> g_init_status = 4;
+                }
+            }
+            break;
+        }
+        //Data
+        case 4:
+        {
+            if (this -> is_spi_idle() == true)
+            {
+                //Enter data mode
+                this -> rs_mode_data();
+                //Length of the data run of the command
+                uint16_t size = 0;
+                while (this -> g_init_sequence_ptr[ this -> g_init_index +size ] != Command::TERMINATOR)
+                {
+                    size++;
+                }
+                //If: the DMA can send the data run
+                if ((Config::USE_DMA == true) && (size > 0))
+                {
+                    this -> dma_send_map8( &this -> g_init_sequence_ptr[ this -> g_init_index ], size );
+                    //Skip the data run and its terminator
+                    this -> g_init_index += size +1;
+                    this -> g_init_status = 3;
+                }
+                //If: the command has no data
+                else if (size == 0)
+                {
+                    //Skip the terminator
+                    this -> g_init_index++;
+                    this -> g_init_status = 3;
+                }
+                //If: the data run is sent one byte at a time
+                else
+                {
+                    this -> g_init_status = 5;
+                }
+            }
+            break;
+        }
+        //Data without DMA
+        default:
+        {
+            if (this -> is_spi_done_tx() == true)
+            {
+                //If: the data run is done
+                if (this -> g_init_sequence_ptr[ this -> g_init_index ] == Command::TERMINATOR)
+                {
+                    //Skip the terminator
+                    this -> g_init_index++;
+                    this -> g_init_status = 3;
+                }
+                else
+                {
+                    spi_i2s_data_transmit( Config::SPI_CH, this -> g_init_sequence_ptr[ this -> g_init_index ] );
+                    this -> g_init_index++;
+                }
+            }
+        }
+    }	//End Switch: bring-up status
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return (this -> g_init_status != 0);
+}	//End Private Method: step_init | void |
+
+/***************************************************************************/
+//!	@brief Private Method
+//!	step_sprite | void |
+/***************************************************************************/
+//! @return bool | false = IDLE | true = BUSY
+//! @details
+//!	\n	Execute a step of the FSM that interfaces with the physical display
+//!	\n	Called by update_sprite in polled mode and by chain_sprite in ISR mode
+//!	\n	Handle both solid color and color map
+//!	\n	sprite data must already be valid before execution
+//!	\n	When a sprite is done, the next sprite in the queue is loaded and its first step is executed in the same call
+//!	\n	The FSM returns IDLE only when the queue is empty
+/***************************************************************************/
+
+template <class Panel>
+bool Display_panel<Panel>::step_sprite( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+    
+    //If: the FSM is done with a sprite and the SPI is done sending it
+    if ((this -> g_sprite_status == 9) && (this -> is_spi_idle() == true))
+    {
+        //Load the next sprite back to back | Return to IDLE if the queue is empty
+        this -> g_sprite_status = (this -> pop_sprite() == false)?(1):(0);
+    }
+    //If: the FSM is about to send the address in width and the display already has it
+    if ((this -> g_sprite_status == 1) && (this -> g_window_cache.f_valid_w == true) && (this -> g_window_cache.start_w == this -> g_sprite.origin_w +this -> get_row_address_offset()) && (this -> g_window_cache.stop_w == this -> g_sprite.origin_w +this -> get_row_address_offset() +this -> g_sprite.size_w -1))
+    {
+        //Skip to the address in height
+        this -> g_sprite_status = 4;
+        this -> g_skipped_commands++;
+        this -> g_command_bytes -= Config::ADDRESS_COMMAND_BYTES;
+    }
+    //If: the FSM is about to send the address in height and the display already has it
+    if ((this -> g_sprite_status == 4) && (this -> g_window_cache.f_valid_h == true) && (this -> g_window_cache.start_h == this -> g_sprite.origin_h +this -> get_col_address_offset()) && (this -> g_window_cache.stop_h == this -> g_sprite.origin_h +this -> get_col_address_offset() +this -> g_sprite.size_h -1))
+    {
+        //Skip to the write memory
+        this -> g_sprite_status = 7;
+        this -> g_skipped_commands++;
+        this -> g_command_bytes -= Config::ADDRESS_COMMAND_BYTES;
+    }
+    //Switch: FSM status
+    switch (this -> g_sprite_status)
+    {
+        //IDLE
+        case 0:
+        {
+            //Do Nothing
+            
+            break;
+        }
+        //Row address
+        case 1:
+        {
+            if (this -> is_spi_idle() == true)
+            {
+                this -> spi_send_command( Command::SEND_ROW_ADDRESS );
+                //Next state
+                this -> g_sprite_status++;
+            }
+            break;
+        }
+        //Row Address start
+        case 2:
+        {
+            //The display is getting this address in width
+            this -> g_window_cache.f_valid_w = true;
+            this -> g_window_cache.start_w = this -> g_sprite.origin_w +this -> get_row_address_offset();
+            this -> g_window_cache.stop_w = this -> g_sprite.origin_w +this -> get_row_address_offset() +this -> g_sprite.size_w -1;
+            //If: user wants to use the DMA
+            if (Config::USE_DMA == true)
+            {
+                if (this -> is_spi_idle() == true)
+                {
+                    this -> rs_mode_data();
+                    //Load addresses on the address buffer
+                    this -> g_address_buffer[ 0 ] = this -> g_sprite.origin_w +this -> get_row_address_offset();
+                    this -> g_address_buffer[ 1 ] = this -> g_sprite.origin_w +this -> get_row_address_offset() +this -> g_sprite.size_w -1;
+                    //Next state. Skip second SPI transfer. Set before the transfer begins, the DMA ISR may resume the FSM right away
+                    this -> g_sprite_status += 2;
+                    //If: single frame size. The SPI stays in 8b and the addresses are sent big endian one byte at a time
+                    if (Config::SPI_SINGLE_FRAME == true)
+                    {
+                        this -> g_address_buffer[ 0 ] = (uint16_t)((this -> g_address_buffer[ 0 ] << 8) | (this -> g_address_buffer[ 0 ] >> 8));
+                        this -> g_address_buffer[ 1 ] = (uint16_t)((this -> g_address_buffer[ 1 ] << 8) | (this -> g_address_buffer[ 1 ] >> 8));
+                        //Program the DMA to send the address
+                        this -> dma_send_map8( (const uint8_t *)this -> g_address_buffer, 4 );
+                    }
+                    else
+                    {
+                        //Addresses are 16b
+                        this -> spi_set_16bit();
+                        //Program the DMA to send the address
+                        this -> dma_send_map16( this -> g_address_buffer, 2 );
+                    }
+                }
+            }
+            //End If: user doesn't want to use the DMA
+            else
+            {
+                if (this -> is_spi_idle() == true)
+                {
+                    this -> rs_mode_data();
+                    //If: single frame size. The SPI stays in 8b, send the most significant byte of the start address
+                    if (Config::SPI_SINGLE_FRAME == true)
+                    {
+                        spi_i2s_data_transmit( Config::SPI_CH, (uint16_t)(this -> g_sprite.origin_w +this -> get_row_address_offset()) >> 8 );
+                    }
+                    else
+                    {
+                        this -> spi_set_16bit();
+                        spi_i2s_data_transmit( Config::SPI_CH, this -> g_sprite.origin_w +this -> get_row_address_offset() );
+                    }
+                    //Next state 
+                    this -> g_sprite_status++;
+                }
+            }
+            break;
+        }
+        //Row Address stop
+        case 3:
         {
             if (this -> is_spi_done_tx() == true)
             {
-                spi_i2s_data_transmit( Config::SPI_CH, this -> g_sprite.origin_h +Config::COL_ADDRESS_OFFSET +this -> g_sprite.size_h -1 );
+                //If: single frame size. Send the three bytes left of the addresses big endian, one per step
+                if (Config::SPI_SINGLE_FRAME == true)
+                {
+                    uint16_t start = this -> g_sprite.origin_w +this -> get_row_address_offset();
+                    uint16_t stop = this -> g_sprite.origin_w +this -> get_row_address_offset() +this -> g_sprite.size_w -1;
+                    spi_i2s_data_transmit( Config::SPI_CH, (this -> g_sprite_row == 0)?(start & 0xFF):((this -> g_sprite_row == 1)?(stop >> 8):(stop & 0xFF)) );
+                    this -> g_sprite_row++;
+                    //If: the stop address is done
+                    if (this -> g_sprite_row >= 3)
+                    {
+                        this -> g_sprite_row = 0;
+                        //Next state
+                        this -> g_sprite_status++;
+                    }
+                }
+                else
+                {
+                    spi_i2s_data_transmit( Config::SPI_CH, this -> g_sprite.origin_w +this -> get_row_address_offset() +this -> g_sprite.size_w -1 );
+                    //Next state
+                    this -> g_sprite_status++;
+                }
+            }
+            break;
+        }	
+        //Col Address
+        case 4:
+        {
+            if (this -> is_spi_idle() == true)
+            {
+                this -> spi_send_command( Command::SEND_COL_ADDRESS );
                 //Next state
                 this -> g_sprite_status++;
             }
             break;
+        }	
+        //Col Address Start
+        case 5:
+        {
+            //The display is getting this address in height
+            this -> g_window_cache.f_valid_h = true;
+            this -> g_window_cache.start_h = this -> g_sprite.origin_h +this -> get_col_address_offset();
+            this -> g_window_cache.stop_h = this -> g_sprite.origin_h +this -> get_col_address_offset() +this -> g_sprite.size_h -1;
+            //If: user wants to use the DMA
+            if (Config::USE_DMA == true)
+            {
+                if (this -> is_spi_idle() == true)
+                {
+                    this -> rs_mode_data();
+                    //Load addresses on the address buffer
+                    this -> g_address_buffer[ 0 ] = this -> g_sprite.origin_h +this -> get_col_address_offset();
+                    this -> g_address_buffer[ 1 ] = this -> g_sprite.origin_h +this -> get_col_address_offset() +this -> g_sprite.size_h -1;
+                    //Next state. Skip second SPI transfer. Set before the transfer begins, the DMA ISR may resume the FSM right away
+                    this -> g_sprite_status += 2;
+                    //If: single frame size. The SPI stays in 8b and the addresses are sent big endian one byte at a time
+                    if (Config::SPI_SINGLE_FRAME == true)
+                    {
+                        this -> g_address_buffer[ 0 ] = (uint16_t)((this -> g_address_buffer[ 0 ] << 8) | (this -> g_address_buffer[ 0 ] >> 8));
+                        this -> g_address_buffer[ 1 ] = (uint16_t)((this -> g_address_buffer[ 1 ] << 8) | (this -> g_address_buffer[ 1 ] >> 8));
+                        //Program the DMA to send the address
+                        this -> dma_send_map8( (const uint8_t *)this -> g_address_buffer, 4 );
+                    }
+                    else
+                    {
+                        //Addresses are 16b
+                        this -> spi_set_16bit();
+                        //Program the DMA to send the address
+                        this -> dma_send_map16( this -> g_address_buffer, 2 );
+                    }
+                }
+            }
+            //End If: user doesn't want to use the DMA
+            else
+            {
+                if (this -> is_spi_idle() == true)
+                {
+                    this -> rs_mode_data();
+                    //If: single frame size. The SPI stays in 8b, send the most significant byte of the start address
+                    if (Config::SPI_SINGLE_FRAME == true)
+                    {
+                        spi_i2s_data_transmit( Config::SPI_CH, (uint16_t)(this -> g_sprite.origin_h +this -> get_col_address_offset()) >> 8 );
+                    }
+                    else
+                    {
+                        this -> spi_set_16bit();
+                        spi_i2s_data_transmit( Config::SPI_CH, this -> g_sprite.origin_h +this -> get_col_address_offset() );
+                    }
+                    //Next state 
+                    this -> g_sprite_status++;
+                }
+            }
+            break;
+        }
+        //Col Address Stop
+        case 6:
+        {
+            if (this -> is_spi_done_tx() == true)
+            {
+                //If: single frame size. Send the three bytes left of the addresses big endian, one per step
+                if (Config::SPI_SINGLE_FRAME == true)
+                {
+                    uint16_t start = this -> g_sprite.origin_h +this -> get_col_address_offset();
+                    uint16_t stop = this -> g_sprite.origin_h +this -> get_col_address_offset() +this -> g_sprite.size_h -1;
+                    spi_i2s_data_transmit( Config::SPI_CH, (this -> g_sprite_row == 0)?(start & 0xFF):((this -> g_sprite_row == 1)?(stop >> 8):(stop & 0xFF)) );
+                    this -> g_sprite_row++;
+                    //If: the stop address is done
+                    if (this -> g_sprite_row >= 3)
+                    {
+                        this -> g_sprite_row = 0;
+                        //Next state
+                        this -> g_sprite_status++;
+                    }
+                }
+                else
+                {
+                    spi_i2s_data_transmit( Config::SPI_CH, this -> g_sprite.origin_h +this -> get_col_address_offset() +this -> g_sprite.size_h -1 );
+                    //Next state
+                    this -> g_sprite_status++;
+                }
+            }
+            break;
         }
         //Write Memory
         case 7:
         {
             if (this -> is_spi_idle() == true)
             {
-                this -> spi_set_8bit();
-                this -> rs_mode_cmd();
-                spi_i2s_data_transmit( Config::SPI_CH, Command::WRITE_MEM );
+                this -> spi_send_command( Command::WRITE_MEM );
                 //Next state. DMA uses a single state, SPI use one state per pixel
                 this -> g_sprite_status = ((Config::USE_DMA == true)?(8):(10));
             }
@@ -779,36 +3138,96 @@ bool Display::update_sprite( void )
         //DMA Send
         case 8:
         {
-            if (this -> is_spi_idle() == true)
+            //If: first transfer, the SPI is done with the command | next row of a strided map, the DMA is done with the previous row
+            if (((this -> g_sprite_row == 0) && (this -> is_spi_idle() == true)) || ((this -> g_sprite_row > 0) && (this -> is_dma_busy() == false)))
             {
                 this -> rs_mode_data();
-                this -> spi_set_16bit();
-                //If: the sprite uses a color map
-                if (this -> g_sprite.b_solid_color == false)
+                //If: byte stream. Pixels are sent one byte at a time
+                if (Config::PIXEL_BYTE_STREAM == true)
+                {
+                    this -> spi_set_8bit();
+                }
+                else
+                {
+                    this -> spi_set_16bit();
+                }
+                //If: the sprite is a byte stream solid color
+                if ((Config::PIXEL_BYTE_STREAM == true) && (this -> g_sprite.b_solid_color == true))
                 {
-                    //Program the DMA to send the pixel map
-                    this -> dma_send_map16( this -> g_sprite.sprite_ptr, this -> g_sprite.size );
-                }	//End If: the sprite uses a color map
+                    //If: first pattern
+                    if (this -> g_sprite_row == 0)
+                    {
+                        //The previous sprite is done with the pattern buffer
+                        this -> fill_solid_pattern( this -> g_sprite.solid_color );
+                    }
+                    //Pixels left to send
+                    uint32_t pixel_left = this -> g_sprite.size -this -> g_sprite_row *Config::SOLID_PATTERN_PIXELS;
+                    pixel_left = (pixel_left < Config::SOLID_PATTERN_PIXELS)?(pixel_left):((uint32_t)Config::SOLID_PATTERN_PIXELS);
+                    this -> g_sprite_row++;
+                    //STOP after the last pattern. Stay here for the next pattern
+                    this -> g_sprite_status = (this -> g_sprite_row *Config::SOLID_PATTERN_PIXELS >= this -> g_sprite.size)?(9):(8);
+                    //Program the DMA to send the pattern
+                    this -> dma_send_map8( this -> g_solid_pattern, Display_panel::get_transfer_bytes( pixel_left ) );
+                }	//End If: the sprite is a byte stream solid color
+                //If: the sprite is RGB444 pixel map
+                else if (Config::COLOR_DEPTH == 12)
+                {
+                    //STOP
+                    this -> g_sprite_status = 9;
+                    //Program the DMA to send the packed pixel map. The first visible pixel starts on a byte
+                    this -> dma_send_map8( &((const uint8_t *)this -> g_sprite.sprite_ptr)[ this -> g_sprite.offset *3 /2 ], Display_panel::get_transfer_bytes( this -> g_sprite.size ) );
+                }	//End If: the sprite is RGB444 pixel map
                 //If: the sprite is solid color
-                else //if (this -> g_sprite.b_solid_color == true)
+                else if (this -> g_sprite.b_solid_color == true)
                 {
+                    //STOP. Set before the transfer begins, the DMA ISR may resume the FSM right away
+                    this -> g_sprite_status = 9;
                     //Program the DMA to send the same pixel a number of times
-                    this -> dma_send_solid16( &this -> g_sprite.solid_color, this -> g_sprite.size );    
+                    this -> dma_send_solid16( &this -> g_sprite.solid_color, this -> g_sprite.size );
                 }	//End If: the sprite is solid color
-                                
-                //STOP
-                this -> g_sprite_status = 9;
+                //If: the rows of the pixel map are contiguous in the buffer
+                else if (this -> g_sprite.stride == this -> g_sprite.size_w)
+                {
+                    //STOP
+                    this -> g_sprite_status = 9;
+                    //If: RGB565 byte stream. The map holds the pixels big endian
+                    if (Config::PIXEL_BYTE_STREAM == true)
+                    {
+                        this -> dma_send_map8( (const uint8_t *)&this -> g_sprite.sprite_ptr[ this -> g_sprite.offset ], Display_panel::get_transfer_bytes( this -> g_sprite.size ) );
+                    }
+                    else
+                    {
+                        //Program the DMA to send the pixel map
+                        this -> dma_send_map16( &this -> g_sprite.sprite_ptr[ this -> g_sprite.offset ], this -> g_sprite.size );
+                    }
+                }	//End If: the rows of the pixel map are contiguous in the buffer
+                //If: the pixel map is a sub rectangle of the buffer
+                else
+                {
+                    //Row to be sent
+                    const uint16_t *row_ptr = &this -> g_sprite.sprite_ptr[ this -> g_sprite.offset +this -> g_sprite_row *this -> g_sprite.stride ];
+                    this -> g_sprite_row++;
+                    //STOP after the last row. Stay here for the next row
+                    this -> g_sprite_status = (this -> g_sprite_row >= this -> g_sprite.size_h)?(9):(8);
+                    //If: RGB565 byte stream. The map holds the pixels big endian
+                    if (Config::PIXEL_BYTE_STREAM == true)
+                    {
+                        this -> dma_send_map8( (const uint8_t *)row_ptr, Display_panel::get_transfer_bytes( this -> g_sprite.size_w ) );
+                    }
+                    else
+                    {
+                        //Program the DMA to send a row
+                        this -> dma_send_map16( row_ptr, this -> g_sprite.size_w );
+                    }
+                }	//End If: the pixel map is a sub rectangle of the buffer
             }
             break;
         }			
         //STOP
         case 9:
         {
-            if (this -> is_spi_idle() == true)
-            {
-                //Return to IDLE
-                this -> g_sprite_status = 0;
-            }
+            //Wait for the SPI to be done with the last transfer. Next sprite is loaded before the switch
+            
             break;
         }
         //SPI SEND FIRST
@@ -817,10 +3236,19 @@ bool Display::update_sprite( void )
             if (this -> is_spi_idle() == true)
             {
                 this -> rs_mode_data();
-                this -> spi_set_16bit();
-                spi_i2s_data_transmit( Config::SPI_CH, (this -> g_sprite.b_solid_color == false)?(this -> g_sprite.sprite_ptr[this -> g_sprite_status -10]):(this -> g_sprite.solid_color) );
+                //If: byte stream. Pixels are sent one byte at a time
+                if (Config::PIXEL_BYTE_STREAM == true)
+                {
+                    this -> spi_set_8bit();
+                    spi_i2s_data_transmit( Config::SPI_CH, this -> get_sprite_byte( this -> g_sprite_status -10 ) );
+                }
+                else
+                {
+                    this -> spi_set_16bit();
+                    spi_i2s_data_transmit( Config::SPI_CH, this -> get_sprite_pixel( this -> g_sprite_status -10 ) );
+                }
                 //If: all pixels have been transfered
-                if ((this -> g_sprite_status -10) >= (this -> g_sprite.size -1))
+                if ((this -> g_sprite_status -10) >= (((Config::PIXEL_BYTE_STREAM == true)?(Display_panel::get_transfer_bytes( this -> g_sprite.size )):(this -> g_sprite.size)) -1))
                 {
                     //STOP
                     this -> g_sprite_status = 9;
@@ -839,9 +3267,9 @@ bool Display::update_sprite( void )
         { 
             if (this -> is_spi_done_tx() == true)
             {
-                spi_i2s_data_transmit( Config::SPI_CH, (this -> g_sprite.b_solid_color == false)?(this -> g_sprite.sprite_ptr[this -> g_sprite_status -10]):(this -> g_sprite.solid_color) );
+                spi_i2s_data_transmit( Config::SPI_CH, (Config::PIXEL_BYTE_STREAM == true)?(this -> get_sprite_byte( this -> g_sprite_status -10 )):(this -> get_sprite_pixel( this -> g_sprite_status -10 )) );
                 //If: all pixels have been transfered
-                if ((this -> g_sprite_status -10) >= (this -> g_sprite.size -1))
+                if ((this -> g_sprite_status -10) >= (((Config::PIXEL_BYTE_STREAM == true)?(Display_panel::get_transfer_bytes( this -> g_sprite.size )):(this -> g_sprite.size)) -1))
                 {
                     //STOP
                     this -> g_sprite_status = 9;
@@ -861,314 +3289,511 @@ bool Display::update_sprite( void )
     //----------------------------------------------------------------
     
     return (this -> g_sprite_status != 0);
-}	//End public method: update_sprite | void |
+}	//End Private Method: step_sprite | void |
 
 /***************************************************************************/
-//!	@brief public method
-//!	draw_sprite | int | int | int | int | uint16_t * |
+//!	@brief Private Method
+//!	chain_sprite | void |
 /***************************************************************************/
-//! @param origin_h | int | starting top left corner height of the sprite
-//! @param origin_w | int | starting top left corner height of the sprite
-//! @param size_h | int | height size of the sprite
-//! @param size_w | int | width size of the sprite
-//! @param sprite_ptr | uint16_t * | pointer to RGB565 pixel color map
-//! @return int | number of pixels drawn
 //! @details
-//!	\n	Draw a sprite
-//!	\n Blocking method
-//!	\n Draw a color map, requires a user buffer of the proper size
+//!	\n	ISR mode. Execute steps of the FSM until a DMA transfer is started, the FSM waits for the SPI or the FSM is IDLE
+//!	\n	Steps that need the SPI idle don't spin. The receive event of the SPI is armed and the FSM is left where it is
+//!	\n	The DMA transfer complete interrupt or the SPI interrupt calls it again through update_sprite_isr
+/***************************************************************************/
+
+template <class Panel>
+void Display_panel<Panel>::chain_sprite( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //While: the FSM is busy and no DMA transfer will resume it
+    while ((this -> g_sprite_status != 0) && (this -> is_dma_busy() == false))
+    {
+        //If: the step waits for the SPI to be done with the previous frames. Only the next row of a strided map waits for the DMA alone
+        if (((this -> g_sprite_status != 8) || (this -> g_sprite_row == 0)) && (this -> is_spi_idle() == false))
+        {
+            //If: the SPI is still busy with the event armed
+            if (this -> arm_spi_event() == true)
+            {
+                //The SPI interrupt resumes the FSM
+                return;
+            }
+        }
+        //Execute a step of the FSM
+        this -> step_sprite();
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return;
+}	//End Private Method: chain_sprite | void |
+
+/***************************************************************************/
+//!	@brief Private Method
+//!	burst_sprite | void |
+/***************************************************************************/
+//! @details
+//!	\n	USE_DMA false. Execute steps of the FSM until the burst budget is spent or the FSM is IDLE
+//!	\n	A step that finds the SPI busy does nothing and is repeated. The loop sends the next frame as soon as the TX buffer is empty
+//!	\n	Each step that moves the FSM counts as one SPI frame against the budget
 /***************************************************************************/
 
-int Display::draw_sprite( int origin_h, int origin_w, int size_h, int size_w, uint16_t* sprite_ptr )
+template <class Panel>
+void Display_panel<Panel>::burst_sprite( void )
 {
     //----------------------------------------------------------------
     //	VARS
     //----------------------------------------------------------------
-    
-    //temp return
-    bool f_ret;
-    //Number of pixels drawn by the method
-    int pixel_count;
-    
+
+    //SPI frames sent during this burst
+    uint16_t frames = 0;
+    //SysTick the burst must end by
+    uint64_t deadline = get_timer_value() +this -> g_burst_ticks;
+
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    //Register the sprite to be drawn. Authorize the update FSM to draw the sprite through the "update_sprite" non blocking method
-    pixel_count = this -> register_sprite( origin_h, origin_w, size_h, size_w, sprite_ptr );
-    //Allow FSM to run if I have at least one pixel to draw
-    f_ret = (pixel_count > 0);
-    //While: the driver FSM is busy
-    while (f_ret == true)
+    //While: the FSM is busy
+    while (this -> g_sprite_status != 0)
     {
+        //Snap the status
+        uint32_t status = this -> g_sprite_status;
         //Execute a step of the FSM
-        f_ret = this -> update_sprite();
-    }
+        this -> step_sprite();
+        //If: the step sent a frame
+        if (this -> g_sprite_status != status)
+        {
+            frames++;
+        }
+        //If: the frame budget is spent
+        if ((this -> g_burst_frames != 0) && (frames >= this -> g_burst_frames))
+        {
+            break;
+        }
+        //If: the time budget is spent
+        if ((this -> g_burst_ticks != 0) && (get_timer_value() >= deadline))
+        {
+            break;
+        }
+    }	//End While: the FSM is busy
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
 
-    return pixel_count;
-}	//End Public Method: draw_sprite | int | int | int | int | uint16_t * |
+    return;
+}	//End Private Method: burst_sprite | void |
 
 /***************************************************************************/
-//!	@brief public method
-//!	draw_sprite | int | int | int | int | uint16_t |
+//!	@brief Private Method
+//!	step_image | void |
 /***************************************************************************/
-//! @param origin_h | int | starting top left corner height of the sprite
-//! @param origin_w | int | starting top left corner height of the sprite
-//! @param size_h | int | height size of the sprite
-//! @param size_w | int | width size of the sprite
-//! @param sprite_color | uint16_t | RGB565 pixel solid color for the full sprite
-//! @return int | number of pixels drawn
+//! @return bool | false = no image | true = BUSY
 //! @details
-//!	\n Draw a sprite
-//!	\n Blocking method
-//!	\n Draw a solid color sprite and doesn't require a color map
+//!	\n Decode the image until the sprite queue is full, the staging buffer to be filled is still used by the DMA or the image is done
+//!	\n Every pass registers at most one sprite
+//!	\n A run long enough goes out as a solid color sprite. A run at the start of a row covering full rows is a single rectangle
+//!	\n Literals and short runs are expanded in a staging buffer. The strip of a buffer is always a rectangle:
+//!	\n part of a single row, or full rows if it starts at the beginning of a row and the buffer has room for the next row
+//!	\n A strip that holds full rows and is midway through the next row absorbs runs instead of breaking
 /***************************************************************************/
 
-int Display::draw_sprite( int origin_h, int origin_w, int size_h, int size_w, uint16_t sprite_color )
+template <class Panel>
+bool Display_panel<Panel>::step_image( void )
 {
     //----------------------------------------------------------------
     //	VARS
     //----------------------------------------------------------------
-    
-    //temp return
-    bool f_ret;
-    //Number of pixels drawn by the method
-    int pixel_count;
-    
+
+    //Image being decoded
+    Image &image = this -> g_image;
+
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    //Register the sprite to be drawn. Authorize the update FSM to draw the sprite through the "update_sprite" non blocking method
-    pixel_count = this -> register_sprite( origin_h, origin_w, size_h, size_w, sprite_color );
-    //Allow FSM to run if I have at least one pixel to draw
-    f_ret = (pixel_count > 0);
-    //While: the driver FSM is busy
-    while (f_ret == true)
+    //While: the image has pixels to decode and the queue has room for a sprite
+    while ((image.data_ptr != nullptr) && (this -> g_queue_cnt < Config::SPRITE_QUEUE_SIZE))
     {
-        //Execute a step of the FSM
-        f_ret = this -> update_sprite();
-    }
+        //If: every pixel of the image is decoded
+        if (image.cursor_h >= image.size_h)
+        {
+            //Send the last strip and release the stream
+            this -> close_image_strip();
+            image.data_ptr = nullptr;
+            continue;
+        }
+        //If: the token is used up
+        if (image.token_cnt == 0)
+        {
+            //If: run
+            if ((image.data_ptr[0] & Image_token::TOKEN_RUN) != 0)
+            {
+                image.f_run = true;
+                //If: long run
+                if ((image.data_ptr[0] & Image_token::TOKEN_LONG) != 0)
+                {
+                    image.token_cnt = (uint16_t)((((image.data_ptr[0] & Image_token::RUN_MASK) << 8) | image.data_ptr[1]) +1);
+                    image.data_ptr += 2;
+                }
+                else
+                {
+                    image.token_cnt = (uint16_t)((image.data_ptr[0] & Image_token::RUN_MASK) +1);
+                    image.data_ptr += 1;
+                }
+                image.run_color = Display_panel::convert_rgb565( (uint16_t)((image.data_ptr[0] << 8) | image.data_ptr[1]) );
+                image.data_ptr += 2;
+            }
+            //If: literal
+            else
+            {
+                image.f_run = false;
+                image.token_cnt = (uint16_t)((image.data_ptr[0] & Image_token::LITERAL_MASK) +1);
+                image.data_ptr += 1;
+            }
+            continue;
+        }
+        //Pixels left in the row of the image
+        uint16_t row_left = image.size_w -image.cursor_w;
+        //If: run
+        if (image.f_run == true)
+        {
+            //Full rows covered by the run. Only from the start of a row, never past the last row
+            uint16_t rows = (image.cursor_w == 0)?(image.token_cnt /image.size_w):(0);
+            rows = (rows < image.size_h -image.cursor_h)?(rows):(image.size_h -image.cursor_h);
+            //Pixels the solid color sprite would cover
+            uint16_t run_cnt = (rows > 0)?(rows *image.size_w):((image.token_cnt < row_left)?(image.token_cnt):(row_left));
+            //true = the strip holds full rows and is midway through the next one. It can't be broken here
+            bool f_locked = ((image.strip_cnt > 0) && (image.cursor_w != 0) && (image.cursor_h != image.strip_h));
+            //If: the run is long enough to be a solid color sprite
+            if ((run_cnt >= Config::IMAGE_SOLID_RUN) && (f_locked == false))
+            {
+                //If: a strip is open
+                if (image.strip_cnt > 0)
+                {
+                    //Send the strip first. The run is sent on the next pass
+                    this -> close_image_strip();
+                    continue;
+                }
+                //Send the run as a rectangle of solid color
+                this -> register_sprite( image.origin_h +image.cursor_h, image.origin_w +image.cursor_w, (rows > 0)?(rows):(1), (rows > 0)?(image.size_w):(run_cnt), image.run_color );
+                image.token_cnt -= run_cnt;
+                //If: full rows
+                if (rows > 0)
+                {
+                    image.cursor_h += rows;
+                }
+                //If: the run reaches the end of the row
+                else if (run_cnt == row_left)
+                {
+                    image.cursor_w = 0;
+                    image.cursor_h++;
+                }
+                else
+                {
+                    image.cursor_w += run_cnt;
+                }
+                continue;
+            }
+        }	//End If: run
+        //If: no strip is open
+        if (image.strip_cnt == 0)
+        {
+            //If: the DMA is still sending the buffer
+            if (this -> is_sprite_buffer_used( this -> g_image_buffer[ image.buffer_index ] ) == true)
+            {
+                //Try again on the next update
+                break;
+            }
+            //Open a strip on the current pixel
+            image.strip_h = image.cursor_h;
+            image.strip_w = image.cursor_w;
+        }
+        //Pixels expanded in this pass. Up to the end of the token, of the row or of the buffer
+        uint16_t cnt = (image.token_cnt < row_left)?(image.token_cnt):(row_left);
+        cnt = (cnt < Config::IMAGE_BUFFER_PIXELS -image.strip_cnt)?(cnt):(Config::IMAGE_BUFFER_PIXELS -image.strip_cnt);
+        uint16_t *pixel_ptr = &this -> g_image_buffer[ image.buffer_index ][ image.strip_cnt ];
+        //If: run
+        if (image.f_run == true)
+        {
+            //For: each pixel
+            for (uint16_t t = 0;t < cnt;t++)
+            {
+                pixel_ptr[t] = image.run_color;
+            }
+        }
+        //If: literal
+        else
+        {
+            //For: each pixel
+            for (uint16_t t = 0;t < cnt;t++)
+            {
+                pixel_ptr[t] = Display_panel::convert_rgb565( (uint16_t)((image.data_ptr[0] << 8) | image.data_ptr[1]) );
+                image.data_ptr += 2;
+            }
+        }
+        image.strip_cnt += cnt;
+        image.token_cnt -= cnt;
+        image.cursor_w += cnt;
+        //If: end of the row
+        if (image.cursor_w >= image.size_w)
+        {
+            image.cursor_w = 0;
+            image.cursor_h++;
+            //If: the strip can't grow by a full row
+            if ((image.strip_w != 0) || (Config::IMAGE_BUFFER_PIXELS -image.strip_cnt < image.size_w))
+            {
+                this -> close_image_strip();
+            }
+        }
+        //If: the buffer is full
+        else if (image.strip_cnt >= Config::IMAGE_BUFFER_PIXELS)
+        {
+            this -> close_image_strip();
+        }
+    }	//End While: the image has pixels to decode and the queue has room for a sprite
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
 
-    return pixel_count;
-}	//End Public Method: draw_sprite | int | int | int | int | uint16_t |
+    return (image.data_ptr != nullptr);
+}	//End Private Method: step_image | void |
 
 /***************************************************************************/
-//!	@brief public method
-//!	clear | void |
+//!	@brief Private Method
+//!	close_image_strip | void |
 /***************************************************************************/
-//! @return int | number of pixels drawn
 //! @details
-//!	\n Clear the screen. Blocking method.
-//!	\n Draw a black sprite the size of the screen
+//!	\n Register the strip of the staging buffer being filled as a pixel map sprite and move on to the other buffer
+//!	\n The strip is part of a row, or full rows if it starts at the beginning of a row. RGB444: the strip is packed in place
 /***************************************************************************/
 
-inline int Display::clear( void )
+template <class Panel>
+void Display_panel<Panel>::close_image_strip( void )
 {
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Image being decoded
+    Image &image = this -> g_image;
+
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    //blocking draw sprite
-    int pixel_count = this -> draw_sprite( 0, 0, Config::HEIGHT, Config::WIDTH, Display::color( 0, 0, 0 ) );
+    //If: the strip is empty
+    if (image.strip_cnt == 0)
+    {
+        return;
+    }
+    //true = the strip is made of full rows
+    bool f_rows = ((image.strip_w == 0) && (image.strip_cnt >= image.size_w));
+    uint16_t *buffer_ptr = this -> g_image_buffer[ image.buffer_index ];
+    //If: RGB444
+    if (Config::COLOR_DEPTH == 12)
+    {
+        Display_panel::pack_rgb444( buffer_ptr, image.strip_cnt );
+    }
+    this -> register_sprite( image.origin_h +image.strip_h, image.origin_w +image.strip_w, (f_rows == true)?(image.strip_cnt /image.size_w):(1), (f_rows == true)?(image.size_w):(image.strip_cnt), buffer_ptr );
+    //Decode the next strip in the other buffer while the DMA sends this one
+    image.strip_cnt = 0;
+    image.buffer_index ^= 0x01;
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
 
-    return pixel_count;
-}	//End public method: clear | void |
+    return;
+}	//End Private Method: close_image_strip | void |
 
 /***************************************************************************/
-//!	@brief public method
-//!	clear | void |
+//!	@brief Private Method
+//!	convert_rgb565 | uint16_t |
 /***************************************************************************/
-//! @param color | uint16_t | clear the display to a solid color
-//! @return int | number of pixels drawn
+//! @param color | uint16_t | RGB565 color
+//! @return uint16_t | color in the color depth of the display
 //! @details
-//!	\n Clear the screen. Blocking method.
-//!	\n Draw a black sprite the size of the screen
+//!	\n RGB444: keep the four most significant bits of each channel
+//!	\n RGB565 byte stream: swap the bytes like Display::color
 /***************************************************************************/
 
-inline int Display::clear( uint16_t color )
+template <class Panel>
+inline uint16_t Display_panel<Panel>::convert_rgb565( uint16_t color )
 {
-    //----------------------------------------------------------------
-    //	BODY
-    //----------------------------------------------------------------
-
-    int pixel_count = this -> draw_sprite( 0, 0, Config::HEIGHT, Config::WIDTH, color );
-
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
 
-    return pixel_count;
-}	//End public method: clear | void |
-
-    /*********************************************************************************************************************************************************
-    **********************************************************************************************************************************************************
-    **	PRIVATE INIT
-    **********************************************************************************************************************************************************
-    *********************************************************************************************************************************************************/
+    //If: RGB444
+    if (Config::COLOR_DEPTH == 12)
+    {
+        return (uint16_t)(((color >> 4) & 0x0F00) | ((color >> 3) & 0x00F0) | ((color >> 1) & 0x000F));
+    }
+    //If: RGB565 byte stream
+    else if (Config::SPI_SINGLE_FRAME == true)
+    {
+        return (uint16_t)((color << 8) | (color >> 8));
+    }
+    return color;
+}	//End Private Method: convert_rgb565 | uint16_t |
 
 /***************************************************************************/
-//!	@brief Private init
-//!	init_gpio | void |
+//!	@brief Private Method
+//!	push_sprite | Sprite & |
 /***************************************************************************/
-//! @return bool | false = OK | true = ERR
+//! @param sprite | Sprite & | sprite descriptor to be copied in the queue
+//! @return bool | false = OK | true = queue full
 //! @details
-//!	\n HAL method
-//!	\n initialize GPIO configuration
+//!	\n Push a sprite in the sprite queue
+//!	\n If the FSM is IDLE, the sprite is loaded right away and the FSM starts
+//!	\n In ISR mode the first DMA transfer is started here, with the DMA interrupt masked
 /***************************************************************************/
 
-inline bool Display::init_gpio( void )
+template <class Panel>
+bool Display_panel<Panel>::push_sprite( Sprite &sprite )
 {
     //----------------------------------------------------------------
-    //	BODY
-    //----------------------------------------------------------------
-    
-    //Clock the GPIOs
-    rcu_periph_clock_enable( RCU_GPIOA );
-    rcu_periph_clock_enable( RCU_GPIOB );
-    rcu_periph_clock_enable( RCU_AF );
-        
-    //LCD RS command pin
-    gpio_init( Config::RS_GPIO, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, Config::RS_PIN );
-    //LCD RST reset pin
-    gpio_init( Config::RST_GPIO, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, Config::RST_PIN );
-    //LCD CS chip select pin
-    gpio_init( Config::SPI_CS_GPIO, GPIO_MODE_OUT_PP, GPIO_OSPEED_50MHZ, Config::SPI_CS_PIN );
-    //Set the SPI0 pins to Alternate Functions
-    gpio_init( Config::SPI_CLK_GPIO, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, Config::SPI_CLK_PIN );
-    gpio_init( Config::SPI_MISO_GPIO, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, Config::SPI_MISO_PIN );
-    gpio_init( Config::SPI_MOSI_GPIO, GPIO_MODE_AF_PP, GPIO_OSPEED_50MHZ, Config::SPI_MOSI_PIN );
-
-    //----------------------------------------------------------------
-    //	RETURN
+    //	CHECK
     //----------------------------------------------------------------
-    
-    return false; //OK
-}	//End Private init: init_gpio | void |
 
-/***************************************************************************/
-//!	@brief Private init
-//!	init_spi | void |
-/***************************************************************************/
-//! @return bool | false = OK | true = ERR
-//! @details
-//!	\n HAL method
-//!	\n Initialize SPI that communicates with the Display
-/***************************************************************************/
+    //If: queue is full
+    if (this -> g_queue_cnt >= Config::SPRITE_QUEUE_SIZE)
+    {
+        return true; //FAIL
+    }
 
-inline bool Display::init_spi( void )
-{
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    //Clock the SPI
-    rcu_periph_clock_enable( RCU_SPI0 );
-    spi_i2s_deinit( Config::SPI_CH );
-    SPI_CTL0( Config::SPI_CH ) = (uint32_t)(SPI_MASTER | SPI_TRANSMODE_FULLDUPLEX | SPI_FRAMESIZE_8BIT | SPI_NSS_SOFT | SPI_ENDIAN_MSB | SPI_CK_PL_LOW_PH_1EDGE | SPI_PSC_8);
-    //If: DMA is accelerating the SPI
-    if (Config::USE_DMA == true)
+    //The ISR may be popping sprites
+    this -> isr_lock();
+    //Index of the first free slot
+    uint8_t index = this -> g_queue_head +this -> g_queue_cnt;
+    index = (index < Config::SPRITE_QUEUE_SIZE)?(index):(index -Config::SPRITE_QUEUE_SIZE);
+    //Save the sprite
+    this -> g_sprite_queue[ index ] = sprite;
+    this -> g_queue_cnt++;
+    //If: FSM is IDLE and the display is ready. During the bring-up the sprite waits in the queue
+    if ((this -> g_sprite_status == 0) && (this -> g_init_status == 0))
     {
-        SPI_CTL1( Config::SPI_CH ) = (uint32_t)(SPI_CTL1_DMATEN);
+        //Load the sprite and start the FSM
+        this -> pop_sprite();
+        this -> g_sprite_status = 1;
+        //If: the DMA ISR advances the FSM
+        if ((Config::USE_ISR == true) && (Config::USE_DMA == true))
+        {
+            //Start the first transfer. The ISR takes over from there
+            this -> chain_sprite();
+        }
     }
-    spi_enable( Config::SPI_CH );
+    this -> isr_unlock();
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-    
+
     return false; //OK
-}	//End Private init: init_spi | void |
+}	//End Private Method: push_sprite | Sprite & |
 
 /***************************************************************************/
-//!	@brief Private init
-//!	init_dma | void |
+//!	@brief Private Method
+//!	pop_sprite | void |
 /***************************************************************************/
-//! @return bool | false = OK | true = ERR
+//! @return bool | false = OK | true = queue empty
 //! @details
-//!	\n Initialize DMA that accelerates the SPI
+//!	\n Load the oldest sprite in the queue as the sprite being sent by the FSM
 /***************************************************************************/
 
-inline bool Display::init_dma( void )
+template <class Panel>
+inline bool Display_panel<Panel>::pop_sprite( void )
 {
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: queue is empty
+    if (this -> g_queue_cnt == 0)
+    {
+        return true; //FAIL
+    }
+
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
-    
-    //CLock the DMA
-    rcu_periph_clock_enable( RCU_DMA0 );
-    dma_deinit( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH );
-    DMA_CHCTL( Config::DMA_SPI_TX, Config::DMA_SPI_TX_CH ) = (uint32_t)(DMA_PRIORITY_ULTRA_HIGH | DMA_CHXCTL_DIR);
-    DMA_CHPADDR( Config::DMA_SPI_TX, Config::DMA_SPI_TX_CH ) = (uint32_t)&SPI_DATA(Config::SPI_CH);
+
+    //Load the oldest sprite
+    this -> g_sprite = this -> g_sprite_queue[ this -> g_queue_head ];
+    this -> g_sprite_row = 0;
+    //Profile the SPI traffic of the sprite
+    this -> g_command_bytes += Config::SPRITE_COMMAND_BYTES;
+    this -> g_pixel_bytes += Display_panel::get_transfer_bytes( this -> g_sprite.size );
+    //Advance the head
+    this -> g_queue_head = (this -> g_queue_head < Config::SPRITE_QUEUE_SIZE -1)?(this -> g_queue_head +1):(0);
+    this -> g_queue_cnt--;
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-    
+
     return false; //OK
-}	//End Private init: init_dma | void |
+}	//End Private Method: pop_sprite | void |
 
 /***************************************************************************/
-//!	@brief Private init
-//!	init_st7735 | void |
+//!	@brief Private Method
+//!	send_command | uint8_t | const uint8_t * | uint8_t |
 /***************************************************************************/
-//! @return bool | false = OK | true = ERR
+//! @param command | uint8_t | command byte
+//! @param data_ptr | const uint8_t * | parameters of the command
+//! @param data_size | uint8_t | number of parameters
 //! @details
-//!	\n Send initialization sequence to the ST7735 display controller
-//!	\n First byte in the sequence is command
-//!	\n Next bytes in the sequence are terminators
-//!	\n If the command is a terminator, it means the initialization sequence is complete
+//!	\n Send a command and its parameters. Blocking method.
+//!	\n Wait for the FSM to send the sprites already in the queue, the command must not split the pixel data of a sprite
+//!	\n The FSM selects the SPI frame size and the RS line of each transfer, it can resume right after
 /***************************************************************************/
 
-bool Display::init_st7735( void )
+template <class Panel>
+void Display_panel<Panel>::send_command( uint8_t command, const uint8_t *data_ptr, uint8_t data_size )
 {
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
-    
-    //Configure SPI and select display
-    this -> cs_active();
+
+    //While: the driver FSM is busy
+    while (this -> update_sprite() == true)
+    {
+        //Wait
+    }
+    //Commands are 8b
+    this -> spi_wait_idle();
     this -> spi_set_8bit();
-    //For: each command sequence
-    for (const uint8_t *str_p = this -> g_st7735s_init_sequence; *str_p != Command::TERMINATOR; str_p++)
-    {
-        //Wait SPI
-        this -> spi_wait_idle();
-        //Send command
-        this -> rs_mode_cmd();
-        spi_i2s_data_transmit(Config::SPI_CH, *str_p++);
-        //Wait SPI
-        this -> spi_wait_idle();
-        //Enter data mode
-        this -> rs_mode_data();
-        //While: I'm not done sendinga data
-        while(*str_p != Command::TERMINATOR)
-        {
-            //Wait SPI
-            this -> spi_wait_tbe();
-            //Send DATA
-            spi_i2s_data_transmit(Config::SPI_CH, *str_p++);
-        }
-    }	//End For: each command sequence
+    //Send command
+    this -> rs_mode_cmd();
+    spi_i2s_data_transmit( Config::SPI_CH, command );
+    this -> spi_wait_idle();
+    //Send parameters
+    this -> rs_mode_data();
+    //For: each parameter
+    for (uint8_t t = 0;t < data_size;t++)
+    {
+        this -> spi_wait_tbe();
+        spi_i2s_data_transmit( Config::SPI_CH, data_ptr[t] );
+    }
+    this -> spi_wait_idle();
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-    
-    return false; //OK
-}	//End Private init: init_st7735 | void |
+
+    return;
+}	//End Private Method: send_command | uint8_t | const uint8_t * | uint8_t |
 
     /*********************************************************************************************************************************************************
     **********************************************************************************************************************************************************
@@ -1185,7 +3810,8 @@ bool Display::init_st7735( void )
 //!	\n return true when the SPI is IDLE
 /***************************************************************************/
 
-inline bool Display::is_spi_idle( void )
+template <class Panel>
+inline bool Display_panel<Panel>::is_spi_idle( void )
 {
     //----------------------------------------------------------------
     //	RETURN
@@ -1202,7 +3828,8 @@ inline bool Display::is_spi_idle( void )
 //!	\n Block execution until SPI is IDLE
 /***************************************************************************/
 
-inline void Display::spi_wait_idle( void )
+template <class Panel>
+inline void Display_panel<Panel>::spi_wait_idle( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1221,6 +3848,43 @@ inline void Display::spi_wait_idle( void )
     return;
 }	//End Private HAL Method: is_spi_idle | void
 
+/***************************************************************************/
+//!	@brief Private HAL Method
+//!	arm_spi_event | void
+/***************************************************************************/
+//! @return bool | false = the SPI is idle, nothing armed | true = the SPI interrupt fires when the SPI is done with a frame
+//! @details
+//!	\n ISR mode. In full duplex the SPI receives a frame for each frame it sends. RBNE rises when the frame is out
+//!	\n Reading the data register drops the frames received so far. The next RBNE is the end of the frame being shifted
+//!	\n The SPI may go idle between the status check of the caller and the read. RBNE would never rise again, so the status is checked again
+//!	\n The status read after the data read also clears the overrun error of the frames nobody read
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::arm_spi_event( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Drop the frames received so far
+    (void)spi_i2s_data_receive( Config::SPI_CH );
+    spi_i2s_interrupt_enable( Config::SPI_CH, SPI_I2S_INT_RBNE );
+    //If: the last frame went out before the read
+    if (this -> is_spi_idle() == true)
+    {
+        //Nothing to wait for
+        spi_i2s_interrupt_disable( Config::SPI_CH, SPI_I2S_INT_RBNE );
+        return false;
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return true;
+}	//End Private HAL Method: arm_spi_event | void
+
 /***************************************************************************/
 //!	@brief Private HAL Method
 //!	is_spi_done_tx | void
@@ -1230,7 +3894,8 @@ inline void Display::spi_wait_idle( void )
 //!	\n return true when the SPI is done TX
 /***************************************************************************/
 
-inline bool Display::is_spi_done_tx( void )
+template <class Panel>
+inline bool Display_panel<Panel>::is_spi_done_tx( void )
 {
     //----------------------------------------------------------------
     //	RETURN
@@ -1247,7 +3912,8 @@ inline bool Display::is_spi_done_tx( void )
 //!	\n Block execution until SPI is done TX
 /***************************************************************************/
 
-inline void Display::spi_wait_tbe( void )
+template <class Panel>
+inline void Display_panel<Panel>::spi_wait_tbe( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1273,7 +3939,8 @@ inline void Display::spi_wait_tbe( void )
 //!	\n Select the ST7735 Display
 /***************************************************************************/
 
-inline void Display::cs_active( void )
+template <class Panel>
+inline void Display_panel<Panel>::cs_active( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1296,7 +3963,8 @@ inline void Display::cs_active( void )
 //!	\n Deselect the ST7735 Display
 /***************************************************************************/
 
-inline void Display::cs_inactive( void )
+template <class Panel>
+inline void Display_panel<Panel>::cs_inactive( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1319,7 +3987,8 @@ inline void Display::cs_inactive( void )
 //!	\n Send a command to the display
 /***************************************************************************/
 
-inline void Display::rs_mode_cmd( void )
+template <class Panel>
+inline void Display_panel<Panel>::rs_mode_cmd( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1342,7 +4011,8 @@ inline void Display::rs_mode_cmd( void )
 //!	\n Send data to the display
 /***************************************************************************/
 
-inline void Display::rs_mode_data( void )
+template <class Panel>
+inline void Display_panel<Panel>::rs_mode_data( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1366,7 +4036,8 @@ inline void Display::rs_mode_data( void )
 //!	\n The display will need time to become ready after an assert
 /***************************************************************************/
 
-inline void Display::rst_active( void )
+template <class Panel>
+inline void Display_panel<Panel>::rst_active( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1389,7 +4060,8 @@ inline void Display::rst_active( void )
 //!	\n Deassert the reset pin of the physical display
 /***************************************************************************/
 
-inline void Display::rst_inactive( void )
+template <class Panel>
+inline void Display_panel<Panel>::rst_inactive( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1412,7 +4084,8 @@ inline void Display::rst_inactive( void )
 //!	\n Configure the SPI to 8b
 /***************************************************************************/		
 
-inline void Display::spi_set_8bit( void )
+template <class Panel>
+inline void Display_panel<Panel>::spi_set_8bit( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1440,7 +4113,8 @@ inline void Display::spi_set_8bit( void )
 //!	\n Configure the SPI to 16b
 /***************************************************************************/
 
-inline void Display::spi_set_16bit( void )
+template <class Panel>
+inline void Display_panel<Panel>::spi_set_16bit( void )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1462,16 +4136,45 @@ inline void Display::spi_set_16bit( void )
 
 /***************************************************************************/
 //!	@brief Private HAL Method
-//!	dma_send_map16 | uint16_t * | uint16_t |
+//!	spi_send_command | uint8_t |
 /***************************************************************************/
-//! @param data_ptr | uint16_t * | pointer to RGB565 pixel color map
+//! @param command | uint8_t | command of the panel controller
+//! @details
+//!	\n Send a command byte with the RS line in command mode. The SPI must be idle
+//!	\n The SPI is configured to 8b. With SPI_SINGLE_FRAME it already is
+/***************************************************************************/
+
+template <class Panel>
+inline void Display_panel<Panel>::spi_send_command( uint8_t command )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    this -> spi_set_8bit();
+    this -> rs_mode_cmd();
+    spi_i2s_data_transmit( Config::SPI_CH, command );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return;
+}	//End Private HAL Method: spi_send_command | uint8_t |
+
+/***************************************************************************/
+//!	@brief Private HAL Method
+//!	dma_send_map16 | const uint16_t * | uint16_t |
+/***************************************************************************/
+//! @param data_ptr | const uint16_t * | pointer to RGB565 pixel color map
 //! @param data_size | uint16_t | size of the pixel color map in pixels
 //! @return void
 //! @details
 //!	\n Use the DMA to send a 16b memory through the SPI
 /***************************************************************************/		
 
-inline void Display::dma_send_map16( uint16_t *data_ptr, uint16_t data_size )
+template <class Panel>
+inline void Display_panel<Panel>::dma_send_map16( const uint16_t *data_ptr, uint16_t data_size )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1480,7 +4183,7 @@ inline void Display::dma_send_map16( uint16_t *data_ptr, uint16_t data_size )
     dma_channel_disable( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH );
     dma_memory_width_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, DMA_MEMORY_WIDTH_16BIT );
     dma_periph_width_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, DMA_PERIPHERAL_WIDTH_16BIT );
-    dma_memory_address_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, (uint32_t)(data_ptr) );
+    dma_memory_address_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, (uintptr_t)(data_ptr) );
     dma_memory_increase_enable( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH );
     dma_transfer_number_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, data_size );
     //Begin the DMA transfer
@@ -1491,8 +4194,41 @@ inline void Display::dma_send_map16( uint16_t *data_ptr, uint16_t data_size )
     //----------------------------------------------------------------
     
     return;
-}	//End Private HAL Method: dma_send_map16 | uint16_t * | uint16_t |
+}	//End Private HAL Method: dma_send_map16 | const uint16_t * | uint16_t |
+
+/***************************************************************************/
+//!	@brief Private HAL Method
+//!	dma_send_map8 | const uint8_t * | uint16_t |
+/***************************************************************************/
+//! @param data_ptr | const uint8_t * | pointer to bytes. Packed RGB444 pixels, RGB565 byte stream or addresses
+//! @param data_size | uint16_t | size in bytes
+//! @return void
+//! @details
+//!	\n Use the DMA to send a 8b memory through the SPI
+/***************************************************************************/		
 
+template <class Panel>
+inline void Display_panel<Panel>::dma_send_map8( const uint8_t *data_ptr, uint16_t data_size )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+    
+    dma_channel_disable( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH );
+    dma_memory_width_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, DMA_MEMORY_WIDTH_8BIT );
+    dma_periph_width_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, DMA_PERIPHERAL_WIDTH_8BIT );
+    dma_memory_address_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, (uintptr_t)(data_ptr) );
+    dma_memory_increase_enable( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH );
+    dma_transfer_number_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, data_size );
+    //Begin the DMA transfer
+    dma_channel_enable( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH );
+    
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return;
+}	//End Private HAL Method: dma_send_map8 | const uint8_t * | uint16_t |
 
 /***************************************************************************/
 //!	@brief Private HAL Method
@@ -1505,7 +4241,8 @@ inline void Display::dma_send_map16( uint16_t *data_ptr, uint16_t data_size )
 //!	\n Use the DMA to send a 16b data through the SPI a number of times
 /***************************************************************************/		
 
-inline void Display::dma_send_solid16( uint16_t* data_ptr, uint16_t data_size )
+template <class Panel>
+inline void Display_panel<Panel>::dma_send_solid16( uint16_t* data_ptr, uint16_t data_size )
 {
     //----------------------------------------------------------------
     //	BODY
@@ -1514,7 +4251,7 @@ inline void Display::dma_send_solid16( uint16_t* data_ptr, uint16_t data_size )
     dma_channel_disable( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH );
     dma_memory_width_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, DMA_MEMORY_WIDTH_16BIT );
     dma_periph_width_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, DMA_PERIPHERAL_WIDTH_16BIT );
-    dma_memory_address_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, (uint32_t)(data_ptr) );
+    dma_memory_address_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, (uintptr_t)(data_ptr) );
     dma_memory_increase_disable( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH );
     dma_transfer_number_config( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH, data_size );
     //Begin the DMA transfer
@@ -1527,6 +4264,85 @@ inline void Display::dma_send_solid16( uint16_t* data_ptr, uint16_t data_size )
     return;
 }	//End Private HAL Method: dma_send_map16 | uint16_t * | uint16_t |
 
+/***************************************************************************/
+//!	@brief Private HAL Method
+//!	is_dma_busy | void |
+/***************************************************************************/
+//! @return bool | false = IDLE | true = BUSY
+//! @details
+//!	\n return true while the DMA channel is enabled and has data left to move to the SPI
+/***************************************************************************/
+
+template <class Panel>
+inline bool Display_panel<Panel>::is_dma_busy( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return (((DMA_CHCTL( Config::DMA_SPI_TX, Config::DMA_SPI_TX_CH ) & DMA_CHXCTL_CHEN) != 0) && (dma_transfer_number_get( Config::DMA_SPI_TX, (dma_channel_enum)Config::DMA_SPI_TX_CH ) != 0));
+}	//End Private HAL Method: is_dma_busy | void |
+
+/***************************************************************************/
+//!	@brief Private HAL Method
+//!	isr_lock | void |
+/***************************************************************************/
+//! @details
+//!	\n Mask the DMA and the SPI interrupts. The main loop can change the sprite queue and start the FSM
+//!	\n Does nothing in polled mode
+/***************************************************************************/
+
+template <class Panel>
+inline void Display_panel<Panel>::isr_lock( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+    
+    //If: the DMA ISR advances the FSM
+    if ((Config::USE_ISR == true) && (Config::USE_DMA == true))
+    {
+        eclic_irq_disable( Config::DMA_SPI_TX_IRQ );
+        eclic_irq_disable( Config::SPI_IRQ );
+    }
+    
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return;
+}	//End Private HAL Method: isr_lock | void |
+
+/***************************************************************************/
+//!	@brief Private HAL Method
+//!	isr_unlock | void |
+/***************************************************************************/
+//! @details
+//!	\n Unmask the DMA and the SPI interrupts. A transfer completed or a frame received while masked is served right away
+//!	\n Does nothing in polled mode
+/***************************************************************************/
+
+template <class Panel>
+inline void Display_panel<Panel>::isr_unlock( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+    
+    //If: the DMA ISR advances the FSM
+    if ((Config::USE_ISR == true) && (Config::USE_DMA == true))
+    {
+        eclic_irq_enable( Config::DMA_SPI_TX_IRQ, Config::DMA_SPI_TX_IRQ_LEVEL, Config::DMA_SPI_TX_IRQ_PRIORITY );
+        eclic_irq_enable( Config::SPI_IRQ, Config::SPI_IRQ_LEVEL, Config::SPI_IRQ_PRIORITY );
+    }
+    
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    return;
+}	//End Private HAL Method: isr_unlock | void |
+
 /**********************************************************************************
 **	NAMESPACE
 **********************************************************************************/
@@ -0,0 +1,325 @@
+/**********************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Orso Eric
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************/
+
+/**********************************************************************************
+**	ENVIROMENT VARIABILE
+**********************************************************************************/
+
+#ifndef GLYPH_EXPANDER_
+    #define GLYPH_EXPANDER_
+
+/**********************************************************************************
+**	GLOBAL INCLUDES
+**********************************************************************************/
+
+#include <stdint.h>
+
+/**********************************************************************************
+**	DEFINES
+**********************************************************************************/
+
+//Two pixels are stored as one 32b word. The first pixel of the pair must be the low half of the word
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+    #error "Glyph_expander stores pixel pairs in little endian order"
+#endif
+
+/**********************************************************************************
+**	MACROS
+**********************************************************************************/
+
+/**********************************************************************************
+**	NAMESPACE
+**********************************************************************************/
+
+//! @namespace User utilities
+namespace User
+{
+
+/**********************************************************************************
+**	TYPEDEFS
+**********************************************************************************/
+
+/**********************************************************************************
+**	PROTOTYPE: STRUCTURES
+**********************************************************************************/
+
+/**********************************************************************************
+**	PROTOTYPE: GLOBAL VARIABILES
+**********************************************************************************/
+
+/**********************************************************************************
+**	PROTOTYPE: CLASS
+**********************************************************************************/
+
+/************************************************************************************/
+//! @class 		Glyph_expander
+/************************************************************************************/
+//!	@author		Orso Eric
+//! @version	2020-09-05
+//! @brief		Expand binary glyph slices into RGB565 pixels, four bits at a time
+//! @bug		None
+//! @warning	Pixel pointers must be 32b aligned
+//! @copyright	BSD 3-Clause License Copyright (c) 2020, Orso Eric
+//! @details
+//!	\n      2020-09-05
+//!	\n A glyph slice holds one bit per pixel, LSB first. false = background | true = foreground
+//!	\n Testing one bit, picking a color and storing one pixel at a time costs a branch and a 16b store per pixel
+//!	\n A table of the sixteen nibbles holds the four pixels of each nibble as two 32b words
+//!	\n A nibble is one lookup and two 32b stores. A 10 pixel slice ends with a two bit tail that uses the first word of the entry
+//!	\n The table is rebuilt only when the background/foreground pair changes
+/************************************************************************************/
+
+class Glyph_expander
+{
+    //Visible to all
+    public:
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PUBLIC ENUM
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //! @brief Configurations for the Glyph_expander class
+        typedef enum _Config
+        {
+            //Bits looked up at once
+            NIBBLE_BITS = 4,
+            //Entries of the table
+            TABLE_SIZE = 1 << NIBBLE_BITS,
+            //Widest slice
+            MAX_SLICE_BITS = 32,
+        } Config;
+
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	CONSTRUCTORS
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        /***************************************************************************/
+        //!	@brief Constructor
+        //!	Glyph_expander | void
+        /***************************************************************************/
+        //! @return no return
+        //!	@details
+        //! Build the table for black background and white foreground
+        /***************************************************************************/
+
+        Glyph_expander( void )
+        {
+            this -> build_table( 0x0000, 0xFFFF );
+            return;
+        }	//end constructor: Glyph_expander | void
+
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PUBLIC METHOD
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        /***************************************************************************/
+        //!	@brief public method
+        //!	set_colors | uint16_t | uint16_t |
+        /***************************************************************************/
+        //! @param background | uint16_t | RGB565 color of the false bits
+        //! @param foreground | uint16_t | RGB565 color of the true bits
+        //! @return no return
+        //!	@details
+        //! \n Select the colors of the next expansions. The table is rebuilt only if the pair changed
+        /***************************************************************************/
+
+        inline void set_colors( uint16_t background, uint16_t foreground )
+        {
+            //If: the table already holds the pair
+            if ((background == this -> g_background_color) && (foreground == this -> g_foreground_color))
+            {
+                return;
+            }
+            this -> build_table( background, foreground );
+            return;
+        }   //End public method: set_colors | uint16_t | uint16_t |
+
+        /***************************************************************************/
+        //!	@brief public method
+        //!	expand | uint32_t | uint16_t * | uint8_t |
+        /***************************************************************************/
+        //! @param slice | uint32_t | binary slice, LSB is the first pixel
+        //! @param pixel_ptr | uint16_t * | first pixel. Must be 32b aligned
+        //! @param count | uint8_t | pixels to write. Up to MAX_SLICE_BITS
+        //! @return no return
+        //!	@details
+        //! \n Write count RGB565 pixels with the colors of set_colors
+        //! \n Nibbles are written as two pixel pairs. Two leftover bits are one pair, a last odd bit is one pixel
+        /***************************************************************************/
+
+        inline void expand( uint32_t slice, uint16_t *pixel_ptr, uint8_t count ) const
+        {
+            //----------------------------------------------------------------
+            //	VARS
+            //----------------------------------------------------------------
+
+            Pixel_pair *pair_ptr = (Pixel_pair *)pixel_ptr;
+
+            //----------------------------------------------------------------
+            //	BODY
+            //----------------------------------------------------------------
+
+            //For: each nibble
+            while (count >= Config::NIBBLE_BITS)
+            {
+                const uint32_t *entry_ptr = this -> g_table[ slice & (Config::TABLE_SIZE -1) ];
+                pair_ptr[0] = entry_ptr[0];
+                pair_ptr[1] = entry_ptr[1];
+                pair_ptr += 2;
+                slice = slice >> Config::NIBBLE_BITS;
+                count -= Config::NIBBLE_BITS;
+            }
+            //If: two bits left. The first word of an entry depends only on the two low bits
+            if (count >= 2)
+            {
+                pair_ptr[0] = this -> g_table[ slice & 0x03 ][0];
+                pair_ptr++;
+                slice = slice >> 2;
+                count -= 2;
+            }
+            //If: one bit left
+            if (count == 1)
+            {
+                *((uint16_t *)pair_ptr) = (uint16_t)this -> g_table[ slice & 0x01 ][0];
+            }
+
+            //----------------------------------------------------------------
+            //	RETURN
+            //----------------------------------------------------------------
+
+            return;
+        }   //End public method: expand | uint32_t | uint16_t * | uint8_t |
+
+        /***************************************************************************/
+        //!	@brief public static method
+        //!	fill | uint16_t | uint16_t * | uint8_t |
+        /***************************************************************************/
+        //! @param color | uint16_t | RGB565 color
+        //! @param pixel_ptr | uint16_t * | first pixel. Must be 32b aligned
+        //! @param count | uint8_t | pixels to write
+        //! @return no return
+        //!	@details
+        //! \n Write count pixels of a solid color as pixel pairs
+        /***************************************************************************/
+
+        static inline void fill( uint16_t color, uint16_t *pixel_ptr, uint8_t count )
+        {
+            Pixel_pair *pair_ptr = (Pixel_pair *)pixel_ptr;
+            uint32_t pair = ((uint32_t)color << 16) | color;
+            //For: each pixel pair
+            for (uint8_t t = 0;t < count /2;t++)
+            {
+                pair_ptr[t] = pair;
+            }
+            //If: odd count
+            if ((count & 0x01) != 0)
+            {
+                pixel_ptr[ count -1 ] = color;
+            }
+            return;
+        }   //End public static method: fill | uint16_t | uint16_t * | uint8_t |
+
+    //Visible only inside the class
+    private:
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PRIVATE TYPEDEFS
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //! @brief Two RGB565 pixels. May alias the uint16_t pixel buffer
+        typedef uint32_t __attribute__((__may_alias__)) Pixel_pair;
+
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PRIVATE METHODS
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        /***************************************************************************/
+        //!	@brief private method
+        //!	build_table | uint16_t | uint16_t |
+        /***************************************************************************/
+        //! @param background | uint16_t | RGB565 color of the false bits
+        //! @param foreground | uint16_t | RGB565 color of the true bits
+        //! @return no return
+        //!	@details
+        //! \n Entry n holds the pixels of bits 0,1 of n in word 0 and of bits 2,3 of n in word 1. The first pixel is the low half
+        /***************************************************************************/
+
+        void build_table( uint16_t background, uint16_t foreground )
+        {
+            //Pixels of the four pairs of bits
+            uint32_t pair[4];
+            pair[0] = ((uint32_t)background << 16) | background;
+            pair[1] = ((uint32_t)background << 16) | foreground;
+            pair[2] = ((uint32_t)foreground << 16) | background;
+            pair[3] = ((uint32_t)foreground << 16) | foreground;
+            //For: each nibble
+            for (uint8_t t = 0;t < Config::TABLE_SIZE;t++)
+            {
+                this -> g_table[t][0] = pair[ t & 0x03 ];
+                this -> g_table[t][1] = pair[ t >> 2 ];
+            }
+            this -> g_background_color = background;
+            this -> g_foreground_color = foreground;
+            return;
+        }   //End private method: build_table | uint16_t | uint16_t |
+
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PRIVATE VARS
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //! @brief Pixel pairs of each nibble
+        uint32_t g_table[ Config::TABLE_SIZE ][2];
+        //! @brief Colors the table was built with
+        uint16_t g_background_color;
+        uint16_t g_foreground_color;
+
+};	//End Class: Glyph_expander
+
+/**********************************************************************************
+**	NAMESPACE
+**********************************************************************************/
+
+} //End Namespace: User
+
+#else
+    #warning "Multiple inclusion of hader file GLYPH_EXPANDER_"
+#endif
@@ -45,6 +45,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ST7735S_W160_H80_C16.hpp"
 //Number -> string
 #include "embedded_string.hpp"
+//Glyph slice -> RGB565 pixels
+#include "glyph_expander.hpp"
 
 /**********************************************************************************
 **	DEBUG
@@ -95,10 +97,6 @@ namespace Longan_nano
 **	TYPEDEFS
 **********************************************************************************/
 
-//Font size 10 has 8x20 sprites on screen
-//Font size 16 has 5x20 sprites on screen
-#define FONT_HEIGHT 10
-
 /**********************************************************************************
 **	PROTOTYPE: STRUCTURES
 **********************************************************************************/
@@ -135,7 +133,7 @@ namespace Longan_nano
 **********************************************************************************/
 
 /*********************************************************************************/
-//! @class 		Screen
+//! @class 		Screen_panel
 /*********************************************************************************/
 //!	@author		Orso Eric
 //! @version	2020-08-08
@@ -213,9 +211,32 @@ namespace Longan_nano
 //! \n  now a register_sprite method combine the processing of color data and registering of sprites
 //! \n  this reduces workload and solves the bug. Now Screen::register_sprite and Display::register_sprite nicely handle the hierarchy
 //! \n  just like Screen::update and Display::update
+//! \n      2020-08-10
+//! \n  The Display driver has a sprite queue. update registers sprites until the queue is full instead of waiting for the driver to send each sprite
+//! \n  update executes one step of the driver FSM per call. Sprites are sent back to back
+//! \n  Solid sprites don't use the pixel buffer and can be queued freely. A pixel map waits until the driver is done with the pixel buffer
+//! \n  Flush planner. Adjacent sprites to be updated are merged in a single address window, in width or in height
+//! \n  Merge or split is decided by comparing the bytes of an address sequence against the pixel bytes of the bridged sprites
+//! \n  update_sprite_isr is exposed. With the Display driver in ISR mode, update only scans the frame buffer and the DMA ISR sends the sprites
+//! \n  Pixel buffers in rotation. A pixel map is rendered in the next buffer while the driver sends the previous ones. PIXEL_BUFFER_COUNT sets the depth
+//! \n  Hardware scroll. scroll rotates a band of sprite columns inside the display memory and only the exposed columns are drawn
+//! \n  The frame buffer keeps the content as seen on screen. Windows are registered at the memory column that shows them
+//! \n  init doesn't block. The driver brings up the display inside update and the first frame is a single black sprite
+//! \n  Template over the panel traits of the Display driver. The frame buffer size is derived from the panel. Screen is the longan nano panel
+//! \n  set_rotation. Portrait swaps the frame buffer geometry and renders sprites turned a quarter from glyphs stored by column at compile time. Flipped rotations reprogram MADCTL
+//! \n  Tile. A string rendered with its colors by the compiler and stored in flash. register_tile points the DMA at it and the sprites under it become transparent
+//! \n  clear sends the whole screen as a single solid color window when the sprites one by one would cost more bytes. The frame buffer is left up to date
+//! \n  Whole screen effects. set_invert, set_blank, set_idle and set_blink use the commands of the panel. An alert flash costs a command instead of a redraw
+//! \n  Dirty bitmap. One bit per sprite in a word per row plus a summary word of the rows. update jumps to the next sprite to be updated with count trailing zeros instead of walking the frame buffer. get_pending is a popcount
+//! \n  Dirty FIFO. update sends the sprite that has been waiting the longest first. A sprite marked again keeps its place. set_flush_order brings back the raster order
+//! \n  Glyph cache. The last GLYPH_CACHE_SIZE characters expanded with their colors are kept. A single character window is sent straight from the cache
+//! \n  Bugfix: set_palette_color didn't redraw the sprites that use the color
+//! \n  Glyph expander. Glyph slices are expanded four bits at a time from a table of pixel pairs built for the background/foreground pair. 32b stores. Solid sprites are filled by pixel pairs
+//! \n  Font registry. Courier New 8x10, NSimSun 8x16 and a 6x8 font replace the FONT_HEIGHT macro. init and set_font select the font, the sprites and the frame buffer take its size. The frame buffer is sized for the smallest glyph. Glyphs are expanded by a loop specialized for the size of the font
 /*********************************************************************************/
 
-class Screen : Longan_nano::Display
+template <class Panel>
+class Screen_panel : Longan_nano::Display_panel<Panel>
 {
     //Visible to all
     public:
@@ -225,15 +246,48 @@ class Screen : Longan_nano::Display
         **********************************************************************************************************************************************************
         *********************************************************************************************************************************************************/
 
+        //! @brief Display driver of the panel
+        typedef Longan_nano::Display_panel<Panel> Display;
+
+        //! @brief Font registry. A sprite is a glyph of the font in use. init and set_font select the font
+        //! A font is a glyph table by row, its columns for portrait, an entry of g_font_metrics and a case of render_glyph
+        typedef enum _Font
+        {
+            COURIER_8X10,	//Courier New 8. 8x20 sprites in landscape
+            NSIMSUN_8X16,	//NSimSun 11. 5x20 sprites in landscape. Refused unless NSIMSUN_8X16_ENABLE is set to true in Config, off by default
+            FIXED_6X8,		//5x7 glyphs in a 6x8 cell. 10x26 sprites in landscape. Dense diagnostic pages. FIXED_6X8_ENABLE
+            NUM_FONTS,
+        } Font;
+
         //! @brief Configuration parameters for the logical screen
         typedef enum _Config
         {
             PEDANTIC_CHECKS			= true,			//Pedantic check meant for debug
             //Screen Logical Configuration. The screen is divided in sprites, shrinking the frame buffer
-            SPRITE_WIDTH			= 8,			//Width of a sprite
-            SPRITE_HEIGHT			= FONT_HEIGHT,  //Height of a sprite
-            SPRITE_PIXEL_COUNT		= SPRITE_HEIGHT *SPRITE_WIDTH,	//Number of pixels in a sprite
-            SPRITE_SCAN_LIMIT		= 5,			//Scan at most # idle sprites before releasing control from update() anyway
+            FONT_DEFAULT			= Font::COURIER_8X10,	//Font after init
+            //Font registry. Size of the glyphs of each font
+            COURIER_8X10_WIDTH		= 8,
+            COURIER_8X10_HEIGHT		= 10,
+            NSIMSUN_8X16_WIDTH		= 8,
+            NSIMSUN_8X16_HEIGHT		= 16,
+            FIXED_6X8_WIDTH			= 6,
+            FIXED_6X8_HEIGHT		= 8,
+            //Dirty bitmap
+            DIRTY_WORD_BITS			= 32,			//Sprites of a row held by a word of the dirty bitmap. Rows held by the summary word
+            //The 6x8 font is available if its frame buffer fits the dirty bitmap in both rotations. Not on panels 240 pixels wide
+            FIXED_6X8_ENABLE		= ((Display::Config::WIDTH > Display::Config::HEIGHT)?(Display::Config::WIDTH):(Display::Config::HEIGHT)) /FIXED_6X8_WIDTH <= DIRTY_WORD_BITS,
+            //The 8x16 font sizes the pixel buffers and the glyph cache for 16 pixel glyphs. 6 kB more RAM on the 160x80 panel. Enable to use it
+            NSIMSUN_8X16_ENABLE		= false,
+            //Smallest and largest glyphs of the available fonts. The frame buffer is sized for the smallest, the pixel buffers for the largest. Courier 8x10 is always available
+            MIN_SPRITE_WIDTH		= (FIXED_6X8_ENABLE == true)?(FIXED_6X8_WIDTH):(COURIER_8X10_WIDTH),
+            MIN_SPRITE_HEIGHT		= (FIXED_6X8_ENABLE == true)?(FIXED_6X8_HEIGHT):(COURIER_8X10_HEIGHT),
+            MAX_SPRITE_WIDTH		= ((NSIMSUN_8X16_ENABLE == true) && (NSIMSUN_8X16_WIDTH > COURIER_8X10_WIDTH))?(NSIMSUN_8X16_WIDTH):(COURIER_8X10_WIDTH),
+            MAX_SPRITE_HEIGHT		= ((NSIMSUN_8X16_ENABLE == true) && (NSIMSUN_8X16_HEIGHT > COURIER_8X10_HEIGHT))?(NSIMSUN_8X16_HEIGHT):(COURIER_8X10_HEIGHT),
+            MAX_SPRITE_PIXEL_COUNT	= MAX_SPRITE_WIDTH *MAX_SPRITE_HEIGHT,
+            //Sprite of the default font
+            SPRITE_WIDTH			= (FONT_DEFAULT == Font::NSIMSUN_8X16)?(NSIMSUN_8X16_WIDTH):((FONT_DEFAULT == Font::FIXED_6X8)?(FIXED_6X8_WIDTH):(COURIER_8X10_WIDTH)),
+            SPRITE_HEIGHT			= (FONT_DEFAULT == Font::NSIMSUN_8X16)?(NSIMSUN_8X16_HEIGHT):((FONT_DEFAULT == Font::FIXED_6X8)?(FIXED_6X8_HEIGHT):(COURIER_8X10_HEIGHT)),
+            SPRITE_PIXEL_COUNT		= SPRITE_HEIGHT *SPRITE_WIDTH,	//Number of pixels in a sprite of the default font
             //Special sprite codes
             NUM_SPECIAL_SPRITES		= 5,			//Number of special sprites
             SPRITE_TRANSPARENT		= 0,			//Transparent sprite. Never updated. Ignore update flag.
@@ -247,13 +301,31 @@ class Screen : Longan_nano::Display
             //Colors are discretized in a palette
             PALETTE_SIZE			= 16,           //Size of the palette
             PALETTE_SIZE_BIT		= 4,			//Number of bit required to describe a color in the palette
-            //Size of the frame buffer. Display phisical size comes from the Physical Display class
-            FRAME_BUFFER_WIDTH		= Longan_nano::Display::Config::WIDTH /SPRITE_WIDTH,
-            FRAME_BUFFER_HEIGHT		= Longan_nano::Display::Config::HEIGHT /SPRITE_HEIGHT,
+            //Size of the frame buffer in landscape with the default font. Display phisical size comes from the Physical Display class
+            FRAME_BUFFER_WIDTH		= Display::Config::WIDTH /SPRITE_WIDTH,
+            FRAME_BUFFER_HEIGHT		= Display::Config::HEIGHT /SPRITE_HEIGHT,
             FRAME_BUFFER_SIZE		= FRAME_BUFFER_WIDTH *FRAME_BUFFER_HEIGHT,
+            //Portrait turns the screen a quarter and the sprites keep their size. The frame buffer takes the largest geometry of both rotations with the smallest glyph
+            FRAME_BUFFER_MAX_WIDTH			= ((Display::Config::WIDTH > Display::Config::HEIGHT)?(Display::Config::WIDTH):(Display::Config::HEIGHT)) /MIN_SPRITE_WIDTH,
+            FRAME_BUFFER_MAX_HEIGHT			= ((Display::Config::WIDTH > Display::Config::HEIGHT)?(Display::Config::WIDTH):(Display::Config::HEIGHT)) /MIN_SPRITE_HEIGHT,
+            FRAME_BUFFER_MAX_SIZE			= ((Display::Config::WIDTH /MIN_SPRITE_WIDTH) *(Display::Config::HEIGHT /MIN_SPRITE_HEIGHT) > (Display::Config::HEIGHT /MIN_SPRITE_WIDTH) *(Display::Config::WIDTH /MIN_SPRITE_HEIGHT))?
+                                                ((Display::Config::WIDTH /MIN_SPRITE_WIDTH) *(Display::Config::HEIGHT /MIN_SPRITE_HEIGHT)):((Display::Config::HEIGHT /MIN_SPRITE_WIDTH) *(Display::Config::WIDTH /MIN_SPRITE_HEIGHT)),
             SPRITE_SIZE				= 128,			//Number of sprites in the sprite table
-            SPRITE_SIZE_BIT			= 7				//Size of the sprite table
+            SPRITE_SIZE_BIT			= 7,			//Size of the sprite table
+            //Flush planner. Adjacent sprites are sent in a single address window when it costs fewer bytes on the SPI
+            MERGE_MAX_SPRITES		= (FRAME_BUFFER_MAX_WIDTH > FRAME_BUFFER_MAX_HEIGHT)?(FRAME_BUFFER_MAX_WIDTH):(FRAME_BUFFER_MAX_HEIGHT),	//Maximum number of sprites in an address window
+            PIXEL_BUFFER_COUNT		= 2,			//Number of pixel buffers. The next window is rendered in a buffer while the driver sends the others
+            //Pixels of a pixel buffer. A window is a band of sprites at most as long as the longest side of the display and as thick as the largest glyph side
+            PIXEL_BUFFER_SIZE		= ((Display::Config::WIDTH > Display::Config::HEIGHT)?(Display::Config::WIDTH):(Display::Config::HEIGHT)) *((MAX_SPRITE_WIDTH > MAX_SPRITE_HEIGHT)?(MAX_SPRITE_WIDTH):(MAX_SPRITE_HEIGHT)),
+            //Glyph cache
+            GLYPH_CACHE_SIZE		= 16,			//Characters kept expanded to pixels with their colors. The least recently used is replaced. 0 = no cache
         } Config;
+        //The dirty bitmap holds a row of the frame buffer in a word and a bit per row in the summary word
+        static_assert( (Config::FRAME_BUFFER_MAX_WIDTH <= Config::DIRTY_WORD_BITS) && (Config::FRAME_BUFFER_MAX_HEIGHT <= Config::DIRTY_WORD_BITS), "ERR: frame buffer too large for the dirty bitmap" );
+        //The font after init must be available
+        static_assert( (((Font)Config::FONT_DEFAULT != Font::NSIMSUN_8X16) || (Config::NSIMSUN_8X16_ENABLE == true)) && (((Font)Config::FONT_DEFAULT != Font::FIXED_6X8) || (Config::FIXED_6X8_ENABLE == true)), "ERR: the default font is not enabled" );
+        //The glyph expander stores pixel pairs as 32b words. Sprites of a window start every glyph width pixels in landscape and every glyph height pixels in portrait
+        static_assert( ((Config::COURIER_8X10_WIDTH | Config::COURIER_8X10_HEIGHT | Config::NSIMSUN_8X16_WIDTH | Config::NSIMSUN_8X16_HEIGHT | Config::FIXED_6X8_WIDTH | Config::FIXED_6X8_HEIGHT) & 0x01) == 0, "ERR: every font of the registry needs an even width and height to keep the pixels of the glyph expander 32b aligned" );
 
         //! @brief Use the default Color palette. Short hand indexes for user. User can change the palette at will
         typedef enum _Color
@@ -283,6 +355,22 @@ class Screen : Longan_nano::Display
             ENG,        //Engineering format with four significant digits and SI suffix
         } Format_format;
 
+        //! @brief Orientation of the screen. Portrait is the landscape image turned a quarter clockwise. Flipped turns the image upside down
+        typedef enum _Rotation
+        {
+            LANDSCAPE,
+            PORTRAIT,
+            LANDSCAPE_FLIPPED,
+            PORTRAIT_FLIPPED,
+        } Rotation;
+
+        //! @brief Order in which update sends the sprites to be updated. Oldest first bounds the wait of a sprite by the number of sprites marked before it
+        typedef enum _Flush_order
+        {
+            OLDEST_FIRST,	//Sprites are sent in the order they were marked for update
+            RASTER,			//Sprites are sent in raster order from the scan position
+        } Flush_order;
+
         //! @brief Left or Right alignment for a number
         typedef enum _Format_align
         {
@@ -332,6 +420,60 @@ class Screen : Longan_nano::Display
             typedef struct _Rule next_rule;
         } Rule;
         */
+
+        //! @brief String of sprites pre-rendered with its colors by the compiler in the default font. A constexpr Tile is stored in flash and register_tile sends it with the DMA in place
+        template <int LENGTH>
+        struct Tile
+        {
+            //SPRITE_HEIGHT rows of LENGTH sprites. Pixels in the color depth of the display. RGB444 packs two pixels in three bytes like Display::pack_rgb444
+            uint16_t pixel[ Config::SPRITE_HEIGHT *LENGTH *Config::SPRITE_WIDTH ];
+            //Render a string with two colors from Screen::color. Characters after the end of the string or outside the ascii sprite table are background
+            constexpr Tile( const char *str, uint16_t background, uint16_t foreground ) : pixel()
+            {
+                //true = end of string found
+                bool f_end = false;
+                //For: each character
+                for (int tc = 0;tc < LENGTH;tc++)
+                {
+                    f_end = ((f_end == true) || (str[tc] == '\0'));
+                    //true = the character has a glyph in the ascii sprite table
+                    bool f_glyph = ((f_end == false) && (str[tc] >= Config::ASCII_START) && (str[tc] <= Config::ASCII_STOP));
+                    //For: each row of the glyph
+                    for (int th = 0;th < Config::SPRITE_HEIGHT;th++)
+                    {
+                        uint8_t slice = ((f_glyph == true)?(Screen_panel::g_font_metrics[ Config::FONT_DEFAULT ].row_ptr[ (str[tc] -Config::ASCII_START) *Config::SPRITE_HEIGHT +th ]):(0));
+                        //For: each column of the glyph
+                        for (int tw = 0;tw < Config::SPRITE_WIDTH;tw++)
+                        {
+                            uint16_t color = ((((slice >> tw) & 0x01) != 0)?(foreground):(background));
+                            int index = (th *LENGTH +tc) *Config::SPRITE_WIDTH +tw;
+                            //If: 16b pixels
+                            if (Display::Config::COLOR_DEPTH != 12)
+                            {
+                                pixel[ index ] = color;
+                            }
+                            //If: first pixel of a pair. RGB444 byte stream is R0G0 B0R1 G1B1
+                            else if ((index & 0x01) == 0)
+                            {
+                                this -> put_byte( index /2 *3 +0, (uint8_t)(color >> 4) );
+                                this -> put_byte( index /2 *3 +1, (uint8_t)((color & 0x0F) << 4) );
+                            }
+                            //If: second pixel of a pair
+                            else
+                            {
+                                this -> put_byte( index /2 *3 +1, (uint8_t)((color >> 8) & 0x0F) );
+                                this -> put_byte( index /2 *3 +2, (uint8_t)(color & 0xFF) );
+                            }
+                        }
+                    }
+                }
+            }
+            //OR a byte of the RGB444 stream into the pixel words. The DMA reads the words as bytes of a little endian core
+            constexpr void put_byte( int index, uint8_t data )
+            {
+                pixel[ index /2 ] |= (uint16_t)(data << ((index & 0x01) *8));
+            }
+        };
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
         **	CONSTRUCTORS
@@ -339,7 +481,7 @@ class Screen : Longan_nano::Display
         *********************************************************************************************************************************************************/
 
         //Empty constructor
-        Screen( void );
+        Screen_panel( void );
 
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -348,7 +490,7 @@ class Screen : Longan_nano::Display
         *********************************************************************************************************************************************************/
 
        //Empty Destructor
-       ~Screen( void );
+       ~Screen_panel( void );
 
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -358,6 +500,8 @@ class Screen : Longan_nano::Display
 
         //call the initializations for the driver
         bool init( void );
+        //call the initializations for the driver. Start with a font of the registry
+        bool init( Font font );
         //Reset the colors to default
         bool reset_colors( void );
 
@@ -388,6 +532,16 @@ class Screen : Longan_nano::Display
         int get_pending( void );
         //Get current error of the screen class
         Error get_error( void );
+        //Sprites in height and in width of the frame buffer. They depend on the rotation and on the font
+        int get_frame_buffer_height( void );
+        int get_frame_buffer_width( void );
+        //Font in use
+        Font get_font( void );
+        //Glyph table of a font of the registry. A byte per row, LSB is the left pixel, from ASCII_START. Lets the application draw the glyphs elsewhere
+        const uint8_t *get_font_rows( Font font );
+        //Glyph cache. Characters found already expanded and characters expanded since init
+        uint32_t get_glyph_cache_hits( void );
+        uint32_t get_glyph_cache_misses( void );
         
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -397,6 +551,21 @@ class Screen : Longan_nano::Display
 
         //Expose color conversion method
         using Display::color;
+        //Profile the SPI traffic. Bytes spent opening address windows, bytes of pixel data and address commands skipped
+        using Display::get_command_bytes;
+        using Display::get_pixel_bytes;
+        using Display::get_skipped_commands;
+        //Number of sprites registered in the driver and not yet sent. Zero when the display is up to date with the frame buffer sent so far
+        using Display::get_sprite_queue_depth;
+        //ISR hook. Call from the DMA transfer complete interrupt when the Display driver uses USE_ISR
+        using Display::update_sprite_isr;
+        //true = the driver brought up the display. update runs the bring-up
+        using Display::is_ready;
+        //Without DMA, budget of SPI frames and microseconds the driver may spend in each update
+        using Display::set_burst;
+        //Draw a RLE565 compressed image from flash. update decodes it. The sprites under the image are drawn again when they change
+        using Display::register_image;
+        using Display::is_image_busy;
         //Core method. FSM that synchronize the frame buffer with the display using the driver
         bool update( void );
         //Swap source color for dest color for each sprite
@@ -425,8 +594,30 @@ class Screen : Longan_nano::Display
         int print( int origin_h, int origin_w, int num );
         //Draw a solid color sprite on the screen
         int paint( int origin_h, int origin_w, Color color );
+        //Draw a tile pre-rendered in flash over a row of sprites. The sprites under the tile are left alone until they are printed again
+        template <int LENGTH>
+        int register_tile( int origin_h, int origin_w, const Tile<LENGTH> &tile );
         //Show the current error code on the screen. green foreground for ok. red foreground for error
         int print_err( int origin_h, int origin_w );
+        //Define the columns of sprites rotated by the hardware scroll. Return number of sprites marked for update
+        int set_scroll_area( int origin_w, int size_w );
+        //Scroll the content of the scroll area left by a number of sprite columns. Negative scrolls right. Only the exposed columns are drawn
+        int scroll( int shift_w );
+        //Turn the screen. Portrait swaps the geometry of the frame buffer. The screen is cleared to black. Blocking method
+        bool set_rotation( Rotation rotation );
+        //Invert the colors of the whole screen. The panel does it, no sprite is sent
+        bool set_invert( bool f_invert );
+        //Blank the whole screen. The frame buffer and the panel memory are kept
+        bool set_blank( bool f_blank );
+        //Show the whole screen in eight colors. Idle mode of the panel, lower power
+        bool set_idle( bool f_idle );
+        //Blink the whole screen by inverting its colors. update toggles the inversion every half period. Zero stops the blink
+        bool set_blink( int period_ms );
+        //Choose the order in which update sends the sprites to be updated. Raster by default
+        bool set_flush_order( Flush_order order );
+        //Switch to a font of the registry. The geometry of the frame buffer follows the font. The screen is cleared to black. Blocking method
+        //NSIMSUN_8X16 returns an error unless NSIMSUN_8X16_ENABLE is set to true in Config. FIXED_6X8 returns an error on panels 240 pixels wide
+        bool set_font( Font font );
     
     //Visible only inside the class
     private:
@@ -436,13 +627,6 @@ class Screen : Longan_nano::Display
         **********************************************************************************************************************************************************
         *********************************************************************************************************************************************************/
 
-        //! @brief States of the Screen side FSM. Display driver also has its own FSM states   
-        typedef enum _Fsm_state
-        {
-            SCAN_SPRITE,    //Search for a sprite
-            SEND_SPRITE,    //Ask the Display driver to send sprites to the physical display
-        } Fsm_state;
-    
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
         **	PRIVATE STRUCT
@@ -452,27 +636,87 @@ class Screen : Longan_nano::Display
         //! @brief Structure that describes a sprite in the sprite frame buffer
         typedef struct _Frame_buffer_sprite
         {
-            //true: this sprite was changed since last scan | false: this sprite does not need updating
-            uint8_t f_update            : 1;
             //sprite index inside the sprite table. A number are special sprite. Not all sprites are mapped
-            uint8_t sprite_index        : Screen::Config::SPRITE_SIZE_BIT;
+            uint8_t sprite_index        : Screen_panel::Config::SPRITE_SIZE_BIT;
             //foreground palette color index
-            uint8_t foreground_color    : Screen::Config::PALETTE_SIZE_BIT;
+            uint8_t foreground_color    : Screen_panel::Config::PALETTE_SIZE_BIT;
             //background palette color index
-            uint8_t background_color    : Screen::Config::PALETTE_SIZE_BIT;
+            uint8_t background_color    : Screen_panel::Config::PALETTE_SIZE_BIT;
         } Frame_buffer_sprite;
 
+        //! @brief Portrait. Glyphs of a font stored by column. Built at compile time
+        typedef struct _Ascii_columns
+        {
+            //Column n of a glyph is the slice width *glyph +n. Bit t of the slice is the pixel of row t of the glyph
+            uint16_t slice[ (Config::ASCII_STOP -Config::ASCII_START +1) *Config::MAX_SPRITE_WIDTH ];
+            //Transpose the glyphs of a font stored by row
+            constexpr _Ascii_columns( const uint8_t *row_ptr, int width, int height ) : slice()
+            {
+                //For: each glyph
+                for (int glyph = 0;glyph <= Config::ASCII_STOP -Config::ASCII_START;glyph++)
+                {
+                    //For: each row of the glyph
+                    for (int th = 0;th < height;th++)
+                    {
+                        //For: each column of the glyph
+                        for (int tw = 0;tw < width;tw++)
+                        {
+                            slice[ glyph *width +tw ] |= (uint16_t)(((row_ptr[ glyph *height +th ] >> tw) & 0x01) << th);
+                        }
+                    }
+                }
+            }
+        } Ascii_columns;
+
+        //! @brief Font registry. Size and glyph tables of a font
+        typedef struct _Font_metrics
+        {
+            uint8_t width;
+            uint8_t height;
+            //Glyphs by row. A byte per row, LSB is the left pixel
+            const uint8_t *row_ptr;
+            //Portrait. Glyphs by column
+            const uint16_t *column_ptr;
+        } Font_metrics;
+
         //! @brief Status of the update FSM
         typedef struct _Fsm_status
         {
-            //width and height scan indexes
+            //width and height scan indexes. The search for the next sprite to be updated starts here, so that every sprite gets its turn
             uint16_t scan_w, scan_h;
-            //Index withing the sprite sending sequence. Number of steps is defined inside the driver
-            uint8_t cnt;
-            //Status of the scan
-            Fsm_state phase;
         } Fsm_status;
         
+        //! @brief Address window made of adjacent sprites of the frame buffer. Sent with a single address sequence
+        typedef struct _Window
+        {
+            //index of the first sprite of the window in the frame buffer
+            uint16_t index_h, index_w;
+            //Number of sprites in the window
+            uint8_t size;
+            //false = sprites are adjacent in width | true = sprites are adjacent in height
+            bool f_vertical;
+            //true = all sprites in the window are the same solid color. Pixel buffer is not needed
+            bool f_solid_color;
+            //Color of a solid color window
+            uint16_t solid_color;
+        } Window;
+
+        //! @brief Character of the glyph cache, expanded to pixels with its colors
+        typedef struct _Glyph
+        {
+            //Ascii sprite index and colors resolved through the palette. Portrait holds the turned sprite
+            uint8_t sprite_index;
+            bool f_portrait;
+            uint16_t background_color;
+            uint16_t foreground_color;
+            //Last use of the entry. 0 = empty
+            uint32_t last_use;
+            //true = registered in the driver queue as a single character window. The driver may still be sending it
+            bool f_queued;
+            //Pixels in the layout of a single sprite window. Sized for the largest glyph. Aligned for the pixel pairs of the glyph expander
+            alignas(uint32_t) uint16_t pixel[ Config::MAX_SPRITE_PIXEL_COUNT ];
+        } Glyph;
+
         //! @brief number format to be printed by the print number method
         typedef struct _Format_number
         {
@@ -500,8 +744,12 @@ class Screen : Longan_nano::Display
         bool init_default_colors( void );
         //Initialize the default color palette
         bool init_palette( void );
+        //Size of the sprites and of the frame buffer from the font and the rotation
+        void init_geometry( void );
         //Initialize Screen FSM
         bool init_fsm( void );
+        //Empty the glyph cache and reset its counters
+        bool init_glyph_cache( void );
 
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -517,6 +765,8 @@ class Screen : Longan_nano::Display
         bool is_using_foreground( uint8_t sprite );
         //true = sprite_a functionally the same as sprite_b
         bool is_same_sprite( Frame_buffer_sprite sprite_a, Frame_buffer_sprite sprite_b );
+        //true = the sprite is marked for update in the dirty bitmap
+        bool is_dirty( uint16_t index_h, uint16_t index_w );
 
         /*********************************************************************************************************************************************************
         **********************************************************************************************************************************************************
@@ -524,10 +774,44 @@ class Screen : Longan_nano::Display
         **********************************************************************************************************************************************************
         *********************************************************************************************************************************************************/
 
-        //Register a sprite for draw in the display driver if possible. Sprite can be xomplex color map or solid color
-        int8_t register_sprite( uint16_t index_h, uint16_t index_w );
-        //Update a sprite in the frame buffer and mark it for update if required. Increase workload counter if required.
+        //Decode how a sprite is drawn. -1 error | 0 transparent | 1 solid color | 2 pixel color map
+        int8_t decode_sprite( Frame_buffer_sprite sprite, uint16_t &color );
+        //Render the pixels of a sprite inside the pixel buffer
+        void render_sprite( Frame_buffer_sprite sprite, uint16_t *pixel_ptr, uint16_t stride );
+        //Portrait. Render the pixels of a sprite turned a quarter clockwise. Glyph columns become display rows
+        void render_sprite_portrait( Frame_buffer_sprite sprite, uint16_t *pixel_ptr, uint16_t stride );
+        //Expand a glyph of the font in use. Dispatch to the expansion specialized for the size of the font
+        void render_glyph( uint8_t glyph, bool f_portrait, uint16_t *pixel_ptr, uint16_t stride );
+        //Expand a glyph of a font of a given size. The rows and the pixels of a row are constants
+        template <int WIDTH, int HEIGHT>
+        void expand_glyph( uint8_t glyph, bool f_portrait, uint16_t *pixel_ptr, uint16_t stride );
+        //Grow an address window from a sprite to be updated along a direction. Return number of sprites in the window
+        uint8_t scan_window( uint16_t index_h, uint16_t index_w, bool f_vertical, uint8_t &num_dirty );
+        //Flush planner. Merge adjacent sprites to be updated in a single address window when it costs fewer bytes on the SPI
+        void plan_window( uint16_t index_h, uint16_t index_w, Window &window );
+        //Register an address window for draw in the display driver. Window can be complex color map or solid color
+        int8_t register_window( Window &window );
+        //Update a sprite in the frame buffer and mark it for update in the dirty bitmap if required
         int8_t update_sprite( uint16_t index_h, uint16_t index_w, Frame_buffer_sprite new_sprite );
+        //Set all sprites of the frame buffer to a solid sprite. Sent as a single address window when it costs fewer bytes than the sprites one by one
+        int fill_screen( Frame_buffer_sprite new_sprite );
+        //Mark a sprite for update even if it didn't change. Return 1 if it wasn't marked already
+        int8_t mark_sprite( uint16_t index_h, uint16_t index_w );
+        //Set and clear the bit of a sprite in the dirty bitmap. Keep the summary word in sync
+        void set_dirty( uint16_t index_h, uint16_t index_w );
+        void clear_dirty( uint16_t index_h, uint16_t index_w );
+        //Find the next sprite to be updated from the scan position, in raster order and wrapping around. true = no sprite to be updated
+        bool find_dirty( uint16_t &index_h, uint16_t &index_w );
+        //Find the sprite that has been waiting the longest in the dirty FIFO. true = no sprite to be updated
+        bool find_oldest_dirty( uint16_t &index_h, uint16_t &index_w );
+        //No sprite to be updated. Clear the dirty bitmap and the dirty FIFO
+        void reset_dirty( void );
+        //Glyph cache. Pixels of a character with its colors. Expanded in the least recently used entry on a miss. nullptr = not a character or no entry free
+        Glyph *get_glyph( Frame_buffer_sprite sprite, bool f_portrait );
+        //Glyph cache. Empty the entries that use a color
+        void invalidate_glyph( uint16_t color );
+        //Column of the display memory that shows a column of the frame buffer. The hardware scroll rotates the scroll area
+        uint16_t get_scroll_column( uint16_t index_w );
         //Report an error in the Screen class
         void report_error( Error error_code );
 
@@ -541,7 +825,7 @@ class Screen : Longan_nano::Display
 
         void show_frame_sprite( Frame_buffer_sprite sprite_tmp )
         {
-            DPRINT("update: %d | index: %5d | background: %5d | foreground: %5d |\n", sprite_tmp.f_update, sprite_tmp.sprite_index, sprite_tmp.background_color, sprite_tmp.foreground_color );
+            DPRINT("index: %5d | background: %5d | foreground: %5d |\n", sprite_tmp.sprite_index, sprite_tmp.background_color, sprite_tmp.foreground_color );
             DPRINT("decoded background color: %6x | decoded foreground color: %6x |\n", g_palette[sprite_tmp.background_color], sprite_tmp.foreground_color );
             return;
         }
@@ -555,7 +839,7 @@ class Screen : Longan_nano::Display
                 DPRINT("");
                 for (int tw = 0;tw < g_sprite.size_w;tw++)
                 {
-                    DPRINT_NOTAB("%6x | ", g_pixel_data[th *g_sprite.size_w +tw]);
+                    DPRINT_NOTAB("%6x | ", g_pixel_data[g_pixel_index][th *g_sprite.size_w +tw]);
                 }
                 DPRINT_NOTAB("\n");
             }
@@ -592,22 +876,58 @@ class Screen : Longan_nano::Display
         Color g_default_foreground_color;
         //! @brief Color Palette. One special code for transparent. Two special indexes store global background and foreground
         uint16_t g_palette[ Config::PALETTE_SIZE ];
-        //! @brief Frame Buffer
-        Frame_buffer_sprite g_frame_buffer[ Config::FRAME_BUFFER_HEIGHT ][ Config::FRAME_BUFFER_WIDTH ];
-        //! @brief Track the number of sprites that require update. At zero the update method quit without scanning and print methods will set the scan to the correct index
-        uint16_t g_pending_cnt;
-        //! @brief Sprite buffer that stores raw pixel data for a single sprite
-        uint16_t g_pixel_data[ Config::SPRITE_PIXEL_COUNT ];
+        //! @brief Frame Buffer. Sized for both rotations and the smallest glyph
+        Frame_buffer_sprite g_frame_buffer[ Config::FRAME_BUFFER_MAX_HEIGHT ][ Config::FRAME_BUFFER_MAX_WIDTH ];
+        //! @brief Rotation of the screen and sprites of the frame buffer in use in height and in width
+        Rotation g_rotation;
+        uint16_t g_frame_buffer_height;
+        uint16_t g_frame_buffer_width;
+        //! @brief Font in use. Pixels of its glyphs in height and in width and bytes needed to send the pixels of a sprite
+        Font g_font;
+        uint16_t g_sprite_height;
+        uint16_t g_sprite_width;
+        uint16_t g_merge_pixel_bytes;
+        //! @brief Dirty bitmap. Bit w of row h is set when sprite h,w requires update. Bit h of the summary is set when row h has a sprite that requires update
+        //! The next sprite to be updated is found with a count trailing zeros and the number of pending sprites with a population count
+        uint32_t g_dirty_row[ Config::FRAME_BUFFER_MAX_HEIGHT ];
+        uint32_t g_dirty_summary;
+        //! @brief Dirty FIFO. Sprites in the order they were marked for update, packed as h <<8 | w. Bit w of queued row h is set while sprite h,w is in the FIFO
+        //! A sprite is queued once. Sprites sent in a window with an older sprite stay in the FIFO and are dropped when they reach the head
+        uint16_t g_dirty_fifo[ Config::FRAME_BUFFER_MAX_SIZE ];
+        uint16_t g_dirty_fifo_head;
+        uint16_t g_dirty_fifo_cnt;
+        uint32_t g_queued_row[ Config::FRAME_BUFFER_MAX_HEIGHT ];
+        //! @brief Order in which update sends the sprites to be updated
+        Flush_order g_flush_order;
+        //! @brief Glyph cache. Characters expanded to pixels, the least recently used is replaced. Clock of the last use. Hits and misses since init
+        Glyph g_glyph_cache[ (Config::GLYPH_CACHE_SIZE > 0)?(Config::GLYPH_CACHE_SIZE):(1) ];
+        uint32_t g_glyph_cache_tick;
+        uint32_t g_glyph_cache_hits;
+        uint32_t g_glyph_cache_misses;
+        //! @brief Expands glyph slices to pixels. Holds the table of the last background/foreground pair
+        User::Glyph_expander g_expander;
+        //! @brief Sprite buffers that store raw pixel data for an address window of sprites. Used in rotation. Aligned for the pixel pairs of the glyph expander
+        alignas(uint32_t) uint16_t g_pixel_data[ Config::PIXEL_BUFFER_COUNT ][ Config::PIXEL_BUFFER_SIZE ];
+        //! @brief Index of the pixel buffer the next complex color map window is rendered in
+        uint8_t g_pixel_index;
         //! @brief Status of the update FSM
         Fsm_status g_status;
+        //! @brief Columns of sprites rotated by the hardware scroll and their rotation. Size zero means no scroll area
+        uint16_t g_scroll_index_w;
+        uint16_t g_scroll_size;
+        uint16_t g_scroll_shift;
         //! @brief Display format for print numeric values
         Format_number g_format_number;
+        //! @brief true = the colors of the whole screen are inverted by the panel
+        bool g_f_invert;
+        //! @brief Blink period in milliseconds, zero means no blink. true = the inversion is toggled by the blink. Time since the last toggle
+        uint16_t g_blink_period;
+        bool g_f_blink_phase;
+        Longan_nano::Chrono g_blink_timer;
     
-        //Support for font with height of 10 pixels
-        #if FONT_HEIGHT == 10
-        //! @brief ASCII Sprites. Stored in the flash memory. 95 sprites from space ' ' code 32 to tilda '~' code 126 + special code 127. FONT_HEIGHT is used to change font
+        //! @brief ASCII Sprites. Stored in the flash memory. 95 sprites from space ' ' code 32 to tilda '~' code 126 + special code 127. One table per font of the registry
         //Font: Courier New 8 with two rows removed from bot and four rows removed from top
-        static constexpr uint8_t g_ascii_sprites[96*10] =
+        static constexpr uint8_t g_font_courier_8x10[96*Config::COURIER_8X10_HEIGHT] =
         {
             0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 	//char:  32 ' '
             0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x10, 0x00, 0x00, 	//char:  33 '!'
@@ -707,11 +1027,8 @@ class Screen : Longan_nano::Display
             0xC6, 0xBA, 0xBE, 0xBE, 0xDE, 0xEE, 0xFE, 0xEE, 0xEE, 0x7C, 	//char: 127 ' '
         };
         
-        //Support for font with height of 16 pixels
-        #elif FONT_HEIGHT == 16
-        //! @brief ASCII Sprites. Stored in the flash memory. 95 sprites from space ' ' code 32 to tilda '~' code 126 + special code 127. FONT_HEIGHT is used to change font
         //Font: NSimSun 11 with one row added on top
-        static constexpr uint8_t g_ascii_sprites[96*16] =
+        static constexpr uint8_t g_font_nsimsun_8x16[96*Config::NSIMSUN_8X16_HEIGHT] =
         {
             0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,     //char:  32 ' '
             0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x08, 0x08, 0x00, 0x00,     //char:  33 '!'
@@ -810,11 +1127,122 @@ class Screen : Longan_nano::Display
             0x00, 0x04, 0x5A, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,     //char: 126 '~'
             0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,     //char: 127 ' '
         };
-        #else
-            #error "ERR: Font size not supported"
-        #endif
+        //Font: classic 5x7 glyphs with a blank column on the right and a blank row at the bottom. Special code 127 is a full block
+        static constexpr uint8_t g_font_fixed_6x8[96*Config::FIXED_6X8_HEIGHT] =
+        {
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,     //char:  32 ' '
+            0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04, 0x00,     //char:  33 '!'
+            0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00,     //char:  34 '"'
+            0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A, 0x00,     //char:  35 '#'
+            0x04, 0x1E, 0x05, 0x0E, 0x14, 0x0F, 0x04, 0x00,     //char:  36 '$'
+            0x03, 0x13, 0x08, 0x04, 0x02, 0x19, 0x18, 0x00,     //char:  37 '%'
+            0x06, 0x09, 0x05, 0x02, 0x15, 0x09, 0x16, 0x00,     //char:  38 '&'
+            0x06, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,     //char:  39 '''
+            0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08, 0x00,     //char:  40 '('
+            0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02, 0x00,     //char:  41 ')'
+            0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00, 0x00,     //char:  42 '*'
+            0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00, 0x00,     //char:  43 '+'
+            0x00, 0x00, 0x00, 0x00, 0x06, 0x04, 0x02, 0x00,     //char:  44 ','
+            0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00,     //char:  45 '-'
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x06, 0x00,     //char:  46 '.'
+            0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00,     //char:  47 '/'
+            0x0E, 0x11, 0x19, 0x15, 0x13, 0x11, 0x0E, 0x00,     //char:  48 '0'
+            0x04, 0x06, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00,     //char:  49 '1'
+            0x0E, 0x11, 0x10, 0x08, 0x04, 0x02, 0x1F, 0x00,     //char:  50 '2'
+            0x1F, 0x08, 0x04, 0x08, 0x10, 0x11, 0x0E, 0x00,     //char:  51 '3'
+            0x08, 0x0C, 0x0A, 0x09, 0x1F, 0x08, 0x08, 0x00,     //char:  52 '4'
+            0x1F, 0x01, 0x0F, 0x10, 0x10, 0x11, 0x0E, 0x00,     //char:  53 '5'
+            0x0C, 0x02, 0x01, 0x0F, 0x11, 0x11, 0x0E, 0x00,     //char:  54 '6'
+            0x1F, 0x10, 0x08, 0x04, 0x02, 0x02, 0x02, 0x00,     //char:  55 '7'
+            0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E, 0x00,     //char:  56 '8'
+            0x0E, 0x11, 0x11, 0x1E, 0x10, 0x08, 0x06, 0x00,     //char:  57 '9'
+            0x00, 0x06, 0x06, 0x00, 0x06, 0x06, 0x00, 0x00,     //char:  58 ':'
+            0x00, 0x06, 0x06, 0x00, 0x06, 0x04, 0x02, 0x00,     //char:  59 ';'
+            0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08, 0x00,     //char:  60 '<'
+            0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00,     //char:  61 '='
+            0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, 0x00,     //char:  62 '>'
+            0x0E, 0x11, 0x10, 0x08, 0x04, 0x00, 0x04, 0x00,     //char:  63 '?'
+            0x0E, 0x11, 0x10, 0x16, 0x15, 0x15, 0x0E, 0x00,     //char:  64 '@'
+            0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x00,     //char:  65 'A'
+            0x0F, 0x11, 0x11, 0x0F, 0x11, 0x11, 0x0F, 0x00,     //char:  66 'B'
+            0x0E, 0x11, 0x01, 0x01, 0x01, 0x11, 0x0E, 0x00,     //char:  67 'C'
+            0x07, 0x09, 0x11, 0x11, 0x11, 0x09, 0x07, 0x00,     //char:  68 'D'
+            0x1F, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x1F, 0x00,     //char:  69 'E'
+            0x1F, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x01, 0x00,     //char:  70 'F'
+            0x0E, 0x11, 0x01, 0x1D, 0x11, 0x11, 0x1E, 0x00,     //char:  71 'G'
+            0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00,     //char:  72 'H'
+            0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00,     //char:  73 'I'
+            0x1C, 0x08, 0x08, 0x08, 0x08, 0x09, 0x06, 0x00,     //char:  74 'J'
+            0x11, 0x09, 0x05, 0x03, 0x05, 0x09, 0x11, 0x00,     //char:  75 'K'
+            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x1F, 0x00,     //char:  76 'L'
+            0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11, 0x00,     //char:  77 'M'
+            0x11, 0x11, 0x13, 0x15, 0x19, 0x11, 0x11, 0x00,     //char:  78 'N'
+            0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00,     //char:  79 'O'
+            0x0F, 0x11, 0x11, 0x0F, 0x01, 0x01, 0x01, 0x00,     //char:  80 'P'
+            0x0E, 0x11, 0x11, 0x11, 0x15, 0x09, 0x16, 0x00,     //char:  81 'Q'
+            0x0F, 0x11, 0x11, 0x0F, 0x05, 0x09, 0x11, 0x00,     //char:  82 'R'
+            0x1E, 0x01, 0x01, 0x0E, 0x10, 0x10, 0x0F, 0x00,     //char:  83 'S'
+            0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00,     //char:  84 'T'
+            0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00,     //char:  85 'U'
+            0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00,     //char:  86 'V'
+            0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A, 0x00,     //char:  87 'W'
+            0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11, 0x00,     //char:  88 'X'
+            0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x00,     //char:  89 'Y'
+            0x1F, 0x10, 0x08, 0x04, 0x02, 0x01, 0x1F, 0x00,     //char:  90 'Z'
+            0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E, 0x00,     //char:  91 '['
+            0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00, 0x00,     //char:  92 '\'
+            0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E, 0x00,     //char:  93 ']'
+            0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00,     //char:  94 '^'
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x00,     //char:  95 '_'
+            0x02, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00,     //char:  96 '`'
+            0x00, 0x00, 0x0E, 0x10, 0x1E, 0x11, 0x1E, 0x00,     //char:  97 'a'
+            0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F, 0x00,     //char:  98 'b'
+            0x00, 0x00, 0x0E, 0x01, 0x01, 0x11, 0x0E, 0x00,     //char:  99 'c'
+            0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E, 0x00,     //char: 100 'd'
+            0x00, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x0E, 0x00,     //char: 101 'e'
+            0x0C, 0x12, 0x02, 0x07, 0x02, 0x02, 0x02, 0x00,     //char: 102 'f'
+            0x00, 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x0E, 0x00,     //char: 103 'g'
+            0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x11, 0x00,     //char: 104 'h'
+            0x04, 0x00, 0x06, 0x04, 0x04, 0x04, 0x0E, 0x00,     //char: 105 'i'
+            0x08, 0x00, 0x0C, 0x08, 0x08, 0x09, 0x06, 0x00,     //char: 106 'j'
+            0x01, 0x01, 0x09, 0x05, 0x03, 0x05, 0x09, 0x00,     //char: 107 'k'
+            0x06, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00,     //char: 108 'l'
+            0x00, 0x00, 0x0B, 0x15, 0x15, 0x11, 0x11, 0x00,     //char: 109 'm'
+            0x00, 0x00, 0x0D, 0x13, 0x11, 0x11, 0x11, 0x00,     //char: 110 'n'
+            0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00,     //char: 111 'o'
+            0x00, 0x00, 0x0F, 0x11, 0x0F, 0x01, 0x01, 0x00,     //char: 112 'p'
+            0x00, 0x00, 0x16, 0x19, 0x1E, 0x10, 0x10, 0x00,     //char: 113 'q'
+            0x00, 0x00, 0x0D, 0x13, 0x01, 0x01, 0x01, 0x00,     //char: 114 'r'
+            0x00, 0x00, 0x0E, 0x01, 0x0E, 0x10, 0x0F, 0x00,     //char: 115 's'
+            0x02, 0x02, 0x07, 0x02, 0x02, 0x12, 0x0C, 0x00,     //char: 116 't'
+            0x00, 0x00, 0x11, 0x11, 0x11, 0x19, 0x16, 0x00,     //char: 117 'u'
+            0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00,     //char: 118 'v'
+            0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A, 0x00,     //char: 119 'w'
+            0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00,     //char: 120 'x'
+            0x00, 0x00, 0x11, 0x11, 0x1E, 0x10, 0x0E, 0x00,     //char: 121 'y'
+            0x00, 0x00, 0x1F, 0x08, 0x04, 0x02, 0x1F, 0x00,     //char: 122 'z'
+            0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08, 0x00,     //char: 123 '{'
+            0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00,     //char: 124 '|'
+            0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02, 0x00,     //char: 125 '}'
+            0x00, 0x00, 0x02, 0x15, 0x08, 0x00, 0x00, 0x00,     //char: 126 '~'
+            0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x00,     //char: 127 ' '
+        };
+        //! @brief Portrait. Glyphs of each font stored by column. Stored in flash memory
+        static constexpr Ascii_columns g_columns_courier_8x10 = Ascii_columns( g_font_courier_8x10, Config::COURIER_8X10_WIDTH, Config::COURIER_8X10_HEIGHT );
+        static constexpr Ascii_columns g_columns_nsimsun_8x16 = Ascii_columns( g_font_nsimsun_8x16, Config::NSIMSUN_8X16_WIDTH, Config::NSIMSUN_8X16_HEIGHT );
+        static constexpr Ascii_columns g_columns_fixed_6x8 = Ascii_columns( g_font_fixed_6x8, Config::FIXED_6X8_WIDTH, Config::FIXED_6X8_HEIGHT );
+        //! @brief Font registry. Indexed by Font
+        static constexpr Font_metrics g_font_metrics[ Font::NUM_FONTS ] =
+        {
+            { Config::COURIER_8X10_WIDTH, Config::COURIER_8X10_HEIGHT, g_font_courier_8x10, g_columns_courier_8x10.slice },
+            { Config::NSIMSUN_8X16_WIDTH, Config::NSIMSUN_8X16_HEIGHT, g_font_nsimsun_8x16, g_columns_nsimsun_8x16.slice },
+            { Config::FIXED_6X8_WIDTH, Config::FIXED_6X8_HEIGHT, g_font_fixed_6x8, g_columns_fixed_6x8.slice },
+        };
 };	//End Class: Screen
 
+//! @brief Screen of the display embedded in the longan nano
+typedef Screen_panel<Panel_st7735s_w160_h80> Screen;
+
     /*********************************************************************************************************************************************************
     **********************************************************************************************************************************************************
     **	CONSTRUCTORS
@@ -829,7 +1257,8 @@ class Screen : Longan_nano::Display
 //!	\n Empty constructor
 /***************************************************************************/
 
-Screen::Screen( void ) : Longan_nano::Display::Display()
+template <class Panel>
+Screen_panel<Panel>::Screen_panel( void ) : Display()
 {
     DENTER();
     //----------------------------------------------------------------
@@ -863,7 +1292,8 @@ Screen::Screen( void ) : Longan_nano::Display::Display()
 //!	\n Void destructor
 /***************************************************************************/
 
-Screen::~Screen( void )
+template <class Panel>
+Screen_panel<Panel>::~Screen_panel( void )
 {
     DENTER();
     //----------------------------------------------------------------
@@ -893,12 +1323,44 @@ Screen::~Screen( void )
 /***************************************************************************/
 //! @return bool | false = OK | true = ERR
 //! @details
-//!	\n call the initializations for the driver
+//!	\n call the initializations for the driver with the default font. Non blocking
 /***************************************************************************/
 
-bool Screen::init( void )
+template <class Panel>
+bool Screen_panel<Panel>::init( void )
 {
-    DENTER();
+    ///--------------------------------------------------------------------------
+    ///	RETURN
+    ///--------------------------------------------------------------------------
+    return this -> init( (Font)Config::FONT_DEFAULT );
+}	//End public init: init | void
+
+/***************************************************************************/
+//!	@brief public init
+//!	init | Font |
+/***************************************************************************/
+//!	@param font | Font | font of the registry. Sets the size of the sprites and of the frame buffer. NSIMSUN_8X16 returns an error unless NSIMSUN_8X16_ENABLE is set to true in Config
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n call the initializations for the driver. Non blocking
+//!	\n The driver brings up the display inside update. A black screen is queued as the first frame
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::init( Font font )
+{
+    DENTER_ARG("font: %d\n", (int)font );
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: the font is not in the registry or not available on the panel
+    if ((font >= Font::NUM_FONTS) || ((font == Font::FIXED_6X8) && (Config::FIXED_6X8_ENABLE == false)) || ((font == Font::NSIMSUN_8X16) && (Config::NSIMSUN_8X16_ENABLE == false)))
+    {
+        DRETURN_ARG("ERR: bad font\n");
+        return true;	//FAIL
+    }
+
     //----------------------------------------------------------------
     //	VARS
     //----------------------------------------------------------------
@@ -911,7 +1373,16 @@ bool Screen::init( void )
     //----------------------------------------------------------------
 
     //Initialize the display driver. It handles phisical communication with the display and provide methods to write sprites
-    f_ret = this -> Longan_nano::Display::init();
+    f_ret = this -> Display::init();
+    //The display reset its scroll area, its scan direction and its effects
+    this -> g_scroll_size = 0;
+    this -> g_scroll_shift = 0;
+    this -> g_rotation = Rotation::LANDSCAPE;
+    this -> g_f_invert = false;
+    this -> g_blink_period = 0;
+    this -> g_f_blink_phase = false;
+    this -> g_font = font;
+    this -> init_geometry();
     //Initialize colors
     this -> init_default_colors();
     //Initialize the frame buffer
@@ -920,15 +1391,17 @@ bool Screen::init( void )
     f_ret |= this -> init_palette();
     //Initialize update FSM
     f_ret |= this -> init_fsm();
-    //Clear the display to black
-    this -> Display::clear();
+    //Empty the glyph cache
+    f_ret |= this -> init_glyph_cache();
+    //Clear the display to black. One solid color sprite, sent as soon as the driver is done with the bring-up
+    f_ret |= (this -> Display::register_sprite( 0, 0, Display::Config::HEIGHT, Display::Config::WIDTH, Display::color( 0x00, 0x00, 0x00 ) ) <= 0);
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
     DRETURN();
     return f_ret;
-}	//End public init: init | void
+}	//End public init: init | Font |
 
 /***************************************************************************/
 //!	@brief public init
@@ -939,7 +1412,8 @@ bool Screen::init( void )
 //!	\n Reset the colors to default
 /***************************************************************************/
 
-bool Screen::reset_colors( void )
+template <class Panel>
+bool Screen_panel<Panel>::reset_colors( void )
 {
     DENTER();
     //----------------------------------------------------------------
@@ -983,7 +1457,8 @@ bool Screen::reset_colors( void )
 //! \n Set background and foreground color of a given sprite
 /***************************************************************************/
 
-inline int Screen::set_color( int origin_h, int origin_w, Color background, Color foreground )
+template <class Panel>
+inline int Screen_panel<Panel>::set_color( int origin_h, int origin_w, Color background, Color foreground )
 {
     DENTER();
     //----------------------------------------------------------------
@@ -991,7 +1466,7 @@ inline int Screen::set_color( int origin_h, int origin_w, Color background, Colo
     //----------------------------------------------------------------
 
     //If: first character is outside the ascii sprite table
-    if ((origin_h < 0) || (origin_h >= Config::FRAME_BUFFER_HEIGHT) || (origin_w < 0) || (origin_w >= Config::FRAME_BUFFER_WIDTH))
+    if ((origin_h < 0) || (origin_h >= this -> g_frame_buffer_height) || (origin_w < 0) || (origin_w >= this -> g_frame_buffer_width))
     {
         DRETURN_ARG("ERR: out of the sprite table %5d %5d\n", origin_h, origin_w);
         return true;	//FAIL
@@ -1053,7 +1528,8 @@ inline int Screen::set_color( int origin_h, int origin_w, Color background, Colo
 //! \n All existing sprites are automatically updated as needed
 /***************************************************************************/
 
-int Screen::set_default_colors( Color new_background, Color new_foreground )
+template <class Panel>
+int Screen_panel<Panel>::set_default_colors( Color new_background, Color new_foreground )
 {
     DENTER();
     //----------------------------------------------------------------
@@ -1098,10 +1574,10 @@ int Screen::set_default_colors( Color new_background, Color new_foreground )
         //Update defaults
         this -> g_default_background_color = new_background;
         //For: scan height
-        for (uint8_t th = 0;th < Config::FRAME_BUFFER_HEIGHT;th++)
+        for (uint8_t th = 0;th < this -> g_frame_buffer_height;th++)
         {
             //For: scan width
-            for (uint8_t tw = 0;tw < Config::FRAME_BUFFER_WIDTH;tw++)
+            for (uint8_t tw = 0;tw < this -> g_frame_buffer_width;tw++)
             {
                 //Fetch sprite
                 sprite_tmp = this -> g_frame_buffer[ th ][ tw ];
@@ -1134,10 +1610,10 @@ int Screen::set_default_colors( Color new_background, Color new_foreground )
         //Update defaults
         this -> g_default_foreground_color = new_foreground;
         //For: scan height
-        for (uint8_t th = 0;th < Config::FRAME_BUFFER_HEIGHT;th++)
+        for (uint8_t th = 0;th < this -> g_frame_buffer_height;th++)
         {
             //For: scan width
-            for (uint8_t tw = 0;tw < Config::FRAME_BUFFER_WIDTH;tw++)
+            for (uint8_t tw = 0;tw < this -> g_frame_buffer_width;tw++)
             {
                 //Fetch sprite
                 sprite_tmp = this -> g_frame_buffer[ th ][ tw ];
@@ -1173,10 +1649,10 @@ int Screen::set_default_colors( Color new_background, Color new_foreground )
         this -> g_default_background_color = new_background;
         this -> g_default_foreground_color = new_foreground;
         //For: scan height
-        for (uint8_t th = 0;th < Config::FRAME_BUFFER_HEIGHT;th++)
+        for (uint8_t th = 0;th < this -> g_frame_buffer_height;th++)
         {
             //For: scan width
-            for (uint8_t tw = 0;tw < Config::FRAME_BUFFER_WIDTH;tw++)
+            for (uint8_t tw = 0;tw < this -> g_frame_buffer_width;tw++)
             {
                 //Fetch sprite
                 sprite_tmp = this -> g_frame_buffer[ th ][ tw ];
@@ -1197,8 +1673,6 @@ int Screen::set_default_colors( Color new_background, Color new_foreground )
                 //If: Sprite has changed
                 if (f_changed == true)
                 {
-                    //Mark sprite for update
-                    sprite_tmp.f_update = true;
                     //Update the sprite
                     ret = this -> update_sprite( th, tw, sprite_tmp );
                     //If: failed to update sprite
@@ -1240,7 +1714,8 @@ int Screen::set_default_colors( Color new_background, Color new_foreground )
 //! \n Use the conversion function provided by the Display driver to compute the right color space
 /***************************************************************************/
 
-int Screen::set_palette_color( Color palette_index, uint8_t r, uint8_t g, uint8_t b )
+template <class Panel>
+int Screen_panel<Panel>::set_palette_color( Color palette_index, uint8_t r, uint8_t g, uint8_t b )
 {
     DENTER_ARG("source: %d |\n", palette_index);
     //----------------------------------------------------------------
@@ -1265,6 +1740,8 @@ int Screen::set_palette_color( Color palette_index, uint8_t r, uint8_t g, uint8_
         DRETURN();    
         return 0;
     }
+    //The characters expanded with the old color are stale
+    this -> invalidate_glyph( this -> g_palette[ palette_index ] );
     //Set the color in the palette
     this -> g_palette[ palette_index ] = new_color;
 
@@ -1279,10 +1756,10 @@ int Screen::set_palette_color( Color palette_index, uint8_t r, uint8_t g, uint8_
     bool f_sprite_changed;
     int num_changed_sprites = 0;
     //For: scan height
-    for (uint8_t th = 0;th < Config::FRAME_BUFFER_HEIGHT;th++)
+    for (uint8_t th = 0;th < this -> g_frame_buffer_height;th++)
     {
         //For: scan width
-        for (uint8_t tw = 0;tw < Config::FRAME_BUFFER_WIDTH;tw++)
+        for (uint8_t tw = 0;tw < this -> g_frame_buffer_width;tw++)
         {
             //Fetch sprite
             sprite_tmp = this -> g_frame_buffer[ th ][ tw ];
@@ -1301,12 +1778,12 @@ int Screen::set_palette_color( Color palette_index, uint8_t r, uint8_t g, uint8_
             //If: sprite was changed
             if (f_sprite_changed == true)
             {
-                //Update the sprite
-                ret = this -> update_sprite( th, tw, sprite_tmp );
-                //If: failed to update sprite
+                //The sprite in the frame buffer is the same, its color is not. Mark it for update
+                ret = this -> mark_sprite( th, tw );
+                //If: failed to mark sprite
                 if ((Config::PEDANTIC_CHECKS == true) && (ret < 0))
                 {
-                    DRETURN_ARG("ERR: Failed to update sprite\n");
+                    DRETURN_ARG("ERR: Failed to mark sprite\n");
                     return -1;
                 }
                 //If: either zero or one sprite was changed
@@ -1343,7 +1820,8 @@ int Screen::set_palette_color( Color palette_index, uint8_t r, uint8_t g, uint8_
 //!	\n The format also specifies full number or enginnering format
 /***************************************************************************/
 
-inline bool Screen::set_format( int number_size, Format_align align, Format_format format )
+template <class Panel>
+inline bool Screen_panel<Panel>::set_format( int number_size, Format_align align, Format_format format )
 {
     DENTER_ARG("number_size: %d |align: %d | format: %d\n", number_size, (int)align, (int)format );
     //----------------------------------------------------------------
@@ -1390,7 +1868,8 @@ inline bool Screen::set_format( int number_size, Format_align align, Format_form
 //!	\n The format also specifies full number or enginnering format
 /***************************************************************************/
 
-inline bool Screen::set_format( int number_size, Format_align align, Format_format format, int exp )
+template <class Panel>
+inline bool Screen_panel<Panel>::set_format( int number_size, Format_align align, Format_format format, int exp )
 {
     DENTER_ARG("number_size: %d |align: %d | format: %d | ENG exponent: %d\n", number_size, (int)align, (int)format, exp );
     //----------------------------------------------------------------
@@ -1440,16 +1919,39 @@ inline bool Screen::set_format( int number_size, Format_align align, Format_form
 //! @return int | number of sprites pending for update in the frame buffer
 //!	@details
 //! \n return the number of sprites pending for update in the frame buffer
+//! \n Population count of the rows of the dirty bitmap flagged by the summary word
 /***************************************************************************/
 
-int Screen::get_pending( void )
+template <class Panel>
+int Screen_panel<Panel>::get_pending( void )
 {
     DENTER(); //Trace Enter
+    ///--------------------------------------------------------------------------
+    ///	VARS
+    ///--------------------------------------------------------------------------
+
+    //Number of sprites pending
+    int pending_cnt = 0;
+    //Rows with sprites pending
+    uint32_t summary = this -> g_dirty_summary;
+
+    ///--------------------------------------------------------------------------
+    ///	BODY
+    ///--------------------------------------------------------------------------
+
+    //While: rows with sprites pending
+    while (summary != 0)
+    {
+        pending_cnt += __builtin_popcount( this -> g_dirty_row[ __builtin_ctz( summary ) ] );
+        //Clear the lowest row
+        summary &= summary -1;
+    }
+
     ///--------------------------------------------------------------------------
     ///	RETURN
     ///--------------------------------------------------------------------------
-    DRETURN_ARG("Pending: %d", this -> g_pending_cnt ); //Trace Return
-    return this -> g_pending_cnt ;	//OK
+    DRETURN_ARG("Pending: %d", pending_cnt ); //Trace Return
+    return pending_cnt;	//OK
 }	//end public getter: get_pending | void |
 
 /***************************************************************************/
@@ -1461,7 +1963,8 @@ int Screen::get_pending( void )
 //! \n return the number of sprites pending for update in the frame buffer
 /***************************************************************************/
 
-Screen::Error Screen::get_error( void )
+template <class Panel>
+typename Screen_panel<Panel>::Error Screen_panel<Panel>::get_error( void )
 {
     DENTER(); //Trace Enter
     ///--------------------------------------------------------------------------
@@ -1471,6 +1974,117 @@ Screen::Error Screen::get_error( void )
     return this -> g_error_code ;	//OK
 }	//end public getter: get_pending | void |
 
+/***************************************************************************/
+//!	@brief public getter
+//!	get_frame_buffer_height | void |
+/***************************************************************************/
+//! @return int | sprites in height of the frame buffer in the current rotation and font
+//!	@details
+//! \n Display height over glyph height in landscape, display width over glyph height in portrait
+/***************************************************************************/
+
+template <class Panel>
+inline int Screen_panel<Panel>::get_frame_buffer_height( void )
+{
+    ///--------------------------------------------------------------------------
+    ///	RETURN
+    ///--------------------------------------------------------------------------
+    return this -> g_frame_buffer_height;
+}	//end public getter: get_frame_buffer_height | void |
+
+/***************************************************************************/
+//!	@brief public getter
+//!	get_frame_buffer_width | void |
+/***************************************************************************/
+//! @return int | sprites in width of the frame buffer in the current rotation and font
+//!	@details
+//! \n Display width over glyph width in landscape, display height over glyph width in portrait
+/***************************************************************************/
+
+template <class Panel>
+inline int Screen_panel<Panel>::get_frame_buffer_width( void )
+{
+    ///--------------------------------------------------------------------------
+    ///	RETURN
+    ///--------------------------------------------------------------------------
+    return this -> g_frame_buffer_width;
+}	//end public getter: get_frame_buffer_width | void |
+
+/***************************************************************************/
+//!	@brief public getter
+//!	get_font | void |
+/***************************************************************************/
+//! @return Font | font of the registry in use
+/***************************************************************************/
+
+template <class Panel>
+inline typename Screen_panel<Panel>::Font Screen_panel<Panel>::get_font( void )
+{
+    ///--------------------------------------------------------------------------
+    ///	RETURN
+    ///--------------------------------------------------------------------------
+    return this -> g_font;
+}	//end public getter: get_font | void |
+
+/***************************************************************************/
+//!	@brief public getter
+//!	get_font_rows | Font |
+/***************************************************************************/
+//! @param font | Font | font of the registry
+//! @return const uint8_t * | glyph table of the font by row. nullptr if the font is not in the registry
+//!	@details
+//! \n Glyph c, row th is at (c -ASCII_START) *height +th. A byte per row, LSB is the left pixel
+/***************************************************************************/
+
+template <class Panel>
+inline const uint8_t *Screen_panel<Panel>::get_font_rows( Font font )
+{
+    ///--------------------------------------------------------------------------
+    ///	CHECK
+    ///--------------------------------------------------------------------------
+    //If: font is not in the registry
+    if (font >= Font::NUM_FONTS)
+    {
+        return nullptr;
+    }
+    ///--------------------------------------------------------------------------
+    ///	RETURN
+    ///--------------------------------------------------------------------------
+    return Screen_panel::g_font_metrics[ font ].row_ptr;
+}	//end public getter: get_font_rows | Font |
+
+/***************************************************************************/
+//!	@brief public getter
+//!	get_glyph_cache_hits | void |
+/***************************************************************************/
+//! @return uint32_t | characters found already expanded in the glyph cache since init
+/***************************************************************************/
+
+template <class Panel>
+inline uint32_t Screen_panel<Panel>::get_glyph_cache_hits( void )
+{
+    ///--------------------------------------------------------------------------
+    ///	RETURN
+    ///--------------------------------------------------------------------------
+    return this -> g_glyph_cache_hits;
+}	//end public getter: get_glyph_cache_hits | void |
+
+/***************************************************************************/
+//!	@brief public getter
+//!	get_glyph_cache_misses | void |
+/***************************************************************************/
+//! @return uint32_t | characters expanded since init because the glyph cache didn't have them
+/***************************************************************************/
+
+template <class Panel>
+inline uint32_t Screen_panel<Panel>::get_glyph_cache_misses( void )
+{
+    ///--------------------------------------------------------------------------
+    ///	RETURN
+    ///--------------------------------------------------------------------------
+    return this -> g_glyph_cache_misses;
+}	//end public getter: get_glyph_cache_misses | void |
+
     /*********************************************************************************************************************************************************
     **********************************************************************************************************************************************************
     **	PUBLIC METHODS
@@ -1485,9 +2099,17 @@ Screen::Error Screen::get_error( void )
 //! @details
 //!	FSM that synchronize the frame buffer with the display using the driver
 //!	The low level driver exposes control steps used by the high level frame buffer driver
+//!	Find the sprites to be updated and register them in the driver sprite queue until the queue is full
+//!	Oldest first takes them from the dirty FIFO in the order they were marked. Raster takes them from the dirty bitmap in raster order from the scan position
+//!	Adjacent sprites to be updated are merged in a single address window by the flush planner
+//!	Then execute a step of the driver FSM. The driver sends queued sprites back to back
+//!	Backpressure: a window is left pending if the queue is full or if the next pixel buffer is still being sent
+//!	Pixel buffers are used in rotation. The next window is rendered while the driver sends the previous ones
+//!	Blink. When the driver is idle and half a period has elapsed, the inversion is toggled. A command, no pixels
 /***************************************************************************/
 
-bool Screen::update( void )
+template <class Panel>
+bool Screen_panel<Panel>::update( void )
 {
     DENTER();
     //----------------------------------------------------------------
@@ -1508,72 +2130,65 @@ bool Screen::update( void )
     //While: the Screen FSM is allowed to run
     while (f_continue == true)
     {
-        DPRINT("exe: %3d | w: %5d | h: %5d | cnt: %3d\n", status.phase, status.scan_w, status.scan_h, status.cnt );
-        //If: I'm scanning for the next sprite to be updated
-        if (status.phase == Fsm_state::SCAN_SPRITE)
+        DPRINT("exe: w: %5d | h: %5d |\n", status.scan_w, status.scan_h );
+        //If: the driver can't accept more sprites
+        if (this -> Display::is_sprite_queue_full() == true)
         {
-            //Fetch the sprite
-            Frame_buffer_sprite sprite_tmp = this -> g_frame_buffer[ status.scan_h ][ status.scan_w ];
-
-            //If: there are no sprites to be updated in the frame buffer
-            if (this -> g_pending_cnt == 0)
+            //Backpressure. Let the driver send sprites
+            f_continue = false;
+        }
+        //If: there are no sprites to be updated in the frame buffer. Otherwise fetch the head of the dirty FIFO or jump to the next one in the dirty bitmap
+        else if (((this -> g_flush_order == Flush_order::OLDEST_FIRST)?(this -> find_oldest_dirty( status.scan_h, status.scan_w )):(this -> find_dirty( status.scan_h, status.scan_w ))) == true)
+        {
+            //I'm done. Don't waste time scanning
+            f_continue = false;
+        }
+        //If: the sprite found is to be updated
+        else
+        {
+            //Merge the adjacent sprites that are cheaper to send together in a single address window
+            Window window;
+            this -> plan_window( status.scan_h, status.scan_w, window );
+            //If: the window needs a pixel buffer and the driver has yet to send the pixel map rendered in the next buffer
+            if ((window.f_solid_color == false) && (this -> Display::is_sprite_buffer_used( this -> g_pixel_data[ this -> g_pixel_index ] ) == true))
             {
-                //I'm done. Don't wasete time scanning
+                //Backpressure. Leave the sprites pending and try again next update
                 f_continue = false;
             }
-            //If: the sprite indexed is to be updated
-            else if (sprite_tmp.f_update == true)
+            //If: the window can be registered
+            else
             {
-                //This sprite is not to be updated anymore
-                this -> g_frame_buffer[ status.scan_h ][ status.scan_w ].f_update = false;                
-                //If: pending counter is already zero
-                if ((Config::PEDANTIC_CHECKS == true) && (this -> g_pending_cnt == 0))
-                {
-                    //Algorithmic error
-                    this -> report_error( Screen::Error::PENDING_UNDERFLOW );
-                    DRETURN_ARG("ERR: %d\n", (int)this -> get_error() );
-                    return true;
-                }
-                //If: pending ccounter is valid
-                else
-                {
-                    //A pending sprite has been processed. This is the only code allowed to reduce workload
-                    this -> g_pending_cnt--;
-                }
-                DPRINT("REFRESH sprite h: %5d | w: %5d\n", status.scan_h, status.scan_w );
-                //Compute the pixel data and try to register the sprite for draw inside the display driver
-                int ret = this -> register_sprite( status.scan_h, status.scan_w );
+                DPRINT("REFRESH window h: %5d | w: %5d | size: %5d\n", status.scan_h, status.scan_w, window.size );
+                //Compute the pixel data and try to register the window for draw inside the display driver. Once registered, sprites in the window are no longer pending
+                int ret = this -> register_window( window );
                 //If: no sprites were registered but no errors occurred
                 if (ret == 0)
                 {
                     //Maybe a transparent sprite. Keep scanning for sprites
                 }
-                //If: sprite has been registered for draw
+                //If: window has been registered for draw
                 else if (ret > 0)
                 {
-                    //Begin execution of the driver FSM that sends pixel data to the screen
-                    status.phase = Fsm_state::SEND_SPRITE;
-                    //Count number of execution steps of the Display FSM
-                    status.cnt = 0;
+                    //The window is in the driver queue. Keep scanning for sprites
                 }
-                //If: failed to register sprite
+                //If: failed to register window
                 else
                 {
-                    DPRINT("ERR: Failed to register sprite\n");
+                    DPRINT("ERR: Failed to register window\n");
                     //Reset the update FSM
                     this -> init_fsm();
                     f_continue = false;
                 }
-
-                    //Move on to next sprite
+                //Sprites of a window in width are up to date. The next search starts after them
+                uint16_t advance = (window.f_vertical == true)?(1):(window.size);
                 //if: space to advance in width
-                if (status.scan_w < Config::FRAME_BUFFER_WIDTH -1)
+                if (status.scan_w +advance < this -> g_frame_buffer_width)
                 {
                     //Move cursor right
-                    status.scan_w++;
+                    status.scan_w += advance;
                 }
                 //If: space to advance in height
-                else if (status.scan_h < Config::FRAME_BUFFER_HEIGHT -1)
+                else if (status.scan_h < this -> g_frame_buffer_height -1)
                 {
                     //Get back left
                     status.scan_w = 0;
@@ -1587,84 +2202,25 @@ bool Screen::update( void )
                     status.scan_h = 0;
                     status.scan_w = 0;
                 }
-            }	//End If: the sprite indexed is to be updated
-            //If: I'm allowed to scan for more sprites
-            else if (status.cnt < Config::SPRITE_SCAN_LIMIT -1)
-            {
-                    //Move on to next sprite
-                //if: space to advance in width
-                if (status.scan_w < Config::FRAME_BUFFER_WIDTH -1)
-                {
-                    //Move cursor right
-                    status.scan_w++;
-                }
-                //If: space to advance in height
-                else if (status.scan_h < Config::FRAME_BUFFER_HEIGHT -1)
-                {
-                    //Get back left
-                    status.scan_w = 0;
-                    //Move down in height (2nd rank of frame buffer vector)
-                    status.scan_h++;
-                }
-                //if: scan limit
-                else
-                {
-                    //Get back to the top left
-                    status.scan_h = 0;
-                    status.scan_w = 0;
-                }
-                //I scanned a sprite
-                status.cnt++;
-            }	//End if: I'm allowed to scan for more sprites
-            //If: I reached the scan limit
-            else
-            {
-                //Reset the scan sprite counter
-                status.cnt = 0;
-                //I'm not allowed to scan more sprite. Release execution of the FSM
-                f_continue = false;
-            }	//End If: I reached the scan limit
-        }	//End If: I'm scanning for the next sprite to be updated
-        //If: I'm in the process of sending a sprite
-        else if (status.phase == Fsm_state::SEND_SPRITE)
-        {
-            DPRINT("Execute display FSM: step: %d\n", status.cnt);
-            //Have the display drivere execute a step in its internal FSM. FSMs are partitioned in logical and physical for future expansion of the screen class.
-            bool f_ret = this -> Display::update_sprite();
-            //if: Display driver FSM is busy
-            if (f_ret == true)
-            {
-                //A FSM step was executed
-                status.cnt++;
-                //Driver still has work to do. Do not scan for more work.
-            }
-            //if: Display driver FSM is IDLE
-            else
-            {
-                DPRINT("Display FSM IDLE\n");
-                //reset status counter
-                status.cnt = 0;
-                //Driver FSM is done. I can scan for more work, if any is available.
-                status.phase = Fsm_state::SCAN_SPRITE;
-            }
-            //
-            f_continue = false;
-        }	//End If: I'm in the process of sending a sprite
-        //If: Algorithmic error
-        else
-        {
-            //Reset the update FSM
-            this -> init_fsm();
-            f_continue = false;
-        }	//End If: Algorithmic error
+            }	//End If: the window can be registered
+        }	//End If: the sprite found is to be updated
     }	//End While: the Screen FSM is allowed to run
     //Write back FSM status
     this -> g_status = status;
+    //Have the display driver execute a step in its internal FSM. The driver sends the queued sprites back to back
+    bool f_busy = this -> Display::update_sprite();
+    //If: blink is active, the driver is idle and half a period has elapsed. The toggle never waits for the sprite queue
+    if ((this -> g_blink_period > 0) && (f_busy == false) && (this -> g_blink_timer.stop( Longan_nano::Chrono::Unit::milliseconds ) >= this -> g_blink_period /2))
+    {
+        this -> g_blink_timer.start();
+        this -> g_f_blink_phase = !this -> g_f_blink_phase;
+        this -> Display::set_invert( this -> g_f_invert != this -> g_f_blink_phase );
+    }
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-    DRETURN_ARG("exe: %3d | w: %5d | h: %5d | cnt: %3d\n", status.phase, status.scan_w, status.scan_h, status.cnt );
+    DRETURN_ARG("exe: w: %5d | h: %5d |\n", status.scan_w, status.scan_h );
     return false;	//OK
 }	//End public method: update | void
 
@@ -1680,7 +2236,8 @@ bool Screen::update( void )
 //! has it swapped for the "dest" palette color. All changed sprites are marked for update
 /***************************************************************************/
 
-int Screen::change_color( Color source, Color dest )
+template <class Panel>
+int Screen_panel<Panel>::change_color( Color source, Color dest )
 {
     DENTER_ARG("source: %d | dest: %d |\n", source, dest);
     //----------------------------------------------------------------
@@ -1703,10 +2260,10 @@ int Screen::change_color( Color source, Color dest )
     int ret = 0;
     bool f_sprite_changed;
     //For: scan height
-    for (uint8_t th = 0;th < Config::FRAME_BUFFER_HEIGHT;th++)
+    for (uint8_t th = 0;th < this -> g_frame_buffer_height;th++)
     {
         //For: scan width
-        for (uint8_t tw = 0;tw < Config::FRAME_BUFFER_WIDTH;tw++)
+        for (uint8_t tw = 0;tw < this -> g_frame_buffer_width;tw++)
         {
             //Fetch sprite
             sprite_tmp = this -> g_frame_buffer[ th ][ tw ];
@@ -1750,9 +2307,11 @@ int Screen::change_color( Color source, Color dest )
 //! @return int | >=0 Number of sprites changed | < 0 error |
 //! @details
 //!	\n Clear the screen by setting a solid color sprite to each element of the sprite frame buffer
+//! \n When most sprites change, the screen is sent as a single solid color window instead of sprite by sprite
 /***************************************************************************/
 
-int Screen::clear( void )
+template <class Panel>
+int Screen_panel<Panel>::clear( void )
 {
     DENTER();
 
@@ -1760,13 +2319,8 @@ int Screen::clear( void )
     //	VARS
     //----------------------------------------------------------------
 
-    //Fast counters
-    uint8_t th, tw;
     //Temp sprite
     Frame_buffer_sprite sprite_tmp;
-    //Number of sprites updated
-    int num_sprites_updated = 0;
-    int ret;
 
     //----------------------------------------------------------------
     //	BODY
@@ -1778,28 +2332,8 @@ int Screen::clear( void )
     //Set color. I don't care about background color
     sprite_tmp.background_color	= Color::BLACK;
     sprite_tmp.foreground_color	= Color::BLACK;
-    sprite_tmp.f_update			= true;
-    //For: each frame buffer row (height scan)
-    for (th = 0;th < Screen::Config::FRAME_BUFFER_HEIGHT;th++)
-    {
-        //For: each frame buffer col (width scan)
-        for (tw = 0;tw < Screen::Config::FRAME_BUFFER_WIDTH;tw++)
-        {
-            //Update the frame buffer with the new sprite if needed
-            ret = this -> update_sprite( th, tw, sprite_tmp );
-            //If: an error occurred
-            if ((Config::PEDANTIC_CHECKS == true) && (ret < 0))
-            {
-                DRETURN_ARG("ERR: Failed to update sprite\n");
-                return ret;
-            }
-            else
-            {
-                //Compute number of updated sprites	
-                num_sprites_updated += ret;
-            }
-        } //End For: each frame buffer col (width scan)
-    } //End For: each frame buffer row (height scan)
+    //Fill the frame buffer. The whole screen is sent as a single solid color window
+    int num_sprites_updated = this -> fill_screen( sprite_tmp );
 
     //----------------------------------------------------------------
     //	RETURN
@@ -1816,9 +2350,11 @@ int Screen::clear( void )
 //! @return int | >=0 Number of sprites changed | < 0 error |
 //! @details
 //!	\n Clear the screen by setting a solid color sprite to each element of the sprite frame buffer
+//! \n When most sprites change, the screen is sent as a single solid color window instead of sprite by sprite
 /***************************************************************************/
 
-int Screen::clear( Color color_tmp )
+template <class Panel>
+int Screen_panel<Panel>::clear( Color color_tmp )
 {
     DENTER_ARG("color: %d\n", (int)color_tmp);
     //----------------------------------------------------------------
@@ -1826,7 +2362,7 @@ int Screen::clear( Color color_tmp )
     //----------------------------------------------------------------
     
     //If: palette index outside the palette
-    if (color_tmp >= (Color)Screen::Config::PALETTE_SIZE)
+    if (color_tmp >= (Color)Screen_panel::Config::PALETTE_SIZE)
     {
         DRETURN_ARG("ERR: palette index outside the palette\n");
         return -1;
@@ -1836,14 +2372,8 @@ int Screen::clear( Color color_tmp )
     //	VARS
     //----------------------------------------------------------------
 
-    //Fast counters
-    uint8_t th, tw;
     //Temp sprite
     Frame_buffer_sprite sprite_tmp;
-    //Number of sprites updated
-    int num_sprites_updated = 0;
-    //Temp return
-    int ret;
 
     //----------------------------------------------------------------
     //	BODY
@@ -1855,28 +2385,8 @@ int Screen::clear( Color color_tmp )
     //Set color. I don't care about background color
     sprite_tmp.background_color	= color_tmp;
     sprite_tmp.foreground_color	= color_tmp;
-    sprite_tmp.f_update			= true;
-    //For: each frame buffer row (height scan)
-    for (th = 0;th < Screen::Config::FRAME_BUFFER_HEIGHT;th++)
-    {
-        //For: each frame buffer col (width scan)
-        for (tw = 0;tw < Screen::Config::FRAME_BUFFER_WIDTH;tw++)
-        {
-            //Update the frame buffer with the new sprite if needed
-            ret = this -> update_sprite( th, tw, sprite_tmp );
-            //If: an error occurred
-            if ((Config::PEDANTIC_CHECKS == true) && (ret < 0))
-            {
-                DRETURN_ARG("ERR: Failed to update sprite\n");
-                return ret;
-            }
-            else
-            {
-                //Compute number of updated sprites	
-                num_sprites_updated += ret;
-            }
-        } //End For: each frame buffer col (width scan)
-    } //End For: each frame buffer row (height scan)
+    //Fill the frame buffer. The whole screen is sent as a single solid color window
+    int num_sprites_updated = this -> fill_screen( sprite_tmp );
 
     //----------------------------------------------------------------
     //	RETURN
@@ -1901,7 +2411,8 @@ int Screen::clear( Color color_tmp )
 //! \n Mark the sprite for update if needs to be
 /***************************************************************************/
 
-int Screen::print( int origin_h, int origin_w, char c, Color background, Color foreground )
+template <class Panel>
+int Screen_panel<Panel>::print( int origin_h, int origin_w, char c, Color background, Color foreground )
 {
     DENTER_ARG("h: %5d, w: %5d, c: %d %d\n", origin_h, origin_w, (int)background, (int)foreground);
     //----------------------------------------------------------------
@@ -1909,7 +2420,7 @@ int Screen::print( int origin_h, int origin_w, char c, Color background, Color f
     //----------------------------------------------------------------
 
     //If: character is outside the ascii sprite table
-    if ((origin_h < 0) || (origin_h >= Config::FRAME_BUFFER_HEIGHT) || (origin_w < 0) || (origin_w >= Config::FRAME_BUFFER_WIDTH))
+    if ((origin_h < 0) || (origin_h >= this -> g_frame_buffer_height) || (origin_w < 0) || (origin_w >= this -> g_frame_buffer_width))
     {
         DRETURN_ARG("ERR: out of the sprite table\n");
         return -1;    //FAIL
@@ -1939,8 +2450,6 @@ int Screen::print( int origin_h, int origin_w, char c, Color background, Color f
     //Use default background and foreground colors
     sprite_tmp.background_color = background;
     sprite_tmp.foreground_color = foreground;
-    //Mark this sprite for update
-    sprite_tmp.f_update = true;            
 
     //----------------------------------------------------------------
     //	BODY
@@ -1971,7 +2480,8 @@ int Screen::print( int origin_h, int origin_w, char c, Color background, Color f
 //! \n Print a character on screen using default background color but a user defined foreground color
 /***************************************************************************/
 
-inline int Screen::print( int origin_h, int origin_w, char c, Color foreground )
+template <class Panel>
+inline int Screen_panel<Panel>::print( int origin_h, int origin_w, char c, Color foreground )
 {
     DENTER();
     //----------------------------------------------------------------
@@ -2001,7 +2511,8 @@ inline int Screen::print( int origin_h, int origin_w, char c, Color foreground )
 //! \n uses default background and foreground colors
 /***************************************************************************/
 
-inline int Screen::print( int origin_h, int origin_w, char c )
+template <class Panel>
+inline int Screen_panel<Panel>::print( int origin_h, int origin_w, char c )
 {
     DENTER();
     //----------------------------------------------------------------
@@ -2034,7 +2545,8 @@ inline int Screen::print( int origin_h, int origin_w, char c )
 //! \n String must be \0 terminated
 /***************************************************************************/
 
-int Screen::print( int origin_h, int origin_w, const char *str, Color background, Color foreground )
+template <class Panel>
+int Screen_panel<Panel>::print( int origin_h, int origin_w, const char *str, Color background, Color foreground )
 {
     DENTER_ARG("h: %5d, w: %5d, c: %p %s\n", origin_h, origin_w, str, str);
     //----------------------------------------------------------------
@@ -2042,7 +2554,7 @@ int Screen::print( int origin_h, int origin_w, const char *str, Color background
     //----------------------------------------------------------------
     
     //If: first character is outside the ascii sprite table
-    if ((origin_h < 0) || (origin_h >= Config::FRAME_BUFFER_HEIGHT) || (origin_w < 0) || (origin_w >= Config::FRAME_BUFFER_WIDTH))
+    if ((origin_h < 0) || (origin_h >= this -> g_frame_buffer_height) || (origin_w < 0) || (origin_w >= this -> g_frame_buffer_width))
     {
         DRETURN_ARG("ERR: out of the sprite table %5d %5d\n", origin_h, origin_w);
         return -1;	//FAIL
@@ -2067,7 +2579,6 @@ int Screen::print( int origin_h, int origin_w, const char *str, Color background
     //Temp sprite
     Frame_buffer_sprite sprite_tmp;
     //Initialize colors
-    sprite_tmp.f_update = true;
     sprite_tmp.background_color = background;
     sprite_tmp.foreground_color = foreground;
     
@@ -2081,7 +2592,7 @@ int Screen::print( int origin_h, int origin_w, const char *str, Color background
     uint8_t tw = origin_w;
     int ret;
     //While: I'm allowed to print, I didn't exceed the string size, and I didn't exceed the screen position
-    while ((str[t] != '\0') && (tw < Config::FRAME_BUFFER_WIDTH))
+    while ((str[t] != '\0') && (tw < this -> g_frame_buffer_width))
     {
         //Compute sprite ascii char
         sprite_tmp.sprite_index = str[t];
@@ -2136,7 +2647,8 @@ int Screen::print( int origin_h, int origin_w, const char *str, Color background
 //! \n wrapper for more general print string function
 /***************************************************************************/
 
-inline int Screen::print( int origin_h, int origin_w, const char *str, Color foreground )
+template <class Panel>
+inline int Screen_panel<Panel>::print( int origin_h, int origin_w, const char *str, Color foreground )
 {
     DENTER();   //Trace enter
     //----------------------------------------------------------------
@@ -2167,7 +2679,8 @@ inline int Screen::print( int origin_h, int origin_w, const char *str, Color for
 //! \n wrapper for more general print string function
 /***************************************************************************/
 
-inline int Screen::print( int origin_h, int origin_w, const char *str )
+template <class Panel>
+inline int Screen_panel<Panel>::print( int origin_h, int origin_w, const char *str )
 {
     DENTER();   //Trace enter
     //----------------------------------------------------------------
@@ -2204,7 +2717,8 @@ inline int Screen::print( int origin_h, int origin_w, const char *str )
 //! \n The format also specifies full number or enginnering format
 /***************************************************************************/
 
-int Screen::print( int origin_h, int origin_w, int num, Color background, Color foreground )
+template <class Panel>
+int Screen_panel<Panel>::print( int origin_h, int origin_w, int num, Color background, Color foreground )
 {
     DENTER_ARG("NUM: %d\n", num);   //Trace enter
 
@@ -2221,7 +2735,7 @@ int Screen::print( int origin_h, int origin_w, int num, Color background, Color
         return -1;    //FAIL
     }
     //If: height fully outside screen
-    if ((origin_h < 0) || (origin_h >= Config::FRAME_BUFFER_HEIGHT))
+    if ((origin_h < 0) || (origin_h >= this -> g_frame_buffer_height))
     {
         DRETURN_ARG("ERR: Height out of range: %d\n", origin_h);
         return -1;
@@ -2233,14 +2747,14 @@ int Screen::print( int origin_h, int origin_w, int num, Color background, Color
     uint8_t stop_w = ((format_tmp.align == Format_align::ADJ_LEFT)?(origin_w +format_tmp.size -1):(origin_w));
     DPRINT("start_w: %3d | stop_w: %3d\n", start_w, stop_w );
     //If: width fully outside screen in right adjust
-    if ( (stop_w < 0) || (start_w >= Config::FRAME_BUFFER_WIDTH) )
+    if ( (stop_w < 0) || (start_w >= this -> g_frame_buffer_width) )
     {
         DRETURN_ARG("ERR: Width out of range\n");
         return -1;
     }
     //Clip the start and stop position to be inside the screen
     start_w = ((start_w < 0)?(0):(start_w));
-    stop_w = ((stop_w >= Config::FRAME_BUFFER_WIDTH)?(Config::FRAME_BUFFER_WIDTH -1):(stop_w));
+    stop_w = ((stop_w >= this -> g_frame_buffer_width)?(this -> g_frame_buffer_width -1):(stop_w));
 
     //----------------------------------------------------------------
     //	NUM -> STRING
@@ -2295,7 +2809,6 @@ int Screen::print( int origin_h, int origin_w, int num, Color background, Color
     //Build temporary sprite
     sprite_tmp.background_color = background;
     sprite_tmp.foreground_color = foreground;
-    sprite_tmp.f_update = true;
     //If: number is too big
     if (num_digit > format_tmp.size)
     {
@@ -2322,7 +2835,7 @@ int Screen::print( int origin_h, int origin_w, int num, Color background, Color
         return num_changed_sprites;
     }
     //If: number partially outside screen in left adjust
-    else if ( (format_tmp.align == Format_align::ADJ_LEFT) && ((origin_w < 0) || ((origin_w +num_digit -1) >= Config::FRAME_BUFFER_WIDTH)) )
+    else if ( (format_tmp.align == Format_align::ADJ_LEFT) && ((origin_w < 0) || ((origin_w +num_digit -1) >= this -> g_frame_buffer_width)) )
     {
         //Print the invalid number character to show the user the number has no meaning
         sprite_tmp.sprite_index = '#';
@@ -2347,7 +2860,7 @@ int Screen::print( int origin_h, int origin_w, int num, Color background, Color
         return num_changed_sprites;
     }
     //If: number partially outside screen in right adjust
-    else if ( (format_tmp.align == Format_align::ADJ_RIGHT) && ((origin_w -num_digit +1 < 0) || (origin_w >= Config::FRAME_BUFFER_WIDTH)) )
+    else if ( (format_tmp.align == Format_align::ADJ_RIGHT) && ((origin_w -num_digit +1 < 0) || (origin_w >= this -> g_frame_buffer_width)) )
     {
         //Print the invalid number character to show the user the number has no meaning
         sprite_tmp.sprite_index = '#';
@@ -2487,7 +3000,8 @@ int Screen::print( int origin_h, int origin_w, int num, Color background, Color
 //!	\n Print a number on screen. Overload with default background.
 /***************************************************************************/
 
-inline int Screen::print( int origin_h, int origin_w, int num, Color foreground )
+template <class Panel>
+inline int Screen_panel<Panel>::print( int origin_h, int origin_w, int num, Color foreground )
 {
     DENTER_ARG("Num: %d\n", num );
     //----------------------------------------------------------------
@@ -2511,7 +3025,8 @@ inline int Screen::print( int origin_h, int origin_w, int num, Color foreground
 //!	\n Print a number on screen. Overload with default background and foreground
 /***************************************************************************/
 
-inline int Screen::print( int origin_h, int origin_w, int num )
+template <class Panel>
+inline int Screen_panel<Panel>::print( int origin_h, int origin_w, int num )
 {
     DENTER_ARG("Num: %d\n", num );
     //----------------------------------------------------------------
@@ -2533,7 +3048,8 @@ inline int Screen::print( int origin_h, int origin_w, int num )
 //! \n There are ery few graphics sprite as they ar meant for progress bars and little more
 /***************************************************************************/
 
-int Screen::paint( int origin_h, int origin_w, Color color )
+template <class Panel>
+int Screen_panel<Panel>::paint( int origin_h, int origin_w, Color color )
 {
     DENTER_ARG("H: %d, W: %d, color index: %d\n", origin_h, origin_w, (int)color );
     //----------------------------------------------------------------
@@ -2547,13 +3063,13 @@ int Screen::paint( int origin_h, int origin_w, Color color )
         return -1;    //FAIL
     }
     //If: height fully outside screen
-    if ((origin_h < 0) || (origin_h >= Config::FRAME_BUFFER_HEIGHT))
+    if ((origin_h < 0) || (origin_h >= this -> g_frame_buffer_height))
     {
         DRETURN_ARG("ERR: Height out of range: %d\n", origin_h);
         return -1;
     }
     //If: width fully outside screen
-    if ((origin_w < 0) || (origin_w >= Config::FRAME_BUFFER_WIDTH))
+    if ((origin_w < 0) || (origin_w >= this -> g_frame_buffer_width))
     {
         DRETURN_ARG("ERR: Height out of range: %d\n", origin_w);
         return -1;
@@ -2569,7 +3085,6 @@ int Screen::paint( int origin_h, int origin_w, Color color )
     sprite_tmp.sprite_index = Config::SPRITE_BACKGROUND;
     sprite_tmp.background_color = color;
     sprite_tmp.foreground_color = color;
-    sprite_tmp.f_update = true;
 
     //----------------------------------------------------------------
     //	Update Frame Buffer
@@ -2587,799 +3102,2446 @@ int Screen::paint( int origin_h, int origin_w, Color color )
 
 /***************************************************************************/
 //!	@brief public method
-//!	print_err | int | int |
+//!	register_tile | int | int | const Tile<LENGTH> & |
 /***************************************************************************/
-//!	@param origin_h | int | height position of the sprite
-//!	@param origin_w | int | width position of the sprite
-//! @return int16_t | >=0 Number of sprites changed | < 0 error |
+//!	@param origin_h | int | height position of the first sprite
+//!	@param origin_w | int | width position of the first sprite
+//!	@param tile | const Tile<LENGTH> & | string pre-rendered by the compiler. constexpr tiles are stored in flash
+//! @return int | >=0 Number of sprites covered by the tile | < 0 error |
 //! @details
-//!	\n print a char inside the sprite frame buffer and mark it for update if needs to be
-//! \n use default background
-//! \n wrapper for more general print string function
+//!	\n The Display driver sends the tile in one address window. The DMA reads the pixels in place, nothing is rendered at runtime
+//! \n The sprites under the tile become transparent. They are not drawn again until something is printed over them
+//! \n The tile must lay inside the screen. Not available in portrait, with fonts other than the default and over a rotated scroll area
+//! \n Example: static constexpr Screen::Tile<5> g_tile_title( "Hello", Screen::color( 0, 0, 0 ), Screen::color( 255, 255, 0 ) );
 /***************************************************************************/
 
-int Screen::print_err( int origin_h, int origin_w )
+template <class Panel>
+template <int LENGTH>
+int Screen_panel<Panel>::register_tile( int origin_h, int origin_w, const Tile<LENGTH> &tile )
 {
-    DENTER();   //Trace enter
+    DENTER_ARG("H: %d, W: %d, length: %d\n", origin_h, origin_w, LENGTH );
     //----------------------------------------------------------------
-    //	BODY
+    //	CHECK
     //----------------------------------------------------------------
 
-    //more general print string function
-    int num_changed_sprites;
-    //If: OK
-    if (this -> g_error_code == 0)
+    //If: portrait. Tiles are rendered by row
+    if ((this -> g_rotation == Rotation::PORTRAIT) || (this -> g_rotation == Rotation::PORTRAIT_FLIPPED))
     {
-        num_changed_sprites = print( origin_h, origin_w, "OK", Color::GREEN );
+        DRETURN_ARG("ERR: no tiles in portrait\n");
+        return -1;
     }
-    //If: ERR
-    else
+    //If: not the default font. Tiles are rendered with its glyphs
+    if (this -> g_font != (Font)Config::FONT_DEFAULT)
     {
-        num_changed_sprites = print( origin_h, origin_w, "ERR", Color::RED );
-        this -> set_format(2, Format_align::ADJ_LEFT, Format_format::NUM );
-        num_changed_sprites += print( origin_h, origin_w +3, (int)this -> g_error_code, Color::RED );
+        DRETURN_ARG("ERR: tiles are in the default font\n");
+        return -1;
     }
-    
-    //----------------------------------------------------------------
-    //	RETURN
-    //----------------------------------------------------------------
+    //If: the tile is not inside the screen
+    if ((LENGTH < 1) || (origin_h < 0) || (origin_h >= this -> g_frame_buffer_height) || (origin_w < 0) || (origin_w +LENGTH > this -> g_frame_buffer_width))
+    {
+        DRETURN_ARG("ERR: bad tile H: %d, W: %d\n", origin_h, origin_w );
+        return -1;
+    }
+    //If: the tile overlaps a rotated scroll area. The memory columns are not where the tile is
+    if ((this -> g_scroll_shift != 0) && (origin_w < this -> g_scroll_index_w +this -> g_scroll_size) && (origin_w +LENGTH > this -> g_scroll_index_w))
+    {
+        DRETURN_ARG("ERR: tile over the rotated scroll area\n");
+        return -1;
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: the Display driver has no room for the tile. Retry later
+    if (this -> Display::register_sprite( origin_h *Config::SPRITE_HEIGHT, origin_w *Config::SPRITE_WIDTH, Config::SPRITE_HEIGHT, LENGTH *Config::SPRITE_WIDTH, tile.pixel ) < 0)
+    {
+        DRETURN_ARG("ERR: sprite queue full\n");
+        return -1;
+    }
+    //For: each sprite under the tile
+    for (int tw = origin_w;tw < origin_w +LENGTH;tw++)
+    {
+        //The tile covers the sprite. It is not waiting for update anymore
+        this -> g_frame_buffer[ origin_h ][ tw ].sprite_index = Config::SPRITE_TRANSPARENT;
+        this -> clear_dirty( origin_h, tw );
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return LENGTH;
+}	//End public method: register_tile | int | int | const Tile<LENGTH> & |
+
+/***************************************************************************/
+//!	@brief public method
+//!	print_err | int | int |
+/***************************************************************************/
+//!	@param origin_h | int | height position of the sprite
+//!	@param origin_w | int | width position of the sprite
+//! @return int16_t | >=0 Number of sprites changed | < 0 error |
+//! @details
+//!	\n print a char inside the sprite frame buffer and mark it for update if needs to be
+//! \n use default background
+//! \n wrapper for more general print string function
+/***************************************************************************/
+
+template <class Panel>
+int Screen_panel<Panel>::print_err( int origin_h, int origin_w )
+{
+    DENTER();   //Trace enter
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //more general print string function
+    int num_changed_sprites;
+    //If: OK
+    if (this -> g_error_code == 0)
+    {
+        num_changed_sprites = print( origin_h, origin_w, "OK", Color::GREEN );
+    }
+    //If: ERR
+    else
+    {
+        num_changed_sprites = print( origin_h, origin_w, "ERR", Color::RED );
+        this -> set_format(2, Format_align::ADJ_LEFT, Format_format::NUM );
+        num_changed_sprites += print( origin_h, origin_w +3, (int)this -> g_error_code, Color::RED );
+    }
+    
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
     DRETURN();  //Trace enter
     return num_changed_sprites;
 }	//End public method: print_err | int | int |
 
-    /*********************************************************************************************************************************************************
-    **********************************************************************************************************************************************************
-    **	PRIVATE INIT
-    **********************************************************************************************************************************************************
-    *********************************************************************************************************************************************************/
-
 /***************************************************************************/
-//!	@brief private init
-//!	init_class_vars | void |
+//!	@brief public method
+//!	set_scroll_area | int | int |
 /***************************************************************************/
-//! @return bool | false = OK | true = ERR
+//!	@param origin_w | int | first sprite column of the scroll area
+//!	@param size_w | int | number of sprite columns in the scroll area
+//! @return int | >=0 Number of sprites marked for update | < 0 error |
 //! @details
-//!	\n Initialize the class vars
+//!	\n Define the columns of sprites rotated by the hardware scroll. Blocking until the driver sends its queue
+//! \n The panel is landscape. The ST7735S vertical scroll moves the image in width, so the scroll area is a band of columns
+//! \n Not available in portrait
+//! \n If the previous area was rotated, its sprites are drawn again at their memory columns
 /***************************************************************************/
 
-bool Screen::init_class_vars( void )
+template <class Panel>
+int Screen_panel<Panel>::set_scroll_area( int origin_w, int size_w )
 {
+    DENTER_ARG("W: %d, size: %d\n", origin_w, size_w );
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: the area is not inside the screen
+    if ((origin_w < 0) || (size_w < 1) || (origin_w +size_w > this -> g_frame_buffer_width))
+    {
+        DRETURN_ARG("ERR: bad scroll area W: %d, size: %d\n", origin_w, size_w );
+        return -1;
+    }
+    //If: portrait. The display scrolls along the height of the screen
+    if ((this -> g_rotation == Rotation::PORTRAIT) || (this -> g_rotation == Rotation::PORTRAIT_FLIPPED))
+    {
+        DRETURN_ARG("ERR: no scroll in portrait\n");
+        return -1;
+    }
+
     //----------------------------------------------------------------
     //	VARS
     //----------------------------------------------------------------
 
+    //Number of sprites marked for update
+    int num_sprites_updated = 0;
+
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    //Initialize error code
-    this -> g_error_code = Screen::Error::OK;
-    //Initialize default number format
-    this -> set_format( Screen::Config::FRAME_BUFFER_WIDTH, Format_align::ADJ_LEFT, Format_format::NUM, 0 );
+    //If: the old area is rotated. The memory columns go back in place
+    if (this -> g_scroll_shift != 0)
+    {
+        //For: each sprite of the old area
+        for (uint16_t th = 0;th < this -> g_frame_buffer_height;th++)
+        {
+            for (uint16_t tw = this -> g_scroll_index_w;tw < this -> g_scroll_index_w +this -> g_scroll_size;tw++)
+            {
+                num_sprites_updated += this -> mark_sprite( th, tw );
+            }
+        }
+    }
+    //Define the area in the display. Windows already in the driver queue are sent with the old rotation
+    if (this -> Display::set_scroll_area( origin_w *this -> g_sprite_width, size_w *this -> g_sprite_width ) == true)
+    {
+        this -> report_error( Error::REGISTER_SPRITE_FAIL );
+        DRETURN_ARG("ERR: failed to set the scroll area\n");
+        return -1;
+    }
+    this -> g_scroll_index_w = origin_w;
+    this -> g_scroll_size = size_w;
+    this -> g_scroll_shift = 0;
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-
-    return false;	//OK
-}	//End private init: init_class_vars | void |
+    DRETURN();
+    return num_sprites_updated;
+}	//End public method: set_scroll_area | int | int |
 
 /***************************************************************************/
-//!	@brief private init
-//!	init_frame_buffer | void
+//!	@brief public method
+//!	scroll | int |
 /***************************************************************************/
-//! @return bool | false = OK | true = ERR
+//!	@param shift_w | int | sprite columns. Positive moves the content left, negative moves the content right
+//! @return int | >=0 Number of sprites marked for update | < 0 error |
 //! @details
-//!	\n Initialize the sprite frame buffer
+//!	\n Scroll the content of the scroll area. Blocking until the driver sends its queue
+//! \n The display rotates its memory, the sprites that stay on screen are not sent again
+//! \n The frame buffer is rotated to match the screen. Exposed columns are cleared to the default background and drawn
+//! \n They show the columns that scrolled out until they are drawn
 /***************************************************************************/
 
-bool Screen::init_frame_buffer()
+template <class Panel>
+int Screen_panel<Panel>::scroll( int shift_w )
 {
-    DENTER();
+    DENTER_ARG("shift: %d\n", shift_w );
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: the scroll area is not defined
+    if (this -> g_scroll_size == 0)
+    {
+        DRETURN_ARG("ERR: no scroll area\n");
+        return -1;
+    }
+
     //----------------------------------------------------------------
     //	VARS
     //----------------------------------------------------------------
 
-    //Fast counter
-    uint16_t tw, th;
-    //Temp sprite
+    //Columns of the area
+    uint16_t size = this -> g_scroll_size;
+    //Rotation to the left of the content
+    uint16_t left = (uint16_t)(((shift_w %(int)size) +(int)size) %(int)size);
+    //Columns that enter the area
+    uint16_t exposed = (uint16_t)((shift_w < 0)?(-shift_w):(shift_w));
+    exposed = (exposed < size)?(exposed):(size);
+    //First exposed column
+    uint16_t exposed_w = (shift_w > 0)?(this -> g_scroll_index_w +size -exposed):(this -> g_scroll_index_w);
+    //Row of the area before the rotation
+    Frame_buffer_sprite row_tmp[ Config::FRAME_BUFFER_MAX_WIDTH ];
+    //Exposed sprite
     Frame_buffer_sprite sprite_tmp;
+    sprite_tmp.sprite_index		= Config::SPRITE_BACKGROUND;
+    sprite_tmp.background_color	= this -> g_default_background_color;
+    sprite_tmp.foreground_color	= this -> g_default_background_color;
+    //Dirty bits of the area within a row of the dirty bitmap
+    uint32_t dirty_mask = ((size >= Config::DIRTY_WORD_BITS)?(~(uint32_t)0):(((uint32_t)1 << size) -1)) << this -> g_scroll_index_w;
+    //Number of sprites marked for update
+    int num_sprites_updated = 0;
 
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    //Force update of this sprite
-    sprite_tmp.f_update = true;
-    //Initialize sprite code to FULL BACKGROUND sprite
-    sprite_tmp.sprite_index = Config::SPRITE_BLACK;
-    //Initialize colors to defaults Color black and white
-    sprite_tmp.background_color = Screen::Color::BLACK;
-    sprite_tmp.foreground_color = Screen::Color::WHITE;
-    show_frame_sprite( sprite_tmp );
-    //For: each frame buffer row (height scan)
-    for (th = 0;th < Screen::Config::FRAME_BUFFER_HEIGHT;th++)
+    //If: nothing to scroll
+    if (exposed == 0)
     {
-        //For: each frame buffer col (width scan)
-        for (tw = 0;tw < Screen::Config::FRAME_BUFFER_WIDTH;tw++)
+        DRETURN();
+        return 0;
+    }
+    //For: each row of the frame buffer
+    for (uint16_t th = 0;th < this -> g_frame_buffer_height;th++)
+    {
+        //Frame buffer row of the area
+        Frame_buffer_sprite *row_ptr = &this -> g_frame_buffer[ th ][ this -> g_scroll_index_w ];
+        //Rotate the row to match the screen
+        for (uint16_t tw = 0;tw < size;tw++)
         {
-            //Save default sprite in the frame buffer
-            this -> g_frame_buffer[th][tw] = sprite_tmp;
-        } //End For: each frame buffer col (width scan)
-    } //End For: each frame buffer row (height scan)
-    //All sprites require update at the initialization
-    this -> g_pending_cnt = Config::FRAME_BUFFER_SIZE;
+            row_tmp[ tw ] = row_ptr[ tw ];
+        }
+        for (uint16_t tw = 0;tw < size;tw++)
+        {
+            row_ptr[ tw ] = row_tmp[ (tw +left) %size ];
+        }
+        //Rotate the dirty bits of the area the same way
+        uint32_t area = (this -> g_dirty_row[ th ] & dirty_mask) >> this -> g_scroll_index_w;
+        if (left > 0)
+        {
+            area = (area >> left) | (area << (size -left));
+        }
+        this -> g_dirty_row[ th ] = (this -> g_dirty_row[ th ] & ~dirty_mask) | ((area << this -> g_scroll_index_w) & dirty_mask);
+        //Sprites to be updated moved to other columns. Queue them in the dirty FIFO at their new place
+        area = this -> g_dirty_row[ th ] & dirty_mask;
+        while (area != 0)
+        {
+            this -> set_dirty( th, __builtin_ctz( area ) );
+            area &= area -1;
+        }
+        //For: each exposed column
+        for (uint16_t tw = exposed_w;tw < exposed_w +exposed;tw++)
+        {
+            //The sprite that scrolled out will never be drawn
+            this -> clear_dirty( th, tw );
+            //Clear the column. The memory column holds what scrolled out and must be drawn
+            this -> g_frame_buffer[ th ][ tw ] = sprite_tmp;
+            num_sprites_updated += this -> mark_sprite( th, tw );
+        }
+    }   //End For: each row of the frame buffer
+    //Rotate the memory of the display
+    this -> g_scroll_shift = (this -> g_scroll_shift +left) %size;
+    if (this -> Display::set_scroll( this -> g_scroll_shift *this -> g_sprite_width ) == true)
+    {
+        this -> report_error( Error::REGISTER_SPRITE_FAIL );
+        DRETURN_ARG("ERR: failed to scroll\n");
+        return -1;
+    }
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
     DRETURN();
-    return false;	//OK
-}	//End private init: init_frame_buffer | void
+    return num_sprites_updated;
+}	//End public method: scroll | int |
 
 /***************************************************************************/
-//!	@brief private init
-//!	init_default_colors | void |
+//!	@brief public method
+//!	set_rotation | Rotation |
 /***************************************************************************/
-//! @return void
+//!	@param rotation | Rotation | orientation of the screen
+//! @return bool | false = OK | true = ERR
 //! @details
-//!	\n Initialize the default background and foreground colors
+//!	\n Turn the screen. Blocking until the driver sends its queue
+//! \n Flipped rotations reprogram MADCTL of the display to turn the image upside down
+//! \n Portrait swaps the geometry of the frame buffer. The display stays landscape and each sprite is rendered turned a quarter
+//! \n using the glyphs stored by column, so a portrait sprite costs the same as a landscape one
+//! \n The content of the frame buffer is lost and the scroll area is cleared. The screen is cleared to black
 /***************************************************************************/
 
-inline bool Screen::init_default_colors( void )
+template <class Panel>
+bool Screen_panel<Panel>::set_rotation( Rotation rotation )
 {
-    DENTER();
+    DENTER_ARG("rotation: %d\n", (int)rotation );
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: bad rotation
+    if ((Config::PEDANTIC_CHECKS == true) && (rotation > Rotation::PORTRAIT_FLIPPED))
+    {
+        DRETURN_ARG("ERR: bad rotation\n");
+        return true;	//FAIL
+    }
+
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Return flag
+    bool f_ret = false;
+
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    //Initialize default colors
-    this -> g_default_background_color = Color::BLACK;
-    this -> g_default_foreground_color = Color::WHITE;
+    //Turn the display upside down for the flipped rotations. The display clears its scroll area
+    f_ret |= this -> Display::set_flip( (rotation == Rotation::LANDSCAPE_FLIPPED) || (rotation == Rotation::PORTRAIT_FLIPPED) );
+    this -> g_scroll_index_w = 0;
+    this -> g_scroll_size = 0;
+    this -> g_scroll_shift = 0;
+    //Swap the geometry of the frame buffer
+    this -> g_rotation = rotation;
+    this -> init_geometry();
+    //Restart from a black screen
+    f_ret |= this -> init_frame_buffer();
+    f_ret |= this -> init_fsm();
+    f_ret |= (this -> Display::register_sprite( 0, 0, Display::Config::HEIGHT, Display::Config::WIDTH, Display::color( 0x00, 0x00, 0x00 ) ) <= 0);
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
     DRETURN();
-    return false;	//OK
-}	//End private init: init_default_colors | void |
+    return f_ret;
+}	//End public method: set_rotation | Rotation |
 
 /***************************************************************************/
-//!	@brief private init
-//!	init_palette | void
+//!	@brief public method
+//!	set_invert | bool |
 /***************************************************************************/
+//!	@param f_invert | bool | false = normal colors | true = inverted colors
 //! @return bool | false = OK | true = ERR
 //! @details
-//!	\n initialize palette to default values
+//!	\n Invert the colors of the whole screen. Blocking until the driver sends its queue
+//! \n The panel inverts the pixels as they are shown. A command of a couple of bytes instead of a redraw of every sprite
+//! \n The frame buffer is not changed. With a blink active, the blink inverts the screen from this state
 /***************************************************************************/
 
-bool Screen::init_palette( void )
+template <class Panel>
+bool Screen_panel<Panel>::set_invert( bool f_invert )
 {
-    DENTER();
+    DENTER_ARG("invert: %d\n", f_invert );
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    //Use the CGA default palette (https://en.wikipedia.org/wiki/Color_Graphics_Adapter)
-    this -> g_palette[Screen::Color::BLACK]		= Longan_nano::Display::color( 0x00, 0x00, 0x00 );
-    this -> g_palette[Screen::Color::BLUE]		= Longan_nano::Display::color( 0x00, 0x00, 0xAA );
-    this -> g_palette[Screen::Color::GREEN] 	= Longan_nano::Display::color( 0x00, 0xAA, 0x00 );
-    this -> g_palette[Screen::Color::CYAN]		= Longan_nano::Display::color( 0x00, 0xAA, 0xAA );
-    this -> g_palette[Screen::Color::RED]		= Longan_nano::Display::color( 0xAA, 0x00, 0x00 );
-    this -> g_palette[Screen::Color::MAGENTA]	= Longan_nano::Display::color( 0xAA, 0x00, 0xAA );
-    this -> g_palette[Screen::Color::BROWN]		= Longan_nano::Display::color( 0xAA, 0x55, 0x00 );
-    this -> g_palette[Screen::Color::LGRAY]		= Longan_nano::Display::color( 0xAA, 0xAA, 0xAA );
-    this -> g_palette[Screen::Color::DGRAY]		= Longan_nano::Display::color( 0x55, 0x55, 0x55 );
-    this -> g_palette[Screen::Color::LBLUE]		= Longan_nano::Display::color( 0x55, 0x55, 0xFF );
-    this -> g_palette[Screen::Color::LGREEN]	= Longan_nano::Display::color( 0x55, 0xFF, 0x55 );
-    this -> g_palette[Screen::Color::LCYAN]		= Longan_nano::Display::color( 0x55, 0xFF, 0xFF );
-    this -> g_palette[Screen::Color::LRED]      = Longan_nano::Display::color( 0xFF, 0x55, 0x55 );
-    this -> g_palette[Screen::Color::LMAGENTA]	= Longan_nano::Display::color( 0xFF, 0x55, 0xFF );
-    this -> g_palette[Screen::Color::YELLOW]	= Longan_nano::Display::color( 0xFF, 0xFF, 0x55 );
-    this -> g_palette[Screen::Color::WHITE]		= Longan_nano::Display::color( 0xFF, 0xFF, 0xFF );
-    #ifdef DEBUG_ENABLE
-    {
-        DPRINT("TEST: %6x\n", Longan_nano::Display::color( 0xFF, 0xFF, 0xFF ));
-        this -> show_palette();
-    }
-    #endif
+    this -> g_f_invert = f_invert;
+    bool f_ret = this -> Display::set_invert( this -> g_f_invert != this -> g_f_blink_phase );
+
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
     DRETURN();
-    return false;	//OK
-}	//End private init: init_palette | void
+    return f_ret;
+}	//End public method: set_invert | bool |
 
 /***************************************************************************/
-//!	@brief private init
-//!	init_fsm | void |
+//!	@brief public method
+//!	set_blank | bool |
 /***************************************************************************/
+//!	@param f_blank | bool | false = show the screen | true = blank screen
 //! @return bool | false = OK | true = ERR
 //! @details
-//!	\n Initialize the update FSM machine
+//!	\n Turn the display off and on. Blocking until the driver sends its queue
+//! \n The frame buffer and the panel memory are kept. update keeps sending sprites while the screen is blank
+//! \n and the screen is shown up to date when it is turned on
 /***************************************************************************/
 
-bool Screen::init_fsm( void )
+template <class Panel>
+bool Screen_panel<Panel>::set_blank( bool f_blank )
 {
+    DENTER_ARG("blank: %d\n", f_blank );
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    //Start from top left
-    this -> g_status.scan_h = 0;
-    this -> g_status.scan_w = 0;
-    //IDLE state
-    this -> g_status.cnt = 0;
-    //Update should scan for the next sprite to be updated
-    this -> g_status.phase = Fsm_state::SCAN_SPRITE;
+    bool f_ret = this -> Display::set_blank( f_blank );
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-
-    return false;	//OK
-}	//End private init: init_fsm | void |
-
-    /*********************************************************************************************************************************************************
-    **********************************************************************************************************************************************************
-    **	PRIVATE SETTER
-    **********************************************************************************************************************************************************
-    *********************************************************************************************************************************************************/
+    DRETURN();
+    return f_ret;
+}	//End public method: set_blank | bool |
 
 /***************************************************************************/
-//!	@brief private setter
-//!	report_error | Error |
+//!	@brief public method
+//!	set_idle | bool |
 /***************************************************************************/
-//! @param error_code | Error | error code of the Screen Class
-//! @return no return
-//!	@details
-//! Method
+//!	@param f_idle | bool | false = full colors | true = idle mode, eight colors
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Dim the screen to the idle mode of the panel. Blocking until the driver sends its queue
+//! \n Only the MSB of each channel is shown. Palette colors that differ in the lower bits look the same
 /***************************************************************************/
 
-void Screen::report_error( Error error_code )
+template <class Panel>
+bool Screen_panel<Panel>::set_idle( bool f_idle )
 {
-    DENTER_ARG("ERR%d\n", (int)error_code ); //Trace Enter
-    ///--------------------------------------------------------------------------
-    ///	CHECK
-    ///--------------------------------------------------------------------------
+    DENTER_ARG("idle: %d\n", f_idle );
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
 
-    if ((Config::PEDANTIC_CHECKS == true) && (error_code >= Screen::Error::NUM_ERROR_CODES))
-    {
-        this -> g_error_code = Screen::Error::BAD_ERROR_CODE;
-    }
-    else
-    {
-        this -> g_error_code = error_code;
-    }
-    
-    ///--------------------------------------------------------------------------
-    ///	RETURN
-    ///--------------------------------------------------------------------------
-    DRETURN(); //Trace Return
-    return;
-}	//end private setter: report_error | Error |
+    bool f_ret = this -> Display::set_idle( f_idle );
 
-    /*********************************************************************************************************************************************************
-    **********************************************************************************************************************************************************
-    **	PRIVATE TESTERS
-    **********************************************************************************************************************************************************
-    *********************************************************************************************************************************************************/
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return f_ret;
+}	//End public method: set_idle | bool |
 
 /***************************************************************************/
-//!	@brief private tester
-//!	is_valid_char | char |
+//!	@brief public method
+//!	set_blink | int |
 /***************************************************************************/
-//! @return bool | false = INVALID | true =VALID
+//!	@param period_ms | int | period of the blink in milliseconds. 0 = stop the blink
+//! @return bool | false = OK | true = ERR
 //! @details
-//!	return true if the char is stored inside the ascii sprite table
+//!	\n Blink the whole screen by inverting its colors. An alert flash costs a command per toggle instead of a redraw
+//! \n update toggles the inversion every half period when the driver is idle. A busy driver delays the toggle
+//! \n Stopping the blink restores the inversion set by set_invert
 /***************************************************************************/
 
-inline bool Screen::is_valid_char( char c )
+template <class Panel>
+bool Screen_panel<Panel>::set_blink( int period_ms )
 {
+    DENTER_ARG("period: %d\n", period_ms );
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: bad period
+    if ((period_ms < 0) || (period_ms > 0xFFFF))
+    {
+        DRETURN_ARG("ERR: bad blink period\n");
+        return true;	//FAIL
+    }
+
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Return flag
+    bool f_ret = false;
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: the blink left the screen inverted
+    if (this -> g_f_blink_phase == true)
+    {
+        this -> g_f_blink_phase = false;
+        f_ret = this -> Display::set_invert( this -> g_f_invert );
+    }
+    this -> g_blink_period = (uint16_t)period_ms;
+    this -> g_blink_timer.start();
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return f_ret;
+}	//End public method: set_blink | int |
+
+/***************************************************************************/
+//!	@brief public method
+//!	set_flush_order | Flush_order |
+/***************************************************************************/
+//!	@param order | Flush_order | order in which update sends the sprites to be updated
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Oldest first sends the sprites in the order they were marked for update. A print waits at most for the sprites marked before it
+//! \n Raster sends them in raster order from the scan position. A sprite marked just behind the scan waits for all the others
+//! \n Both orders merge the adjacent sprites in windows. Sprites pending when the order changes are sent anyway
+//! \n Only oldest first keeps the dirty FIFO. Switching to it queues the pending sprites in raster order
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::set_flush_order( Flush_order order )
+{
+    DENTER_ARG("order: %d\n", (int)order );
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: bad order
+    if ((Config::PEDANTIC_CHECKS == true) && (order > Flush_order::RASTER))
+    {
+        DRETURN_ARG("ERR: bad flush order\n");
+        return true;	//FAIL
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: the order doesn't change. The dirty FIFO is kept
+    if (order == this -> g_flush_order)
+    {
+        DRETURN();
+        return false;	//OK
+    }
+    this -> g_flush_order = order;
+    //Empty the dirty FIFO
+    for (uint16_t th = 0;th < Config::FRAME_BUFFER_MAX_HEIGHT;th++)
+    {
+        this -> g_queued_row[ th ] = 0;
+    }
+    this -> g_dirty_fifo_head = 0;
+    this -> g_dirty_fifo_cnt = 0;
+    //If: oldest first. Queue the sprites already pending
+    if (order == Flush_order::OLDEST_FIRST)
+    {
+        //For: each row of the frame buffer
+        for (uint16_t th = 0;th < this -> g_frame_buffer_height;th++)
+        {
+            uint32_t row = this -> g_dirty_row[ th ];
+            //While: the row has sprites to be updated
+            while (row != 0)
+            {
+                uint16_t tw = __builtin_ctz( row );
+                row &= row -1;
+                this -> set_dirty( th, tw );
+            }
+        }
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return false;	//OK
+}	//End public method: set_flush_order | Flush_order |
+
+/***************************************************************************/
+//!	@brief public method
+//!	set_font | Font |
+/***************************************************************************/
+//!	@param font | Font | font of the registry
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Switch font. Blocking until the driver sends its queue
+//! \n The sprites take the size of the glyphs and the geometry of the frame buffer follows. e.g. FIXED_6X8 has 10x26 sprites in landscape
+//! \n Like set_rotation, the content of the frame buffer is lost and the scroll area is cleared. The screen is cleared to black
+//! \n The glyph cache is emptied. Tiles are rendered in the default font and are refused with the others
+//! \n NSIMSUN_8X16 is off by default, it returns an error unless NSIMSUN_8X16_ENABLE is set to true in Config. The flag sizes the pixel buffers and the glyph cache for its 16 pixel glyphs
+//! \n FIXED_6X8 returns an error when its frame buffer doesn't fit the dirty bitmap. FIXED_6X8_ENABLE
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::set_font( Font font )
+{
+    DENTER_ARG("font: %d\n", (int)font );
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: the font is not in the registry or not available on the panel
+    if ((font >= Font::NUM_FONTS) || ((font == Font::FIXED_6X8) && (Config::FIXED_6X8_ENABLE == false)) || ((font == Font::NSIMSUN_8X16) && (Config::NSIMSUN_8X16_ENABLE == false)))
+    {
+        DRETURN_ARG("ERR: bad font\n");
+        return true;	//FAIL
+    }
+    //If: the font is already in use
+    if (font == this -> g_font)
+    {
+        DRETURN_ARG("same font\n");
+        return false;	//OK
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    this -> g_font = font;
+    //Set the geometry of the new font and restart from a black screen. The driver queue is sent before the glyph cache is emptied
+    bool f_ret = this -> set_rotation( this -> g_rotation );
+    f_ret |= this -> init_glyph_cache();
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return f_ret;
+}	//End public method: set_font | Font |
+
+    /*********************************************************************************************************************************************************
+    **********************************************************************************************************************************************************
+    **	PRIVATE INIT
+    **********************************************************************************************************************************************************
+    *********************************************************************************************************************************************************/
+
+/***************************************************************************/
+//!	@brief private init
+//!	init_class_vars | void |
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Initialize the class vars
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::init_class_vars( void )
+{
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Initialize error code
+    this -> g_error_code = Screen_panel::Error::OK;
+    //Initialize default number format
+    this -> set_format( Screen_panel::Config::FRAME_BUFFER_WIDTH, Format_align::ADJ_LEFT, Format_format::NUM, 0 );
+    //Start rendering from the first pixel buffer
+    this -> g_pixel_index = 0;
+    //Landscape
+    this -> g_rotation = Rotation::LANDSCAPE;
+    //Default font
+    this -> g_font = (Font)Config::FONT_DEFAULT;
+    this -> init_geometry();
+    //No scroll area
+    this -> g_scroll_index_w = 0;
+    this -> g_scroll_size = 0;
+    this -> g_scroll_shift = 0;
+    //No effects
+    this -> g_f_invert = false;
+    this -> g_blink_period = 0;
+    this -> g_f_blink_phase = false;
+    //Send the sprites in raster order from the scan position
+    this -> g_flush_order = Flush_order::RASTER;
+    //Empty glyph cache
+    this -> init_glyph_cache();
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return false;	//OK
+}	//End private init: init_class_vars | void |
+
+/***************************************************************************/
+//!	@brief private init
+//!	init_frame_buffer | void
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Initialize the sprite frame buffer
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::init_frame_buffer()
+{
+    DENTER();
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Fast counter
+    uint16_t tw, th;
+    //Temp sprite
+    Frame_buffer_sprite sprite_tmp;
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //The display is cleared to black by init
+    //Initialize sprite code to FULL BACKGROUND sprite
+    sprite_tmp.sprite_index = Config::SPRITE_BLACK;
+    //Initialize colors to defaults Color black and white
+    sprite_tmp.background_color = Screen_panel::Color::BLACK;
+    sprite_tmp.foreground_color = Screen_panel::Color::WHITE;
+    show_frame_sprite( sprite_tmp );
+    //For: each frame buffer row (height scan)
+    for (th = 0;th < Config::FRAME_BUFFER_MAX_HEIGHT;th++)
+    {
+        //For: each frame buffer col (width scan)
+        for (tw = 0;tw < Config::FRAME_BUFFER_MAX_WIDTH;tw++)
+        {
+            //Save default sprite in the frame buffer
+            this -> g_frame_buffer[th][tw] = sprite_tmp;
+        } //End For: each frame buffer col (width scan)
+    } //End For: each frame buffer row (height scan)
+    //No sprite requires update
+    this -> reset_dirty();
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return false;	//OK
+}	//End private init: init_frame_buffer | void
+
+/***************************************************************************/
+//!	@brief private init
+//!	init_default_colors | void |
+/***************************************************************************/
+//! @return void
+//! @details
+//!	\n Initialize the default background and foreground colors
+/***************************************************************************/
+
+template <class Panel>
+inline bool Screen_panel<Panel>::init_default_colors( void )
+{
+    DENTER();
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Initialize default colors
+    this -> g_default_background_color = Color::BLACK;
+    this -> g_default_foreground_color = Color::WHITE;
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return false;	//OK
+}	//End private init: init_default_colors | void |
+
+/***************************************************************************/
+//!	@brief private init
+//!	init_palette | void
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n initialize palette to default values
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::init_palette( void )
+{
+    DENTER();
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Use the CGA default palette (https://en.wikipedia.org/wiki/Color_Graphics_Adapter)
+    this -> g_palette[Screen_panel::Color::BLACK]		= Display::color( 0x00, 0x00, 0x00 );
+    this -> g_palette[Screen_panel::Color::BLUE]		= Display::color( 0x00, 0x00, 0xAA );
+    this -> g_palette[Screen_panel::Color::GREEN] 	= Display::color( 0x00, 0xAA, 0x00 );
+    this -> g_palette[Screen_panel::Color::CYAN]		= Display::color( 0x00, 0xAA, 0xAA );
+    this -> g_palette[Screen_panel::Color::RED]		= Display::color( 0xAA, 0x00, 0x00 );
+    this -> g_palette[Screen_panel::Color::MAGENTA]	= Display::color( 0xAA, 0x00, 0xAA );
+    this -> g_palette[Screen_panel::Color::BROWN]		= Display::color( 0xAA, 0x55, 0x00 );
+    this -> g_palette[Screen_panel::Color::LGRAY]		= Display::color( 0xAA, 0xAA, 0xAA );
+    this -> g_palette[Screen_panel::Color::DGRAY]		= Display::color( 0x55, 0x55, 0x55 );
+    this -> g_palette[Screen_panel::Color::LBLUE]		= Display::color( 0x55, 0x55, 0xFF );
+    this -> g_palette[Screen_panel::Color::LGREEN]	= Display::color( 0x55, 0xFF, 0x55 );
+    this -> g_palette[Screen_panel::Color::LCYAN]		= Display::color( 0x55, 0xFF, 0xFF );
+    this -> g_palette[Screen_panel::Color::LRED]      = Display::color( 0xFF, 0x55, 0x55 );
+    this -> g_palette[Screen_panel::Color::LMAGENTA]	= Display::color( 0xFF, 0x55, 0xFF );
+    this -> g_palette[Screen_panel::Color::YELLOW]	= Display::color( 0xFF, 0xFF, 0x55 );
+    this -> g_palette[Screen_panel::Color::WHITE]		= Display::color( 0xFF, 0xFF, 0xFF );
+    #ifdef DEBUG_ENABLE
+    {
+        DPRINT("TEST: %6x\n", Display::color( 0xFF, 0xFF, 0xFF ));
+        this -> show_palette();
+    }
+    #endif
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return false;	//OK
+}	//End private init: init_palette | void
+
+/***************************************************************************/
+//!	@brief private init
+//!	init_geometry | void |
+/***************************************************************************/
+//! @return no return
+//! @details
+//!	\n Size of the sprites from the font in use. Size of the frame buffer from the sprites and the rotation
+//! \n Portrait turns the screen a quarter. The sprites keep their size, the frame buffer swaps its geometry
+/***************************************************************************/
+
+template <class Panel>
+void Screen_panel<Panel>::init_geometry( void )
+{
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    const Font_metrics &font = Screen_panel::g_font_metrics[ this -> g_font ];
+    bool f_portrait = ((this -> g_rotation == Rotation::PORTRAIT) || (this -> g_rotation == Rotation::PORTRAIT_FLIPPED));
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    this -> g_sprite_height = font.height;
+    this -> g_sprite_width = font.width;
+    this -> g_merge_pixel_bytes = (uint16_t)(font.height *font.width *Display::Config::COLOR_DEPTH /8);
+    this -> g_frame_buffer_height = (uint16_t)(((f_portrait == true)?(Display::Config::WIDTH):(Display::Config::HEIGHT)) /font.height);
+    this -> g_frame_buffer_width = (uint16_t)(((f_portrait == true)?(Display::Config::HEIGHT):(Display::Config::WIDTH)) /font.width);
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return;
+}	//End private init: init_geometry | void |
+
+/***************************************************************************/
+//!	@brief private init
+//!	init_fsm | void |
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Initialize the update FSM machine
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::init_fsm( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Start from top left
+    this -> g_status.scan_h = 0;
+    this -> g_status.scan_w = 0;
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return false;	//OK
+}	//End private init: init_fsm | void |
+
+/***************************************************************************/
+//!	@brief private init
+//!	init_glyph_cache | void |
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n Empty the glyph cache and reset its counters
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::init_glyph_cache( void )
+{
+    //For: each entry of the glyph cache
+    for (uint16_t t = 0;t < sizeof(this -> g_glyph_cache) /sizeof(Glyph);t++)
+    {
+        this -> g_glyph_cache[t].last_use = 0;
+        this -> g_glyph_cache[t].f_queued = false;
+    }
+    this -> g_glyph_cache_tick = 0;
+    this -> g_glyph_cache_hits = 0;
+    this -> g_glyph_cache_misses = 0;
+    return false;	//OK
+}	//End private init: init_glyph_cache | void |
+
+    /*********************************************************************************************************************************************************
+    **********************************************************************************************************************************************************
+    **	PRIVATE SETTER
+    **********************************************************************************************************************************************************
+    *********************************************************************************************************************************************************/
+
+/***************************************************************************/
+//!	@brief private setter
+//!	report_error | Error |
+/***************************************************************************/
+//! @param error_code | Error | error code of the Screen Class
+//! @return no return
+//!	@details
+//! Method
+/***************************************************************************/
+
+template <class Panel>
+void Screen_panel<Panel>::report_error( Error error_code )
+{
+    DENTER_ARG("ERR%d\n", (int)error_code ); //Trace Enter
+    ///--------------------------------------------------------------------------
+    ///	CHECK
+    ///--------------------------------------------------------------------------
+
+    if ((Config::PEDANTIC_CHECKS == true) && (error_code >= Screen_panel::Error::NUM_ERROR_CODES))
+    {
+        this -> g_error_code = Screen_panel::Error::BAD_ERROR_CODE;
+    }
+    else
+    {
+        this -> g_error_code = error_code;
+    }
+    
+    ///--------------------------------------------------------------------------
+    ///	RETURN
+    ///--------------------------------------------------------------------------
+    DRETURN(); //Trace Return
+    return;
+}	//end private setter: report_error | Error |
+
+    /*********************************************************************************************************************************************************
+    **********************************************************************************************************************************************************
+    **	PRIVATE TESTERS
+    **********************************************************************************************************************************************************
+    *********************************************************************************************************************************************************/
+
+/***************************************************************************/
+//!	@brief private tester
+//!	is_valid_char | char |
+/***************************************************************************/
+//! @return bool | false = INVALID | true =VALID
+//! @details
+//!	return true if the char is stored inside the ascii sprite table
+/***************************************************************************/
+
+template <class Panel>
+inline bool Screen_panel<Panel>::is_valid_char( char c )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return ((c >= Config::ASCII_START) && (c <= Config::ASCII_STOP));
+}	//End private tester: is_valid_char | char |
+
+/***************************************************************************/
+//!	@brief private tester
+//!	is_using_background | uint8_t  |
+/***************************************************************************/
+//! @return bool | false = sprite do not use background color | true = sprite use background color
+//! @details
+//!	return true if the sprite make use of the background palette color
+/***************************************************************************/
+
+template <class Panel>
+inline bool Screen_panel<Panel>::is_using_background( uint8_t sprite )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+    //If: special sprite
+    if (sprite < Config::NUM_SPECIAL_SPRITES)
+    {
+        //If: special sprite that use the background
+        if (sprite == Config::SPRITE_BACKGROUND)
+        {
+            //Use background
+            return true;
+        }
+        else
+        {
+            //Do not use the background
+            return false;
+        }
+    }
+    //If: sprite is an ascii character
+    else if (this -> is_valid_char(sprite) == true)
+    {
+        //An ascii character use the background
+        return true;
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    //Non drawable sprite
+    return false;
+}	//End private tester: is_using_background | uint8_t  |
+
+/***************************************************************************/
+//!	@brief private tester
+//!	is_using_foreground | uint8_t  |
+/***************************************************************************/
+//! @return bool | false = sprite do not use foreground color | true = sprite use foreground color
+//! @details
+//!	return true if the sprite make use of the foreground palette color
+/***************************************************************************/
+
+template <class Panel>
+inline bool Screen_panel<Panel>::is_using_foreground( uint8_t sprite )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+    //If: special sprite
+    if (sprite < Config::NUM_SPECIAL_SPRITES)
+    {
+        //If: special sprite that use the color
+        if (sprite == Config::SPRITE_FOREGROUND)
+        {
+            //Using color
+            return true;
+        }
+        else
+        {
+            //Not Using color
+            return false;
+        }
+    }
+    //If: sprite is an ascii character
+    else if (this -> is_valid_char(sprite) == true)
+    {
+        //An ascii character use the color
+        return true;
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    
+    //Non drawable sprite
+    return false;
+}	//End private tester: is_using_foreground | uint8_t  |
+
+/***************************************************************************/
+//!	@brief private tester
+//!	is_same_sprite | Frame_buffer_sprite | Frame_buffer_sprite |
+/***************************************************************************/
+//! @return bool | false = different | true = same
+//! @details
+//! check if sprite_a is functionally the same as sprite_b
+//! this is used to decide if mark a sprite for update or leave it as is
+//! this function is more nuanced that it appears
+//! this function is inside the drivers and assumes all relevant checks have been made by interface functions
+//! E.G. >a foreground sprite with with foreground is the same as a background sprite with white background
+//! E.G. >writing 'a' red on black is differet from writing 'a' green on black
+//! A change of a color in the palette will automatically mark for update all characters that use that palette color, but its taken care by the relevant function
+//! Because of that, no function but the update FSM is allowed to deactivate the update flag, so don't be overly aggressive with the result of this function
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::is_same_sprite( Frame_buffer_sprite sprite_a, Frame_buffer_sprite sprite_b )
+{
+    DENTER();
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+    
+    bool f_ascii_a = is_valid_char( sprite_a.sprite_index );
+    bool f_special_a = (sprite_a.sprite_index < Config::NUM_SPECIAL_SPRITES);
+    bool f_ascii_b = is_valid_char( sprite_b.sprite_index );
+    bool f_special_b = (sprite_b.sprite_index < Config::NUM_SPECIAL_SPRITES);
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: both characters are special
+    if ((f_special_a == true) && (f_special_b == true))
+    {
+        //If: sprite indexes are the same
+        if (sprite_a.sprite_index == sprite_b.sprite_index)
+        {
+            //If: fixed color sprites (do not use palette)
+            if ((sprite_a.sprite_index == Config::SPRITE_BLACK) || (sprite_a.sprite_index == Config::SPRITE_WHITE))
+            {
+                DRETURN_ARG("Same fixed solid sprites: %d %d\n", sprite_a.sprite_index, sprite_b.sprite_index );
+                return true;    //Same
+            }
+            //If: character that use background only
+            else if (sprite_a.sprite_index == Config::SPRITE_BACKGROUND)
+            {
+                //If: background are the same
+                if (sprite_a.background_color == sprite_b.background_color)
+                {
+                    DRETURN_ARG("Same solid background sprites: %d\n", sprite_a.background_color );
+                    return true;    //Same
+                }
+                //If: background are the different
+                else
+                {
+                    DRETURN_ARG("Different solid background sprites: %d %d\n", sprite_a.background_color, sprite_b.background_color );
+                    return false;   //Different
+                }
+            }
+            //If: character that use foreground only
+            else if (sprite_a.sprite_index == Config::SPRITE_FOREGROUND)
+            {
+                //If: background are the same
+                if (sprite_a.foreground_color == sprite_b.foreground_color)
+                {
+                    DRETURN_ARG("Same solid foreground sprites: %d\n", sprite_a.foreground_color );
+                    return true;    //Same
+                }
+                //If: background are the different
+                else
+                {
+                    DRETURN_ARG("Different solid foreground sprites: %d %d\n", sprite_a.foreground_color, sprite_b.foreground_color );
+                    return false;   //Different
+                }
+            }
+            //Default:
+            else
+            {
+                //Any other combination is to be treated as different sprites 
+                DRETURN_ARG("Different sprites: %d %d\n", sprite_a.sprite_index, sprite_b.sprite_index );
+                return false; //Different
+            }
+        }   //End If: sprite indexes are the same
+        //End If: sprite indexes are the different
+        else
+        {
+            //@todo: there are combinations of different indexes that yield the same color
+            DRETURN_ARG("Different sprites: %d %d\n", sprite_a.sprite_index, sprite_b.sprite_index );
+            return false; //Different
+        }
+    }   //End If: both characters are special
+    //If: both are validascii characters
+    else if ((f_ascii_a == true) && (f_ascii_b == true))
+    {
+        //If: sprites have the same index, the same background and the same foreground
+        if ((sprite_a.sprite_index == sprite_b.sprite_index) && (sprite_a.background_color == sprite_b.background_color) && (sprite_a.foreground_color == sprite_b.foreground_color))
+        {
+            DRETURN_ARG("Same ascii characters: %c %c\n", sprite_a.sprite_index, sprite_b.sprite_index );
+            return true;    //Same ascii
+        }
+        //If: any property is different
+        else
+        {
+            DRETURN_ARG("Different ascii characters: %c %c\n", sprite_a.sprite_index, sprite_b.sprite_index );
+            return false; //Different ascii
+        }
+    }
+    //@todo: graphics sprites (Symbols)
+    //If: every other combination is an invalid sprite
+    else
+    {
+        //Do nothing
+    }
+    
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return false;	//Sprites are different
+}	//End private tester: is_same_sprite | Frame_buffer_sprite | Frame_buffer_sprite |
+
+/***************************************************************************/
+//!	@brief private tester
+//!	is_dirty | uint16_t | uint16_t |
+/***************************************************************************/
+//! @param index_h | uint16_t | index of the sprite in the frame buffer
+//! @param index_w | uint16_t | index of the sprite in the frame buffer
+//! @return bool | false = up to date | true = marked for update
+//! @details
+//!	\n Test the bit of a sprite in the dirty bitmap
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::is_dirty( uint16_t index_h, uint16_t index_w )
+{
+    return (((this -> g_dirty_row[ index_h ] >> index_w) & 0x00000001) != 0);
+}	//End private tester: is_dirty | uint16_t | uint16_t |
+
+    /*********************************************************************************************************************************************************
+    **********************************************************************************************************************************************************
+    **	PRIVATE METHODS
+    **********************************************************************************************************************************************************
+    *********************************************************************************************************************************************************/
+
+/***************************************************************************/
+//!	@brief private method
+//!	decode_sprite | Frame_buffer_sprite | uint16_t & |
+/***************************************************************************/
+//! @param sprite | Frame_buffer_sprite | sprite from the frame buffer
+//! @param color | uint16_t & | output. RGB565 color of a solid sprite
+//! @return int8_t | -1 error | 0 transparent sprite | 1 solid color | 2 pixel color map
+//! @details
+//!	\n Decide how a sprite of the frame buffer is drawn
+//! \n Ascii characters with different background and foreground colors need a pixel color map
+//! \n Special sprites and ascii characters with the same background and foreground colors are solid colors
+/***************************************************************************/
+
+template <class Panel>
+int8_t Screen_panel<Panel>::decode_sprite( Frame_buffer_sprite sprite, uint16_t &color )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Decode background and foreground colors
+    uint16_t background_color = g_palette[ sprite.background_color ];
+    uint16_t foreground_color = g_palette[ sprite.foreground_color ];
+
+    //If: special sprite
+    if (sprite.sprite_index < Config::NUM_SPECIAL_SPRITES)
+    {
+        //If: Solid black
+        if (sprite.sprite_index == Config::SPRITE_BLACK)
+        {
+            color = Display::color(0x00,0x00,0x00);
+            return 1;
+        }
+        //If: Solid white
+        else if (sprite.sprite_index == Config::SPRITE_WHITE)
+        {
+            color = Display::color(0xFF,0xFF,0xFF);
+            return 1;
+        }
+        //If: Solid background
+        else if (sprite.sprite_index == Config::SPRITE_BACKGROUND)
+        {
+            color = background_color;
+            return 1;
+        }
+        //If: Solid foreground
+        else if (sprite.sprite_index == Config::SPRITE_FOREGROUND)
+        {
+            color = foreground_color;
+            return 1;
+        }
+        //If: Transparent sprite
+        else if (sprite.sprite_index == Config::SPRITE_TRANSPARENT)
+        {
+            //Never drawn
+            return 0;
+        }
+        //If: unhandled special sprite
+        else
+        {
+            return -1;
+        }
+    }   //End If: special sprite
+    //If: Handled Ascii Character in the character table
+    else if (this -> is_valid_char( sprite.sprite_index ) == true)
+    {
+        //If: background and foreground are different
+        if (background_color != foreground_color)
+        {
+            //Full pixel color map
+            return 2;
+        }
+        //If: background and foreground are the same
+        else //if (background_color == foreground_color)
+        {
+            //Draw a solid color sprite. Don't bother with computing a redundant pixel color map
+            color = background_color;
+            return 1;
+        }
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    //Unhandled sprite
+    return -1;
+}	//End private method: decode_sprite | Frame_buffer_sprite | uint16_t & |
+
+/***************************************************************************/
+//!	@brief private method
+//!	render_sprite | Frame_buffer_sprite | uint16_t * | uint16_t |
+/***************************************************************************/
+//! @param sprite | Frame_buffer_sprite | sprite from the frame buffer. Must be drawable
+//! @param pixel_ptr | uint16_t * | first pixel of the sprite inside the pixel buffer
+//! @param stride | uint16_t | number of pixels between the start of two sprite rows in the pixel buffer
+//! @details
+//!	\n Write the RGB565 pixels of a sprite inside the pixel buffer
+//! \n The stride allows a sprite to be rendered as a slice of a wider address window
+/***************************************************************************/
+
+template <class Panel>
+void Screen_panel<Panel>::render_sprite( Frame_buffer_sprite sprite, uint16_t *pixel_ptr, uint16_t stride )
+{
+    DENTER_ARG("stride: %5d\n", stride);
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Fast counter
+    int th;
+    //Temp color
+    uint16_t color;
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    show_frame_sprite( sprite );
+    //If: the sprite is a solid color
+    if (this -> decode_sprite( sprite, color ) != 2)
+    {
+        //For: Scan height
+        for (th = 0;th < this -> g_sprite_height;th++)
+        {
+            User::Glyph_expander::fill( color, &pixel_ptr[ th *stride ], (uint8_t)this -> g_sprite_width );
+        }
+    }
+    //If: sprite is a complex color map
+    else
+    {
+        //Decode background and foreground colors. The expander table is rebuilt only if the pair changed
+        this -> g_expander.set_colors( g_palette[ sprite.background_color ], g_palette[ sprite.foreground_color ] );
+        //Expand the rows of the glyph with the font in use
+        this -> render_glyph( sprite.sprite_index -Config::ASCII_START, false, pixel_ptr, stride );
+    }   //End If: sprite is a complex color map
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return;
+}	//End private method: render_sprite | Frame_buffer_sprite | uint16_t * | uint16_t |
+
+/***************************************************************************/
+//!	@brief private method
+//!	render_sprite_portrait | Frame_buffer_sprite | uint16_t * | uint16_t |
+/***************************************************************************/
+//! @param sprite | Frame_buffer_sprite | sprite from the frame buffer. Must be drawable
+//! @param pixel_ptr | uint16_t * | first pixel of the turned sprite inside the pixel buffer
+//! @param stride | uint16_t | number of pixels between the start of two display rows in the pixel buffer
+//! @details
+//!	\n Portrait. Write the RGB565 pixels of a sprite turned a quarter clockwise inside the pixel buffer
+//! \n The sprite is glyph width display rows by glyph height display columns
+//! \n The top display row is the last column of the glyph. Columns are read from the glyphs stored by column, one slice per row, like render_sprite
+/***************************************************************************/
+
+template <class Panel>
+void Screen_panel<Panel>::render_sprite_portrait( Frame_buffer_sprite sprite, uint16_t *pixel_ptr, uint16_t stride )
+{
+    DENTER_ARG("stride: %5d\n", stride);
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Fast counter
+    int th;
+    //Temp color
+    uint16_t color;
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    show_frame_sprite( sprite );
+    //If: the sprite is a solid color
+    if (this -> decode_sprite( sprite, color ) != 2)
+    {
+        //For: Scan display rows
+        for (th = 0;th < this -> g_sprite_width;th++)
+        {
+            User::Glyph_expander::fill( color, &pixel_ptr[ th *stride ], (uint8_t)this -> g_sprite_height );
+        }
+    }
+    //If: sprite is a complex color map
+    else
+    {
+        //Decode background and foreground colors. The expander table is rebuilt only if the pair changed
+        this -> g_expander.set_colors( g_palette[ sprite.background_color ], g_palette[ sprite.foreground_color ] );
+        //Expand the columns of the glyph with the font in use
+        this -> render_glyph( sprite.sprite_index -Config::ASCII_START, true, pixel_ptr, stride );
+    }   //End If: sprite is a complex color map
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN();
+    return;
+}	//End private method: render_sprite_portrait | Frame_buffer_sprite | uint16_t * | uint16_t |
+
+/***************************************************************************/
+//!	@brief private method
+//!	render_glyph | uint8_t | bool | uint16_t * | uint16_t |
+/***************************************************************************/
+//! @param glyph | uint8_t | index of the glyph inside the font. Character minus ASCII_START
+//! @param f_portrait | bool | true = the glyph is turned a quarter like render_sprite_portrait
+//! @param pixel_ptr | uint16_t * | first pixel of the sprite inside the pixel buffer
+//! @param stride | uint16_t | number of pixels between the start of two display rows in the pixel buffer
+//! @details
+//!	\n Font registry. Dispatch once per sprite to the expansion specialized for the size of the font in use
+//! \n The glyph expander colors must be set
+/***************************************************************************/
+
+template <class Panel>
+void Screen_panel<Panel>::render_glyph( uint8_t glyph, bool f_portrait, uint16_t *pixel_ptr, uint16_t stride )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    switch (this -> g_font)
+    {
+        case Font::NSIMSUN_8X16:
+        {
+            this -> expand_glyph<Config::NSIMSUN_8X16_WIDTH, Config::NSIMSUN_8X16_HEIGHT>( glyph, f_portrait, pixel_ptr, stride );
+            break;
+        }
+        case Font::FIXED_6X8:
+        {
+            this -> expand_glyph<Config::FIXED_6X8_WIDTH, Config::FIXED_6X8_HEIGHT>( glyph, f_portrait, pixel_ptr, stride );
+            break;
+        }
+        default:
+        {
+            this -> expand_glyph<Config::COURIER_8X10_WIDTH, Config::COURIER_8X10_HEIGHT>( glyph, f_portrait, pixel_ptr, stride );
+            break;
+        }
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return;
+}	//End private method: render_glyph | uint8_t | bool | uint16_t * | uint16_t |
+
+/***************************************************************************/
+//!	@brief private method
+//!	expand_glyph | uint8_t | bool | uint16_t * | uint16_t |
+/***************************************************************************/
+//! @tparam WIDTH | int | pixels in width of the glyphs of the font in use
+//! @tparam HEIGHT | int | pixels in height of the glyphs of the font in use
+//! @param glyph | uint8_t | index of the glyph inside the font
+//! @param f_portrait | bool | true = the glyph is turned a quarter like render_sprite_portrait
+//! @param pixel_ptr | uint16_t * | first pixel of the sprite inside the pixel buffer
+//! @param stride | uint16_t | number of pixels between the start of two display rows in the pixel buffer
+//! @details
+//!	\n The number of slices and the pixels of a slice are constants. The glyph expander loop is unrolled for the font
+//! \n Landscape expands the rows. Portrait expands the columns from the last, that is the top display row
+/***************************************************************************/
+
+template <class Panel>
+template <int WIDTH, int HEIGHT>
+void Screen_panel<Panel>::expand_glyph( uint8_t glyph, bool f_portrait, uint16_t *pixel_ptr, uint16_t stride )
+{
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    const Font_metrics &font = Screen_panel::g_font_metrics[ this -> g_font ];
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: portrait
+    if (f_portrait == true)
+    {
+        //Point to the last column of the glyph
+        const uint16_t *column_ptr = &font.column_ptr[ glyph *WIDTH +WIDTH -1 ];
+        //For: Scan display rows
+        for (int th = 0;th < WIDTH;th++)
+        {
+            //Expand the glyph column shown on this display row | false = background | true = foreground
+            this -> g_expander.expand( column_ptr[ -th ], &pixel_ptr[ th *stride ], HEIGHT );
+        }
+    }
+    //If: landscape
+    else
+    {
+        //Point to the first row of the glyph
+        const uint8_t *row_ptr = &font.row_ptr[ glyph *HEIGHT ];
+        //For: Scan height
+        for (int th = 0;th < HEIGHT;th++)
+        {
+            DPRINT_NOTAB(" %x |", row_ptr[ th ]);
+            //Expand the full width slice (row) | false = background | true = foreground
+            this -> g_expander.expand( row_ptr[ th ], &pixel_ptr[ th *stride ], WIDTH );
+        }
+        DPRINT_NOTAB("\n");
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return;
+}	//End private method: expand_glyph | uint8_t | bool | uint16_t * | uint16_t |
+
+/***************************************************************************/
+//!	@brief private method
+//!	scan_window | uint16_t | uint16_t | bool | uint8_t & |
+/***************************************************************************/
+//! @param index_h | uint16_t | index of the first sprite of the window in the frame buffer
+//! @param index_w | uint16_t | index of the first sprite of the window in the frame buffer
+//! @param f_vertical | bool | false = grow the window in width | true = grow the window in height
+//! @param num_dirty | uint8_t & | output. Number of sprites to be updated inside the window
+//! @return uint8_t | number of sprites in the window
+//! @details
+//!	\n Grow an address window from a sprite to be updated along a direction
+//! \n Sprites to be updated are always merged. The pixel bytes are the same, one address sequence is saved
+//! \n Sprites that are already up to date are bridged only if sending their pixels costs fewer bytes than opening a new address window
+//! \n Transparent sprites are never drawn and stop the window
+/***************************************************************************/
+
+template <class Panel>
+uint8_t Screen_panel<Panel>::scan_window( uint16_t index_h, uint16_t index_w, bool f_vertical, uint8_t &num_dirty )
+{
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Sprites in the window. The first sprite is the one to be updated
+    uint8_t size = 1;
+    num_dirty = 1;
+    //Number of up to date sprites since the last sprite to be updated
+    uint8_t gap = 0;
+    //Sprites available in the chosen direction
+    uint16_t limit = (f_vertical == true)?(this -> g_frame_buffer_height -index_h):(this -> g_frame_buffer_width -index_w);
+    limit = (limit < Config::MERGE_MAX_SPRITES)?(limit):((uint16_t)Config::MERGE_MAX_SPRITES);
+    //Temp color
+    uint16_t color;
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: a window in width may cross a rotated scroll area. The memory columns of the display are not contiguous at the edges of the rotation
+    if ((f_vertical == false) && (this -> g_scroll_shift != 0))
+    {
+        //Sprites before the memory columns wrap around
+        uint16_t run = limit;
+        //If: the window starts inside the scroll area
+        if ((index_w >= this -> g_scroll_index_w) && (index_w < this -> g_scroll_index_w +this -> g_scroll_size))
+        {
+            run = this -> g_scroll_index_w +this -> g_scroll_size -this -> get_scroll_column( index_w );
+        }
+        //If: the window starts before the scroll area
+        else if (index_w < this -> g_scroll_index_w)
+        {
+            run = this -> g_scroll_index_w -index_w;
+        }
+        limit = (limit < run)?(limit):(run);
+    }
+
+    //For: each sprite after the first in the chosen direction
+    for (uint16_t t = 1;t < limit;t++)
+    {
+        //Fetch the sprite
+        Frame_buffer_sprite sprite_tmp = (f_vertical == true)?(this -> g_frame_buffer[ index_h +t ][ index_w ]):(this -> g_frame_buffer[ index_h ][ index_w +t ]);
+        //If: the sprite can't be drawn
+        if (this -> decode_sprite( sprite_tmp, color ) <= 0)
+        {
+            //Transparent sprites must not be overwritten
+            break;
+        }
+        //If: the sprite is to be updated
+        else if (((f_vertical == true)?(this -> is_dirty( index_h +t, index_w )):(this -> is_dirty( index_h, index_w +t ))) == true)
+        {
+            //Merge it and the sprites bridged to reach it
+            size = t +1;
+            num_dirty++;
+            gap = 0;
+        }
+        //If: the sprite is up to date
+        else
+        {
+            gap++;
+            //If: sending the bridged pixels already costs more than a new address window
+            if (gap *this -> g_merge_pixel_bytes >= Display::Config::SPRITE_COMMAND_BYTES)
+            {
+                //Split
+                break;
+            }
+        }
+    }   //End For: each sprite after the first in the chosen direction
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return size;
+}	//End private method: scan_window | uint16_t | uint16_t | bool | uint8_t & |
+
+/***************************************************************************/
+//!	@brief private method
+//!	plan_window | uint16_t | uint16_t | Window & |
+/***************************************************************************/
+//! @param index_h | uint16_t | index of a sprite to be updated in the frame buffer
+//! @param index_w | uint16_t | index of a sprite to be updated in the frame buffer
+//! @param window | Window & | output. Address window that starts from the sprite
+//! @details
+//!	\n Flush planner. Decide which sprites are sent with the sprite to be updated inside a single address window
+//! \n Grow the window in width and in height and keep the one that saves more bytes on the SPI
+//! \n Each merged sprite saves the bytes of an address sequence. Each bridged up to date sprite costs its pixel bytes
+//! \n If all sprites inside the window are the same solid color, the window is drawn as a solid color and the pixel buffer is not needed
+/***************************************************************************/
+
+template <class Panel>
+void Screen_panel<Panel>::plan_window( uint16_t index_h, uint16_t index_w, Window &window )
+{
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Sprites and sprites to be updated inside the candidate windows
+    uint8_t size_w, size_h, dirty_w, dirty_h;
+    //Bytes saved by the candidate windows
+    int saving_w, saving_h;
+    //Temp color
+    uint16_t color;
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Single sprite window
+    window.index_h = index_h;
+    window.index_w = index_w;
+    window.size = 1;
+    window.f_vertical = false;
+    //If: the first sprite can't be drawn
+    if (this -> decode_sprite( this -> g_frame_buffer[ index_h ][ index_w ], color ) <= 0)
+    {
+        //register_window handles it alone
+        window.f_solid_color = true;
+        window.solid_color = 0;
+        return;
+    }
+    //Grow the window in both directions
+    size_w = this -> scan_window( index_h, index_w, false, dirty_w );
+    size_h = this -> scan_window( index_h, index_w, true, dirty_h );
+    //Bytes saved on the SPI by each candidate window
+    saving_w = (dirty_w -1) *Display::Config::SPRITE_COMMAND_BYTES -(size_w -dirty_w) *this -> g_merge_pixel_bytes;
+    saving_h = (dirty_h -1) *Display::Config::SPRITE_COMMAND_BYTES -(size_h -dirty_h) *this -> g_merge_pixel_bytes;
+    //If: the window in height saves more
+    if (saving_h > saving_w)
+    {
+        window.size = size_h;
+        window.f_vertical = true;
+    }
+    //If: the window in width saves the same or more
+    else
+    {
+        window.size = size_w;
+    }
+    //Is the full window a single solid color?
+    window.f_solid_color = true;
+    //For: each sprite in the window
+    for (uint8_t t = 0;t < window.size;t++)
+    {
+        //Fetch the sprite
+        Frame_buffer_sprite sprite_tmp = (window.f_vertical == true)?(this -> g_frame_buffer[ index_h +t ][ index_w ]):(this -> g_frame_buffer[ index_h ][ index_w +t ]);
+        //If: the sprite needs a pixel color map or has a different solid color
+        if ((this -> decode_sprite( sprite_tmp, color ) != 1) || ((t > 0) && (color != window.solid_color)))
+        {
+            window.f_solid_color = false;
+        }
+        window.solid_color = color;
+    }
+
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
 
-    return ((c >= Config::ASCII_START) && (c <= Config::ASCII_STOP));
-}	//End private tester: is_valid_char | char |
-
-/***************************************************************************/
-//!	@brief private tester
-//!	is_using_background | uint8_t  |
-/***************************************************************************/
-//! @return bool | false = sprite do not use background color | true = sprite use background color
-//! @details
-//!	return true if the sprite make use of the background palette color
-/***************************************************************************/
+    return;
+}	//End private method: plan_window | uint16_t | uint16_t | Window & |
+
+/***************************************************************************/
+//!	@brief private method
+//!	register_window | Window & |
+/***************************************************************************/
+//! @param window | Window & | address window computed by plan_window
+//! @return int8_t | -1 error | 0 nothing to draw | >0 sprites registered for draw
+//! @details
+//!	\n Register an address window for draw in the display driver
+//! \n The sprites inside the window are marked up to date once the driver holds the window. If the driver refuses it they stay dirty
+//! \n Sprites are rendered side by side in the pixel buffer, one row of the window after the other
+//! \n A complex color map moves the rotation to the next pixel buffer. The caller checks that buffer is no longer used by the driver
+//! \n Characters come from the glyph cache when it has them. A single character window in RGB565 is sent straight from the cache
+//! \n Window can be complex color map or solid color
+/***************************************************************************/
+
+template <class Panel>
+int8_t Screen_panel<Panel>::register_window( Window &window )
+{
+    DENTER_ARG("index_h : %5d | index_w %5d | size: %5d | vertical: %d\n", window.index_h, window.index_w, window.size, window.f_vertical);
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    //Temp color
+    uint16_t color;
+    //Pixel buffer in use
+    uint16_t *pixel_ptr = this -> g_pixel_data[ this -> g_pixel_index ];
+    //Single character window sent straight from the glyph cache. nullptr = the window is sent from the pixel buffer
+    Glyph *glyph_window_ptr = nullptr;
+    //Portrait. A sprite is a block of SPRITE_WIDTH display rows by SPRITE_HEIGHT display columns. Frame buffer columns run up the display
+    bool f_portrait = ((this -> g_rotation == Rotation::PORTRAIT) || (this -> g_rotation == Rotation::PORTRAIT_FLIPPED));
+    //Pixels between two rows of a sprite inside the pixel buffer
+    uint16_t stride;
+    //If: portrait
+    if (f_portrait == true)
+    {
+        stride = (window.f_vertical == true)?((uint16_t)(window.size *this -> g_sprite_height)):((uint16_t)this -> g_sprite_height);
+    }
+    else
+    {
+        stride = (window.f_vertical == true)?((uint16_t)this -> g_sprite_width):((uint16_t)(window.size *this -> g_sprite_width));
+    }
+
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: bad parameters
+    if ((Config::PEDANTIC_CHECKS == true) && ((window.index_w >= this -> g_frame_buffer_width) || (window.index_h >= this -> g_frame_buffer_height) || (window.size < 1) || (window.size > Config::MERGE_MAX_SPRITES)) )
+    {
+        DRETURN_ARG("ERR: bad parameters\n");
+        return -1; //FAIL
+    }
 
-inline bool Screen::is_using_background( uint8_t sprite )
-{
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
-    //If: special sprite
-    if (sprite < Config::NUM_SPECIAL_SPRITES)
+
+    //For: each sprite in the window
+    for (uint8_t t = 0;t < window.size;t++)
     {
-        //If: special sprite that use the background
-        if (sprite == Config::SPRITE_BACKGROUND)
+        //Point to the sprite in the frame buffer
+        Frame_buffer_sprite &sprite_tmp = (window.f_vertical == true)?(this -> g_frame_buffer[ window.index_h +t ][ window.index_w ]):(this -> g_frame_buffer[ window.index_h ][ window.index_w +t ]);
+        //Decode the sprite
+        int8_t ret = this -> decode_sprite( sprite_tmp, color );
+        //If: Transparent sprite or unhandled sprite. Nothing will ever be drawn, the sprite is not to be updated anymore
+        if (ret <= 0)
         {
-            //Use background
-            return true;
+            if (window.f_vertical == true)
+            {
+                this -> clear_dirty( window.index_h +t, window.index_w );
+            }
+            else
+            {
+                this -> clear_dirty( window.index_h, window.index_w +t );
+            }
         }
-        else
+        //If: Transparent sprite. Only a single sprite window can hold one
+        if (ret == 0)
         {
-            //Do not use the background
-            return false;
+            DRETURN_ARG("Transparent Sprite\n");
+            return 0;
+        }
+        //If: unhandled sprite
+        else if (ret < 0)
+        {
+            //Signal the error
+            this -> report_error( Error::REGISTER_SPRITE_FAIL );
+            DRETURN_ARG("ERR%d: unhandled sprite\n", this -> get_error() );
+            return -1;
+        }
+        //If: the window needs a pixel color map
+        else if (window.f_solid_color == false)
+        {
+            //Slice of the sprite in the pixel buffer. In portrait the first sprite of a window in width is the bottom block on the display
+            uint16_t *slice_ptr;
+            if (f_portrait == true)
+            {
+                slice_ptr = &pixel_ptr[ (window.f_vertical == true)?(t *this -> g_sprite_height):((window.size -1 -t) *this -> g_sprite_height *this -> g_sprite_width) ];
+            }
+            else
+            {
+                slice_ptr = &pixel_ptr[ (window.f_vertical == true)?(t *this -> g_sprite_height *this -> g_sprite_width):(t *this -> g_sprite_width) ];
+            }
+            //Character already expanded with its colors
+            Glyph *glyph_ptr = this -> get_glyph( sprite_tmp, f_portrait );
+            //If: a single character window in RGB565. The driver sends it straight from the glyph cache
+            if ((glyph_ptr != nullptr) && (window.size == 1) && (Display::Config::COLOR_DEPTH == 16))
+            {
+                glyph_window_ptr = glyph_ptr;
+            }
+            //If: a character of a wider window. Copy its rows in its slice of the pixel buffer
+            else if (glyph_ptr != nullptr)
+            {
+                uint16_t rows = (f_portrait == true)?((uint16_t)this -> g_sprite_width):((uint16_t)this -> g_sprite_height);
+                uint16_t cols = (f_portrait == true)?((uint16_t)this -> g_sprite_height):((uint16_t)this -> g_sprite_width);
+                for (uint16_t th = 0;th < rows;th++)
+                {
+                    for (uint16_t tw = 0;tw < cols;tw++)
+                    {
+                        slice_ptr[ th *stride +tw ] = glyph_ptr -> pixel[ th *cols +tw ];
+                    }
+                }
+            }
+            //If: portrait. Render the turned sprite in its slice of the pixel buffer
+            else if (f_portrait == true)
+            {
+                this -> render_sprite_portrait( sprite_tmp, slice_ptr, stride );
+            }
+            //Render the sprite in its slice of the pixel buffer
+            else
+            {
+                this -> render_sprite( sprite_tmp, slice_ptr, stride );
+            }
         }
+    }   //End For: each sprite in the window
+
+    //Origin and size of the window on the display in pixels
+    int origin_h, origin_w, size_h, size_w;
+    //If: portrait. Frame buffer rows are bands of display columns. Frame buffer columns are bands of display rows counted from the bottom
+    if (f_portrait == true)
+    {
+        size_h = (window.f_vertical == true)?(this -> g_sprite_width):(window.size *this -> g_sprite_width);
+        size_w = (window.f_vertical == true)?(window.size *this -> g_sprite_height):(this -> g_sprite_height);
+        origin_h = Display::Config::HEIGHT -window.index_w *this -> g_sprite_width -size_h;
+        origin_w = window.index_h *this -> g_sprite_height;
     }
-    //If: sprite is an ascii character
-    else if (this -> is_valid_char(sprite) == true)
+    else
     {
-        //An ascii character use the background
-        return true;
+        size_h = (window.f_vertical == true)?(window.size *this -> g_sprite_height):(this -> g_sprite_height);
+        size_w = (window.f_vertical == true)?(this -> g_sprite_width):(window.size *this -> g_sprite_width);
+        origin_h = window.index_h *this -> g_sprite_height;
+        origin_w = this -> get_scroll_column( window.index_w ) *this -> g_sprite_width;
+    }
+    //Temp return
+    int ret;
+    //If: single character window from the glyph cache. The pixel buffer is left for the next window
+    if (glyph_window_ptr != nullptr)
+    {
+        ret = this -> Display::register_sprite( origin_h, origin_w, size_h, size_w, glyph_window_ptr -> pixel );
+        //If: the driver holds the entry. It can't be replaced until the driver is done with it
+        if (ret > 0)
+        {
+            glyph_window_ptr -> f_queued = true;
+        }
+    }
+    //If: window is a complex color map
+    else if (window.f_solid_color == false)
+    {
+        //If: the display takes RGB444. Pack the rendered window in place, the Display sends it as a byte stream
+        if (Display::Config::COLOR_DEPTH == 12)
+        {
+            Display::pack_rgb444( pixel_ptr, size_h *size_w );
+        }
+        //Register the window for draw in the Display driver
+        ret = this -> Display::register_sprite( origin_h, origin_w, size_h, size_w, pixel_ptr );
+        //If: the driver holds the pixel buffer
+        if (ret > 0)
+        {
+            //Render the next window in the next pixel buffer
+            this -> g_pixel_index = (this -> g_pixel_index < Config::PIXEL_BUFFER_COUNT -1)?(this -> g_pixel_index +1):(0);
+        }
+    }
+    //If: window is a solid color
+    else //if (window.f_solid_color == true)
+    {
+        //Register the window for draw in the Display driver
+        ret = this -> Display::register_sprite( origin_h, origin_w, size_h, size_w, window.solid_color );
+    }
+    //If: failed to register. the register sprite in future can be smaller than the sprite size if trying to register a sprite partially out of screen
+    if (ret <= 0)
+    {
+        //Signal the error
+        this -> report_error( Error::REGISTER_SPRITE_FAIL );
+        //Failed to register sprite. The sprites stay dirty and are tried again
+        ret = -1;
+    }
+    //If: success
+    else
+    {
+        //For: each sprite in the window. The driver holds it, it is not to be updated anymore
+        for (uint8_t t = 0;t < window.size;t++)
+        {
+            if (window.f_vertical == true)
+            {
+                this -> clear_dirty( window.index_h +t, window.index_w );
+            }
+            else
+            {
+                this -> clear_dirty( window.index_h, window.index_w +t );
+            }
+        }
+        //Sprites drawn
+        ret = window.size;
     }
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-    
-    //Non drawable sprite
-    return false;
-}	//End private tester: is_using_background | uint8_t  |
+    DRETURN();
+    return ret;
+}	//End private method: register_window | Window & |
 
 /***************************************************************************/
 //!	@brief private tester
-//!	is_using_foreground | uint8_t  |
+//!	update_sprite | uint16_t | uint16_t | Frame_buffer_sprite |
 /***************************************************************************/
-//! @return bool | false = sprite do not use foreground color | true = sprite use foreground color
+//! @return ont | <0 = error coccurred | 0 = frame buffer wasn't updated | 1 = frame buffer was updated
 //! @details
-//!	return true if the sprite make use of the foreground palette color
+//!	Update a sprite in the frame buffer and mark it for update if required
+//!	The bit of the sprite is set in the dirty bitmap. The update FSM finds it with count trailing zeros
 /***************************************************************************/
 
-inline bool Screen::is_using_foreground( uint8_t sprite )
+template <class Panel>
+int8_t Screen_panel<Panel>::update_sprite( uint16_t index_h, uint16_t index_w, Frame_buffer_sprite new_sprite )
 {
+    DENTER_ARG("H: %d | W: %d |\n", index_h, index_w );
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: invalid coordinates
+    if ((Config::PEDANTIC_CHECKS == true) && ((index_h >= this -> g_frame_buffer_height) || (index_w >= this -> g_frame_buffer_width)) )
+    {
+        DRETURN_ARG("ERR: bad index H: %d | W: %d |\n", index_h, index_w);
+        return -1;
+    }
+
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
-    //If: special sprite
-    if (sprite < Config::NUM_SPECIAL_SPRITES)
+
+    int8_t num_updated_sprites;
+    //Fetch sprite
+    Frame_buffer_sprite old_sprite = this -> g_frame_buffer[index_h][index_w];
+    //If: the sprites are the same
+    if (this -> is_same_sprite(old_sprite, new_sprite) == true)
     {
-        //If: special sprite that use the color
-        if (sprite == Config::SPRITE_FOREGROUND)
-        {
-            //Using color
-            return true;
-        }
-        else
-        {
-            //Not Using color
-            return false;
-        }
+        //Do nothing
+        num_updated_sprites = 0;
     }
-    //If: sprite is an ascii character
-    else if (this -> is_valid_char(sprite) == true)
+    //If: the sprites are not the same
+    else
     {
-        //An ascii character use the color
-        return true;
+        //Mark for update
+        this -> set_dirty( index_h, index_w );
+        //Update the sprite
+        this -> g_frame_buffer[index_h][index_w] = new_sprite;
+        //A sprite was updated
+        num_updated_sprites = 1;
     }
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-    
-    //Non drawable sprite
-    return false;
-}	//End private tester: is_using_foreground | uint8_t  |
+    DRETURN();
+    return num_updated_sprites;
+}	//End private method: update_sprite | uint16_t | uint16_t | Frame_buffer_sprite |
 
 /***************************************************************************/
-//!	@brief private tester
-//!	is_same_sprite | Frame_buffer_sprite | Frame_buffer_sprite |
+//!	@brief private method
+//!	fill_screen | Frame_buffer_sprite |
 /***************************************************************************/
-//! @return bool | false = different | true = same
+//! @param new_sprite | Frame_buffer_sprite | solid sprite
+//! @return int | <0 = error | >=0 number of sprites changed
 //! @details
-//! check if sprite_a is functionally the same as sprite_b
-//! this is used to decide if mark a sprite for update or leave it as is
-//! this function is more nuanced that it appears
-//! this function is inside the drivers and assumes all relevant checks have been made by interface functions
-//! E.G. >a foreground sprite with with foreground is the same as a background sprite with white background
-//! E.G. >writing 'a' red on black is differet from writing 'a' green on black
-//! A change of a color in the palette will automatically mark for update all characters that use that palette color, but its taken care by the relevant function
-//! Because of that, no function but the update FSM is allowed to deactivate the update flag, so don't be overly aggressive with the result of this function
+//!	\n Set all sprites of the frame buffer to a solid sprite
+//! \n Sprites one by one cost at worst an address window each. If they cost more bytes than the whole screen, the screen is sent as a single solid color window
+//! \n The frame buffer is then up to date with the display and the sprites are not scanned
+//! \n If the driver has no room for the window, the sprites are marked for update one by one
 /***************************************************************************/
 
-bool Screen::is_same_sprite( Frame_buffer_sprite sprite_a, Frame_buffer_sprite sprite_b )
+template <class Panel>
+int Screen_panel<Panel>::fill_screen( Frame_buffer_sprite new_sprite )
 {
     DENTER();
     //----------------------------------------------------------------
     //	VARS
     //----------------------------------------------------------------
-    
-    bool f_ascii_a = is_valid_char( sprite_a.sprite_index );
-    bool f_special_a = (sprite_a.sprite_index < Config::NUM_SPECIAL_SPRITES);
-    bool f_ascii_b = is_valid_char( sprite_b.sprite_index );
-    bool f_special_b = (sprite_b.sprite_index < Config::NUM_SPECIAL_SPRITES);
+
+    //Fast counters
+    uint16_t th, tw;
+    //Number of sprites that change and number of sprites the display has to draw. Pending sprites are drawn even if they don't change
+    int num_sprites_updated = 0;
+    int num_sprites_draw = 0;
+    //Solid color of the sprite
+    uint16_t color;
+    //Temp return
+    int ret;
 
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    //If: both characters are special
-    if ((f_special_a == true) && (f_special_b == true))
+    //For: each sprite of the frame buffer
+    for (th = 0;th < this -> g_frame_buffer_height;th++)
     {
-        //If: sprite indexes are the same
-        if (sprite_a.sprite_index == sprite_b.sprite_index)
-        {
-            //If: fixed color sprites (do not use palette)
-            if ((sprite_a.sprite_index == Config::SPRITE_BLACK) || (sprite_a.sprite_index == Config::SPRITE_WHITE))
-            {
-                DRETURN_ARG("Same fixed solid sprites: %d %d\n", sprite_a.sprite_index, sprite_b.sprite_index );
-                return true;    //Same
-            }
-            //If: character that use background only
-            else if (sprite_a.sprite_index == Config::SPRITE_BACKGROUND)
-            {
-                //If: background are the same
-                if (sprite_a.background_color == sprite_b.background_color)
-                {
-                    DRETURN_ARG("Same solid background sprites: %d\n", sprite_a.background_color );
-                    return true;    //Same
-                }
-                //If: background are the different
-                else
-                {
-                    DRETURN_ARG("Different solid background sprites: %d %d\n", sprite_a.background_color, sprite_b.background_color );
-                    return false;   //Different
-                }
-            }
-            //If: character that use foreground only
-            else if (sprite_a.sprite_index == Config::SPRITE_FOREGROUND)
-            {
-                //If: background are the same
-                if (sprite_a.foreground_color == sprite_b.foreground_color)
-                {
-                    DRETURN_ARG("Same solid foreground sprites: %d\n", sprite_a.foreground_color );
-                    return true;    //Same
-                }
-                //If: background are the different
-                else
-                {
-                    DRETURN_ARG("Different solid foreground sprites: %d %d\n", sprite_a.foreground_color, sprite_b.foreground_color );
-                    return false;   //Different
-                }
-            }
-            //Default:
-            else
-            {
-                //Any other combination is to be treated as different sprites 
-                DRETURN_ARG("Different sprites: %d %d\n", sprite_a.sprite_index, sprite_b.sprite_index );
-                return false; //Different
-            }
-        }   //End If: sprite indexes are the same
-        //End If: sprite indexes are the different
-        else
+        for (tw = 0;tw < this -> g_frame_buffer_width;tw++)
         {
-            //@todo: there are combinations of different indexes that yield the same color
-            DRETURN_ARG("Different sprites: %d %d\n", sprite_a.sprite_index, sprite_b.sprite_index );
-            return false; //Different
+            bool f_same = this -> is_same_sprite( this -> g_frame_buffer[th][tw], new_sprite );
+            num_sprites_updated += (f_same == false);
+            num_sprites_draw += ((f_same == false) || (this -> is_dirty( th, tw ) == true));
         }
-    }   //End If: both characters are special
-    //If: both are validascii characters
-    else if ((f_ascii_a == true) && (f_ascii_b == true))
+    }
+    //Origin and size of the screen on the display in pixels. Portrait frame buffer columns are bands of display rows counted from the bottom
+    bool f_portrait = ((this -> g_rotation == Rotation::PORTRAIT) || (this -> g_rotation == Rotation::PORTRAIT_FLIPPED));
+    int size_h = (f_portrait == true)?(this -> g_frame_buffer_width *this -> g_sprite_width):(this -> g_frame_buffer_height *this -> g_sprite_height);
+    int size_w = (f_portrait == true)?(this -> g_frame_buffer_height *this -> g_sprite_height):(this -> g_frame_buffer_width *this -> g_sprite_width);
+    //If: sprites one by one cost more bytes than a single window. Register the screen
+    if ((num_sprites_draw *(this -> g_merge_pixel_bytes +Display::Config::SPRITE_COMMAND_BYTES) >= this -> g_frame_buffer_height *this -> g_frame_buffer_width *this -> g_merge_pixel_bytes +Display::Config::SPRITE_COMMAND_BYTES) &&
+        (this -> decode_sprite( new_sprite, color ) == 1) &&
+        (this -> Display::register_sprite( (f_portrait == true)?(Display::Config::HEIGHT -size_h):(0), 0, size_h, size_w, color ) > 0))
     {
-        //If: sprites have the same index, the same background and the same foreground
-        if ((sprite_a.sprite_index == sprite_b.sprite_index) && (sprite_a.background_color == sprite_b.background_color) && (sprite_a.foreground_color == sprite_b.foreground_color))
+        //The display shows the new sprite everywhere
+        for (th = 0;th < this -> g_frame_buffer_height;th++)
         {
-            DRETURN_ARG("Same ascii characters: %c %c\n", sprite_a.sprite_index, sprite_b.sprite_index );
-            return true;    //Same ascii
+            for (tw = 0;tw < this -> g_frame_buffer_width;tw++)
+            {
+                this -> g_frame_buffer[th][tw] = new_sprite;
+            }
         }
-        //If: any property is different
-        else
+        //No sprite is pending anymore
+        this -> reset_dirty();
+    }
+    //If: a few sprites change. Let the update FSM merge them
+    else
+    {
+        for (th = 0;th < this -> g_frame_buffer_height;th++)
         {
-            DRETURN_ARG("Different ascii characters: %c %c\n", sprite_a.sprite_index, sprite_b.sprite_index );
-            return false; //Different ascii
+            for (tw = 0;tw < this -> g_frame_buffer_width;tw++)
+            {
+                //Update the frame buffer with the new sprite if needed
+                ret = this -> update_sprite( th, tw, new_sprite );
+                //If: an error occurred
+                if ((Config::PEDANTIC_CHECKS == true) && (ret < 0))
+                {
+                    DRETURN_ARG("ERR: Failed to update sprite\n");
+                    return ret;
+                }
+            }
         }
     }
-    //@todo: graphics sprites (Symbols)
-    //If: every other combination is an invalid sprite
-    else
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+    DRETURN_ARG("changed: %d, drawn: %d\n", num_sprites_updated, num_sprites_draw );
+    return num_sprites_updated;
+}	//End private method: fill_screen | Frame_buffer_sprite |
+
+/***************************************************************************/
+//!	@brief private method
+//!	mark_sprite | uint16_t | uint16_t |
+/***************************************************************************/
+//! @param index_h | uint16_t | index of the sprite in the frame buffer
+//! @param index_w | uint16_t | index of the sprite in the frame buffer
+//! @return int8_t | <0 = error | 0 = sprite was already marked | 1 = sprite marked for update
+//! @details
+//!	\n Mark a sprite for update even if it didn't change. The display lost it
+/***************************************************************************/
+
+template <class Panel>
+int8_t Screen_panel<Panel>::mark_sprite( uint16_t index_h, uint16_t index_w )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: invalid coordinates
+    if ((Config::PEDANTIC_CHECKS == true) && ((index_h >= this -> g_frame_buffer_height) || (index_w >= this -> g_frame_buffer_width)) )
     {
-        //Do nothing
+        return -1;
     }
-    
+    //If: already marked
+    if (this -> is_dirty( index_h, index_w ) == true)
+    {
+        return 0;
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Mark for update
+    this -> set_dirty( index_h, index_w );
+
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-    DRETURN();
-    return false;	//Sprites are different
-}	//End private tester: is_same_sprite | Frame_buffer_sprite | Frame_buffer_sprite |
 
-    /*********************************************************************************************************************************************************
-    **********************************************************************************************************************************************************
-    **	PRIVATE METHODS
-    **********************************************************************************************************************************************************
-    *********************************************************************************************************************************************************/
+    return 1;
+}	//End private method: mark_sprite | uint16_t | uint16_t |
+
+/***************************************************************************/
+//!	@brief private method
+//!	set_dirty | uint16_t | uint16_t |
+/***************************************************************************/
+//! @param index_h | uint16_t | index of the sprite in the frame buffer
+//! @param index_w | uint16_t | index of the sprite in the frame buffer
+//! @details
+//!	\n Mark a sprite for update in the dirty bitmap
+//! \n Bit W of row H is the sprite. Bit H of the summary word is set when row H has a sprite to be updated
+//! \n Oldest first. The sprite is pushed in the dirty FIFO unless it is already there
+/***************************************************************************/
+
+template <class Panel>
+void Screen_panel<Panel>::set_dirty( uint16_t index_h, uint16_t index_w )
+{
+    this -> g_dirty_row[ index_h ] |= (uint32_t)1 << index_w;
+    this -> g_dirty_summary |= (uint32_t)1 << index_h;
+    //If: oldest first and the sprite is not in the dirty FIFO. A sprite marked again keeps its place
+    if ((this -> g_flush_order == Flush_order::OLDEST_FIRST) && ((this -> g_queued_row[ index_h ] & ((uint32_t)1 << index_w)) == 0))
+    {
+        this -> g_queued_row[ index_h ] |= (uint32_t)1 << index_w;
+        //Each sprite is queued at most once. The FIFO can't overflow
+        uint16_t tail = this -> g_dirty_fifo_head +this -> g_dirty_fifo_cnt;
+        tail = (tail >= Config::FRAME_BUFFER_MAX_SIZE)?(tail -Config::FRAME_BUFFER_MAX_SIZE):(tail);
+        this -> g_dirty_fifo[ tail ] = (index_h << 8) | index_w;
+        this -> g_dirty_fifo_cnt++;
+    }
+    return;
+}	//End private method: set_dirty | uint16_t | uint16_t |
+
+/***************************************************************************/
+//!	@brief private method
+//!	clear_dirty | uint16_t | uint16_t |
+/***************************************************************************/
+//! @param index_h | uint16_t | index of the sprite in the frame buffer
+//! @param index_w | uint16_t | index of the sprite in the frame buffer
+//! @details
+//!	\n The sprite is up to date with the display. Clear its bit in the dirty bitmap
+//! \n The summary bit of the row is cleared when the row has no sprite left to be updated
+/***************************************************************************/
+
+template <class Panel>
+void Screen_panel<Panel>::clear_dirty( uint16_t index_h, uint16_t index_w )
+{
+    this -> g_dirty_row[ index_h ] &= ~((uint32_t)1 << index_w);
+    //If: the row is up to date
+    if (this -> g_dirty_row[ index_h ] == 0)
+    {
+        this -> g_dirty_summary &= ~((uint32_t)1 << index_h);
+    }
+    return;
+}	//End private method: clear_dirty | uint16_t | uint16_t |
 
 /***************************************************************************/
 //!	@brief private method
-//!	register_sprite | uint16_t | uint16_t |
+//!	find_dirty | uint16_t & | uint16_t & |
 /***************************************************************************/
-//! @param index_h | uint16_t | index of the sprite in the frame buffer to build pixel from
-//! @param index_w | uint16_t | index of the sprite in the frame buffer to build pixel from
-//! @return int8_t | -1 error | >= 0 sprites registered for draw
+//! @param index_h | uint16_t & | in: scan position | out: sprite to be updated
+//! @param index_w | uint16_t & | in: scan position | out: sprite to be updated
+//! @return bool | false = found a sprite to be updated | true = no sprite to be updated
 //! @details
-//!	\n Register a sprite for draw in the display driver if possible
-//! \n Sprite can be xomplex color map or solid color
+//!	\n Find the first sprite to be updated at or after the scan position, in raster order, wrapping around the frame buffer
+//! \n The summary word skips the rows that are up to date and count trailing zeros skips the sprites that are up to date
+//! \n Cost doesn't depend on the size of the frame buffer nor on the distance between sprites to be updated
+//! \n Round robin from the scan position keeps a sprite that is changed over and over from starving the others
 /***************************************************************************/
 
-int8_t Screen::register_sprite( uint16_t index_h, uint16_t index_w )
+template <class Panel>
+bool Screen_panel<Panel>::find_dirty( uint16_t &index_h, uint16_t &index_w )
 {
-    DENTER_ARG("index_h : %5d | index_w %5d\n", index_h, index_w);
     //----------------------------------------------------------------
     //	VARS
     //----------------------------------------------------------------
 
-    //Temp sprite data
-    uint16_t foreground_color, background_color;
-    //Temp color
-    uint16_t color;
-    //false = complex color map | true = solid color
-    bool f_solid_color;
+    uint32_t summary = this -> g_dirty_summary;
+    uint32_t row;
 
     //----------------------------------------------------------------
-    //	INIT
+    //	BODY
     //----------------------------------------------------------------
 
-    //If: bad parameters
-    if ((Config::PEDANTIC_CHECKS == true) && ((index_w >= Config::FRAME_BUFFER_WIDTH) || (index_h >= Config::FRAME_BUFFER_HEIGHT)) )
+    //If: no sprite to be updated
+    if (summary == 0)
     {
-        DRETURN_ARG("ERR: bad parameters\n");
-        return -1; //FAIL
+        return true;
+    }
+    //If: the scan is past the frame buffer. A rotation changed its geometry
+    if ((index_h >= this -> g_frame_buffer_height) || (index_w >= this -> g_frame_buffer_width))
+    {
+        index_h = 0;
+        index_w = 0;
+    }
+    //Sprites to be updated of the scan row at or after the scan column
+    row = this -> g_dirty_row[ index_h ] & (~(uint32_t)0 << index_w);
+    //If: none. Rows to be updated after the scan row
+    if (row == 0)
+    {
+        summary &= (index_h +1 < Config::DIRTY_WORD_BITS)?(~(uint32_t)0 << (index_h +1)):(0);
+        //If: none. Wrap around to the first row to be updated
+        if (summary == 0)
+        {
+            summary = this -> g_dirty_summary;
+        }
+        index_h = __builtin_ctz( summary );
+        row = this -> g_dirty_row[ index_h ];
     }
+    index_w = __builtin_ctz( row );
 
     //----------------------------------------------------------------
-    //	DECODE SPRITE
+    //	RETURN
     //----------------------------------------------------------------
 
-    //Fetch a frame sprite
-    Frame_buffer_sprite sprite_tmp = g_frame_buffer[index_h][index_w];
-    show_frame_sprite( sprite_tmp );
-    //Decode background and foreground colors
-    background_color = g_palette[ sprite_tmp.background_color ];
-    foreground_color = g_palette[ sprite_tmp.foreground_color ];
-    DPRINT("sprite: %d | background color: %6x | foreground_color: %6x |\n", sprite_tmp.sprite_index, background_color, foreground_color );
-    //Pointer to sprite data
-    const uint8_t *sprite_ptr = nullptr;
+    return false;
+}	//End private method: find_dirty | uint16_t & | uint16_t & |
 
-    //If: special sprite
-    if (sprite_tmp.sprite_index < Config::NUM_SPECIAL_SPRITES)
+/***************************************************************************/
+//!	@brief private method
+//!	find_oldest_dirty | uint16_t & | uint16_t & |
+/***************************************************************************/
+//! @param index_h | uint16_t & | out: sprite to be updated
+//! @param index_w | uint16_t & | out: sprite to be updated
+//! @return bool | false = found a sprite to be updated | true = no sprite to be updated
+//! @details
+//!	\n Head of the dirty FIFO. The sprite that has been waiting the longest
+//! \n Sprites at the head that are already up to date were sent in a window with an older sprite, or scrolled out. They are dropped
+//! \n The sprite is left in the FIFO. It is dropped on the next call once its window has been registered
+/***************************************************************************/
+
+template <class Panel>
+bool Screen_panel<Panel>::find_oldest_dirty( uint16_t &index_h, uint16_t &index_w )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //While: there are sprites in the dirty FIFO
+    while (this -> g_dirty_fifo_cnt > 0)
     {
-        //If: Solid black
-        if (sprite_tmp.sprite_index == Config::SPRITE_BLACK)
+        uint16_t h = this -> g_dirty_fifo[ this -> g_dirty_fifo_head ] >> 8;
+        uint16_t w = this -> g_dirty_fifo[ this -> g_dirty_fifo_head ] & 0x00FF;
+        //If: the head is to be updated
+        if (this -> is_dirty( h, w ) == true)
         {
-            f_solid_color = true;
-            color = Display::color(0x00,0x00,0x00);
-        }
-        //If: Solid white
-        else if (sprite_tmp.sprite_index == Config::SPRITE_WHITE)
-        {
-            f_solid_color = true;
-            color = Display::color(0xFF,0xFF,0xFF);
-        }
-        //If: Solid background
-        else if (sprite_tmp.sprite_index == Config::SPRITE_BACKGROUND)
-        {
-            f_solid_color = true;
-            color = background_color;
-        }
-        //If: Solid foreground
-        else if (sprite_tmp.sprite_index == Config::SPRITE_FOREGROUND)
-        {
-            f_solid_color = true;
-            color = foreground_color;
-        }
-        //If: Transparent sprite
-        else if (sprite_tmp.sprite_index == Config::SPRITE_TRANSPARENT)
-        {
-            DRETURN_ARG("Transparent Sprite\n");
-            return 0;
-        }
-        //If: unhandled special sprite
-        else
-        {
-            //Signal the error
-            this -> report_error( Error::REGISTER_SPRITE_FAIL );
-            DRETURN_ARG("ERR%d: unhandled special sprit\n", this -> get_error() );
-            return -1;
+            index_h = h;
+            index_w = w;
+            return false;
         }
-    }   //End If: special sprite
-    //If: Handled Ascii Character in the character table
-    else if (this -> is_valid_char( sprite_tmp.sprite_index ) == true)
+        //Drop the head
+        this -> g_queued_row[ h ] &= ~((uint32_t)1 << w);
+        this -> g_dirty_fifo_head = (this -> g_dirty_fifo_head +1 >= Config::FRAME_BUFFER_MAX_SIZE)?(0):(this -> g_dirty_fifo_head +1);
+        this -> g_dirty_fifo_cnt--;
+    }
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return true;
+}	//End private method: find_oldest_dirty | uint16_t & | uint16_t & |
+
+/***************************************************************************/
+//!	@brief private method
+//!	reset_dirty | void |
+/***************************************************************************/
+//! @details
+//!	\n No sprite is to be updated. Clear the dirty bitmap and empty the dirty FIFO
+/***************************************************************************/
+
+template <class Panel>
+void Screen_panel<Panel>::reset_dirty( void )
+{
+    //For: each row of the dirty bitmap
+    for (uint16_t th = 0;th < Config::FRAME_BUFFER_MAX_HEIGHT;th++)
     {
-        //If: background and foreground are different
-        if (background_color != foreground_color)
-        {
-            //Full pixel color map
-            f_solid_color = false;
-            //Point to the first byte of the ascii sprite
-            sprite_ptr = &g_ascii_sprites[ (sprite_tmp.sprite_index -Config::ASCII_START) *Config::SPRITE_HEIGHT ];
-        }
-        //If: background and foreground are the same
-        else //if (background_color == foreground_color)
-        {
-            //Draw a solid color sprite. Don't bother with computing a redundant pixel color map
-            f_solid_color = true;
-            color = background_color;
-        }
+        this -> g_dirty_row[ th ] = 0;
+        this -> g_queued_row[ th ] = 0;
     }
-    //If: Unhandled sprite
-    else
+    this -> g_dirty_summary = 0;
+    this -> g_dirty_fifo_head = 0;
+    this -> g_dirty_fifo_cnt = 0;
+    return;
+}	//End private method: reset_dirty | void |
+
+/***************************************************************************/
+//!	@brief private method
+//!	get_glyph | Frame_buffer_sprite | bool |
+/***************************************************************************/
+//! @param sprite | Frame_buffer_sprite | sprite from the frame buffer
+//! @param f_portrait | bool | true = the character is turned a quarter like render_sprite_portrait
+//! @return Glyph * | entry with the pixels of the character in the layout of a single sprite window | nullptr = not cached
+//! @details
+//!	\n Glyph cache. Characters are keyed by sprite index, by their colors resolved through the palette and by rotation
+//! \n A hit returns the pixels expanded before. A miss expands the character in the least recently used entry
+//! \n An entry the driver is still sending is never replaced. If the least recently used one is, nullptr and the caller renders the character
+//! \n Special sprites and characters with the same background and foreground are solid colors and are not cached
+/***************************************************************************/
+
+template <class Panel>
+typename Screen_panel<Panel>::Glyph *Screen_panel<Panel>::get_glyph( Frame_buffer_sprite sprite, bool f_portrait )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //Decode background and foreground colors
+    uint16_t background_color = this -> g_palette[ sprite.background_color ];
+    uint16_t foreground_color = this -> g_palette[ sprite.foreground_color ];
+    //If: no cache or not a character with two colors
+    if ((Config::GLYPH_CACHE_SIZE == 0) || (this -> is_valid_char( sprite.sprite_index ) == false) || (background_color == foreground_color))
     {
-        //Signal the error
-        this -> report_error( Error::REGISTER_SPRITE_FAIL );
-        DRETURN_ARG("ERR%d: unhandled special sprit\n", this -> get_error() );
-        return -1;
+        return nullptr;
     }
 
     //----------------------------------------------------------------
-    //	BUILD PIXEL MAP
+    //	VARS
     //----------------------------------------------------------------
 
-    //Temp return
-    int ret;
-    //If: sprite is a complex color map
-    if (f_solid_color == false)
+    //Least recently used entry. Replaced on a miss
+    uint16_t victim = 0;
+    //Tick the clock of the cache. If it wraps around the order is lost, start from an empty cache
+    this -> g_glyph_cache_tick++;
+    if (this -> g_glyph_cache_tick == 0)
     {
-        //Fast counter
-        int tw, th;
-        //Store a fullbinary width slice (row)
-        uint32_t sprite_width_slice;
-        DPRINT("sprite table index: %c %5d | width slice | ", sprite_index, sprite_index-' ' );
-        //For: Scan height
-        for (th = 0;th < Config::SPRITE_HEIGHT;th++)
-        {
-            //Grab full width slice of data
-            sprite_width_slice = sprite_ptr[ th ];
-            DPRINT_NOTAB(" %x |",sprite_width_slice);
-            //For: Scan width
-            for (tw = 0;tw < Config::SPRITE_WIDTH;tw++)
-            {
-                //Compute color from the binary sprite map | false = background | true = foreground
-                color = ((sprite_width_slice & 0x01) == 0x00)?(background_color):(foreground_color);
-                //Shift away the decoded bit
-                sprite_width_slice = sprite_width_slice >> 1;
-                //Save pixel
-                this -> g_pixel_data[((th *Config::SPRITE_WIDTH) +tw)] = color;
-            }	//End For: Scan width
-        }	//End For: Scan height
-        DPRINT_NOTAB("\n");
-        //Register the sprite for draw in the Display driver
-        ret = this -> Display::register_sprite( index_h *Config::SPRITE_HEIGHT, index_w *Config::SPRITE_WIDTH, Config::SPRITE_HEIGHT, Config::SPRITE_WIDTH, g_pixel_data );
-        //If: failed to register. the register sprite in future can be smaller than the sprite size if trying to register a sprite partially out of screen
-        if (ret <= 0)
+        for (uint16_t t = 0;t < Config::GLYPH_CACHE_SIZE;t++)
         {
-            //Signal the error
-            this -> report_error( Error::REGISTER_SPRITE_FAIL );
-            //Failed to register sprite
-            ret = -1;
-        }
-        //If: success
-        else
-        {
-            //One sprite has been drawn
-            ret = 1;
+            this -> g_glyph_cache[t].last_use = 0;
         }
-    }   //End If: sprite is a complex color map
-    //If: sprite is a solid color
-    else //if (f_solid_color == true)
+        this -> g_glyph_cache_tick = 1;
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //For: each entry of the glyph cache
+    for (uint16_t t = 0;t < Config::GLYPH_CACHE_SIZE;t++)
     {
-        //Register the sprite for draw in the Display driver
-        ret = this -> Display::register_sprite( index_h *Config::SPRITE_HEIGHT, index_w *Config::SPRITE_WIDTH, Config::SPRITE_HEIGHT, Config::SPRITE_WIDTH, color );
-        //If: failed to register. the register sprite in future can be smaller than the sprite size if trying to register a sprite partially out of screen
-        if (ret <= 0)
+        Glyph &glyph = this -> g_glyph_cache[t];
+        //If: hit
+        if ((glyph.last_use != 0) && (glyph.sprite_index == sprite.sprite_index) && (glyph.f_portrait == f_portrait) &&
+            (glyph.background_color == background_color) && (glyph.foreground_color == foreground_color))
         {
-            //Signal the error
-            this -> report_error( Error::REGISTER_SPRITE_FAIL );
-            //Failed to register sprite
-            ret = -1;
+            glyph.last_use = this -> g_glyph_cache_tick;
+            this -> g_glyph_cache_hits++;
+            return &glyph;
         }
-        //If: success
-        else
+        //If: least recently used so far
+        if (glyph.last_use < this -> g_glyph_cache[victim].last_use)
         {
-            //One sprite has been drawn
-            ret = 1;
+            victim = t;
         }
-    }	//End If: sprite is a solid color
-
-    //DEBUG
-    show_pixels();
+    }
+    this -> g_glyph_cache_misses++;
+    //If: the driver is still sending the least recently used entry. The queue holds recent entries, it is seldom the case
+    if ((this -> g_glyph_cache[victim].f_queued == true) && (this -> Display::is_sprite_buffer_used( this -> g_glyph_cache[victim].pixel ) == true))
+    {
+        return nullptr;
+    }
+    //Expand the character in the victim
+    Glyph &glyph = this -> g_glyph_cache[victim];
+    glyph.sprite_index = sprite.sprite_index;
+    glyph.f_portrait = f_portrait;
+    glyph.background_color = background_color;
+    glyph.foreground_color = foreground_color;
+    glyph.last_use = this -> g_glyph_cache_tick;
+    glyph.f_queued = false;
+    if (f_portrait == true)
+    {
+        this -> render_sprite_portrait( sprite, glyph.pixel, this -> g_sprite_height );
+    }
+    else
+    {
+        this -> render_sprite( sprite, glyph.pixel, this -> g_sprite_width );
+    }
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-    DRETURN();
-    return ret;
-}	//End private method: register_sprite | uint16_t | uint16_t |
+
+    return &glyph;
+}	//End private method: get_glyph | Frame_buffer_sprite | bool |
 
 /***************************************************************************/
-//!	@brief private tester
-//!	update_sprite | uint16_t | uint16_t | Frame_buffer_sprite |
+//!	@brief private method
+//!	invalidate_glyph | uint16_t |
 /***************************************************************************/
-//! @return ont | <0 = error coccurred | 0 = frame buffer wasn't updated | 1 = frame buffer was updated
+//! @param color | uint16_t | color that is leaving the palette
 //! @details
-//!	Update a sprite in the frame buffer and mark it for update if required
-//!	Increase the workload counter if applicable
-//!	If workload counter is zero, set the scan to the current sprite to quicken the seek
+//!	\n Glyph cache. Empty the entries that use a color as background or foreground. They are the first to be replaced
 /***************************************************************************/
 
-int8_t Screen::update_sprite( uint16_t index_h, uint16_t index_w, Frame_buffer_sprite new_sprite )
+template <class Panel>
+void Screen_panel<Panel>::invalidate_glyph( uint16_t color )
 {
-    DENTER_ARG("H: %d | W: %d |\n", index_h, index_w );
-    //----------------------------------------------------------------
-    //	CHECK
-    //----------------------------------------------------------------
-
-    //If: invalid coordinates
-    if ((Config::PEDANTIC_CHECKS == true) && ((index_h >= Config::FRAME_BUFFER_HEIGHT) || (index_w >= Config::FRAME_BUFFER_WIDTH)) )
+    //For: each entry of the glyph cache
+    for (uint16_t t = 0;t < Config::GLYPH_CACHE_SIZE;t++)
     {
-        DRETURN_ARG("ERR: bad index H: %d | W: %d |\n", index_h, index_w);
-        return -1;
+        if ((this -> g_glyph_cache[t].background_color == color) || (this -> g_glyph_cache[t].foreground_color == color))
+        {
+            this -> g_glyph_cache[t].last_use = 0;
+        }
     }
+    return;
+}	//End private method: invalidate_glyph | uint16_t |
+
+/***************************************************************************/
+//!	@brief private method
+//!	get_scroll_column | uint16_t |
+/***************************************************************************/
+//! @param index_w | uint16_t | column of the frame buffer
+//! @return uint16_t | column of the display memory that is shown at index_w
+//! @details
+//!	\n The hardware scroll shows the memory column index +(w -index +shift) %size at column w of the scroll area
+/***************************************************************************/
 
+template <class Panel>
+inline uint16_t Screen_panel<Panel>::get_scroll_column( uint16_t index_w )
+{
     //----------------------------------------------------------------
     //	BODY
     //----------------------------------------------------------------
 
-    int8_t num_updated_sprites;
-    //Fetch sprite
-    Frame_buffer_sprite old_sprite = this -> g_frame_buffer[index_h][index_w];
-    //If: the sprites are the same
-    if (this -> is_same_sprite(old_sprite, new_sprite) == true)
+    //If: the column is outside the scroll area or the area is not rotated
+    if ((this -> g_scroll_shift == 0) || (index_w < this -> g_scroll_index_w) || (index_w >= this -> g_scroll_index_w +this -> g_scroll_size))
     {
-        //Do nothing
-        num_updated_sprites = 0;
-    }
-    //If: the sprites are not the same
-    else //if (old_sprite.f_update == true)
-    {
-        //If: old sprite was not marked for update
-        if (old_sprite.f_update == false)
-        {
-            //If: the library workload is full
-            if ((Config::PEDANTIC_CHECKS == true) && (this -> g_pending_cnt >= Config::FRAME_BUFFER_SIZE))
-            {
-                this -> report_error( Screen::Error::PENDING_OVERFLOW );
-            }
-            //If: the screen class was IDLE before this call
-            else if (this -> g_pending_cnt == 0)
-            {
-                //Set the scan to this sprite so that the seek is quick
-                this -> g_status.scan_h = index_h;
-                this -> g_status.scan_w = index_w;
-                //Increase workload of the Screen class
-                this -> g_pending_cnt = 1;
-            }
-            //If: Screen class is already busy
-            else
-            {
-                //Increase workload of the Screen class
-                this -> g_pending_cnt++;
-            }
-        }
-    
-        //Mark for update
-        new_sprite.f_update = true;
-        //Update the sprite
-        this -> g_frame_buffer[index_h][index_w] = new_sprite;
-        //A sprite was updated
-        num_updated_sprites = 1;
+        return index_w;
     }
 
     //----------------------------------------------------------------
     //	RETURN
     //----------------------------------------------------------------
-    DRETURN();
-    return num_updated_sprites;
-}	//End private method: update_sprite | uint16_t | uint16_t | Frame_buffer_sprite |
+
+    return this -> g_scroll_index_w +(index_w -this -> g_scroll_index_w +this -> g_scroll_shift) %this -> g_scroll_size;
+}	//End private method: get_scroll_column | uint16_t |
 
 /**********************************************************************************
 **	NAMESPACE
@@ -0,0 +1,448 @@
+/**********************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Orso Eric
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************/
+
+/**********************************************************************************
+**	ENVIROMENT VARIABILE
+**********************************************************************************/
+
+#ifndef LONGAN_NANO_SCREEN_SCHEDULER_H_
+    #define LONGAN_NANO_SCREEN_SCHEDULER_H_
+
+/**********************************************************************************
+**	GLOBAL INCLUDES
+**********************************************************************************/
+
+//Screens driven by the scheduler
+#ifndef SCREEN_HPP_
+    #include "longan_nano_screen.hpp"
+#endif
+
+/**********************************************************************************
+**	DEFINES
+**********************************************************************************/
+
+/**********************************************************************************
+**	MACROS
+**********************************************************************************/
+
+/**********************************************************************************
+**	NAMESPACE
+**********************************************************************************/
+
+//! @namespace Longan_nano namespace encapsulating all related drivers and HAL
+namespace Longan_nano
+{
+
+/**********************************************************************************
+**	TYPEDEFS
+**********************************************************************************/
+
+/**********************************************************************************
+**	PROTOTYPE: STRUCTURES
+**********************************************************************************/
+
+/**********************************************************************************
+**	PROTOTYPE: GLOBAL VARIABILES
+**********************************************************************************/
+
+/**********************************************************************************
+**	PROTOTYPE: CLASS
+**********************************************************************************/
+
+/************************************************************************************/
+//! @class 		Screen_scheduler
+/************************************************************************************/
+//!	@author		Orso Eric
+//! @brief		Drive several screens on different SPI buses from a single update call
+//! @copyright	BSD 3-Clause License Copyright (c) 2020, Orso Eric
+//! @details
+//! \n	Each Screen owns its SPI and its DMA channel through the panel traits, e.g. Screen and Screen_panel< Panel_st7735s_w160_h80_spi1 >
+//! \n	Screens of different panels are different types. The scheduler stores one pointer and the update hooks of each screen
+//! \n	update executes one step of each screen. A step only kicks the DMA of its bus, so the DMA channels send sprites in parallel
+//! \n	The screen served first rotates at each call. With burst budgets on polled buses no screen is always served last
+//! \n	With the Display driver in ISR mode, each DMA channel interrupt calls update_sprite_isr of its own screen
+/************************************************************************************/
+
+class Screen_scheduler
+{
+    //Visible to all
+    public:
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PUBLIC ENUM
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //! @brief Configurations of the scheduler
+        typedef enum _Config
+        {
+            MAX_SCREENS		= 3,				//Maximum number of screens. One for each SPI of the GD32VF103
+        } Config;
+
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	CONSTRUCTORS
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //Empty Constructor
+        Screen_scheduler( void );
+
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	DESTRUCTORS
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //Empty Destructor
+        ~Screen_scheduler( void );
+
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PUBLIC METHOD
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //Add a screen to the scheduler. The screen must outlive the scheduler
+        template <class Panel>
+        bool add( Screen_panel<Panel> &screen );
+        //Execute one update step of each screen. Round robin on the screen served first
+        bool update( void );
+        //Sum of the sprites pending for update in the frame buffers of the screens
+        int get_pending( void );
+        //Sum of the sprites registered in the drivers and not yet sent
+        int get_sprite_queue_depth( void );
+        //Number of screens driven by the scheduler
+        int get_num_screens( void );
+
+    //Visible only inside the class
+    private:
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PRIVATE STRUCT
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //! @brief A screen and the hooks that call its methods
+        typedef struct _Member
+        {
+            //Screen_panel of any panel
+            void *screen_ptr;
+            //Hooks instanced for the panel of the screen
+            bool (*update)( void *screen_ptr );
+            int (*get_pending)( void *screen_ptr );
+            int (*get_sprite_queue_depth)( void *screen_ptr );
+        } Member;
+
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PRIVATE METHODS
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //Hooks. Restore the type of the screen and call its method
+        template <class Panel>
+        static bool update_screen( void *screen_ptr );
+        template <class Panel>
+        static int get_screen_pending( void *screen_ptr );
+        template <class Panel>
+        static int get_screen_queue_depth( void *screen_ptr );
+
+        /*********************************************************************************************************************************************************
+        **********************************************************************************************************************************************************
+        **	PRIVATE VARS
+        **********************************************************************************************************************************************************
+        *********************************************************************************************************************************************************/
+
+        //Screens driven by the scheduler
+        Member g_member[ Config::MAX_SCREENS ];
+        uint8_t g_num_screens;
+        //Screen served first by the next update
+        uint8_t g_next;
+};	//End Class: Screen_scheduler
+
+    /*********************************************************************************************************************************************************
+    **********************************************************************************************************************************************************
+    **	CONSTRUCTORS
+    **********************************************************************************************************************************************************
+    *********************************************************************************************************************************************************/
+
+/***************************************************************************/
+//!	@brief Empty Constructor
+//!	Screen_scheduler | void
+/***************************************************************************/
+//! @return void
+//! @details
+//!	\n No screens
+/***************************************************************************/
+
+inline Screen_scheduler::Screen_scheduler( void )
+{
+    //No screens
+    this -> g_num_screens = 0;
+    this -> g_next = 0;
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return;
+}	//End Constructor: Screen_scheduler | void
+
+    /*********************************************************************************************************************************************************
+    **********************************************************************************************************************************************************
+    **	DESTRUCTORS
+    **********************************************************************************************************************************************************
+    *********************************************************************************************************************************************************/
+
+/***************************************************************************/
+//!	@brief Empty Destructor
+/***************************************************************************/
+//!	~Screen_scheduler | void
+//! @return void
+/***************************************************************************/
+
+inline Screen_scheduler::~Screen_scheduler( void )
+{
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return;
+}	//End Destructor: Screen_scheduler | void
+
+    /*********************************************************************************************************************************************************
+    **********************************************************************************************************************************************************
+    **	PUBLIC METHOD
+    **********************************************************************************************************************************************************
+    *********************************************************************************************************************************************************/
+
+/***************************************************************************/
+//!	@brief public method
+//!	add | Screen_panel<Panel> &
+/***************************************************************************/
+//! @param screen | Screen_panel<Panel> & | screen to be driven by the scheduler
+//! @return bool | false = OK | true = ERR
+//! @details
+//!	\n The scheduler is full or the screen was already added
+//! \n Two screens on the same SPI would share the bus and its DMA channel, the user wires one screen per bus
+/***************************************************************************/
+
+template <class Panel>
+inline bool Screen_scheduler::add( Screen_panel<Panel> &screen )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: the scheduler is full
+    if (this -> g_num_screens >= Config::MAX_SCREENS)
+    {
+        return true;
+    }
+    //For: each screen already added
+    for (uint8_t t = 0;t < this -> g_num_screens;t++)
+    {
+        //If: same screen
+        if (this -> g_member[ t ].screen_ptr == (void *)&screen)
+        {
+            return true;
+        }
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    Member &member = this -> g_member[ this -> g_num_screens ];
+    member.screen_ptr = (void *)&screen;
+    member.update = &Screen_scheduler::update_screen<Panel>;
+    member.get_pending = &Screen_scheduler::get_screen_pending<Panel>;
+    member.get_sprite_queue_depth = &Screen_scheduler::get_screen_queue_depth<Panel>;
+    this -> g_num_screens++;
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return false;
+}	//End public method: add | Screen_panel<Panel> &
+
+/***************************************************************************/
+//!	@brief public method
+//!	update | void
+/***************************************************************************/
+//! @return bool | false = OK | true = ERR. At least one screen failed
+//! @details
+//!	\n Execute one update step of each screen, starting from a different screen each call
+//! \n A step registers the windows of a screen and kicks the DMA of its bus without waiting for the other buses
+/***************************************************************************/
+
+inline bool Screen_scheduler::update( void )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    //If: no screens
+    if (this -> g_num_screens == 0)
+    {
+        return false;
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    bool f_ret = false;
+    uint8_t index = this -> g_next;
+    //For: each screen
+    for (uint8_t t = 0;t < this -> g_num_screens;t++)
+    {
+        f_ret |= this -> g_member[ index ].update( this -> g_member[ index ].screen_ptr );
+        index = (index < this -> g_num_screens -1)?(index +1):(0);
+    }
+    //The next call starts from the next screen
+    this -> g_next = (this -> g_next < this -> g_num_screens -1)?(this -> g_next +1):(0);
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return f_ret;
+}	//End public method: update | void
+
+/***************************************************************************/
+//!	@brief public method
+//!	get_pending | void
+/***************************************************************************/
+//! @return int | sprites pending for update in the frame buffers of all the screens
+/***************************************************************************/
+
+inline int Screen_scheduler::get_pending( void )
+{
+    int pending = 0;
+    //For: each screen
+    for (uint8_t t = 0;t < this -> g_num_screens;t++)
+    {
+        pending += this -> g_member[ t ].get_pending( this -> g_member[ t ].screen_ptr );
+    }
+    return pending;
+}	//End public method: get_pending | void
+
+/***************************************************************************/
+//!	@brief public method
+//!	get_sprite_queue_depth | void
+/***************************************************************************/
+//! @return int | sprites registered in the drivers of all the screens and not yet sent
+/***************************************************************************/
+
+inline int Screen_scheduler::get_sprite_queue_depth( void )
+{
+    int depth = 0;
+    //For: each screen
+    for (uint8_t t = 0;t < this -> g_num_screens;t++)
+    {
+        depth += this -> g_member[ t ].get_sprite_queue_depth( this -> g_member[ t ].screen_ptr );
+    }
+    return depth;
+}	//End public method: get_sprite_queue_depth | void
+
+/***************************************************************************/
+//!	@brief public method
+//!	get_num_screens | void
+/***************************************************************************/
+//! @return int | number of screens driven by the scheduler
+/***************************************************************************/
+
+inline int Screen_scheduler::get_num_screens( void )
+{
+    return this -> g_num_screens;
+}	//End public method: get_num_screens | void
+
+    /*********************************************************************************************************************************************************
+    **********************************************************************************************************************************************************
+    **	PRIVATE METHODS
+    **********************************************************************************************************************************************************
+    *********************************************************************************************************************************************************/
+
+/***************************************************************************/
+//!	@brief private method
+//!	update_screen | void *
+/***************************************************************************/
+//! @param screen_ptr | void * | Screen_panel<Panel> added to the scheduler
+//! @return bool | false = OK | true = ERR
+/***************************************************************************/
+
+template <class Panel>
+inline bool Screen_scheduler::update_screen( void *screen_ptr )
+{
+    return ((Screen_panel<Panel> *)screen_ptr) -> update();
+}	//End private method: update_screen | void *
+
+/***************************************************************************/
+//!	@brief private method
+//!	get_screen_pending | void *
+/***************************************************************************/
+//! @param screen_ptr | void * | Screen_panel<Panel> added to the scheduler
+//! @return int | sprites pending for update in the frame buffer of the screen
+/***************************************************************************/
+
+template <class Panel>
+inline int Screen_scheduler::get_screen_pending( void *screen_ptr )
+{
+    return ((Screen_panel<Panel> *)screen_ptr) -> get_pending();
+}	//End private method: get_screen_pending | void *
+
+/***************************************************************************/
+//!	@brief private method
+//!	get_screen_queue_depth | void *
+/***************************************************************************/
+//! @param screen_ptr | void * | Screen_panel<Panel> added to the scheduler
+//! @return int | sprites registered in the driver of the screen and not yet sent
+/***************************************************************************/
+
+template <class Panel>
+inline int Screen_scheduler::get_screen_queue_depth( void *screen_ptr )
+{
+    return ((Screen_panel<Panel> *)screen_ptr) -> get_sprite_queue_depth();
+}	//End private method: get_screen_queue_depth | void *
+
+/**********************************************************************************
+**	NAMESPACE
+**********************************************************************************/
+
+} //End Namespace: Longan_nano
+
+#else
+    #warning "Multiple inclusion of hader file LONGAN_NANO_SCREEN_SCHEDULER_H_"
+#endif
@@ -86,6 +86,10 @@ typedef enum _Demo
     TEST_CHANGE_COLORS,
     //Profile execution time with constant workload
     TEST_WORKLOAD,
+    //Alarm flash and dimming done by the panel. No pixel is sent
+    TEST_EFFECTS,
+    //Dense diagnostic page with the 6x8 font. 10 rows of 26 characters
+    TEST_DIAGNOSTICS,
     //Total number of demos installed
     NUM_DEMOS,
     //Maximum length of a demo string
@@ -131,6 +135,9 @@ Scheduler g_scheduler = { 0 };
 //True when the PA8 button is released
 volatile bool g_f_pa8_button_up = false;
 
+//Display Driver. Global so that the DMA ISR can advance the driver FSM
+Longan_nano::Screen g_screen;
+
 /****************************************************************************
 **	FUNCTIONS
 ****************************************************************************/
@@ -156,9 +163,6 @@ int main( void )
     Longan_nano::Chrono timer_screen;
     Longan_nano::Chrono timer_demo;
 
-    
-    //Display Driver
-    Longan_nano::Screen g_screen;
     //elapsed time
     int elapsed_us;
     //Demo scheduler prescaler
@@ -268,6 +272,11 @@ int main( void )
                 {
                     //Clear flag
                     g_f_pa8_button_up = false;
+                    //Stop the whole screen effects of the previous demo
+                    g_screen.set_blink( 0 );
+                    g_screen.set_idle( false );
+                    //Back to the default font of the other demos
+                    g_screen.set_font( (Longan_nano::Screen::Font)Longan_nano::Screen::Config::FONT_DEFAULT );
                     //Next demo
                     demo_index = (Demo)( ((uint8_t)demo_index < (uint8_t)Demo::NUM_DEMOS-1)?((uint8_t)demo_index +1):(0));
                     //Initialize the demo
@@ -352,8 +361,23 @@ int main( void )
                     //If: demo is initialized and can be run
                     else
                     {
-                        //Clear the screen to a random color
+                        //Clear the screen to a random color. The screen is sent as a single solid color window
                         g_screen.clear( (Longan_nano::Screen::Color)g_rng_color( g_rng_engine ) );     
+                        //Compute CPU usage for the screen
+                        g_screen.print( 0, 0, "CPU |" );
+                        g_screen.print( 0, 12, '|' );
+                        int tmp_uptime = timer_uptime.stop( Longan_nano::Chrono::Unit::milliseconds );
+                        int tmp_deltat = timer_screen.get_accumulator( Longan_nano::Chrono::Unit::milliseconds );
+                        int cpu_tmp = (int64_t)1 *tmp_deltat *100000 /tmp_uptime;
+                        g_screen.set_format( User::String::STRING_SIZE_SENG -1, Longan_nano::Screen::Format_align::ADJ_RIGHT, Longan_nano::Screen::Format_format::ENG, -3 );
+                        g_screen.print( 0, 11, tmp_deltat );
+                        g_screen.print( 0, 19, cpu_tmp );
+                        //Show the SPI bytes spent opening address windows for each byte of pixel data
+                        g_screen.print( 1, 0, "CMD |" );
+                        g_screen.print( 1, 12, '|' );
+                        int64_t pixel_bytes = g_screen.get_pixel_bytes();
+                        int cmd_ratio = (pixel_bytes > 0)?((int64_t)1 *g_screen.get_command_bytes() *1000 /pixel_bytes):(0);
+                        g_screen.print( 1, 11, cmd_ratio );
                     }
 
                     break;
@@ -821,9 +845,123 @@ int main( void )
                         cpu_tmp = (int64_t)1 *tmp_deltat *100000 /tmp_uptime;
                         g_screen.set_format( User::String::STRING_SIZE_SENG -1, Longan_nano::Screen::Format_align::ADJ_RIGHT, Longan_nano::Screen::Format_format::ENG, -3 );
                         g_screen.print( 0, 19, (int)cpu_tmp );
+                        //Show the SPI bytes spent opening address windows for each byte of pixel data
+                        g_screen.print( 1, 0, "CMD |" );
+                        g_screen.print( 1, 12, '|' );
+                        int64_t pixel_bytes = g_screen.get_pixel_bytes();
+                        int cmd_ratio = (pixel_bytes > 0)?((int64_t)1 *g_screen.get_command_bytes() *1000 /pixel_bytes):(0);
+                        g_screen.set_format( User::String::STRING_SIZE_SENG -1, Longan_nano::Screen::Format_align::ADJ_RIGHT, Longan_nano::Screen::Format_format::ENG, -3 );
+                        g_screen.print( 1, 11, cmd_ratio );
+                    }
+                    break;
+                }
+                
+                //----------------------------------------------------------------
+                //	TEST_EFFECTS
+                //----------------------------------------------------------------
+                //	Whole screen effects done by the panel with a command
+                //	An alarm blinks the screen for a while, then the screen dims to idle mode
+
+                case Demo::TEST_EFFECTS:
+                {
+                    static uint8_t effect_cnt;
+                    //If: demo is yet to be initialized
+                    if (f_demo_init == false)
+                    {
+                        g_screen.reset_colors();
+                        //Clear the screen
+                        g_screen.clear( Longan_nano::Screen::Color::BLACK );
+                        g_screen.print( 0, 0, "DEMO: Effects" );
+                        //Configure prescaler to achieve the correct execution time    
+                        demo_pre = Config::SLOW_DEMO_US/Config::SCREEN_US;
+                        effect_cnt = 0;
+                        //Demo is now initialized
+                        f_demo_init = true;
+                    }
+                    //If: demo is initialized and can be run
+                    else
+                    {
+                        //Alarm. The whole screen flashes, each flash is a command of a couple of bytes
+                        if (effect_cnt == 0)
+                        {
+                            g_screen.print( 2, 0, "ALARM ", Longan_nano::Screen::Color::RED );
+                            g_screen.set_idle( false );
+                            g_screen.set_blink( 250 );
+                        }
+                        //Alarm acknowledged. Stop the flash
+                        else if (effect_cnt == 4)
+                        {
+                            g_screen.print( 2, 0, "ACK   ", Longan_nano::Screen::Color::GREEN );
+                            g_screen.set_blink( 0 );
+                        }
+                        //Nothing going on. Dim the screen to idle mode
+                        else if (effect_cnt == 8)
+                        {
+                            g_screen.print( 2, 0, "IDLE  ", Longan_nano::Screen::Color::WHITE );
+                            g_screen.set_idle( true );
+                        }
+                        effect_cnt = (effect_cnt < 11)?(effect_cnt +1):(0);
+                        //Show the SPI bytes spent opening address windows for each byte of pixel data
+                        g_screen.print( 1, 0, "CMD |" );
+                        g_screen.print( 1, 12, '|' );
+                        int64_t pixel_bytes = g_screen.get_pixel_bytes();
+                        int cmd_ratio = (pixel_bytes > 0)?((int64_t)1 *g_screen.get_command_bytes() *1000 /pixel_bytes):(0);
+                        g_screen.set_format( User::String::STRING_SIZE_SENG -1, Longan_nano::Screen::Format_align::ADJ_RIGHT, Longan_nano::Screen::Format_format::ENG, -3 );
+                        g_screen.print( 1, 11, cmd_ratio );
                     }
                     break;
-                }				
+                }
+
+                //----------------------------------------------------------------
+                //	TEST_DIAGNOSTICS
+                //----------------------------------------------------------------
+                //	Switch to the 6x8 font of the registry. A page of counters with a label and a value per row
+
+                case Demo::TEST_DIAGNOSTICS:
+                {
+                    static int demo_cnt;
+                    //If: demo is yet to be initialized
+                    if (f_demo_init == false)
+                    {
+                        g_screen.reset_colors();
+                        //Dense font. The screen is cleared to black
+                        g_screen.set_font( Longan_nano::Screen::Font::FIXED_6X8 );
+                        g_screen.print( 0, 0, "DEMO: Diagnostics 6x8", Longan_nano::Screen::Color::YELLOW );
+                        g_screen.print( 1, 0, "Uptime                 mS" );
+                        g_screen.print( 2, 0, "Screen CPU             mS" );
+                        g_screen.print( 3, 0, "Pending" );
+                        g_screen.print( 4, 0, "Queue depth" );
+                        g_screen.print( 5, 0, "Glyph hits" );
+                        g_screen.print( 6, 0, "Glyph misses" );
+                        g_screen.print( 7, 0, "Pixel bytes" );
+                        g_screen.print( 8, 0, "Command bytes" );
+                        g_screen.print( 9, 0, "Counter" );
+                        //Configure prescaler to achieve the correct execution time    
+                        demo_pre = Config::MEDIUM_DEMO_US/Config::SCREEN_US;
+                        demo_cnt = 0;
+                        //Demo is now initialized
+                        f_demo_init = true;
+                    }
+                    //If: demo is initialized and can be run
+                    else
+                    {
+                        demo_cnt++;
+                        //Values right aligned on the last columns
+                        g_screen.set_format( 10, Longan_nano::Screen::Format_align::ADJ_RIGHT, Longan_nano::Screen::Format_format::NUM );
+                        g_screen.print( 1, 22, timer_uptime.stop( Longan_nano::Chrono::Unit::milliseconds ) );
+                        g_screen.print( 2, 22, timer_screen.get_accumulator( Longan_nano::Chrono::Unit::milliseconds ) );
+                        g_screen.print( 3, 25, g_screen.get_pending() );
+                        g_screen.print( 4, 25, g_screen.get_sprite_queue_depth() );
+                        g_screen.print( 5, 25, (int)g_screen.get_glyph_cache_hits() );
+                        g_screen.print( 6, 25, (int)g_screen.get_glyph_cache_misses() );
+                        g_screen.print( 9, 25, demo_cnt );
+                        //Bytes on the SPI in thousands
+                        g_screen.set_format( User::String::STRING_SIZE_SENG -1, Longan_nano::Screen::Format_align::ADJ_RIGHT, Longan_nano::Screen::Format_format::ENG, 3 );
+                        g_screen.print( 7, 25, (int)(g_screen.get_pixel_bytes() /1000) );
+                        g_screen.print( 8, 25, (int)(g_screen.get_command_bytes() /1000) );
+                    }
+                    break;
+                }
                 //Unhandled demo
                 default:
                 {
@@ -906,4 +1044,40 @@ void EXTI5_9_IRQHandler( void )
     {
         //Do nothing (should clear the interrupt flags)
     }
-}   //End isr: EXTI5_9_IRQHandler | void
\ No newline at end of file
+}   //End isr: EXTI5_9_IRQHandler | void
+
+/****************************************************************************
+**	@brief isr
+**	DMA0_Channel2_IRQHandler | void
+****************************************************************************/
+//! @details 
+//! DMA0 CH2 moves sprite data to SPI0. A transfer is complete
+//! The screen driver sends the next commands and starts the next transfer
+/***************************************************************************/
+
+extern "C"
+void DMA0_Channel2_IRQHandler( void )
+{
+    //Advance the Display driver FSM
+    g_screen.update_sprite_isr();
+
+    return;
+}   //End isr: DMA0_Channel2_IRQHandler | void
+
+/****************************************************************************
+**	@brief isr
+**	SPI0_IRQHandler | void
+****************************************************************************/
+//! @details 
+//! SPI0 received a frame. The screen driver armed it while it waits for the SPI to be idle
+//! The screen driver sends the next commands and starts the next transfer
+/***************************************************************************/
+
+extern "C"
+void SPI0_IRQHandler( void )
+{
+    //Advance the Display driver FSM
+    g_screen.update_sprite_isr();
+
+    return;
+}   //End isr: SPI0_IRQHandler | void
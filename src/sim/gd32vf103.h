@@ -0,0 +1,1365 @@
+/**********************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Orso Eric
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************/
+
+/**********************************************************************************
+**	ENVIROMENT VARIABILE
+**********************************************************************************/
+
+#ifndef GD32VF103_H
+    #define GD32VF103_H
+
+/**********************************************************************************
+**	GLOBAL INCLUDES
+**********************************************************************************/
+
+//Standard bit size types
+#include <stdint.h>
+#include <string.h>
+
+/**********************************************************************************
+**	DESCRIPTION
+***********************************************************************************
+**		SIMULATED GD32VF103 HAL
+**	Host stand in for <gd32vf103.h> used by the native environment
+**	Implements the subset of the GD32VF103 firmware library used by the Longan Nano drivers
+**	RCU, GPIO, EXTI, ECLIC, SPI, DMA and the machine timer
+**
+**		TIME
+**	Virtual time advances in CPU cycles at SystemCoreClock
+**	Every HAL call costs Sim::Config::HAL_CALL_CYCLES, a read of the timer costs Sim::Config::TIMER_READ_CYCLES
+**	mtime runs at SystemCoreClock/4 like the Bumblebee core timer
+**	Application code between HAL calls is free. Use Sim::spend to charge it
+**
+**		SPI
+**	Transmit buffer and shift register. Frame time = frame bits * prescaler * core clock / bus clock
+**	SPI0 is on APB2 (108MHz), SPI1 and SPI2 are on APB1 (54MHz)
+**	TBE and TRANS flags are computed from the virtual time when read
+**
+**		DMA
+**	A channel with the peripheral address of a SPI data register feeds the SPI when TBE is set
+**	Each item is written Sim::Config::DMA_LATENCY_CYCLES after TBE rises
+**	Transfer complete raises FTF and the interrupt, if enabled
+**
+**		INTERRUPTS
+**	Pending interrupts are dispatched at HAL call boundaries, outside of interrupt context
+**	Handlers are the weak IRQ symbols of the application, e.g. DMA0_Channel2_IRQHandler
+**
+**		LCD
+**	Each SPI drives a ST7735S model. Frames are sampled with the RS pin bound to the SPI
+**	The model decodes CASET, RASET, RAMWR, COLMOD, MADCTL, VSCRDEF, VSCSAD and the display modes
+**	and keeps the 132x162 frame memory and traffic counters
+**
+**		ADDRESSES
+**	The drivers pass memory addresses to the DMA as uintptr_t. It is 32 bits on the MCU and holds a full host pointer here
+**	DMA source buffers can live anywhere: static storage, stack or heap
+**********************************************************************************/
+
+/**********************************************************************************
+**	DEFINES
+**********************************************************************************/
+
+#define BIT(x)						((uint32_t)((uint32_t)0x01U<<(x)))
+#define BITS(start, end)			((0xFFFFFFFFUL << (start)) & (0xFFFFFFFFUL >> (31U - (uint32_t)(end))))
+
+//Peripheral base addresses
+#define GPIOA						(0x40010800U)
+#define GPIOB						(0x40010C00U)
+#define GPIOC						(0x40011000U)
+#define GPIOD						(0x40011400U)
+#define GPIOE						(0x40011800U)
+#define SPI0						(0x40013000U)
+#define SPI1						(0x40003800U)
+#define SPI2						(0x40003C00U)
+#define DMA0						(0x40020000U)
+#define DMA1						(0x40020400U)
+
+//GPIO
+#define GPIO_PIN_0					BIT(0)
+#define GPIO_PIN_1					BIT(1)
+#define GPIO_PIN_2					BIT(2)
+#define GPIO_PIN_3					BIT(3)
+#define GPIO_PIN_4					BIT(4)
+#define GPIO_PIN_5					BIT(5)
+#define GPIO_PIN_6					BIT(6)
+#define GPIO_PIN_7					BIT(7)
+#define GPIO_PIN_8					BIT(8)
+#define GPIO_PIN_9					BIT(9)
+#define GPIO_PIN_10					BIT(10)
+#define GPIO_PIN_11					BIT(11)
+#define GPIO_PIN_12					BIT(12)
+#define GPIO_PIN_13					BIT(13)
+#define GPIO_PIN_14					BIT(14)
+#define GPIO_PIN_15					BIT(15)
+#define GPIO_MODE_AIN				((uint8_t)0x00U)
+#define GPIO_MODE_IN_FLOATING		((uint8_t)0x04U)
+#define GPIO_MODE_IPD				((uint8_t)0x28U)
+#define GPIO_MODE_IPU				((uint8_t)0x48U)
+#define GPIO_MODE_OUT_OD			((uint8_t)0x14U)
+#define GPIO_MODE_OUT_PP			((uint8_t)0x10U)
+#define GPIO_MODE_AF_OD				((uint8_t)0x1CU)
+#define GPIO_MODE_AF_PP				((uint8_t)0x18U)
+#define GPIO_OSPEED_10MHZ			((uint8_t)0x01U)
+#define GPIO_OSPEED_2MHZ			((uint8_t)0x02U)
+#define GPIO_OSPEED_50MHZ			((uint8_t)0x03U)
+#define GPIO_PORT_SOURCE_GPIOA		((uint8_t)0x00U)
+#define GPIO_PORT_SOURCE_GPIOB		((uint8_t)0x01U)
+#define GPIO_PORT_SOURCE_GPIOC		((uint8_t)0x02U)
+#define GPIO_PIN_SOURCE_8			((uint8_t)0x08U)
+
+//EXTI
+#define EXTI_8						BIT(8)
+
+//SPI registers
+#define SPI_CTL0(spix)				(Sim::spi_register( spix ).ctl0)
+#define SPI_CTL1(spix)				(Sim::spi_register( spix ).ctl1)
+#define SPI_STAT(spix)				(Sim::spi_stat( spix ))
+#define SPI_DATA(spix)				(Sim::spi_peripheral( spix ).data)
+//SPI_CTL0 bits
+#define SPI_CTL0_CKPH				BIT(0)
+#define SPI_CTL0_CKPL				BIT(1)
+#define SPI_CTL0_MSTMOD				BIT(2)
+#define SPI_CTL0_PSC				BITS(3,5)
+#define SPI_CTL0_SPIEN				BIT(6)
+#define SPI_CTL0_LF					BIT(7)
+#define SPI_CTL0_SWNSS				BIT(8)
+#define SPI_CTL0_SWNSSEN			BIT(9)
+#define SPI_CTL0_RO					BIT(10)
+#define SPI_CTL0_FF16				BIT(11)
+#define SPI_CTL0_BDOEN				BIT(14)
+#define SPI_CTL0_BDEN				BIT(15)
+//SPI_CTL1 bits
+#define SPI_CTL1_DMAREN				BIT(0)
+#define SPI_CTL1_DMATEN				BIT(1)
+#define SPI_CTL1_NSSDRV				BIT(2)
+#define SPI_CTL1_ERRIE				BIT(5)
+#define SPI_CTL1_RBNEIE				BIT(6)
+#define SPI_CTL1_TBEIE				BIT(7)
+//SPI_STAT bits
+#define SPI_STAT_RBNE				BIT(0)
+#define SPI_STAT_TBE				BIT(1)
+#define SPI_STAT_TRANS				BIT(7)
+//SPI init values
+#define SPI_MASTER					(SPI_CTL0_MSTMOD | SPI_CTL0_SWNSS)
+#define SPI_TRANSMODE_FULLDUPLEX	((uint32_t)0x00000000U)
+#define SPI_FRAMESIZE_16BIT			SPI_CTL0_FF16
+#define SPI_FRAMESIZE_8BIT			((uint32_t)0x00000000U)
+#define SPI_NSS_SOFT				SPI_CTL0_SWNSSEN
+#define SPI_ENDIAN_MSB				((uint32_t)0x00000000U)
+#define SPI_CK_PL_LOW_PH_1EDGE		((uint32_t)0x00000000U)
+#define CTL0_PSC(regval)			(BITS(3,5) & ((uint32_t)(regval) << 3))
+#define SPI_PSC_2					CTL0_PSC(0)
+#define SPI_PSC_4					CTL0_PSC(1)
+#define SPI_PSC_8					CTL0_PSC(2)
+#define SPI_PSC_16					CTL0_PSC(3)
+#define SPI_PSC_32					CTL0_PSC(4)
+#define SPI_PSC_64					CTL0_PSC(5)
+#define SPI_PSC_128					CTL0_PSC(6)
+#define SPI_PSC_256					CTL0_PSC(7)
+//SPI interrupts
+#define SPI_I2S_INT_TBE				((uint8_t)0x00U)
+#define SPI_I2S_INT_RBNE			((uint8_t)0x01U)
+#define SPI_I2S_INT_FLAG_TBE		((uint8_t)0x00U)
+#define SPI_I2S_INT_FLAG_RBNE		((uint8_t)0x01U)
+
+//DMA registers
+#define DMA_CHCTL(dmax, chx)		(Sim::dma_peripheral( dmax ).ch[ chx ].ctl)
+#define DMA_CHCNT(dmax, chx)		(Sim::dma_peripheral( dmax ).ch[ chx ].cnt)
+#define DMA_CHPADDR(dmax, chx)		(Sim::dma_peripheral( dmax ).ch[ chx ].paddr)
+#define DMA_CHMADDR(dmax, chx)		(Sim::dma_peripheral( dmax ).ch[ chx ].maddr)
+//DMA_CHCTL bits
+#define DMA_CHXCTL_CHEN				BIT(0)
+#define DMA_CHXCTL_FTFIE			BIT(1)
+#define DMA_CHXCTL_HTFIE			BIT(2)
+#define DMA_CHXCTL_ERRIE			BIT(3)
+#define DMA_CHXCTL_DIR				BIT(4)
+#define DMA_CHXCTL_CMEN				BIT(5)
+#define DMA_CHXCTL_PNAGA			BIT(6)
+#define DMA_CHXCTL_MNAGA			BIT(7)
+#define DMA_CHXCTL_PWIDTH			BITS(8,9)
+#define DMA_CHXCTL_MWIDTH			BITS(10,11)
+#define DMA_CHXCTL_PRIO				BITS(12,13)
+#define DMA_CHXCTL_M2M				BIT(14)
+//DMA init values
+#define DMA_PRIORITY_LOW			((uint32_t)0x00000000U)
+#define DMA_PRIORITY_HIGH			((uint32_t)0x00002000U)
+#define DMA_PRIORITY_ULTRA_HIGH		((uint32_t)0x00003000U)
+#define DMA_PERIPHERAL_WIDTH_8BIT	((uint32_t)0x00000000U)
+#define DMA_PERIPHERAL_WIDTH_16BIT	((uint32_t)0x00000100U)
+#define DMA_PERIPHERAL_WIDTH_32BIT	((uint32_t)0x00000200U)
+#define DMA_MEMORY_WIDTH_8BIT		((uint32_t)0x00000000U)
+#define DMA_MEMORY_WIDTH_16BIT		((uint32_t)0x00000400U)
+#define DMA_MEMORY_WIDTH_32BIT		((uint32_t)0x00000800U)
+//DMA flags and interrupts
+#define DMA_FLAG_G					BIT(0)
+#define DMA_FLAG_FTF				BIT(1)
+#define DMA_FLAG_HTF				BIT(2)
+#define DMA_FLAG_ERR				BIT(3)
+#define DMA_INT_FLAG_G				BIT(0)
+#define DMA_INT_FLAG_FTF			BIT(1)
+#define DMA_INT_FLAG_HTF			BIT(2)
+#define DMA_INT_FLAG_ERR			BIT(3)
+#define DMA_INT_FTF					DMA_CHXCTL_FTFIE
+#define DMA_INT_HTF					DMA_CHXCTL_HTFIE
+#define DMA_INT_ERR					DMA_CHXCTL_ERRIE
+
+//ECLIC
+#define ECLIC_PRIGROUP_LEVEL0_PRIO4	0
+#define ECLIC_PRIGROUP_LEVEL1_PRIO3	1
+#define ECLIC_PRIGROUP_LEVEL2_PRIO2	2
+#define ECLIC_PRIGROUP_LEVEL3_PRIO1	3
+#define ECLIC_PRIGROUP_LEVEL4_PRIO0	4
+
+/**********************************************************************************
+**	TYPEDEFS
+**********************************************************************************/
+
+typedef enum {RESET = 0, SET = 1} FlagStatus;
+typedef FlagStatus bit_status;
+typedef enum {DISABLE = 0, ENABLE = 1} ControlStatus;
+typedef enum {ERROR = 0, SUCCESS = 1} ErrStatus;
+
+//! @brief Clock gates. Clocks are not simulated
+typedef enum
+{
+    RCU_GPIOA, RCU_GPIOB, RCU_GPIOC, RCU_GPIOD, RCU_GPIOE, RCU_AF,
+    RCU_SPI0, RCU_SPI1, RCU_SPI2, RCU_DMA0, RCU_DMA1,
+} rcu_periph_enum;
+
+//! @brief DMA channels
+typedef enum
+{
+    DMA_CH0 = 0, DMA_CH1, DMA_CH2, DMA_CH3, DMA_CH4, DMA_CH5, DMA_CH6
+} dma_channel_enum;
+
+//! @brief EXTI lines used by the application
+typedef uint32_t exti_line_enum;
+//! @brief EXTI modes
+typedef enum {EXTI_INTERRUPT = 0, EXTI_EVENT} exti_mode_enum;
+//! @brief EXTI triggers
+typedef enum {EXTI_TRIG_RISING = 0, EXTI_TRIG_FALLING, EXTI_TRIG_BOTH} exti_trig_type_enum;
+
+//! @brief ECLIC interrupt sources, same numbering as the GD32VF103
+typedef enum
+{
+    EXTI5_9_IRQn			= 42,
+    DMA0_Channel0_IRQn		= 30,
+    DMA0_Channel1_IRQn		= 31,
+    DMA0_Channel2_IRQn		= 32,
+    DMA0_Channel3_IRQn		= 33,
+    DMA0_Channel4_IRQn		= 34,
+    DMA0_Channel5_IRQn		= 35,
+    DMA0_Channel6_IRQn		= 36,
+    SPI0_IRQn				= 54,
+    SPI1_IRQn				= 55,
+    SPI2_IRQn				= 70,
+    DMA1_Channel0_IRQn		= 75,
+    DMA1_Channel1_IRQn		= 76,
+    DMA1_Channel2_IRQn		= 77,
+    DMA1_Channel3_IRQn		= 78,
+    DMA1_Channel4_IRQn		= 79,
+    ECLIC_NUM_INTERRUPTS	= 87
+} IRQn_Type;
+
+/**********************************************************************************
+**	PROTOTYPE: INTERRUPT HANDLERS
+**********************************************************************************/
+
+//Handlers provided by the application. Weak so that unused ones resolve to nullptr
+extern "C"
+{
+    void DMA0_Channel2_IRQHandler( void ) __attribute__((weak));
+    void DMA0_Channel4_IRQHandler( void ) __attribute__((weak));
+    void DMA1_Channel1_IRQHandler( void ) __attribute__((weak));
+    void SPI0_IRQHandler( void ) __attribute__((weak));
+    void SPI1_IRQHandler( void ) __attribute__((weak));
+    void SPI2_IRQHandler( void ) __attribute__((weak));
+    void EXTI5_9_IRQHandler( void ) __attribute__((weak));
+}
+
+/**********************************************************************************
+**	NAMESPACE
+**********************************************************************************/
+
+//! @namespace Sim simulated peripherals of the GD32VF103
+namespace Sim
+{
+
+/**********************************************************************************
+**	ENUM
+**********************************************************************************/
+
+//! @brief Timing model of the simulator
+typedef enum _Config
+{
+    CORE_CLOCK				= 108000000,		//SystemCoreClock [Hz]
+    APB1_CLOCK				= 54000000,			//SPI1, SPI2 bus clock [Hz]
+    APB2_CLOCK				= 108000000,		//SPI0 bus clock [Hz]
+    HAL_CALL_CYCLES			= 12,				//CPU cycles charged for a HAL function call or a register access
+    TIMER_READ_CYCLES		= 8,				//CPU cycles charged for a read of mtime
+    DMA_LATENCY_CYCLES		= 6,				//Cycles between TBE and the DMA write of the next item
+    ISR_ENTRY_CYCLES		= 40,				//CPU cycles charged for the entry and the exit of an interrupt handler. Context save and restore
+    NUM_SPI					= 3,
+    NUM_DMA					= 2,
+    NUM_DMA_CH				= 7,
+    NUM_GPIO				= 5,
+    //ST7735S frame memory
+    LCD_MEM_COLS			= 132,
+    LCD_MEM_ROWS			= 162,
+} Config;
+
+/**********************************************************************************
+**	STRUCTURES
+**********************************************************************************/
+
+//! @brief Register whose address can be taken like a peripheral register. &SPI_DATA(x) yields the bus address
+struct Register
+{
+    uint32_t address;
+    uint32_t value;
+    uint32_t operator &( void ) const
+    {
+        return address;
+    }
+};
+
+//! @brief ST7735S display controller model
+struct Lcd
+{
+    //RS pin bound to the SPI. Sampled for every frame
+    uint32_t rs_gpio;
+    uint32_t rs_pin;
+    //Frame memory in RGB565
+    uint16_t mem[ Config::LCD_MEM_ROWS ][ Config::LCD_MEM_COLS ];
+    //Command decoder
+    uint8_t cmd;
+    uint32_t param_cnt;
+    uint8_t param[ 16 ];
+    //Address window
+    uint16_t xs, xe, ys, ye;
+    uint16_t x, y;
+    //Pixel decoder
+    uint8_t colmod;
+    uint8_t madctl;
+    uint8_t pixel_bytes[ 3 ];
+    uint8_t pixel_byte_cnt;
+    //Scroll
+    uint16_t tfa, vsa, bfa, ssa;
+    //Display modes
+    bool f_inverted;
+    bool f_display_on;
+    bool f_idle;
+    bool f_sleep;
+    //Traffic counters in bytes
+    uint64_t cnt_cmd_bytes;
+    uint64_t cnt_param_bytes;
+    uint64_t cnt_pixel_bytes;
+    uint64_t cnt_pixels;
+    uint64_t cnt_address_cmd;
+    uint64_t cnt_ramwr_cmd;
+    uint64_t cnt_cmd[ 256 ];
+};
+
+//! @brief SPI peripheral model
+struct Spi
+{
+    uint32_t base;
+    uint32_t ctl0;
+    uint32_t ctl1;
+    Register data;
+    //Transmit buffer
+    bool f_buffer;
+    uint16_t buffer;
+    //Receive buffer. A frame is received for each frame sent. Only the flag is modeled
+    bool f_rbne;
+    //Shift register
+    bool f_shift;
+    uint16_t shift;
+    bool f_shift16;
+    bool f_shift_rs;
+    uint64_t shift_end;
+    //Time TBE last rose
+    uint64_t tbe_time;
+    //Counters
+    uint64_t cnt_frames;
+    uint64_t cnt_busy_cycles;
+    uint64_t cnt_frame_size_changes;
+    uint64_t cnt_overrun;
+    uint32_t last_ctl0;
+    //Display on the bus
+    Lcd lcd;
+};
+
+//! @brief DMA channel model
+struct Dma_channel
+{
+    uint32_t ctl;
+    uint32_t cnt;
+    uint32_t paddr;
+    uintptr_t maddr;
+    //Internal
+    uintptr_t address;
+    uint32_t remaining;
+    uint64_t enable_time;
+    uint32_t flags;
+};
+
+//! @brief DMA peripheral model
+struct Dma
+{
+    uint32_t base;
+    Dma_channel ch[ Config::NUM_DMA_CH ];
+};
+
+//! @brief Whole simulated MCU
+struct Mcu
+{
+    //Virtual time in CPU cycles
+    uint64_t now;
+    //Cycles charged to the application
+    uint64_t cnt_hal_calls;
+    //Cycles spent inside interrupt handlers, entry included
+    uint64_t cnt_isr_cycles;
+    Spi spi[ Config::NUM_SPI ];
+    Dma dma[ Config::NUM_DMA ];
+    uint32_t gpio_out[ Config::NUM_GPIO ];
+    uint32_t gpio_in[ Config::NUM_GPIO ];
+    bool f_irq_enabled[ ECLIC_NUM_INTERRUPTS ];
+    bool f_global_irq;
+    bool f_in_isr;
+    uint32_t isr_cnt;
+    bool f_init;
+};
+
+/**********************************************************************************
+**	GLOBAL VARIABILES
+**********************************************************************************/
+
+//! @brief the simulated MCU
+inline Mcu g_mcu;
+
+/**********************************************************************************
+**	FUNCTIONS
+**********************************************************************************/
+
+void sync( void );
+
+//! @brief Initialize the simulated MCU. Called by the first HAL access
+inline void reset( void )
+{
+    memset( &g_mcu, 0, sizeof(Mcu) );
+    const uint32_t spi_base[ Config::NUM_SPI ] = { SPI0, SPI1, SPI2 };
+    for (int t = 0;t < Config::NUM_SPI;t++)
+    {
+        g_mcu.spi[t].base = spi_base[t];
+        g_mcu.spi[t].data.address = spi_base[t] +0x0C;
+        g_mcu.spi[t].lcd.rs_gpio = GPIOB;
+        g_mcu.spi[t].lcd.rs_pin = GPIO_PIN_0;
+        g_mcu.spi[t].lcd.colmod = 0x06;
+        g_mcu.spi[t].lcd.vsa = Config::LCD_MEM_ROWS;
+        g_mcu.spi[t].lcd.xe = Config::LCD_MEM_COLS -1;
+        g_mcu.spi[t].lcd.ye = Config::LCD_MEM_ROWS -1;
+        g_mcu.spi[t].lcd.f_sleep = true;
+    }
+    g_mcu.dma[0].base = DMA0;
+    g_mcu.dma[1].base = DMA1;
+    g_mcu.f_init = true;
+    return;
+}
+
+//! @brief Lazy initialization
+inline Mcu &mcu( void )
+{
+    if (g_mcu.f_init == false)
+    {
+        reset();
+    }
+    return g_mcu;
+}
+
+//! @brief Charge CPU cycles to the application and let the peripherals run
+inline void spend( uint64_t cycles )
+{
+    mcu().now += cycles;
+    sync();
+    return;
+}
+
+//! @brief current virtual time in CPU cycles
+inline uint64_t now( void )
+{
+    return mcu().now;
+}
+
+inline int gpio_index( uint32_t gpio_periph )
+{
+    return (int)((gpio_periph -GPIOA) /0x400);
+}
+
+inline Spi &spi_peripheral( uint32_t spi_periph )
+{
+    Mcu &m = mcu();
+    for (int t = 0;t < Config::NUM_SPI;t++)
+    {
+        if (m.spi[t].base == spi_periph)
+        {
+            return m.spi[t];
+        }
+    }
+    return m.spi[0];
+}
+
+inline Dma &dma_peripheral( uint32_t dma_periph )
+{
+    return mcu().dma[ (dma_periph == DMA1)?(1):(0) ];
+}
+
+//! @brief Bind the RS pin of the display connected to a SPI
+inline void lcd_bind( uint32_t spi_periph, uint32_t rs_gpio, uint32_t rs_pin )
+{
+    spi_peripheral( spi_periph ).lcd.rs_gpio = rs_gpio;
+    spi_peripheral( spi_periph ).lcd.rs_pin = rs_pin;
+    return;
+}
+
+//! @brief Display model attached to a SPI
+inline Lcd &lcd( uint32_t spi_periph )
+{
+    return spi_peripheral( spi_periph ).lcd;
+}
+
+//! @brief Convert a 12b RGB444 pixel to RGB565
+inline uint16_t rgb444_to_565( uint16_t c )
+{
+    uint16_t r = (c >> 8) & 0x0F, g = (c >> 4) & 0x0F, b = c & 0x0F;
+    return (uint16_t)(((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5) | (b << 1 | b >> 3));
+}
+
+//! @brief Write a pixel at the current address of the window and advance it
+inline void lcd_write_pixel( Lcd &l, uint16_t color )
+{
+    //Column address is the inner loop
+    uint16_t c = l.x, r = l.y;
+    //MV exchanges rows and columns, then MX and MY mirror them
+    if (l.madctl & 0x20)
+    {
+        uint16_t tmp = c;
+        c = r;
+        r = tmp;
+    }
+    if (l.madctl & 0x40)
+    {
+        c = (uint16_t)(Config::LCD_MEM_COLS -1 -c);
+    }
+    if (l.madctl & 0x80)
+    {
+        r = (uint16_t)(Config::LCD_MEM_ROWS -1 -r);
+    }
+    if ((c < Config::LCD_MEM_COLS) && (r < Config::LCD_MEM_ROWS))
+    {
+        l.mem[r][c] = color;
+    }
+    l.cnt_pixels++;
+    //Advance address inside the window
+    if (l.x < l.xe)
+    {
+        l.x++;
+    }
+    else
+    {
+        l.x = l.xs;
+        l.y = (l.y < l.ye)?(l.y +1):(l.ys);
+    }
+    return;
+}
+
+//! @brief Execute a command once its parameters are complete
+inline void lcd_param( Lcd &l, uint8_t data )
+{
+    //Memory write: pixel data
+    if (l.cmd == 0x2C)
+    {
+        l.cnt_pixel_bytes++;
+        l.pixel_bytes[ l.pixel_byte_cnt++ ] = data;
+        //12b: 3 bytes are 2 pixels. A pixel is written as soon as its 12 bits are in, the last pixel of an odd window ends in a padded byte
+        if ((l.colmod & 0x07) == 0x03)
+        {
+            if (l.pixel_byte_cnt == 2)
+            {
+                lcd_write_pixel( l, rgb444_to_565( (uint16_t)((l.pixel_bytes[0] << 4) | (l.pixel_bytes[1] >> 4)) ) );
+            }
+            else if (l.pixel_byte_cnt == 3)
+            {
+                lcd_write_pixel( l, rgb444_to_565( (uint16_t)(((l.pixel_bytes[1] & 0x0F) << 8) | l.pixel_bytes[2]) ) );
+                l.pixel_byte_cnt = 0;
+            }
+        }
+        //18b: 3 bytes are 1 pixel
+        else if ((l.colmod & 0x07) == 0x06)
+        {
+            if (l.pixel_byte_cnt == 3)
+            {
+                lcd_write_pixel( l, (uint16_t)(((l.pixel_bytes[0] >> 3) << 11) | ((l.pixel_bytes[1] >> 2) << 5) | (l.pixel_bytes[2] >> 3)) );
+                l.pixel_byte_cnt = 0;
+            }
+        }
+        //16b: 2 bytes are 1 pixel
+        else
+        {
+            if (l.pixel_byte_cnt == 2)
+            {
+                lcd_write_pixel( l, (uint16_t)((l.pixel_bytes[0] << 8) | l.pixel_bytes[1]) );
+                l.pixel_byte_cnt = 0;
+            }
+        }
+        return;
+    }
+    l.cnt_param_bytes++;
+    if (l.param_cnt < sizeof(l.param))
+    {
+        l.param[ l.param_cnt ] = data;
+    }
+    l.param_cnt++;
+    switch (l.cmd)
+    {
+        //CASET
+        case 0x2A:
+        {
+            if (l.param_cnt == 4)
+            {
+                l.xs = (uint16_t)(l.param[0] << 8 | l.param[1]);
+                l.xe = (uint16_t)(l.param[2] << 8 | l.param[3]);
+            }
+            break;
+        }
+        //RASET
+        case 0x2B:
+        {
+            if (l.param_cnt == 4)
+            {
+                l.ys = (uint16_t)(l.param[0] << 8 | l.param[1]);
+                l.ye = (uint16_t)(l.param[2] << 8 | l.param[3]);
+            }
+            break;
+        }
+        //VSCRDEF
+        case 0x33:
+        {
+            if (l.param_cnt == 6)
+            {
+                l.tfa = (uint16_t)(l.param[0] << 8 | l.param[1]);
+                l.vsa = (uint16_t)(l.param[2] << 8 | l.param[3]);
+                l.bfa = (uint16_t)(l.param[4] << 8 | l.param[5]);
+            }
+            break;
+        }
+        //MADCTL
+        case 0x36:
+        {
+            l.madctl = data;
+            break;
+        }
+        //VSCSAD
+        case 0x37:
+        {
+            if (l.param_cnt == 2)
+            {
+                l.ssa = (uint16_t)(l.param[0] << 8 | l.param[1]);
+            }
+            break;
+        }
+        //COLMOD
+        case 0x3A:
+        {
+            l.colmod = data;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+    return;
+}
+
+//! @brief A command byte was received
+inline void lcd_command( Lcd &l, uint8_t data )
+{
+    l.cnt_cmd_bytes++;
+    l.cnt_cmd[ data ]++;
+    l.cmd = data;
+    l.param_cnt = 0;
+    l.pixel_byte_cnt = 0;
+    switch (data)
+    {
+        case 0x11: l.f_sleep = false; break;
+        case 0x10: l.f_sleep = true; break;
+        case 0x20: l.f_inverted = false; break;
+        case 0x21: l.f_inverted = true; break;
+        case 0x28: l.f_display_on = false; break;
+        case 0x29: l.f_display_on = true; break;
+        case 0x38: l.f_idle = false; break;
+        case 0x39: l.f_idle = true; break;
+        case 0x2A:
+        case 0x2B:
+        {
+            l.cnt_address_cmd++;
+            break;
+        }
+        //RAMWR: restart from the top left corner of the window
+        case 0x2C:
+        {
+            l.cnt_ramwr_cmd++;
+            l.x = l.xs;
+            l.y = l.ys;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+    return;
+}
+
+//! @brief A byte reaches the display
+inline void lcd_byte( Lcd &l, bool f_rs, uint8_t data )
+{
+    if (f_rs == false)
+    {
+        lcd_command( l, data );
+    }
+    else
+    {
+        lcd_param( l, data );
+    }
+    return;
+}
+
+//! @brief Pixel shown at a physical position of the panel, scroll applied. Native orientation, 132 columns by 162 lines
+inline uint16_t lcd_pixel( Lcd &l, uint16_t line, uint16_t col )
+{
+    uint16_t row = line;
+    //If: line inside the scroll area
+    if ((l.vsa > 0) && (line >= l.tfa) && (line < l.tfa +l.vsa))
+    {
+        row = (uint16_t)(l.tfa +((line -l.tfa) +(l.ssa -l.tfa) +l.vsa) %l.vsa);
+    }
+    return l.mem[ row ][ col ];
+}
+
+//! @brief Cycles needed to shift a frame
+inline uint64_t spi_frame_cycles( Spi &s, bool f16 )
+{
+    uint64_t psc = 2ULL << ((s.ctl0 & SPI_CTL0_PSC) >> 3);
+    uint64_t bus = (s.base == SPI0)?(Config::APB2_CLOCK):(Config::APB1_CLOCK);
+    return (f16?16:8) *psc *(Config::CORE_CLOCK /bus);
+}
+
+//! @brief Move a frame into the shift register
+inline void spi_start_frame( Spi &s, uint16_t data, uint64_t t )
+{
+    Mcu &m = mcu();
+    s.f_shift = true;
+    s.shift = data;
+    s.f_shift16 = ((s.ctl0 & SPI_CTL0_FF16) != 0);
+    s.f_shift_rs = ((m.gpio_out[ gpio_index( s.lcd.rs_gpio ) ] & s.lcd.rs_pin) != 0);
+    uint64_t frame = spi_frame_cycles( s, s.f_shift16 );
+    s.shift_end = t +frame;
+    s.cnt_busy_cycles += frame;
+    return;
+}
+
+//! @brief A frame was shifted out. Deliver it to the display
+inline void spi_end_frame( Spi &s )
+{
+    s.f_shift = false;
+    s.f_rbne = true;
+    s.cnt_frames++;
+    if (s.f_shift16 == true)
+    {
+        lcd_byte( s.lcd, s.f_shift_rs, (uint8_t)(s.shift >> 8) );
+        lcd_byte( s.lcd, s.f_shift_rs, (uint8_t)(s.shift & 0xFF) );
+    }
+    else
+    {
+        lcd_byte( s.lcd, s.f_shift_rs, (uint8_t)(s.shift & 0xFF) );
+    }
+    return;
+}
+
+//! @brief Write in the transmit buffer at a given time
+inline void spi_write( Spi &s, uint16_t data, uint64_t t )
+{
+    if (s.f_shift == false)
+    {
+        spi_start_frame( s, data, t );
+        s.tbe_time = t;
+    }
+    else
+    {
+        if (s.f_buffer == true)
+        {
+            s.cnt_overrun++;
+        }
+        s.f_buffer = true;
+        s.buffer = data;
+    }
+    return;
+}
+
+//! @brief DMA channel feeding a SPI, if any
+inline Dma_channel *spi_dma( Spi &s )
+{
+    Mcu &m = mcu();
+    if ((s.ctl1 & SPI_CTL1_DMATEN) == 0)
+    {
+        return nullptr;
+    }
+    for (int d = 0;d < Config::NUM_DMA;d++)
+    {
+        for (int c = 0;c < Config::NUM_DMA_CH;c++)
+        {
+            Dma_channel &ch = m.dma[d].ch[c];
+            if ((ch.ctl & DMA_CHXCTL_CHEN) && (ch.remaining > 0) && (ch.paddr == s.data.address))
+            {
+                return &ch;
+            }
+        }
+    }
+    return nullptr;
+}
+
+//! @brief Advance a SPI and its DMA up to time t
+inline void spi_sync( Spi &s, uint64_t t )
+{
+    while (true)
+    {
+        Dma_channel *ch = spi_dma( s );
+        uint64_t t_dma = UINT64_MAX;
+        if ((ch != nullptr) && (s.f_buffer == false))
+        {
+            t_dma = ((s.tbe_time > ch -> enable_time)?(s.tbe_time):(ch -> enable_time)) +Config::DMA_LATENCY_CYCLES;
+        }
+        uint64_t t_shift = (s.f_shift == true)?(s.shift_end):(UINT64_MAX);
+        //Earliest event
+        if ((t_shift <= t_dma) && (t_shift <= t))
+        {
+            spi_end_frame( s );
+            if (s.f_buffer == true)
+            {
+                s.f_buffer = false;
+                spi_start_frame( s, s.buffer, t_shift );
+                s.tbe_time = t_shift;
+            }
+        }
+        else if ((t_dma < t_shift) && (t_dma <= t))
+        {
+            uint16_t data;
+            if ((ch -> ctl & DMA_CHXCTL_MWIDTH) == DMA_MEMORY_WIDTH_16BIT)
+            {
+                data = *(const uint16_t *)(ch -> address);
+                if (ch -> ctl & DMA_CHXCTL_MNAGA)
+                {
+                    ch -> address += 2;
+                }
+            }
+            else
+            {
+                data = *(const uint8_t *)(ch -> address);
+                if (ch -> ctl & DMA_CHXCTL_MNAGA)
+                {
+                    ch -> address += 1;
+                }
+            }
+            ch -> remaining--;
+            ch -> cnt = ch -> remaining;
+            spi_write( s, data, t_dma );
+            //Keep the DMA from writing twice in the same cycle
+            s.tbe_time = t_dma;
+            if (ch -> remaining == 0)
+            {
+                ch -> flags |= DMA_FLAG_FTF | DMA_FLAG_G;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+    return;
+}
+
+//! @brief Execute an interrupt handler. Entry, exit and the HAL calls of the handler are charged to the ISR counter
+inline void run_isr( void (*handler)( void ) )
+{
+    Mcu &m = mcu();
+    uint64_t start = m.now;
+    m.f_in_isr = true;
+    m.isr_cnt++;
+    m.now += Config::ISR_ENTRY_CYCLES;
+    handler();
+    m.f_in_isr = false;
+    m.cnt_isr_cycles += m.now -start;
+    return;
+}
+
+//! @brief Dispatch pending interrupts
+inline void dispatch( void )
+{
+    Mcu &m = mcu();
+    if ((m.f_global_irq == false) || (m.f_in_isr == true))
+    {
+        return;
+    }
+    //DMA transfer complete
+    static const struct { int dma; int ch; IRQn_Type irq; void (*handler)( void ); } dma_irq[] =
+    {
+        { 0, 2, DMA0_Channel2_IRQn, DMA0_Channel2_IRQHandler },
+        { 0, 4, DMA0_Channel4_IRQn, DMA0_Channel4_IRQHandler },
+        { 1, 1, DMA1_Channel1_IRQn, DMA1_Channel1_IRQHandler },
+    };
+    for (auto &irq : dma_irq)
+    {
+        Dma_channel &ch = m.dma[ irq.dma ].ch[ irq.ch ];
+        if ((ch.flags & DMA_FLAG_FTF) && (ch.ctl & DMA_CHXCTL_FTFIE) && (m.f_irq_enabled[ irq.irq ]) && (irq.handler != nullptr))
+        {
+            run_isr( irq.handler );
+        }
+    }
+    //SPI transmit buffer empty or receive buffer not empty
+    static const struct { int spi; IRQn_Type irq; void (*handler)( void ); } spi_irq[] =
+    {
+        { 0, SPI0_IRQn, SPI0_IRQHandler },
+        { 1, SPI1_IRQn, SPI1_IRQHandler },
+        { 2, SPI2_IRQn, SPI2_IRQHandler },
+    };
+    for (auto &irq : spi_irq)
+    {
+        Spi &s = m.spi[ irq.spi ];
+        bool f_event = ((s.f_buffer == false) && (s.ctl1 & SPI_CTL1_TBEIE)) || ((s.f_rbne == true) && (s.ctl1 & SPI_CTL1_RBNEIE));
+        if ((f_event == true) && (m.f_irq_enabled[ irq.irq ]) && (irq.handler != nullptr))
+        {
+            run_isr( irq.handler );
+        }
+    }
+    return;
+}
+
+//! @brief Advance all peripherals to the current time and dispatch interrupts
+inline void sync( void )
+{
+    Mcu &m = mcu();
+    for (int t = 0;t < Config::NUM_SPI;t++)
+    {
+        spi_sync( m.spi[t], m.now );
+    }
+    dispatch();
+    return;
+}
+
+//! @brief Charge the cost of a HAL call
+inline void hal_call( void )
+{
+    mcu().now += Config::HAL_CALL_CYCLES;
+    mcu().cnt_hal_calls++;
+    sync();
+    return;
+}
+
+//! @brief Access a control register of a SPI. Each access of the application is charged like a HAL call
+inline Spi &spi_register( uint32_t spi_periph )
+{
+    hal_call();
+    return spi_peripheral( spi_periph );
+}
+
+//! @brief Read the status register of a SPI
+inline uint32_t spi_stat( uint32_t spi_periph )
+{
+    hal_call();
+    Spi &s = spi_peripheral( spi_periph );
+    uint32_t stat = 0;
+    if (s.f_buffer == false)
+    {
+        stat |= SPI_STAT_TBE;
+    }
+    if (s.f_rbne == true)
+    {
+        stat |= SPI_STAT_RBNE;
+    }
+    if ((s.f_buffer == true) || (s.f_shift == true))
+    {
+        stat |= SPI_STAT_TRANS;
+    }
+    //Count frame size changes
+    if ((s.ctl0 ^ s.last_ctl0) & SPI_CTL0_FF16)
+    {
+        s.cnt_frame_size_changes++;
+    }
+    s.last_ctl0 = s.ctl0;
+    return stat;
+}
+
+//! @brief Run until all SPI and DMA are idle
+inline void drain( void )
+{
+    Mcu &m = mcu();
+    bool f_busy = true;
+    while (f_busy == true)
+    {
+        f_busy = false;
+        for (int t = 0;t < Config::NUM_SPI;t++)
+        {
+            if ((m.spi[t].f_shift == true) || (m.spi[t].f_buffer == true) || (spi_dma( m.spi[t] ) != nullptr))
+            {
+                f_busy = true;
+            }
+        }
+        if (f_busy == true)
+        {
+            spend( 64 );
+        }
+    }
+    return;
+}
+
+}	//End namespace: Sim
+
+/**********************************************************************************
+**	HAL FUNCTIONS
+**********************************************************************************/
+
+//! @brief Core clock
+inline uint32_t SystemCoreClock = Sim::Config::CORE_CLOCK;
+
+//! @brief machine timer. Runs at SystemCoreClock/4
+inline uint64_t get_timer_value( void )
+{
+    Sim::mcu().now += Sim::Config::TIMER_READ_CYCLES;
+    Sim::sync();
+    return Sim::mcu().now /4;
+}
+
+inline void rcu_periph_clock_enable( rcu_periph_enum periph )
+{
+    (void)periph;
+    Sim::hal_call();
+}
+
+inline void gpio_init( uint32_t gpio_periph, uint32_t mode, uint32_t speed, uint32_t pin )
+{
+    (void)mode;
+    (void)speed;
+    //Inputs read high by default, buttons are released
+    Sim::mcu().gpio_in[ Sim::gpio_index( gpio_periph ) ] |= pin;
+    Sim::hal_call();
+}
+
+inline void gpio_bit_set( uint32_t gpio_periph, uint32_t pin )
+{
+    Sim::hal_call();
+    Sim::mcu().gpio_out[ Sim::gpio_index( gpio_periph ) ] |= pin;
+}
+
+inline void gpio_bit_reset( uint32_t gpio_periph, uint32_t pin )
+{
+    Sim::hal_call();
+    Sim::mcu().gpio_out[ Sim::gpio_index( gpio_periph ) ] &= ~pin;
+}
+
+inline void gpio_bit_write( uint32_t gpio_periph, uint32_t pin, bit_status bit_value )
+{
+    if (bit_value == SET)
+    {
+        gpio_bit_set( gpio_periph, pin );
+    }
+    else
+    {
+        gpio_bit_reset( gpio_periph, pin );
+    }
+}
+
+inline FlagStatus gpio_input_bit_get( uint32_t gpio_periph, uint32_t pin )
+{
+    Sim::hal_call();
+    return ((Sim::mcu().gpio_in[ Sim::gpio_index( gpio_periph ) ] & pin) != 0)?(SET):(RESET);
+}
+
+inline FlagStatus gpio_output_bit_get( uint32_t gpio_periph, uint32_t pin )
+{
+    Sim::hal_call();
+    return ((Sim::mcu().gpio_out[ Sim::gpio_index( gpio_periph ) ] & pin) != 0)?(SET):(RESET);
+}
+
+inline void gpio_exti_source_select( uint8_t output_port, uint8_t output_pin )
+{
+    (void)output_port;
+    (void)output_pin;
+    Sim::hal_call();
+}
+
+inline void exti_init( exti_line_enum linex, exti_mode_enum mode, exti_trig_type_enum trig_type )
+{
+    (void)linex;
+    (void)mode;
+    (void)trig_type;
+    Sim::hal_call();
+}
+
+inline FlagStatus exti_interrupt_flag_get( exti_line_enum linex )
+{
+    (void)linex;
+    Sim::hal_call();
+    return RESET;
+}
+
+inline void exti_interrupt_flag_clear( exti_line_enum linex )
+{
+    (void)linex;
+    Sim::hal_call();
+}
+
+inline void eclic_global_interrupt_enable( void )
+{
+    Sim::mcu().f_global_irq = true;
+    Sim::hal_call();
+}
+
+inline void eclic_global_interrupt_disable( void )
+{
+    Sim::hal_call();
+    Sim::mcu().f_global_irq = false;
+}
+
+inline void eclic_priority_group_set( uint32_t prigroup )
+{
+    (void)prigroup;
+    Sim::hal_call();
+}
+
+inline void eclic_irq_enable( uint32_t source, uint8_t level, uint8_t priority )
+{
+    (void)level;
+    (void)priority;
+    Sim::mcu().f_irq_enabled[ source ] = true;
+    Sim::hal_call();
+}
+
+inline void eclic_irq_disable( uint32_t source )
+{
+    Sim::mcu().f_irq_enabled[ source ] = false;
+    Sim::hal_call();
+}
+
+inline void spi_i2s_deinit( uint32_t spi_periph )
+{
+    Sim::Spi &s = Sim::spi_peripheral( spi_periph );
+    s.ctl0 = 0;
+    s.ctl1 = 0;
+    s.last_ctl0 = 0;
+    Sim::hal_call();
+}
+
+inline void spi_enable( uint32_t spi_periph )
+{
+    Sim::spi_peripheral( spi_periph ).ctl0 |= SPI_CTL0_SPIEN;
+    Sim::hal_call();
+}
+
+inline void spi_disable( uint32_t spi_periph )
+{
+    Sim::spi_peripheral( spi_periph ).ctl0 &= ~SPI_CTL0_SPIEN;
+    Sim::hal_call();
+}
+
+inline void spi_i2s_data_transmit( uint32_t spi_periph, uint16_t data )
+{
+    Sim::hal_call();
+    Sim::Spi &s = Sim::spi_peripheral( spi_periph );
+    Sim::spi_write( s, data, Sim::now() );
+}
+
+inline uint16_t spi_i2s_data_receive( uint32_t spi_periph )
+{
+    Sim::hal_call();
+    Sim::spi_peripheral( spi_periph ).f_rbne = false;
+    return 0xFFFF;
+}
+
+inline void spi_i2s_interrupt_enable( uint32_t spi_periph, uint8_t interrupt )
+{
+    if (interrupt == SPI_I2S_INT_TBE)
+    {
+        Sim::spi_peripheral( spi_periph ).ctl1 |= SPI_CTL1_TBEIE;
+    }
+    else if (interrupt == SPI_I2S_INT_RBNE)
+    {
+        Sim::spi_peripheral( spi_periph ).ctl1 |= SPI_CTL1_RBNEIE;
+    }
+    Sim::hal_call();
+}
+
+inline void spi_i2s_interrupt_disable( uint32_t spi_periph, uint8_t interrupt )
+{
+    if (interrupt == SPI_I2S_INT_TBE)
+    {
+        Sim::spi_peripheral( spi_periph ).ctl1 &= ~SPI_CTL1_TBEIE;
+    }
+    else if (interrupt == SPI_I2S_INT_RBNE)
+    {
+        Sim::spi_peripheral( spi_periph ).ctl1 &= ~SPI_CTL1_RBNEIE;
+    }
+    Sim::hal_call();
+}
+
+inline FlagStatus spi_i2s_interrupt_flag_get( uint32_t spi_periph, uint8_t interrupt )
+{
+    Sim::hal_call();
+    Sim::Spi &s = Sim::spi_peripheral( spi_periph );
+    if (interrupt == SPI_I2S_INT_FLAG_TBE)
+    {
+        return ((s.f_buffer == false) && (s.ctl1 & SPI_CTL1_TBEIE))?(SET):(RESET);
+    }
+    return ((s.f_rbne == true) && (s.ctl1 & SPI_CTL1_RBNEIE))?(SET):(RESET);
+}
+
+inline void dma_deinit( uint32_t dma_periph, dma_channel_enum channelx )
+{
+    Sim::Dma_channel &ch = Sim::dma_peripheral( dma_periph ).ch[ channelx ];
+    memset( &ch, 0, sizeof(Sim::Dma_channel) );
+    Sim::hal_call();
+}
+
+inline void dma_channel_enable( uint32_t dma_periph, dma_channel_enum channelx )
+{
+    Sim::hal_call();
+    Sim::Dma_channel &ch = Sim::dma_peripheral( dma_periph ).ch[ channelx ];
+    ch.ctl |= DMA_CHXCTL_CHEN;
+    ch.address = ch.maddr;
+    ch.remaining = ch.cnt;
+    ch.enable_time = Sim::now();
+    Sim::sync();
+}
+
+inline void dma_channel_disable( uint32_t dma_periph, dma_channel_enum channelx )
+{
+    Sim::hal_call();
+    Sim::dma_peripheral( dma_periph ).ch[ channelx ].ctl &= ~DMA_CHXCTL_CHEN;
+}
+
+inline void dma_memory_width_config( uint32_t dma_periph, dma_channel_enum channelx, uint32_t mwidth )
+{
+    Sim::Dma_channel &ch = Sim::dma_peripheral( dma_periph ).ch[ channelx ];
+    ch.ctl = (ch.ctl & ~DMA_CHXCTL_MWIDTH) | mwidth;
+    Sim::hal_call();
+}
+
+inline void dma_periph_width_config( uint32_t dma_periph, dma_channel_enum channelx, uint32_t pwidth )
+{
+    Sim::Dma_channel &ch = Sim::dma_peripheral( dma_periph ).ch[ channelx ];
+    ch.ctl = (ch.ctl & ~DMA_CHXCTL_PWIDTH) | pwidth;
+    Sim::hal_call();
+}
+
+inline void dma_memory_address_config( uint32_t dma_periph, dma_channel_enum channelx, uintptr_t address )
+{
+    Sim::dma_peripheral( dma_periph ).ch[ channelx ].maddr = address;
+    Sim::hal_call();
+}
+
+inline void dma_periph_address_config( uint32_t dma_periph, dma_channel_enum channelx, uint32_t address )
+{
+    Sim::dma_peripheral( dma_periph ).ch[ channelx ].paddr = address;
+    Sim::hal_call();
+}
+
+inline void dma_memory_increase_enable( uint32_t dma_periph, dma_channel_enum channelx )
+{
+    Sim::dma_peripheral( dma_periph ).ch[ channelx ].ctl |= DMA_CHXCTL_MNAGA;
+    Sim::hal_call();
+}
+
+inline void dma_memory_increase_disable( uint32_t dma_periph, dma_channel_enum channelx )
+{
+    Sim::dma_peripheral( dma_periph ).ch[ channelx ].ctl &= ~DMA_CHXCTL_MNAGA;
+    Sim::hal_call();
+}
+
+inline void dma_transfer_number_config( uint32_t dma_periph, dma_channel_enum channelx, uint32_t number )
+{
+    Sim::dma_peripheral( dma_periph ).ch[ channelx ].cnt = number & 0xFFFF;
+    Sim::hal_call();
+}
+
+inline uint32_t dma_transfer_number_get( uint32_t dma_periph, dma_channel_enum channelx )
+{
+    Sim::hal_call();
+    return Sim::dma_peripheral( dma_periph ).ch[ channelx ].remaining;
+}
+
+inline FlagStatus dma_flag_get( uint32_t dma_periph, dma_channel_enum channelx, uint32_t flag )
+{
+    Sim::hal_call();
+    return ((Sim::dma_peripheral( dma_periph ).ch[ channelx ].flags & flag) != 0)?(SET):(RESET);
+}
+
+inline void dma_flag_clear( uint32_t dma_periph, dma_channel_enum channelx, uint32_t flag )
+{
+    uint32_t &flags = Sim::dma_peripheral( dma_periph ).ch[ channelx ].flags;
+    //Clearing the global flag clears all flags of the channel
+    flags &= (flag & DMA_FLAG_G)?(0):(~flag);
+    Sim::hal_call();
+}
+
+inline void dma_interrupt_enable( uint32_t dma_periph, dma_channel_enum channelx, uint32_t source )
+{
+    Sim::dma_peripheral( dma_periph ).ch[ channelx ].ctl |= source;
+    Sim::hal_call();
+}
+
+inline void dma_interrupt_disable( uint32_t dma_periph, dma_channel_enum channelx, uint32_t source )
+{
+    Sim::dma_peripheral( dma_periph ).ch[ channelx ].ctl &= ~source;
+    Sim::hal_call();
+}
+
+inline FlagStatus dma_interrupt_flag_get( uint32_t dma_periph, dma_channel_enum channelx, uint32_t flag )
+{
+    return dma_flag_get( dma_periph, channelx, flag );
+}
+
+inline void dma_interrupt_flag_clear( uint32_t dma_periph, dma_channel_enum channelx, uint32_t flag )
+{
+    dma_flag_clear( dma_periph, channelx, flag );
+}
+
+#endif
@@ -0,0 +1,217 @@
+/**********************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Orso Eric
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************************/
+
+/**********************************************************************************
+**	ENVIROMENT VARIABILE
+**********************************************************************************/
+
+#ifndef IMAGE_RLE565_H_
+    #define IMAGE_RLE565_H_
+
+/**********************************************************************************
+**	GLOBAL INCLUDES
+**********************************************************************************/
+
+//Standard bit size types
+#include <stdint.h>
+//Growing byte stream
+#include <vector>
+
+/**********************************************************************************
+**	DESCRIPTION
+***********************************************************************************
+**		RLE565 ENCODER
+**	Host side encoder of the compressed images drawn by Display::register_image
+**	Used by tools/image_encoder to convert pictures into flash arrays and by the simulator benchmark
+**
+**		STREAM
+**	Height and width of the image, 16b big endian
+**	Tokens until every pixel is decoded. Pixels run row after row, a run can cross rows
+**	0nnnnnnn literal. n+1 RGB565 colors follow, 16b big endian
+**	10nnnnnn run of n+1 pixels. One RGB565 color follows
+**	11nnnnnn nnnnnnnn run of n+1 pixels. One RGB565 color follows
+**********************************************************************************/
+
+/**********************************************************************************
+**	NAMESPACE
+**********************************************************************************/
+
+//! @namespace Rle565 host side encoder of the RLE565 images
+namespace Rle565
+{
+
+/**********************************************************************************
+**	TYPEDEFS
+**********************************************************************************/
+
+//! @brief Configuration of the encoder
+typedef enum _Config
+{
+    MAX_LITERAL		= 128,		//Colors in a literal token
+    MAX_SHORT_RUN	= 64,		//Pixels of a one byte run token
+    MAX_LONG_RUN	= 16384,	//Pixels of a two byte run token
+    MIN_RUN			= 3,		//Shorter runs are cheaper inside a literal
+} Config;
+
+/**********************************************************************************
+**	FUNCTIONS
+**********************************************************************************/
+
+/***************************************************************************/
+//!	@brief function
+//!	color | uint8_t | uint8_t | uint8_t |
+/***************************************************************************/
+//! @param r | uint8_t | red
+//! @param g | uint8_t | green
+//! @param b | uint8_t | blue
+//! @return uint16_t | RGB565 color. Same conversion as Display::color
+/***************************************************************************/
+
+static inline uint16_t color( uint8_t r, uint8_t g, uint8_t b )
+{
+    return (uint16_t)( ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | ((b & 0xF8) >> 3) );
+}	//End function: color | uint8_t | uint8_t | uint8_t |
+
+/***************************************************************************/
+//!	@brief function
+//!	push_color | std::vector<uint8_t> & | uint16_t |
+/***************************************************************************/
+//! @param stream | std::vector<uint8_t> & | stream being encoded
+//! @param color | uint16_t | RGB565 color. Appended big endian
+/***************************************************************************/
+
+static inline void push_color( std::vector<uint8_t> &stream, uint16_t color )
+{
+    stream.push_back( (uint8_t)(color >> 8) );
+    stream.push_back( (uint8_t)(color & 0xFF) );
+    return;
+}	//End function: push_color | std::vector<uint8_t> & | uint16_t |
+
+/***************************************************************************/
+//!	@brief function
+//!	encode | const uint16_t * | uint16_t | uint16_t |
+/***************************************************************************/
+//! @param pixel_ptr | const uint16_t * | RGB565 pixel map, row after row
+//! @param size_h | uint16_t | height of the image
+//! @param size_w | uint16_t | width of the image
+//! @return std::vector<uint8_t> | RLE565 stream, header included
+//! @details
+//!	\n Greedy encoder. Runs of at least MIN_RUN pixels become run tokens, the other pixels are gathered in literals
+/***************************************************************************/
+
+static std::vector<uint8_t> encode( const uint16_t *pixel_ptr, uint16_t size_h, uint16_t size_w )
+{
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    std::vector<uint8_t> stream;
+    uint32_t size = (uint32_t)size_h *size_w;
+    //First pixel of the literal being gathered and its length
+    uint32_t literal_start = 0;
+    uint32_t literal_cnt = 0;
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //Header
+    push_color( stream, size_h );
+    push_color( stream, size_w );
+    //For: each pixel
+    uint32_t index = 0;
+    while (index <= size)
+    {
+        //Length of the run starting here
+        uint32_t run = 0;
+        while ((index +run < size) && (run < Config::MAX_LONG_RUN) && (pixel_ptr[ index +run ] == pixel_ptr[ index ]))
+        {
+            run++;
+        }
+        //If: the literal must be closed. A run starts, the literal is full or the image is done
+        if ((literal_cnt > 0) && ((run >= Config::MIN_RUN) || (literal_cnt >= Config::MAX_LITERAL) || (index >= size)))
+        {
+            stream.push_back( (uint8_t)(literal_cnt -1) );
+            for (uint32_t t = 0;t < literal_cnt;t++)
+            {
+                push_color( stream, pixel_ptr[ literal_start +t ] );
+            }
+            literal_cnt = 0;
+        }
+        //If: image is done
+        if (index >= size)
+        {
+            break;
+        }
+        //If: run token
+        if (run >= Config::MIN_RUN)
+        {
+            if (run <= Config::MAX_SHORT_RUN)
+            {
+                stream.push_back( (uint8_t)(0x80 | (run -1)) );
+            }
+            else
+            {
+                stream.push_back( (uint8_t)(0xC0 | ((run -1) >> 8)) );
+                stream.push_back( (uint8_t)((run -1) & 0xFF) );
+            }
+            push_color( stream, pixel_ptr[ index ] );
+            index += run;
+        }
+        //If: the pixel joins the literal
+        else
+        {
+            if (literal_cnt == 0)
+            {
+                literal_start = index;
+            }
+            literal_cnt++;
+            index++;
+        }
+    }	//End For: each pixel
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return stream;
+}	//End function: encode | const uint16_t * | uint16_t | uint16_t |
+
+/**********************************************************************************
+**	NAMESPACE
+**********************************************************************************/
+
+} //End Namespace: Rle565
+
+#else
+    #warning "Multiple inclusion of hader file IMAGE_RLE565_H_"
+#endif
@@ -0,0 +1,808 @@
+/****************************************************************************
+**	OrangeBot Project
+*****************************************************************************
+**        /
+**       /
+**      /
+** ______ \
+**         \
+**          \
+*****************************************************************************
+**	Longan Nano Screen Benchmark
+*****************************************************************************
+**  Host build of the Screen and Display classes on top of the simulated GD32VF103 HAL
+**  Virtual time is deterministic. The same build gives the same numbers on any machine
+**  Measures time to first frame, throughput and latency of Screen::update and the SPI traffic it generates
+**  Screen cpu is the time spent in Screen::update and in the interrupt handlers of the driver
+**  Compares the print to glass latency of the oldest first and raster flush orders under a steady stream of prints
+**  Without DMA, also measures the throughput of the polled driver with burst budgets
+****************************************************************************/
+
+/****************************************************************************
+**	INCLUDES
+****************************************************************************/
+
+//printf
+#include <stdio.h>
+//C++ std random number generators
+#include <random>
+//Latency samples and their percentiles
+#include <vector>
+#include <algorithm>
+//Simulated Longan Nano HAL
+#include <gd32vf103.h>
+//Higher level abstraction layer to base Display Class. Provides character sprites and print methods with color
+#include "longan_nano_screen.hpp"
+//Host encoder of the RLE565 images
+#include "image_rle565.hpp"
+//Round robin update of screens on different SPI buses
+#include "longan_nano_screen_scheduler.hpp"
+
+/****************************************************************************
+**	ENUM
+****************************************************************************/
+
+//Configurations
+typedef enum _Config
+{
+    //Microseconds between calls of the screen update method. Same as the demo
+    SCREEN_US           = 100,
+    //Microseconds between calls of the demos
+    DEMO_US             = 50000,
+    //Microseconds of virtual time each demo runs for
+    RUN_US              = 10000000,
+    //Number of characters printed to measure the latency
+    LATENCY_SAMPLES     = 1000,
+    //Number of characters printed to compare the flush orders. Average microseconds between two prints, close to the throughput of the display
+    FLUSH_SAMPLES       = 4000,
+    FLUSH_ARRIVAL_US    = 100,
+    //Microseconds between two looks at the display memory for the characters on their way
+    FLUSH_PROBE_US      = 10,
+    //CPU cycles charged for each pass of the main loop
+    LOOP_CYCLES         = 20,
+    //Maximum length of a demo string
+    MAX_STR_LEN         = 25,
+    //Size of the RLE565 test images. Full screen
+    IMAGE_HEIGHT        = 80,
+    IMAGE_WIDTH         = 160,
+} Config;
+
+/****************************************************************************
+**	GLOBAL VARIABILES
+****************************************************************************/
+
+//C++ Standard Random Number Generator
+std::default_random_engine g_rng_engine;
+//C++ standard random number distributions
+std::uniform_int_distribution<uint8_t> g_rng_char( ' ', '~' );
+std::uniform_int_distribution<int> g_rng_height( 0, Longan_nano::Screen::Config::FRAME_BUFFER_HEIGHT -1 );
+std::uniform_int_distribution<int> g_rng_width( 0, Longan_nano::Screen::Config::FRAME_BUFFER_WIDTH -1 );
+std::uniform_int_distribution<uint8_t> g_rng_color( 0, Longan_nano::Screen::Config::PALETTE_SIZE -1 );
+std::uniform_int_distribution<uint8_t> g_rng_length( 0, Config::MAX_STR_LEN );
+
+//Display Driver. Global so that the DMA ISR can advance the driver FSM and the DMA can reach the pixel buffers
+Longan_nano::Screen g_screen;
+//Second display on SPI1 and DMA0 channel 4. Updated together with the first by the scheduler
+typedef Longan_nano::Screen_panel<Longan_nano::Panel_st7735s_w160_h80_spi1> Screen_spi1;
+Screen_spi1 g_screen_spi1;
+Longan_nano::Screen_scheduler g_scheduler;
+
+/****************************************************************************
+**	FUNCTIONS
+****************************************************************************/
+
+/****************************************************************************
+**	@brief function
+**	us_to_cycles | uint64_t
+****************************************************************************/
+//! @param us | uint64_t | microseconds
+//! @return uint64_t | CPU cycles of virtual time
+/***************************************************************************/
+
+static uint64_t us_to_cycles( uint64_t us )
+{
+    return us *(Sim::Config::CORE_CLOCK /1000000);
+}
+
+/****************************************************************************
+**	@brief function
+**	is_screen_idle | void
+****************************************************************************/
+//! @return bool | true = no sprites pending in the frame buffer and the driver sent all the sprites
+/***************************************************************************/
+
+static bool is_screen_idle( void )
+{
+    return ((g_screen.get_pending() == 0) && (g_screen.get_sprite_queue_depth() == 0));
+}
+
+/****************************************************************************
+**	@brief function
+**	screen_task | uint64_t &
+****************************************************************************/
+//! @param screen_cycles | uint64_t & | accumulate CPU cycles spent inside Screen::update
+//! @details Execute a screen update and profile it. Interrupts nested in the update are left out, isr_cycles charges all of them
+/***************************************************************************/
+
+static void screen_task( uint64_t &screen_cycles )
+{
+    uint64_t start = Sim::now();
+    uint64_t start_isr = Sim::mcu().cnt_isr_cycles;
+    g_screen.update();
+    screen_cycles += (Sim::now() -start) -(Sim::mcu().cnt_isr_cycles -start_isr);
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	isr_cycles | uint64_t
+****************************************************************************/
+//! @param start_isr | uint64_t | ISR counter of the simulator at the start of the measure
+//! @return uint64_t | CPU cycles spent in the interrupt handlers since the start of the measure. The driver FSM runs there when USE_ISR is true
+/***************************************************************************/
+
+static uint64_t isr_cycles( uint64_t start_isr )
+{
+    return Sim::mcu().cnt_isr_cycles -start_isr;
+}
+
+/****************************************************************************
+**	@brief function
+**	run_until_idle | uint64_t &
+****************************************************************************/
+//! @param screen_cycles | uint64_t & | accumulate CPU cycles spent inside Screen::update
+//! @details Run the screen scheduler until the display is up to date with the frame buffer
+/***************************************************************************/
+
+static void run_until_idle( uint64_t &screen_cycles )
+{
+    uint64_t next_screen = Sim::now();
+    //While: the display is not up to date
+    while (is_screen_idle() == false)
+    {
+        //If: time for a screen update
+        if (Sim::now() >= next_screen)
+        {
+            next_screen += us_to_cycles( Config::SCREEN_US );
+            screen_task( screen_cycles );
+        }
+        Sim::spend( Config::LOOP_CYCLES );
+    }
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	demo_string | void
+****************************************************************************/
+//! @details Print a random string with random length in a random position. Same as TEST_STRING_CONSOLE
+/***************************************************************************/
+
+static void demo_string( void )
+{
+    char str[ Config::MAX_STR_LEN +1 ];
+    uint8_t len_tmp = g_rng_length( g_rng_engine );
+    for (uint8_t t = 0; t < len_tmp;t++)
+    {
+        str[t] = g_rng_char( g_rng_engine );
+    }
+    str[len_tmp] = '\0';
+    int height_tmp = g_rng_height( g_rng_engine );
+    int width_tmp = g_rng_width( g_rng_engine );
+    g_screen.print( height_tmp, width_tmp, str );
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	demo_workload | void
+****************************************************************************/
+//! @details Paint random sprites and print two numbers. Same as TEST_WORKLOAD
+/***************************************************************************/
+
+static void demo_workload( void )
+{
+    for (uint8_t t = 0;t < 10;t++)
+    {
+        int th = g_rng_height( g_rng_engine );
+        int tw = g_rng_width( g_rng_engine );
+        Longan_nano::Screen::Color color_tmp = (Longan_nano::Screen::Color)g_rng_color( g_rng_engine );
+        g_screen.paint( th, tw, color_tmp );
+    }
+    g_screen.print( 0, 0, "CPU |" );
+    g_screen.print( 0, 12, '|' );
+    g_screen.set_format( User::String::STRING_SIZE_SENG -1, Longan_nano::Screen::Format_align::ADJ_RIGHT, Longan_nano::Screen::Format_format::ENG, -3 );
+    g_screen.print( 0, 11, (int)(Sim::now() /1000 %100000) );
+    g_screen.print( 0, 19, (int)(Sim::now() /777 %100000) );
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	demo_clear | void
+****************************************************************************/
+//! @details Clear the screen to a random color. Same as TEST_CLEAR_BLINK without the profile rows
+/***************************************************************************/
+
+static void demo_clear( void )
+{
+    g_screen.clear( (Longan_nano::Screen::Color)g_rng_color( g_rng_engine ) );
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	run_demo | const char * | void (*)( void )
+****************************************************************************/
+//! @param name | const char * | name of the demo in the report
+//! @param demo | void (*)( void ) | demo called every DEMO_US
+//! @details
+//!	Hardwired scheduler of the demo. Screen every SCREEN_US, demo every DEMO_US for RUN_US of virtual time
+//!	Report the CPU share of the screen, the SPI traffic and the characters found in the glyph cache
+/***************************************************************************/
+
+static void run_demo( const char *name, void (*demo)( void ) )
+{
+    Sim::Lcd &lcd = Sim::lcd( SPI0 );
+    uint64_t windows = lcd.cnt_ramwr_cmd;
+    uint64_t command_bytes = g_screen.get_command_bytes();
+    uint64_t pixel_bytes = g_screen.get_pixel_bytes();
+    uint64_t spi_busy = Sim::spi_peripheral( SPI0 ).cnt_busy_cycles;
+    uint32_t glyph_hits = g_screen.get_glyph_cache_hits();
+    uint32_t glyph_misses = g_screen.get_glyph_cache_misses();
+    uint64_t screen_cycles = 0;
+
+    uint64_t start = Sim::now();
+    uint64_t start_isr = Sim::mcu().cnt_isr_cycles;
+    uint64_t next_screen = start;
+    uint64_t next_demo = start;
+    //While: virtual time left
+    while (Sim::now() -start < us_to_cycles( Config::RUN_US ))
+    {
+        //If: time for a screen update
+        if (Sim::now() >= next_screen)
+        {
+            next_screen += us_to_cycles( Config::SCREEN_US );
+            screen_task( screen_cycles );
+        }
+        //If: time for the demo
+        if (Sim::now() >= next_demo)
+        {
+            next_demo += us_to_cycles( Config::DEMO_US );
+            demo();
+        }
+        Sim::spend( Config::LOOP_CYCLES );
+    }
+    uint64_t elapsed = Sim::now() -start;
+    screen_cycles += isr_cycles( start_isr );
+
+    windows = lcd.cnt_ramwr_cmd -windows;
+    command_bytes = g_screen.get_command_bytes() -command_bytes;
+    pixel_bytes = g_screen.get_pixel_bytes() -pixel_bytes;
+    spi_busy = Sim::spi_peripheral( SPI0 ).cnt_busy_cycles -spi_busy;
+    glyph_hits = g_screen.get_glyph_cache_hits() -glyph_hits;
+    glyph_misses = g_screen.get_glyph_cache_misses() -glyph_misses;
+    printf( "%-10s | windows: %8llu | cmd bytes: %8llu | pixel bytes: %9llu | cmd/pixel: %6.4f | screen cpu: %5.2f%% | spi busy: %5.2f%% | pending: %3d | glyph hits: %5.1f%%\n",
+        name, (unsigned long long)windows, (unsigned long long)command_bytes, (unsigned long long)pixel_bytes,
+        (pixel_bytes > 0)?((double)command_bytes /pixel_bytes):(0.0), 100.0 *screen_cycles /elapsed, 100.0 *spi_busy /elapsed, g_screen.get_pending(),
+        (glyph_hits +glyph_misses > 0)?(100.0 *glyph_hits /(glyph_hits +glyph_misses)):(0.0) );
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	run_redraw | const char * | int |
+****************************************************************************/
+//! @param name | const char * | name of the row
+//! @param seed | int | shift of the characters. A different seed changes every character again
+//! @details
+//!	Throughput. Change every character of the screen and measure the time until the display is up to date. Screen scheduled every SCREEN_US
+/***************************************************************************/
+
+static void run_redraw( const char *name, int seed )
+{
+    uint64_t screen_cycles = 0;
+    //Every sprite changes
+    for (int th = 0;th < Longan_nano::Screen::Config::FRAME_BUFFER_HEIGHT;th++)
+    {
+        for (int tw = 0;tw < Longan_nano::Screen::Config::FRAME_BUFFER_WIDTH;tw++)
+        {
+            g_screen.print( th, tw, (char)('A' +(th *Longan_nano::Screen::Config::FRAME_BUFFER_WIDTH +tw +seed) %26), (Longan_nano::Screen::Color)(tw %Longan_nano::Screen::Config::PALETTE_SIZE), Longan_nano::Screen::Color::WHITE );
+        }
+    }
+    uint64_t start = Sim::now();
+    uint64_t start_isr = Sim::mcu().cnt_isr_cycles;
+    run_until_idle( screen_cycles );
+    uint64_t elapsed = Sim::now() -start;
+    screen_cycles += isr_cycles( start_isr );
+    printf( "%-10s | sprites: %8d | time: %8llu us | sprites/s: %8llu | screen cpu: %5.2f%%\n",
+        name, (int)Longan_nano::Screen::Config::FRAME_BUFFER_SIZE, (unsigned long long)(elapsed *1000000 /Sim::Config::CORE_CLOCK),
+        (unsigned long long)(Longan_nano::Screen::Config::FRAME_BUFFER_SIZE *(uint64_t)Sim::Config::CORE_CLOCK /elapsed), 100.0 *screen_cycles /elapsed );
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	run_burst | void
+****************************************************************************/
+//! @details
+//!	Driver without DMA. Full redraw with burst budgets in SPI frames and in microseconds per update. Sprites per second against screen CPU
+//!	Skipped when the driver uses the DMA
+/***************************************************************************/
+
+static void run_burst( void )
+{
+    //Budgets. SPI frames, microseconds
+    static const uint16_t budget[][2] = { { 16, 0 }, { 64, 0 }, { 256, 0 }, { 0, 20 }, { 0, 50 } };
+    char name[16];
+    //For: each budget
+    for (int t = 0;t < (int)(sizeof(budget) /sizeof(budget[0]));t++)
+    {
+        //If: the driver uses the DMA
+        if (g_screen.set_burst( budget[t][0], budget[t][1] ) == true)
+        {
+            return;
+        }
+        if (budget[t][0] != 0)
+        {
+            snprintf( name, sizeof(name), "burst %uf", (unsigned)budget[t][0] );
+        }
+        else
+        {
+            snprintf( name, sizeof(name), "burst %uus", (unsigned)budget[t][1] );
+        }
+        run_redraw( name, t +1 );
+    }
+    //Back to one step per update
+    g_screen.set_burst( 1, 0 );
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	run_latency | void
+****************************************************************************/
+//! @details
+//!	Latency. Print a character and measure the time until it is on the display. Screen scheduled every SCREEN_US
+/***************************************************************************/
+
+static void run_latency( void )
+{
+    uint64_t screen_cycles = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    //For: each sample
+    for (int t = 0;t < Config::LATENCY_SAMPLES;t++)
+    {
+        //Land at a random phase of the screen scheduler
+        Sim::spend( us_to_cycles( Config::SCREEN_US ) *t /Config::LATENCY_SAMPLES );
+        uint64_t start = Sim::now();
+        g_screen.print( g_rng_height( g_rng_engine ), g_rng_width( g_rng_engine ), (char)g_rng_char( g_rng_engine ), (Longan_nano::Screen::Color)g_rng_color( g_rng_engine ), Longan_nano::Screen::Color::WHITE );
+        //Wait for the character to be on the display
+        run_until_idle( screen_cycles );
+        uint64_t latency = Sim::now() -start;
+        sum += latency;
+        max = (latency > max)?(latency):(max);
+    }
+    printf( "%-10s | samples: %8d | average: %8llu us | max: %8llu us\n",
+        "latency", (int)Config::LATENCY_SAMPLES, (unsigned long long)(sum /Config::LATENCY_SAMPLES *1000000 /Sim::Config::CORE_CLOCK), (unsigned long long)(max *1000000 /Sim::Config::CORE_CLOCK) );
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	get_lcd_pixel | int | int | int |
+****************************************************************************/
+//! @param index_h | int | sprite of the frame buffer
+//! @param index_w | int | sprite of the frame buffer
+//! @param index | int | pixel of the sprite, row by row
+//! @return uint16_t & | pixel of the sprite inside the memory of the simulated display
+//! @details Landscape without scroll. MADCTL MV runs the memory lines along the width and MX mirrors the columns
+/***************************************************************************/
+
+static uint16_t &get_lcd_pixel( int index_h, int index_w, int index )
+{
+    typedef Longan_nano::Panel_st7735s_w160_h80::Config Panel_config;
+    int pixel_h = index_h *Longan_nano::Screen::Config::SPRITE_HEIGHT +index /Longan_nano::Screen::Config::SPRITE_WIDTH;
+    int pixel_w = index_w *Longan_nano::Screen::Config::SPRITE_WIDTH +index %Longan_nano::Screen::Config::SPRITE_WIDTH;
+    return Sim::lcd( SPI0 ).mem[ Panel_config::ROW_ADDRESS_OFFSET +pixel_w ][ Panel_config::COL_ADDRESS_OFFSET +Panel_config::HEIGHT -1 -pixel_h ];
+}
+
+/****************************************************************************
+**	@brief function
+**	run_flush_order | const char * | Longan_nano::Screen::Flush_order |
+****************************************************************************/
+//! @param name | const char * | name of the row
+//! @param order | Longan_nano::Screen::Flush_order | order in which Screen::update sends the sprites to be updated
+//! @details
+//!	Print to glass latency. Characters are printed at random cells at about the throughput of the display, so that a backlog comes and goes
+//!	Each character changes both colors of its cell. It is on glass when every pixel of the cell changed in the display memory
+//!	A cell is not printed again while its character is on its way
+/***************************************************************************/
+
+static void run_flush_order( const char *name, Longan_nano::Screen::Flush_order order )
+{
+    typedef Longan_nano::Screen::Config Screen_config;
+    //Colors of each cell, time its character was printed and pixels before the print. Zero time means the cell is on glass
+    static uint8_t color[ Screen_config::FRAME_BUFFER_HEIGHT ][ Screen_config::FRAME_BUFFER_WIDTH ][ 2 ];
+    static uint64_t print_time[ Screen_config::FRAME_BUFFER_HEIGHT ][ Screen_config::FRAME_BUFFER_WIDTH ];
+    static uint16_t old_pixel[ Screen_config::FRAME_BUFFER_HEIGHT ][ Screen_config::FRAME_BUFFER_WIDTH ][ Screen_config::SPRITE_PIXEL_COUNT ];
+    std::uniform_int_distribution<int> rng_arrival( 0, 2 *Config::FLUSH_ARRIVAL_US );
+    std::vector<uint64_t> latency;
+    uint64_t screen_cycles = 0;
+
+    //Start from a black screen
+    g_screen.set_flush_order( order );
+    g_screen.clear( Longan_nano::Screen::Color::BLACK );
+    run_until_idle( screen_cycles );
+    for (int th = 0;th < Screen_config::FRAME_BUFFER_HEIGHT;th++)
+    {
+        for (int tw = 0;tw < Screen_config::FRAME_BUFFER_WIDTH;tw++)
+        {
+            color[th][tw][0] = Longan_nano::Screen::Color::BLACK;
+            color[th][tw][1] = Longan_nano::Screen::Color::BLACK;
+            print_time[th][tw] = 0;
+        }
+    }
+    int printed = 0;
+    uint64_t next_screen = Sim::now();
+    uint64_t next_print = Sim::now();
+    uint64_t next_probe = Sim::now();
+    //While: characters to be printed or on their way
+    while ((int)latency.size() < Config::FLUSH_SAMPLES)
+    {
+        //If: time for a screen update
+        if (Sim::now() >= next_screen)
+        {
+            next_screen += us_to_cycles( Config::SCREEN_US );
+            screen_task( screen_cycles );
+        }
+        //If: time for a print
+        if ((printed < Config::FLUSH_SAMPLES) && (Sim::now() >= next_print))
+        {
+            next_print += us_to_cycles( rng_arrival( g_rng_engine ) );
+            int th = g_rng_height( g_rng_engine );
+            int tw = g_rng_width( g_rng_engine );
+            //If: the cell is on glass
+            if (print_time[th][tw] == 0)
+            {
+                //Two new colors, different from the old ones, so that every pixel changes
+                uint8_t new_color[2];
+                for (int t = 0;t < 2;t++)
+                {
+                    do
+                    {
+                        new_color[t] = g_rng_color( g_rng_engine );
+                    }
+                    while ((new_color[t] == color[th][tw][0]) || (new_color[t] == color[th][tw][1]) || ((t == 1) && (new_color[1] == new_color[0])));
+                }
+                for (int t = 0;t < Screen_config::SPRITE_PIXEL_COUNT;t++)
+                {
+                    old_pixel[th][tw][t] = get_lcd_pixel( th, tw, t );
+                }
+                color[th][tw][0] = new_color[0];
+                color[th][tw][1] = new_color[1];
+                print_time[th][tw] = Sim::now();
+                g_screen.print( th, tw, (char)g_rng_char( g_rng_engine ), (Longan_nano::Screen::Color)new_color[0], (Longan_nano::Screen::Color)new_color[1] );
+                printed++;
+            }
+        }
+        //If: time to look for the characters on glass
+        if (Sim::now() >= next_probe)
+        {
+            next_probe += us_to_cycles( Config::FLUSH_PROBE_US );
+            for (int th = 0;th < Screen_config::FRAME_BUFFER_HEIGHT;th++)
+            {
+                for (int tw = 0;tw < Screen_config::FRAME_BUFFER_WIDTH;tw++)
+                {
+                    bool f_glass = (print_time[th][tw] != 0);
+                    for (int t = 0;(f_glass == true) && (t < Screen_config::SPRITE_PIXEL_COUNT);t++)
+                    {
+                        f_glass = (get_lcd_pixel( th, tw, t ) != old_pixel[th][tw][t]);
+                    }
+                    if (f_glass == true)
+                    {
+                        latency.push_back( Sim::now() -print_time[th][tw] );
+                        print_time[th][tw] = 0;
+                    }
+                }
+            }
+        }
+        Sim::spend( Config::LOOP_CYCLES );
+    }
+    std::sort( latency.begin(), latency.end() );
+    uint64_t sum = 0;
+    for (uint64_t sample : latency)
+    {
+        sum += sample;
+    }
+    printf( "%-10s | samples: %8d | average: %8llu us | p99: %8llu us | max: %8llu us\n", name, (int)latency.size(),
+        (unsigned long long)(sum /latency.size() *1000000 /Sim::Config::CORE_CLOCK),
+        (unsigned long long)(latency[ latency.size() *99 /100 ] *1000000 /Sim::Config::CORE_CLOCK),
+        (unsigned long long)(latency.back() *1000000 /Sim::Config::CORE_CLOCK) );
+    //Back to the default order
+    g_screen.set_flush_order( Longan_nano::Screen::Flush_order::RASTER );
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	make_image | int | uint16_t * |
+****************************************************************************/
+//! @param kind | int | 0 = logo, flat areas | 1 = gradient, one color per row | 2 = photo, every pixel different
+//! @param pixel_ptr | uint16_t * | RGB565 pixel map IMAGE_HEIGHT x IMAGE_WIDTH
+//! @details Synthetic pictures from the best to the worst case of the RLE565 encoder
+/***************************************************************************/
+
+static void make_image( int kind, uint16_t *pixel_ptr )
+{
+    std::default_random_engine rng_engine;
+    std::uniform_int_distribution<int> rng_color( 0, 0xFFFF );
+    //For: each pixel
+    for (int th = 0;th < Config::IMAGE_HEIGHT;th++)
+    {
+        for (int tw = 0;tw < Config::IMAGE_WIDTH;tw++)
+        {
+            uint16_t color;
+            if (kind == 0)
+            {
+                //Dark background, a frame, three color bars and a disc
+                int dh = th -40, dw = tw -120;
+                color = Rle565::color( 0, 0, 64 );
+                color = ((th < 2) || (th >= Config::IMAGE_HEIGHT -2) || (tw < 2) || (tw >= Config::IMAGE_WIDTH -2))?(Rle565::color( 255, 255, 255 )):(color);
+                color = ((th >= 10) && (th < 70) && (tw >= 10) && (tw < 80))?(Rle565::color( (tw < 33)?(255):(0), (tw >= 33) && (tw < 57)?(255):(0), (tw >= 57)?(255):(0) )):(color);
+                color = (dh *dh +dw *dw < 625)?(Rle565::color( 255, 128, 0 )):(color);
+            }
+            else if (kind == 1)
+            {
+                color = Rle565::color( (uint8_t)(th *3), 64, (uint8_t)(255 -th *3) );
+            }
+            else
+            {
+                color = (uint16_t)rng_color( rng_engine );
+            }
+            pixel_ptr[ th *Config::IMAGE_WIDTH +tw ] = color;
+        }
+    }
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	run_image | void
+****************************************************************************/
+//! @details
+//!	Throughput of the RLE565 decoder. Encode a full screen picture, draw it and measure the time until it is on the display. Screen scheduled every SCREEN_US
+//!	The simulator charges the HAL calls of the decoder, not its loops. Screen cpu doesn't include the expansion of literals
+/***************************************************************************/
+
+static void run_image( void )
+{
+    static const char *name[] = { "image logo", "image grad", "image photo" };
+    static uint16_t pixel[ Config::IMAGE_HEIGHT *Config::IMAGE_WIDTH ];
+    Sim::Lcd &lcd = Sim::lcd( SPI0 );
+    //For: each picture
+    for (int t = 0;t < 3;t++)
+    {
+        make_image( t, pixel );
+        std::vector<uint8_t> stream = Rle565::encode( pixel, Config::IMAGE_HEIGHT, Config::IMAGE_WIDTH );
+        uint64_t screen_cycles = 0;
+        uint64_t windows = lcd.cnt_ramwr_cmd;
+        uint64_t pixel_bytes = g_screen.get_pixel_bytes();
+        uint64_t start = Sim::now();
+        uint64_t start_isr = Sim::mcu().cnt_isr_cycles;
+        uint64_t next_screen = start;
+        g_screen.register_image( 0, 0, stream.data() );
+        //While: the image is being decoded or sent
+        while ((g_screen.is_image_busy() == true) || (is_screen_idle() == false))
+        {
+            //If: time for a screen update
+            if (Sim::now() >= next_screen)
+            {
+                next_screen += us_to_cycles( Config::SCREEN_US );
+                screen_task( screen_cycles );
+            }
+            Sim::spend( Config::LOOP_CYCLES );
+        }
+        uint64_t elapsed = Sim::now() -start;
+        screen_cycles += isr_cycles( start_isr );
+        printf( "%-11s| bytes: %8u | ratio: %5.1f%% | windows: %6llu | pixel bytes: %6llu | time: %8llu us | pixels/s: %8llu | screen cpu: %5.2f%%\n",
+            name[t], (unsigned)stream.size(), 100.0 *stream.size() /(2.0 *Config::IMAGE_HEIGHT *Config::IMAGE_WIDTH),
+            (unsigned long long)(lcd.cnt_ramwr_cmd -windows), (unsigned long long)(g_screen.get_pixel_bytes() -pixel_bytes),
+            (unsigned long long)(elapsed *1000000 /Sim::Config::CORE_CLOCK),
+            (unsigned long long)((uint64_t)Config::IMAGE_HEIGHT *Config::IMAGE_WIDTH *Sim::Config::CORE_CLOCK /elapsed), 100.0 *screen_cycles /elapsed );
+    }
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	run_dual | void
+****************************************************************************/
+//! @details
+//!	Two displays on SPI0 and SPI1. Change every character of both screens and measure the time until both displays are up to date
+//!	The scheduler is called every SCREEN_US. SPI1 is clocked by APB1 and runs at half the speed of SPI0
+//!	The buses are busy at the same time when the scheduler keeps both DMA channels fed
+/***************************************************************************/
+
+static void run_dual( void )
+{
+    //The second display answers on SPI1
+    Sim::lcd_bind( SPI1, Longan_nano::Panel_st7735s_w160_h80_spi1::Config::RS_GPIO, Longan_nano::Panel_st7735s_w160_h80_spi1::Config::RS_PIN );
+    g_screen_spi1.init();
+    g_scheduler.add( g_screen );
+    g_scheduler.add( g_screen_spi1 );
+    uint64_t screen_cycles = 0;
+    //For: bring-up of the second display, then every sprite of both screens changes
+    for (int pass = 0;pass < 2;pass++)
+    {
+        if (pass == 1)
+        {
+            for (int th = 0;th < Longan_nano::Screen::Config::FRAME_BUFFER_HEIGHT;th++)
+            {
+                for (int tw = 0;tw < Longan_nano::Screen::Config::FRAME_BUFFER_WIDTH;tw++)
+                {
+                    g_screen.print( th, tw, (char)('a' +(th *Longan_nano::Screen::Config::FRAME_BUFFER_WIDTH +tw) %26), (Longan_nano::Screen::Color)(tw %Longan_nano::Screen::Config::PALETTE_SIZE), Longan_nano::Screen::Color::WHITE );
+                    g_screen_spi1.print( th, tw, (char)('A' +(th *Longan_nano::Screen::Config::FRAME_BUFFER_WIDTH +tw) %26), Screen_spi1::Color::WHITE, (Screen_spi1::Color)(tw %Longan_nano::Screen::Config::PALETTE_SIZE) );
+                }
+            }
+        }
+        uint64_t spi0_busy = Sim::spi_peripheral( SPI0 ).cnt_busy_cycles;
+        uint64_t spi1_busy = Sim::spi_peripheral( SPI1 ).cnt_busy_cycles;
+        screen_cycles = 0;
+        uint64_t start = Sim::now();
+        uint64_t start_isr = Sim::mcu().cnt_isr_cycles;
+        uint64_t next_screen = start;
+        //While: a display is not up to date
+        while ((g_scheduler.get_pending() > 0) || (g_scheduler.get_sprite_queue_depth() > 0) || (g_screen_spi1.is_ready() == false))
+        {
+            //If: time for a screen update
+            if (Sim::now() >= next_screen)
+            {
+                next_screen += us_to_cycles( Config::SCREEN_US );
+                uint64_t start_task = Sim::now();
+                uint64_t start_task_isr = Sim::mcu().cnt_isr_cycles;
+                g_scheduler.update();
+                screen_cycles += (Sim::now() -start_task) -isr_cycles( start_task_isr );
+            }
+            Sim::spend( Config::LOOP_CYCLES );
+        }
+        uint64_t elapsed = Sim::now() -start;
+        screen_cycles += isr_cycles( start_isr );
+        spi0_busy = Sim::spi_peripheral( SPI0 ).cnt_busy_cycles -spi0_busy;
+        spi1_busy = Sim::spi_peripheral( SPI1 ).cnt_busy_cycles -spi1_busy;
+        if (pass == 1)
+        {
+            printf( "%-10s | sprites: %8d | time: %8llu us | sprites/s: %8llu | screen cpu: %5.2f%% | spi0 busy: %5.2f%% | spi1 busy: %5.2f%%\n",
+                "dual", 2 *(int)Longan_nano::Screen::Config::FRAME_BUFFER_SIZE, (unsigned long long)(elapsed *1000000 /Sim::Config::CORE_CLOCK),
+                (unsigned long long)(2 *Longan_nano::Screen::Config::FRAME_BUFFER_SIZE *(uint64_t)Sim::Config::CORE_CLOCK /elapsed), 100.0 *screen_cycles /elapsed,
+                100.0 *spi0_busy /elapsed, 100.0 *spi1_busy /elapsed );
+        }
+    }
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	run_boot | void
+****************************************************************************/
+//! @details
+//!	Bring-up. Measure the time init keeps the CPU and the time until the first frame is on the display
+/***************************************************************************/
+
+static void run_boot( void )
+{
+    uint64_t screen_cycles = 0;
+    uint64_t start = Sim::now();
+    uint64_t start_isr = Sim::mcu().cnt_isr_cycles;
+    //Initialize the Display
+    g_screen.init();
+    uint64_t blocked = Sim::now() -start;
+    //Let the driver bring up the display and send the first frame
+    run_until_idle( screen_cycles );
+    uint64_t first_frame = Sim::now() -start;
+    screen_cycles += isr_cycles( start_isr );
+    printf( "%-10s | init: %8llu us | first frame: %8llu us | screen cpu: %5.2f%%\n",
+        "boot", (unsigned long long)(blocked *1000000 /Sim::Config::CORE_CLOCK), (unsigned long long)(first_frame *1000000 /Sim::Config::CORE_CLOCK), 100.0 *(blocked +screen_cycles) /first_frame );
+    return;
+}
+
+/****************************************************************************
+**	@brief main
+**	main | void
+****************************************************************************/
+//! @return int |
+//! @details Entry point of the benchmark
+/***************************************************************************/
+
+int main( void )
+{
+    //----------------------------------------------------------------
+    //	INIT
+    //----------------------------------------------------------------
+
+    //The DMA and SPI ISR of the driver need interrupts
+    eclic_global_interrupt_enable();
+    //Initialize the Display
+    run_boot();
+    g_screen.clear( Longan_nano::Screen::Color::BLACK );
+    //Let the driver send the clear
+    while (is_screen_idle() == false)
+    {
+        g_screen.update();
+    }
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    run_redraw( "redraw", 0 );
+    run_burst();
+    run_latency();
+    run_flush_order( "raster", Longan_nano::Screen::Flush_order::RASTER );
+    run_flush_order( "oldest", Longan_nano::Screen::Flush_order::OLDEST_FIRST );
+    run_image();
+    run_demo( "string", demo_string );
+    run_demo( "workload", demo_workload );
+    run_demo( "clear", demo_clear );
+    run_dual();
+    Sim::drain();
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return 0;
+}	//end function: main | void
+
+/****************************************************************************
+**	@brief isr
+**	DMA0_Channel2_IRQHandler | void
+****************************************************************************/
+//! @details DMA transfer complete of the SPI transmit channel. Advance the driver FSM
+/***************************************************************************/
+
+extern "C" void DMA0_Channel2_IRQHandler( void )
+{
+    g_screen.update_sprite_isr();
+    return;
+}	//End isr: DMA0_Channel2_IRQHandler | void
+
+/****************************************************************************
+**	@brief isr
+**	DMA0_Channel4_IRQHandler | void
+****************************************************************************/
+//! @details DMA transfer complete of the SPI1 transmit channel. Advance the driver FSM of the second display
+/***************************************************************************/
+
+extern "C" void DMA0_Channel4_IRQHandler( void )
+{
+    g_screen_spi1.update_sprite_isr();
+    return;
+}	//End isr: DMA0_Channel4_IRQHandler | void
+
+/****************************************************************************
+**	@brief isr
+**	SPI0_IRQHandler | void
+****************************************************************************/
+//! @details SPI0 is done with the frame the driver waits for. Advance the driver FSM
+/***************************************************************************/
+
+extern "C" void SPI0_IRQHandler( void )
+{
+    g_screen.update_sprite_isr();
+    return;
+}	//End isr: SPI0_IRQHandler | void
+
+/****************************************************************************
+**	@brief isr
+**	SPI1_IRQHandler | void
+****************************************************************************/
+//! @details SPI1 is done with the frame the driver waits for. Advance the driver FSM of the second display
+/***************************************************************************/
+
+extern "C" void SPI1_IRQHandler( void )
+{
+    g_screen_spi1.update_sprite_isr();
+    return;
+}	//End isr: SPI1_IRQHandler | void
@@ -0,0 +1,267 @@
+/****************************************************************************
+**	OrangeBot Project
+*****************************************************************************
+**        /
+**       /
+**      /
+** ______ \
+**         \
+**          \
+*****************************************************************************
+**	Longan Nano Display Frame Checks
+*****************************************************************************
+**  Host build of the Display class on top of the simulated GD32VF103 HAL
+**  Draws on the panel and compares the frame memory of the simulated ST7735S with a reference frame
+**  Window clipping of pixel maps and solid colors, primitives and clear
+**	pio test -e native
+****************************************************************************/
+
+/****************************************************************************
+**	INCLUDES
+****************************************************************************/
+
+//Unit test framework
+#include <unity.h>
+//Simulated Longan Nano HAL
+#include <gd32vf103.h>
+//Display driver
+#include "ST7735S_W160_H80_C16.hpp"
+
+/****************************************************************************
+**	ENUM
+****************************************************************************/
+
+typedef Longan_nano::Display Display;
+typedef Longan_nano::Panel_st7735s_w160_h80 Panel;
+
+//Configurations
+typedef enum _Config
+{
+    HEIGHT          = Panel::Config::HEIGHT,
+    WIDTH           = Panel::Config::WIDTH,
+    //Size of the test pixel map
+    MAP_HEIGHT      = 30,
+    MAP_WIDTH       = 20,
+} Config;
+
+/****************************************************************************
+**	GLOBAL VARIABILES
+****************************************************************************/
+
+//Display Driver. Global so that the DMA ISR can advance the driver FSM
+Display g_display;
+//What the panel should show
+uint16_t g_reference[ Config::HEIGHT ][ Config::WIDTH ];
+//Pixel map drawn across the borders of the screen
+uint16_t g_map[ Config::MAP_HEIGHT *Config::MAP_WIDTH ];
+
+/****************************************************************************
+**	FUNCTIONS
+****************************************************************************/
+
+/****************************************************************************
+**	@brief function
+**	get_pixel | int | int
+****************************************************************************/
+//! @param h | int | line of the screen
+//! @param w | int | column of the screen
+//! @return uint16_t | RGB565 pixel in the frame memory of the simulated panel. Byte order of Display::color
+//! @details The landscape screen sits in the 132x162 memory with MV set and its address offsets
+/***************************************************************************/
+
+static uint16_t get_pixel( int h, int w )
+{
+    uint16_t pixel = Sim::lcd_pixel( Sim::lcd( Panel::Config::SPI_CH ), (uint16_t)(Panel::Config::ROW_ADDRESS_OFFSET +w), (uint16_t)(Panel::Config::COL_ADDRESS_OFFSET +Config::HEIGHT -1 -h) );
+    //Same byte order as Display::color
+    Display::pack_rgb565( &pixel, 1 );
+    return pixel;
+}
+
+/****************************************************************************
+**	@brief function
+**	reference_rect | int | int | int | int | uint16_t
+****************************************************************************/
+//! @return int | pixels of the rectangle inside the screen
+//! @details Paint a rectangle in the reference frame, clipped like the driver should
+/***************************************************************************/
+
+static int reference_rect( int origin_h, int origin_w, int size_h, int size_w, uint16_t color )
+{
+    int num_pixels = 0;
+    for (int h = origin_h;h < origin_h +size_h;h++)
+    {
+        for (int w = origin_w;w < origin_w +size_w;w++)
+        {
+            if ((h >= 0) && (h < Config::HEIGHT) && (w >= 0) && (w < Config::WIDTH))
+            {
+                g_reference[h][w] = color;
+                num_pixels++;
+            }
+        }
+    }
+    return num_pixels;
+}
+
+/****************************************************************************
+**	@brief function
+**	count_wrong_pixels | void
+****************************************************************************/
+//! @return int | pixels of the panel that differ from the reference frame
+/***************************************************************************/
+
+static int count_wrong_pixels( void )
+{
+    int num_wrong = 0;
+    for (int h = 0;h < Config::HEIGHT;h++)
+    {
+        for (int w = 0;w < Config::WIDTH;w++)
+        {
+            num_wrong += (get_pixel( h, w ) != g_reference[h][w]);
+        }
+    }
+    return num_wrong;
+}
+
+/****************************************************************************
+**	@brief function
+**	flush | void
+****************************************************************************/
+//! @details Run the driver until it sent every sprite and the SPI is idle
+/***************************************************************************/
+
+static void flush( void )
+{
+    while ((g_display.update_sprite() == true) || (g_display.is_sprite_queue_empty() == false))
+    {
+    }
+    Sim::drain();
+    return;
+}
+
+void setUp( void )
+{
+    g_display.clear( 0x0000 );
+    Sim::drain();
+    memset( g_reference, 0, sizeof(g_reference) );
+    return;
+}
+
+void tearDown( void )
+{
+    return;
+}
+
+/****************************************************************************
+**	TESTS
+****************************************************************************/
+
+//Pixel maps and solid colors across every border and corner of the screen are clipped to the visible pixels
+void test_window_clipping( void )
+{
+    const int origin[][2] = { { -5, -7 }, { 70, 150 }, { -10, 145 }, { 60, -15 }, { 30, 50 }, { -30, 0 }, { 0, -20 }, { 200, 0 } };
+    for (int t = 0;t < Config::MAP_HEIGHT *Config::MAP_WIDTH;t++)
+    {
+        g_map[t] = (uint16_t)(t *37 +1);
+    }
+    for (auto &o : origin)
+    {
+        //Pixel map, only the part of the map inside the screen is sent
+        int num_expected = 0;
+        for (int h = 0;h < Config::MAP_HEIGHT;h++)
+        {
+            for (int w = 0;w < Config::MAP_WIDTH;w++)
+            {
+                num_expected += reference_rect( o[0] +h, o[1] +w, 1, 1, g_map[ h *Config::MAP_WIDTH +w ] );
+            }
+        }
+        TEST_ASSERT_EQUAL_INT( num_expected, g_display.draw_sprite( o[0], o[1], Config::MAP_HEIGHT, Config::MAP_WIDTH, g_map ) );
+        //Solid color over it
+        num_expected = reference_rect( o[0] +3, o[1] +1, 5, 7, 0xABCD );
+        TEST_ASSERT_EQUAL_INT( num_expected, g_display.draw_sprite( o[0] +3, o[1] +1, 5, 7, (uint16_t)0xABCD ) );
+    }
+    Sim::drain();
+    TEST_ASSERT_EQUAL_INT( 0, count_wrong_pixels() );
+    return;
+}
+
+//Lines and frames are registered as clipped solid rectangles
+void test_primitives( void )
+{
+    const uint16_t red = Display::color( 255, 0, 0 );
+    const uint16_t green = Display::color( 0, 255, 0 );
+    const uint16_t blue = Display::color( 0, 0, 255 );
+    TEST_ASSERT_EQUAL_INT( 156, g_display.draw_frame( 2, 3, 30, 50, 1, red ) );
+    reference_rect( 2, 3, 1, 50, red );
+    reference_rect( 31, 3, 1, 50, red );
+    reference_rect( 2, 3, 30, 1, red );
+    reference_rect( 2, 52, 30, 1, red );
+    flush();
+    TEST_ASSERT_EQUAL_INT( 160, g_display.draw_hline( 35, -5, 200, blue ) );
+    reference_rect( 35, -5, 1, 200, blue );
+    TEST_ASSERT_EQUAL_INT( 47, g_display.draw_vline( -3, 70, 50, blue ) );
+    reference_rect( -3, 70, 50, 1, blue );
+    flush();
+    //Thicker than half the frame: a solid rectangle
+    TEST_ASSERT_EQUAL_INT( 35, g_display.draw_frame( 10, 110, 5, 7, 3, green ) );
+    reference_rect( 10, 110, 5, 7, green );
+    TEST_ASSERT_EQUAL_INT( 9, g_display.fill_rect( 20, 120, 3, 3, blue ) );
+    reference_rect( 20, 120, 3, 3, blue );
+    //Nothing to draw
+    TEST_ASSERT_EQUAL_INT( 0, g_display.fill_rect( 90, 0, 5, 5, blue ) );
+    flush();
+    TEST_ASSERT_EQUAL_INT( 0, count_wrong_pixels() );
+    return;
+}
+
+//Clear fills the whole screen with one color
+void test_clear( void )
+{
+    const uint16_t cyan = Display::color( 0, 255, 255 );
+    g_display.draw_sprite( 10, 10, 5, 5, (uint16_t)0x1234 );
+    g_display.clear( cyan );
+    Sim::drain();
+    reference_rect( 0, 0, Config::HEIGHT, Config::WIDTH, cyan );
+    TEST_ASSERT_EQUAL_INT( 0, count_wrong_pixels() );
+    return;
+}
+
+int main( int argc, char **argv )
+{
+    eclic_global_interrupt_enable();
+    g_display.init();
+    while (g_display.is_ready() == false)
+    {
+        g_display.update_sprite();
+    }
+    UNITY_BEGIN();
+    RUN_TEST( test_window_clipping );
+    RUN_TEST( test_primitives );
+    RUN_TEST( test_clear );
+    return UNITY_END();
+}
+
+/****************************************************************************
+**	@brief isr
+**	DMA0_Channel2_IRQHandler | void
+****************************************************************************/
+//! @details DMA transfer complete of SPI0 transmit. Advance the driver FSM
+/***************************************************************************/
+
+extern "C" void DMA0_Channel2_IRQHandler( void )
+{
+    g_display.update_sprite_isr();
+    return;
+}	//End isr: DMA0_Channel2_IRQHandler | void
+
+/****************************************************************************
+**	@brief isr
+**	SPI0_IRQHandler | void
+****************************************************************************/
+//! @details SPI0 is done with the frame the driver waits for. Advance the driver FSM
+/***************************************************************************/
+
+extern "C" void SPI0_IRQHandler( void )
+{
+    g_display.update_sprite_isr();
+    return;
+}	//End isr: SPI0_IRQHandler | void
@@ -0,0 +1,275 @@
+/****************************************************************************
+**	OrangeBot Project
+*****************************************************************************
+**        /
+**       /
+**      /
+** ______ \
+**         \
+**          \
+*****************************************************************************
+**	Longan Nano Display RGB444 Frame Checks
+*****************************************************************************
+**  Host build of the Display class in 12 bit color on top of the simulated GD32VF103 HAL
+**  Two pixels are packed in three bytes. The simulated ST7735S expands them to RGB565 in its frame memory
+**  Packed pixel maps, odd windows ending in a padded byte, clipping of packed maps and solid colors
+**	pio test -e native
+****************************************************************************/
+
+/****************************************************************************
+**	INCLUDES
+****************************************************************************/
+
+//Unit test framework
+#include <unity.h>
+//Simulated Longan Nano HAL
+#include <gd32vf103.h>
+//Display driver
+#include "ST7735S_W160_H80_C16.hpp"
+
+/****************************************************************************
+**	ENUM
+****************************************************************************/
+
+//Embedded display of the longan nano in 12 bit color
+struct Panel
+{
+    typedef enum _Config
+    {
+        WIDTH				= Longan_nano::Panel_st7735s_w160_h80::Config::WIDTH,
+        HEIGHT				= Longan_nano::Panel_st7735s_w160_h80::Config::HEIGHT,
+        ROW_ADDRESS_OFFSET	= Longan_nano::Panel_st7735s_w160_h80::Config::ROW_ADDRESS_OFFSET,
+        COL_ADDRESS_OFFSET	= Longan_nano::Panel_st7735s_w160_h80::Config::COL_ADDRESS_OFFSET,
+        PANEL_LINES			= Longan_nano::Panel_st7735s_w160_h80::Config::PANEL_LINES,
+        PANEL_COLUMNS		= Longan_nano::Panel_st7735s_w160_h80::Config::PANEL_COLUMNS,
+        MADCTL				= Longan_nano::Panel_st7735s_w160_h80::Config::MADCTL,
+        INVERSION			= Longan_nano::Panel_st7735s_w160_h80::Config::INVERSION,
+        COLOR_DEPTH			= 12,
+        RS_GPIO				= Longan_nano::Panel_st7735s_w160_h80::Config::RS_GPIO,
+        RS_PIN				= Longan_nano::Panel_st7735s_w160_h80::Config::RS_PIN,
+        RST_GPIO			= Longan_nano::Panel_st7735s_w160_h80::Config::RST_GPIO,
+        RST_PIN				= Longan_nano::Panel_st7735s_w160_h80::Config::RST_PIN,
+        SPI_RCU				= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_RCU,
+        SPI_CH				= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_CH,
+        SPI_CS_GPIO			= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_CS_GPIO,
+        SPI_CS_PIN			= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_CS_PIN,
+        SPI_CLK_GPIO		= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_CLK_GPIO,
+        SPI_CLK_PIN			= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_CLK_PIN,
+        SPI_MISO_GPIO		= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_MISO_GPIO,
+        SPI_MISO_PIN		= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_MISO_PIN,
+        SPI_MOSI_GPIO		= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_MOSI_GPIO,
+        SPI_MOSI_PIN		= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_MOSI_PIN,
+        DMA_SPI_TX_RCU		= Longan_nano::Panel_st7735s_w160_h80::Config::DMA_SPI_TX_RCU,
+        DMA_SPI_TX			= Longan_nano::Panel_st7735s_w160_h80::Config::DMA_SPI_TX,
+        DMA_SPI_TX_CH		= Longan_nano::Panel_st7735s_w160_h80::Config::DMA_SPI_TX_CH,
+        DMA_SPI_TX_IRQ		= Longan_nano::Panel_st7735s_w160_h80::Config::DMA_SPI_TX_IRQ,
+        SPI_IRQ			= Longan_nano::Panel_st7735s_w160_h80::Config::SPI_IRQ,
+    } Config;
+    static constexpr const uint8_t *g_init_sequence = Longan_nano::Panel_st7735s_w160_h80::g_init_sequence;
+};
+
+typedef Longan_nano::Display_panel<Panel> Display;
+
+//Configurations
+typedef enum _Config
+{
+    HEIGHT          = Panel::Config::HEIGHT,
+    WIDTH           = Panel::Config::WIDTH,
+    //Size of the test pixel map
+    MAP_HEIGHT      = 30,
+    MAP_WIDTH       = 20,
+} Config;
+
+/****************************************************************************
+**	GLOBAL VARIABILES
+****************************************************************************/
+
+//Display Driver. Global so that the DMA ISR can advance the driver FSM
+Display g_display;
+//What the panel should show
+uint16_t g_reference[ Config::HEIGHT ][ Config::WIDTH ];
+//Pixel map, packed in place before it is drawn
+uint16_t g_map[ Config::MAP_HEIGHT *Config::MAP_WIDTH ];
+
+/****************************************************************************
+**	FUNCTIONS
+****************************************************************************/
+
+/****************************************************************************
+**	@brief function
+**	get_pixel | int | int
+****************************************************************************/
+//! @param h | int | line of the screen
+//! @param w | int | column of the screen
+//! @return uint16_t | RGB565 pixel in the frame memory of the simulated panel
+//! @details The landscape screen sits in the 132x162 memory with MV set and its address offsets
+/***************************************************************************/
+
+static uint16_t get_pixel( int h, int w )
+{
+    return Sim::lcd_pixel( Sim::lcd( Panel::Config::SPI_CH ), (uint16_t)(Panel::Config::ROW_ADDRESS_OFFSET +w), (uint16_t)(Panel::Config::COL_ADDRESS_OFFSET +Config::HEIGHT -1 -h) );
+}
+
+/****************************************************************************
+**	@brief function
+**	reference_rect | int | int | int | int | uint16_t
+****************************************************************************/
+//! @return int | pixels of the rectangle inside the screen
+//! @details Paint a rectangle of a RGB444 color in the reference frame, clipped like the driver should
+/***************************************************************************/
+
+static int reference_rect( int origin_h, int origin_w, int size_h, int size_w, uint16_t color )
+{
+    int num_pixels = 0;
+    for (int h = origin_h;h < origin_h +size_h;h++)
+    {
+        for (int w = origin_w;w < origin_w +size_w;w++)
+        {
+            if ((h >= 0) && (h < Config::HEIGHT) && (w >= 0) && (w < Config::WIDTH))
+            {
+                g_reference[h][w] = Sim::rgb444_to_565( color );
+                num_pixels++;
+            }
+        }
+    }
+    return num_pixels;
+}
+
+/****************************************************************************
+**	@brief function
+**	count_wrong_pixels | void
+****************************************************************************/
+//! @return int | pixels of the panel that differ from the reference frame
+/***************************************************************************/
+
+static int count_wrong_pixels( void )
+{
+    int num_wrong = 0;
+    for (int h = 0;h < Config::HEIGHT;h++)
+    {
+        for (int w = 0;w < Config::WIDTH;w++)
+        {
+            num_wrong += (get_pixel( h, w ) != g_reference[h][w]);
+        }
+    }
+    return num_wrong;
+}
+
+void setUp( void )
+{
+    g_display.clear( 0x0000 );
+    Sim::drain();
+    memset( g_reference, 0, sizeof(g_reference) );
+    return;
+}
+
+void tearDown( void )
+{
+    return;
+}
+
+/****************************************************************************
+**	TESTS
+****************************************************************************/
+
+//Packed maps inside the screen. An odd number of pixels ends in a padded byte
+void test_packed_map( void )
+{
+    const int size[][2] = { { 30, 20 }, { 5, 7 }, { 1, 1 }, { 3, 1 } };
+    const int origin[][2] = { { 10, 10 }, { 40, 100 }, { 79, 159 }, { 0, 0 } };
+    for (int t = 0;t < 4;t++)
+    {
+        int num_pixels = size[t][0] *size[t][1];
+        for (int p = 0;p < num_pixels;p++)
+        {
+            g_map[p] = (uint16_t)((p *37 +t) & 0x0FFF);
+            reference_rect( origin[t][0] +p /size[t][1], origin[t][1] +p %size[t][1], 1, 1, g_map[p] );
+        }
+        TEST_ASSERT_EQUAL_INT( (num_pixels *3 +1) /2, Display::pack_rgb444( g_map, num_pixels ) );
+        TEST_ASSERT_EQUAL_INT( num_pixels, g_display.draw_sprite( origin[t][0], origin[t][1], size[t][0], size[t][1], g_map ) );
+        Sim::drain();
+    }
+    TEST_ASSERT_EQUAL_INT( 0, count_wrong_pixels() );
+    return;
+}
+
+//A packed map can be clipped in height when an even number of pixels is skipped. Other clips are refused
+void test_packed_map_clipping( void )
+{
+    for (int p = 0;p < Config::MAP_HEIGHT *Config::MAP_WIDTH;p++)
+    {
+        g_map[p] = (uint16_t)((p *11) & 0x0FFF);
+    }
+    for (int p = 2 *Config::MAP_WIDTH;p < Config::MAP_HEIGHT *Config::MAP_WIDTH;p++)
+    {
+        reference_rect( -2 +p /Config::MAP_WIDTH, 30 +p %Config::MAP_WIDTH, 1, 1, g_map[p] );
+    }
+    Display::pack_rgb444( g_map, Config::MAP_HEIGHT *Config::MAP_WIDTH );
+    TEST_ASSERT_EQUAL_INT( (Config::MAP_HEIGHT -2) *Config::MAP_WIDTH, g_display.draw_sprite( -2, 30, Config::MAP_HEIGHT, Config::MAP_WIDTH, g_map ) );
+    //Five pixels skipped: the first visible pixel is in the middle of a byte
+    TEST_ASSERT_EQUAL_INT( -1, g_display.draw_sprite( -1, 60, 7, 5, g_map ) );
+    TEST_ASSERT_EQUAL_INT( -1, g_display.draw_sprite( 10, -4, Config::MAP_HEIGHT, Config::MAP_WIDTH, g_map ) );
+    Sim::drain();
+    TEST_ASSERT_EQUAL_INT( 0, count_wrong_pixels() );
+    return;
+}
+
+//Solid colors are sent from a packed pattern and clipped anywhere
+void test_solid_clipping( void )
+{
+    const int origin[][2] = { { -5, -7 }, { 70, 150 }, { -10, 145 }, { 60, -15 }, { 30, 50 }, { 0, 0 }, { 79, 0 }, { 200, 0 } };
+    for (auto &o : origin)
+    {
+        int num_expected = reference_rect( o[0], o[1], 5, 7, 0x0ABC );
+        TEST_ASSERT_EQUAL_INT( num_expected, g_display.draw_sprite( o[0], o[1], 5, 7, (uint16_t)0x0ABC ) );
+    }
+    Sim::drain();
+    TEST_ASSERT_EQUAL_INT( 0, count_wrong_pixels() );
+    //Whole screen, longer than the pattern
+    g_display.clear( Display::color( 0, 255, 255 ) );
+    Sim::drain();
+    reference_rect( 0, 0, Config::HEIGHT, Config::WIDTH, Display::color( 0, 255, 255 ) );
+    TEST_ASSERT_EQUAL_INT( 0, count_wrong_pixels() );
+    return;
+}
+
+int main( int argc, char **argv )
+{
+    eclic_global_interrupt_enable();
+    g_display.init();
+    while (g_display.is_ready() == false)
+    {
+        g_display.update_sprite();
+    }
+    UNITY_BEGIN();
+    RUN_TEST( test_packed_map );
+    RUN_TEST( test_packed_map_clipping );
+    RUN_TEST( test_solid_clipping );
+    return UNITY_END();
+}
+
+/****************************************************************************
+**	@brief isr
+**	DMA0_Channel2_IRQHandler | void
+****************************************************************************/
+//! @details DMA transfer complete of SPI0 transmit. Advance the driver FSM
+/***************************************************************************/
+
+extern "C" void DMA0_Channel2_IRQHandler( void )
+{
+    g_display.update_sprite_isr();
+    return;
+}	//End isr: DMA0_Channel2_IRQHandler | void
+
+/****************************************************************************
+**	@brief isr
+**	SPI0_IRQHandler | void
+****************************************************************************/
+//! @details SPI0 is done with the frame the driver waits for. Advance the driver FSM
+/***************************************************************************/
+
+extern "C" void SPI0_IRQHandler( void )
+{
+    g_display.update_sprite_isr();
+    return;
+}	//End isr: SPI0_IRQHandler | void
@@ -0,0 +1,471 @@
+/****************************************************************************
+**	OrangeBot Project
+*****************************************************************************
+**        /
+**       /
+**      /
+** ______ \
+**         \
+**          \
+*****************************************************************************
+**	Longan Nano Screen Frame Checks
+*****************************************************************************
+**  Host build of the Screen class on top of the simulated GD32VF103 HAL
+**  Keeps a model of the text on screen, renders it from the glyph tables of the font registry
+**  and compares it with the frame memory of the simulated ST7735S
+**  Every font in every rotation, flipped included, hardware scroll, tiles and clear
+**	pio test -e native
+****************************************************************************/
+
+/****************************************************************************
+**	INCLUDES
+****************************************************************************/
+
+//Unit test framework
+#include <unity.h>
+//Simulated Longan Nano HAL
+#include <gd32vf103.h>
+//Higher level abstraction layer to base Display Class. Provides character sprites and print methods with color
+#include "longan_nano_screen.hpp"
+
+/****************************************************************************
+**	ENUM
+****************************************************************************/
+
+typedef Longan_nano::Screen Screen;
+typedef Longan_nano::Display Display;
+typedef Longan_nano::Panel_st7735s_w160_h80 Panel;
+
+//Configurations
+typedef enum _Config
+{
+    HEIGHT          = Panel::Config::HEIGHT,
+    WIDTH           = Panel::Config::WIDTH,
+    //Largest frame buffer of the model
+    MODEL_SIZE      = 32,
+    //Calls of Screen::update allowed to bring the display up to date with the frame buffer
+    MAX_UPDATES     = 1000000,
+    //Colors of the text
+    BACKGROUND      = 0x0000,
+    FOREGROUND      = 0xFFFF,
+} Config;
+
+/****************************************************************************
+**	STRUCT
+****************************************************************************/
+
+//A sprite of the model. A character and its colors in RGB565
+typedef struct _Model_sprite
+{
+    char c;
+    uint16_t background;
+    uint16_t foreground;
+} Model_sprite;
+
+/****************************************************************************
+**	GLOBAL VARIABILES
+****************************************************************************/
+
+//Display Driver. Global so that the DMA ISR can advance the driver FSM and the DMA can reach the pixel buffers
+Screen g_screen;
+//What the frame buffer should hold
+Model_sprite g_model[ Config::MODEL_SIZE ][ Config::MODEL_SIZE ];
+//What the panel should show
+uint16_t g_reference[ Config::HEIGHT ][ Config::WIDTH ];
+//Rotation of the screen
+Screen::Rotation g_rotation;
+
+//Pre-rendered labels in flash
+static constexpr Screen::Tile<7> g_tile_label( "Tile 7!", Screen::color( 0, 0, 255 ), Screen::color( 255, 255, 0 ) );
+static constexpr Screen::Tile<5> g_tile_short( "ab", Screen::color( 0, 0, 255 ), Screen::color( 255, 255, 0 ) );
+
+/****************************************************************************
+**	FUNCTIONS
+****************************************************************************/
+
+/****************************************************************************
+**	@brief function
+**	get_pixel | int | int
+****************************************************************************/
+//! @param h | int | line of the panel in landscape
+//! @param w | int | column of the panel in landscape
+//! @return uint16_t | RGB565 pixel shown by the simulated panel, hardware scroll applied. Byte order of Display::color
+/***************************************************************************/
+
+static uint16_t get_pixel( int h, int w )
+{
+    uint16_t pixel = Sim::lcd_pixel( Sim::lcd( Panel::Config::SPI_CH ), (uint16_t)(Panel::Config::ROW_ADDRESS_OFFSET +w), (uint16_t)(Panel::Config::COL_ADDRESS_OFFSET +Config::HEIGHT -1 -h) );
+    //Same byte order as Display::color
+    Display::pack_rgb565( &pixel, 1 );
+    return pixel;
+}
+
+/****************************************************************************
+**	@brief function
+**	count_wrong_pixels | void
+****************************************************************************/
+//! @return int | pixels of the panel that differ from the reference frame
+/***************************************************************************/
+
+static int count_wrong_pixels( void )
+{
+    int num_wrong = 0;
+    for (int h = 0;h < Config::HEIGHT;h++)
+    {
+        for (int w = 0;w < Config::WIDTH;w++)
+        {
+            num_wrong += (get_pixel( h, w ) != g_reference[h][w]);
+        }
+    }
+    return num_wrong;
+}
+
+/****************************************************************************
+**	@brief function
+**	flush | void
+****************************************************************************/
+//! @details Run the screen until the display is up to date with the frame buffer and the SPI is idle
+/***************************************************************************/
+
+static void flush( void )
+{
+    for (int t = 0;(t < Config::MAX_UPDATES) && ((g_screen.get_pending() > 0) || (g_screen.get_sprite_queue_depth() > 0));t++)
+    {
+        g_screen.update();
+    }
+    Sim::drain();
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	set_rotation | Screen::Rotation
+****************************************************************************/
+//! @return bool | false = OK | true = ERR
+//! @details Turn the screen and remember the rotation for the model
+/***************************************************************************/
+
+static bool set_rotation( Screen::Rotation rotation )
+{
+    g_rotation = rotation;
+    return g_screen.set_rotation( rotation );
+}
+
+/****************************************************************************
+**	@brief function
+**	model_print | int | int | const char *
+****************************************************************************/
+//! @details Print a string on screen in the text colors and in the model
+/***************************************************************************/
+
+static void model_print( int origin_h, int origin_w, const char *str )
+{
+    g_screen.print( origin_h, origin_w, str, Screen::Color::BLACK, Screen::Color::WHITE );
+    for (int t = 0;(str[t] != '\0') && (origin_w +t < g_screen.get_frame_buffer_width());t++)
+    {
+        g_model[ origin_h ][ origin_w +t ] = { str[t], Config::BACKGROUND, Config::FOREGROUND };
+    }
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	model_clear | uint16_t
+****************************************************************************/
+//! @details Fill the model with blank sprites of a color
+/***************************************************************************/
+
+static void model_clear( uint16_t color )
+{
+    for (int th = 0;th < Config::MODEL_SIZE;th++)
+    {
+        for (int tw = 0;tw < Config::MODEL_SIZE;tw++)
+        {
+            g_model[th][tw] = { ' ', color, color };
+        }
+    }
+    return;
+}
+
+/****************************************************************************
+**	@brief function
+**	render_model | void
+****************************************************************************/
+//! @details Render the model in the reference frame with the glyph table of the font in use
+//! The rotation is applied by mapping each pixel of the landscape panel to the rotated screen
+//! Pixels past the last full sprite stay black
+/***************************************************************************/
+
+static void render_model( void )
+{
+    const Screen::Font font = g_screen.get_font();
+    const uint8_t *rows = g_screen.get_font_rows( font );
+    const int glyph_width[] = { Screen::Config::COURIER_8X10_WIDTH, Screen::Config::NSIMSUN_8X16_WIDTH, Screen::Config::FIXED_6X8_WIDTH };
+    const int glyph_height[] = { Screen::Config::COURIER_8X10_HEIGHT, Screen::Config::NSIMSUN_8X16_HEIGHT, Screen::Config::FIXED_6X8_HEIGHT };
+    const int fw = glyph_width[ font ], fh = glyph_height[ font ];
+    const bool f_portrait = ((g_rotation == Screen::Rotation::PORTRAIT) || (g_rotation == Screen::Rotation::PORTRAIT_FLIPPED));
+    const bool f_flip = ((g_rotation == Screen::Rotation::LANDSCAPE_FLIPPED) || (g_rotation == Screen::Rotation::PORTRAIT_FLIPPED));
+    for (int h = 0;h < Config::HEIGHT;h++)
+    {
+        for (int w = 0;w < Config::WIDTH;w++)
+        {
+            //Pixel of the rotated screen
+            int y, x;
+            if (f_portrait == false)
+            {
+                y = (f_flip == false)?(h):(Config::HEIGHT -1 -h);
+                x = (f_flip == false)?(w):(Config::WIDTH -1 -w);
+            }
+            else
+            {
+                y = (f_flip == false)?(w):(Config::WIDTH -1 -w);
+                x = (f_flip == false)?(Config::HEIGHT -1 -h):(h);
+            }
+            int th = y /fh, tw = x /fw;
+            uint16_t color = 0x0000;
+            if ((th < g_screen.get_frame_buffer_height()) && (tw < g_screen.get_frame_buffer_width()))
+            {
+                const Model_sprite &sprite = g_model[th][tw];
+                uint8_t slice = rows[ (sprite.c -Screen::Config::ASCII_START) *fh +y %fh ];
+                color = (((slice >> (x %fw)) & 0x01) != 0)?(sprite.foreground):(sprite.background);
+            }
+            g_reference[h][w] = color;
+        }
+    }
+    return;
+}
+
+void setUp( void )
+{
+    set_rotation( Screen::Rotation::LANDSCAPE );
+    g_screen.set_font( (Screen::Font)Screen::Config::FONT_DEFAULT );
+    model_clear( 0x0000 );
+    return;
+}
+
+void tearDown( void )
+{
+    return;
+}
+
+/****************************************************************************
+**	TESTS
+****************************************************************************/
+
+//Fill the screen with text in every font of the registry and every rotation
+void test_fonts_and_rotations( void )
+{
+    for (int font = 0;font < Screen::Font::NUM_FONTS;font++)
+    {
+        //If: the font is not available on this panel or not enabled
+        if (((font == Screen::Font::FIXED_6X8) && (Screen::Config::FIXED_6X8_ENABLE == false)) || ((font == Screen::Font::NSIMSUN_8X16) && (Screen::Config::NSIMSUN_8X16_ENABLE == false)))
+        {
+            TEST_ASSERT_TRUE( g_screen.set_font( (Screen::Font)font ) );
+            continue;
+        }
+        TEST_ASSERT_FALSE( g_screen.set_font( (Screen::Font)font ) );
+        for (int rotation = 0;rotation < 4;rotation++)
+        {
+            TEST_ASSERT_FALSE( set_rotation( (Screen::Rotation)rotation ) );
+            model_clear( 0x0000 );
+            int height = g_screen.get_frame_buffer_height(), width = g_screen.get_frame_buffer_width();
+            for (int th = 0;th < height;th++)
+            {
+                for (int tw = 0;tw < width;tw++)
+                {
+                    char str[2] = { (char)(' ' +(th *width +tw +rotation +font) %95), '\0' };
+                    model_print( th, tw, str );
+                }
+            }
+            flush();
+            render_model();
+            TEST_ASSERT_EQUAL_INT_MESSAGE( 0, count_wrong_pixels(), "font and rotation" );
+            //Overwrite part of the text. Only the changed sprites are sent
+            model_print( height /2, 1, "Hello" );
+            flush();
+            render_model();
+            TEST_ASSERT_EQUAL_INT_MESSAGE( 0, count_wrong_pixels(), "print over text" );
+        }
+    }
+    return;
+}
+
+//Scroll a band of columns with the hardware scroll while text keeps being printed
+void test_scroll( void )
+{
+    const int origin_w = 2, size_w = 13;
+    const int shift[] = { 1, 3, -2, 25, -1, 0, 7, -13 };
+    int height = g_screen.get_frame_buffer_height(), width = g_screen.get_frame_buffer_width();
+    TEST_ASSERT_EQUAL_INT( 0, g_screen.set_scroll_area( origin_w, size_w ) );
+    TEST_ASSERT_EQUAL_INT( -1, g_screen.set_scroll_area( width -1, 2 ) );
+    for (int th = 0;th < height;th++)
+    {
+        for (int tw = 0;tw < width;tw++)
+        {
+            char str[2] = { (char)('A' +(th *width +tw) %26), '\0' };
+            model_print( th, tw, str );
+        }
+    }
+    flush();
+    for (int t = 0;t < (int)(sizeof(shift) /sizeof(shift[0]));t++)
+    {
+        //Sprites still pending when the area rotates
+        char str[2] = { (char)('a' +t), '\0' };
+        model_print( t %height, origin_w +t, str );
+        TEST_ASSERT_TRUE( g_screen.scroll( shift[t] ) >= 0 );
+        //Model: the area rotates left, the exposed columns are blank
+        int left = ((shift[t] %size_w) +size_w) %size_w;
+        int exposed = (shift[t] < 0)?(-shift[t]):(shift[t]);
+        exposed = (exposed < size_w)?(exposed):(size_w);
+        int exposed_w = (shift[t] > 0)?(origin_w +size_w -exposed):(origin_w);
+        for (int th = 0;th < height;th++)
+        {
+            Model_sprite row[ Config::MODEL_SIZE ];
+            for (int tw = 0;tw < size_w;tw++)
+            {
+                row[tw] = g_model[th][ origin_w +(tw +left) %size_w ];
+            }
+            for (int tw = 0;tw < size_w;tw++)
+            {
+                g_model[th][ origin_w +tw ] = row[tw];
+            }
+            for (int tw = exposed_w;tw < exposed_w +exposed;tw++)
+            {
+                g_model[th][tw] = { ' ', 0x0000, 0x0000 };
+            }
+        }
+        flush();
+        render_model();
+        TEST_ASSERT_EQUAL_INT_MESSAGE( 0, count_wrong_pixels(), "scroll" );
+    }
+    //Moving the area puts the rotated memory columns back in place
+    TEST_ASSERT_TRUE( g_screen.set_scroll_area( 0, width ) >= 0 );
+    flush();
+    render_model();
+    TEST_ASSERT_EQUAL_INT( 0, count_wrong_pixels() );
+    return;
+}
+
+//Tiles pre-rendered in flash show the same pixels as the same text printed in the same colors
+void test_tiles( void )
+{
+    const uint16_t background = Screen::color( 0, 0, 255 ), foreground = Screen::color( 255, 255, 0 );
+    //Pending prints under the tile are dropped
+    model_print( 2, 3, "XXXXXXX" );
+    int pending = g_screen.get_pending();
+    TEST_ASSERT_EQUAL_INT( 7, g_screen.register_tile( 2, 3, g_tile_label ) );
+    TEST_ASSERT_EQUAL_INT( pending -7, g_screen.get_pending() );
+    while (g_screen.register_tile( 5, 10, g_tile_short ) < 0)
+    {
+        g_screen.update();
+    }
+    //Outside the screen
+    TEST_ASSERT_TRUE( g_screen.register_tile( 0, 17, g_tile_short ) < 0 );
+    TEST_ASSERT_TRUE( g_screen.register_tile( -1, 0, g_tile_short ) < 0 );
+    const char *label = "Tile 7!";
+    for (int t = 0;t < 7;t++)
+    {
+        g_model[2][3 +t] = { label[t], background, foreground };
+    }
+    const char *label_short = "ab   ";
+    for (int t = 0;t < 5;t++)
+    {
+        g_model[5][10 +t] = { label_short[t], background, foreground };
+    }
+    flush();
+    render_model();
+    TEST_ASSERT_EQUAL_INT_MESSAGE( 0, count_wrong_pixels(), "tile" );
+    //A print over the tile draws the sprite again
+    model_print( 2, 4, "Q" );
+    flush();
+    render_model();
+    TEST_ASSERT_EQUAL_INT_MESSAGE( 0, count_wrong_pixels(), "print over tile" );
+    //Tiles are rendered in the default font, in landscape
+    set_rotation( Screen::Rotation::PORTRAIT );
+    TEST_ASSERT_TRUE( g_screen.register_tile( 0, 0, g_tile_short ) < 0 );
+    return;
+}
+
+//Clear sends the whole screen as one solid color window in every rotation, rotated scroll area included
+void test_clear( void )
+{
+    const uint16_t red = Screen::color( 255, 0, 0 );
+    for (int rotation = 0;rotation < 4;rotation++)
+    {
+        set_rotation( (Screen::Rotation)rotation );
+        int height = g_screen.get_frame_buffer_height(), width = g_screen.get_frame_buffer_width();
+        if (rotation == 0)
+        {
+            g_screen.set_scroll_area( 2, 10 );
+            g_screen.print( 0, 2, "abcdefghij" );
+            g_screen.scroll( 3 );
+            flush();
+        }
+        g_screen.print( 1, 1, "pending" );
+        TEST_ASSERT_EQUAL_INT( height *width, g_screen.clear( Screen::Color::RED ) );
+        TEST_ASSERT_EQUAL_INT( 0, g_screen.get_pending() );
+        flush();
+        model_clear( red );
+        render_model();
+        TEST_ASSERT_EQUAL_INT_MESSAGE( 0, count_wrong_pixels(), "clear" );
+        //Same color again: nothing to do
+        TEST_ASSERT_EQUAL_INT( 0, g_screen.clear( Screen::Color::RED ) );
+        TEST_ASSERT_EQUAL_INT( 0, g_screen.get_sprite_queue_depth() );
+        //Text drawn over the clear color
+        g_screen.print( 0, 0, "Hi", Screen::Color::RED, Screen::Color::WHITE );
+        g_model[0][0] = { 'H', red, Config::FOREGROUND };
+        g_model[0][1] = { 'i', red, Config::FOREGROUND };
+        flush();
+        render_model();
+        TEST_ASSERT_EQUAL_INT_MESSAGE( 0, count_wrong_pixels(), "print after clear" );
+        //Clear to black, even if black is not in the palette
+        g_screen.clear();
+        flush();
+        model_clear( 0x0000 );
+        render_model();
+        TEST_ASSERT_EQUAL_INT_MESSAGE( 0, count_wrong_pixels(), "clear to black" );
+    }
+    return;
+}
+
+int main( int argc, char **argv )
+{
+    eclic_global_interrupt_enable();
+    g_screen.init();
+    g_screen.set_palette_color( Screen::Color::BLACK, 0, 0, 0 );
+    g_screen.set_palette_color( Screen::Color::WHITE, 255, 255, 255 );
+    g_screen.set_palette_color( Screen::Color::RED, 255, 0, 0 );
+    flush();
+    UNITY_BEGIN();
+    RUN_TEST( test_fonts_and_rotations );
+    RUN_TEST( test_scroll );
+    RUN_TEST( test_tiles );
+    RUN_TEST( test_clear );
+    return UNITY_END();
+}
+
+/****************************************************************************
+**	@brief isr
+**	DMA0_Channel2_IRQHandler | void
+****************************************************************************/
+//! @details DMA transfer complete of SPI0 transmit. Advance the driver FSM
+/***************************************************************************/
+
+extern "C" void DMA0_Channel2_IRQHandler( void )
+{
+    g_screen.update_sprite_isr();
+    return;
+}	//End isr: DMA0_Channel2_IRQHandler | void
+
+/****************************************************************************
+**	@brief isr
+**	SPI0_IRQHandler | void
+****************************************************************************/
+//! @details SPI0 is done with the frame the driver waits for. Advance the driver FSM
+/***************************************************************************/
+
+extern "C" void SPI0_IRQHandler( void )
+{
+    g_screen.update_sprite_isr();
+    return;
+}	//End isr: SPI0_IRQHandler | void
@@ -0,0 +1,276 @@
+/****************************************************************************
+**	OrangeBot Project
+*****************************************************************************
+**        /
+**       /
+**      /
+** ______ \
+**         \
+**          \
+*****************************************************************************
+**	Glyph Expander Benchmark
+*****************************************************************************
+**  Check User::Glyph_expander against the bit by bit loop it replaced and count the cycles of both
+**  Equivalence is exhaustive: every slice of 8, 10 and 16 bits with several color pairs
+**  Host build: g++ -O2 -I src tools/glyph_expander_bench.cpp -o glyph_expander_bench
+**  RV32 build: the board toolchain with printf retargeted to the USART. Cycles are read from mcycle
+**  On the host cycles are the time stamp counter on x86 and nanoseconds elsewhere
+****************************************************************************/
+
+/****************************************************************************
+**	INCLUDES
+****************************************************************************/
+
+//printf
+#include <stdio.h>
+//Glyph slice -> RGB565 pixels
+#include "glyph_expander.hpp"
+#if defined(__riscv)
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#else
+    #include <chrono>
+#endif
+
+/****************************************************************************
+**	DEFINES
+****************************************************************************/
+
+//Rows of a landscape sprite (8 pixels wide) and of a portrait sprite (10 or 16 pixels wide) rendered in a benchmark round
+#define BENCH_SPRITES		96
+#define BENCH_ROUNDS		200
+//Pixels of the guard after an expansion that must be left untouched
+#define GUARD_PIXELS		4
+#define GUARD_COLOR			0xDEAD
+
+/****************************************************************************
+**	GLOBAL VARIABILES
+****************************************************************************/
+
+//Color pairs of the equivalence test. Same colors, black/white, swapped and arbitrary patterns
+static const uint16_t g_color_pair[][2] =
+{
+    { 0x0000, 0xFFFF },
+    { 0xFFFF, 0x0000 },
+    { 0xF800, 0x07E0 },
+    { 0x1234, 0x1234 },
+    { 0xABCD, 0x5432 },
+    { 0x001F, 0xFFE0 },
+};
+
+//Pixel buffer. Aligned for the pixel pairs of the expander
+alignas(uint32_t) static uint16_t g_pixel[ 16 *32 +GUARD_PIXELS ];
+//Sink of the benchmark so the compiler keeps the loops
+static volatile uint32_t g_sink;
+
+/****************************************************************************
+**	FUNCTIONS
+****************************************************************************/
+
+/****************************************************************************
+**	@brief function
+**	get_cycles | void |
+****************************************************************************/
+//! @return uint32_t | free running cycle counter
+/***************************************************************************/
+
+static inline uint32_t get_cycles( void )
+{
+#if defined(__riscv)
+    uint32_t cycles;
+    __asm__ volatile ("csrr %0, mcycle" : "=r" (cycles));
+    return cycles;
+#elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+#endif
+}	//End function: get_cycles | void |
+
+/****************************************************************************
+**	@brief function
+**	expand_reference | uint32_t | uint16_t * | uint8_t | uint16_t | uint16_t |
+****************************************************************************/
+//! @details The loop of Screen::render_sprite before the expander. One bit, one color, one 16b store per pixel
+/***************************************************************************/
+
+static void __attribute__((noinline)) expand_reference( uint32_t slice, uint16_t *pixel_ptr, uint8_t count, uint16_t background_color, uint16_t foreground_color )
+{
+    for (uint8_t tw = 0;tw < count;tw++)
+    {
+        //Compute color from the binary sprite map | false = background | true = foreground
+        uint16_t color = ((slice & 0x01) == 0x00)?(background_color):(foreground_color);
+        //Shift away the decoded bit
+        slice = slice >> 1;
+        //Save pixel
+        pixel_ptr[ tw ] = color;
+    }
+    return;
+}	//End function: expand_reference | uint32_t | uint16_t * | uint8_t | uint16_t | uint16_t |
+
+/****************************************************************************
+**	@brief function
+**	expand_kernel | User::Glyph_expander & | uint32_t | uint16_t * | uint8_t |
+****************************************************************************/
+//! @details Same call boundary as the reference so the benchmark compares the loops
+/***************************************************************************/
+
+static void __attribute__((noinline)) expand_kernel( const User::Glyph_expander &expander, uint32_t slice, uint16_t *pixel_ptr, uint8_t count )
+{
+    expander.expand( slice, pixel_ptr, count );
+    return;
+}	//End function: expand_kernel | User::Glyph_expander & | uint32_t | uint16_t * | uint8_t |
+
+/****************************************************************************
+**	@brief function
+**	check_equivalence | uint8_t |
+****************************************************************************/
+//! @param count | uint8_t | bits of a slice
+//! @return bool | false = OK | true = ERR
+//! @details Expand every slice of count bits with every color pair with both loops and compare the pixels and the guard
+/***************************************************************************/
+
+static bool check_equivalence( uint8_t count )
+{
+    User::Glyph_expander expander;
+    uint16_t reference[ 32 ];
+    for (unsigned int tc = 0;tc < sizeof(g_color_pair) /sizeof(g_color_pair[0]);tc++)
+    {
+        uint16_t background_color = g_color_pair[tc][0];
+        uint16_t foreground_color = g_color_pair[tc][1];
+        expander.set_colors( background_color, foreground_color );
+        for (uint32_t slice = 0;slice < (1u << count);slice++)
+        {
+            for (unsigned int t = 0;t < (unsigned int)count +GUARD_PIXELS;t++)
+            {
+                g_pixel[t] = GUARD_COLOR;
+            }
+            expand_reference( slice, reference, count, background_color, foreground_color );
+            expander.expand( slice, g_pixel, count );
+            for (unsigned int t = 0;t < (unsigned int)count +GUARD_PIXELS;t++)
+            {
+                uint16_t expected = (t < count)?(reference[t]):((uint16_t)GUARD_COLOR);
+                if (g_pixel[t] != expected)
+                {
+                    printf( "MISMATCH count %u colors %04X/%04X slice %05X pixel %u: %04X expected %04X\n",
+                        count, background_color, foreground_color, (unsigned)slice, t, g_pixel[t], expected );
+                    return true;
+                }
+            }
+        }
+    }
+    //Solid fill of every length up to count
+    for (uint8_t t = 0;t <= count;t++)
+    {
+        for (unsigned int tp = 0;tp < (unsigned int)count +GUARD_PIXELS;tp++)
+        {
+            g_pixel[tp] = GUARD_COLOR;
+        }
+        User::Glyph_expander::fill( 0x5A5A, g_pixel, t );
+        for (unsigned int tp = 0;tp < (unsigned int)count +GUARD_PIXELS;tp++)
+        {
+            if (g_pixel[tp] != ((tp < t)?(0x5A5A):(GUARD_COLOR)))
+            {
+                printf( "MISMATCH fill %u pixel %u\n", t, tp );
+                return true;
+            }
+        }
+    }
+    return false;
+}	//End function: check_equivalence | uint8_t |
+
+/****************************************************************************
+**	@brief function
+**	run_bench | const char * | uint8_t | uint8_t |
+****************************************************************************/
+//! @param name | const char * | name of the sprite layout
+//! @param rows | uint8_t | slices of a sprite
+//! @param count | uint8_t | pixels of a slice
+//! @return no return
+//! @details Render BENCH_SPRITES sprites BENCH_ROUNDS times with both loops. The colors change every sprite like a text with two color pairs
+/***************************************************************************/
+
+static void run_bench( const char *name, uint8_t rows, uint8_t count )
+{
+    User::Glyph_expander expander;
+    //Slices of a font. A fixed pseudo random pattern
+    static uint16_t slice[ BENCH_SPRITES *16 ];
+    uint32_t seed = 0x12345678;
+    for (unsigned int t = 0;t < BENCH_SPRITES *16;t++)
+    {
+        seed = seed *1664525 +1013904223;
+        slice[t] = (uint16_t)(seed >> 16);
+    }
+    uint32_t best_reference = 0xFFFFFFFF;
+    uint32_t best_kernel = 0xFFFFFFFF;
+    for (unsigned int tr = 0;tr < BENCH_ROUNDS;tr++)
+    {
+        uint32_t start = get_cycles();
+        for (unsigned int ts = 0;ts < BENCH_SPRITES;ts++)
+        {
+            uint16_t background_color = ((ts & 0x01) == 0)?(0x0000):(0x001F);
+            uint16_t foreground_color = ((ts & 0x01) == 0)?(0xFFFF):(0xFFE0);
+            for (uint8_t th = 0;th < rows;th++)
+            {
+                expand_reference( slice[ ts *16 +th ], &g_pixel[ th *count ], count, background_color, foreground_color );
+            }
+        }
+        uint32_t elapsed = get_cycles() -start;
+        best_reference = (elapsed < best_reference)?(elapsed):(best_reference);
+        g_sink = g_sink +g_pixel[0];
+
+        start = get_cycles();
+        for (unsigned int ts = 0;ts < BENCH_SPRITES;ts++)
+        {
+            uint16_t background_color = ((ts & 0x01) == 0)?(0x0000):(0x001F);
+            uint16_t foreground_color = ((ts & 0x01) == 0)?(0xFFFF):(0xFFE0);
+            expander.set_colors( background_color, foreground_color );
+            for (uint8_t th = 0;th < rows;th++)
+            {
+                expand_kernel( expander, slice[ ts *16 +th ], &g_pixel[ th *count ], count );
+            }
+        }
+        elapsed = get_cycles() -start;
+        best_kernel = (elapsed < best_kernel)?(elapsed):(best_kernel);
+        g_sink = g_sink +g_pixel[0];
+    }
+    printf( "%-22s | bit loop %7.1f | expander %7.1f | %4.2fx\n", name,
+        (double)best_reference /BENCH_SPRITES, (double)best_kernel /BENCH_SPRITES, (double)best_reference /best_kernel );
+    return;
+}	//End function: run_bench | const char * | uint8_t | uint8_t |
+
+/****************************************************************************
+**	@brief main
+**	main | void |
+****************************************************************************/
+//! @return int | 0 = OK | 1 = ERR
+/***************************************************************************/
+
+int main( void )
+{
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //For: landscape rows, 10 row font columns, 16 row font columns
+    const uint8_t count[] = { 8, 10, 16 };
+    for (unsigned int t = 0;t < sizeof(count);t++)
+    {
+        if (check_equivalence( count[t] ) == true)
+        {
+            return 1;
+        }
+        printf( "equivalence %2u bits: OK\n", count[t] );
+    }
+    printf( "cycles per sprite. Best of %d rounds of %d sprites. Colors change every sprite\n", BENCH_ROUNDS, BENCH_SPRITES );
+    run_bench( "landscape 10x8", 10, 8 );
+    run_bench( "landscape 16x8", 16, 8 );
+    run_bench( "portrait 8x10", 8, 10 );
+    run_bench( "portrait 8x16", 8, 16 );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return 0;
+}	//end function: main | void |
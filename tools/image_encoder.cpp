@@ -0,0 +1,145 @@
+/****************************************************************************
+**	OrangeBot Project
+*****************************************************************************
+**        /
+**       /
+**      /
+** ______ \
+**         \
+**          \
+*****************************************************************************
+**	RLE565 Image Encoder
+*****************************************************************************
+**  Host tool. Convert a binary PPM picture into a RLE565 flash array for Display::register_image
+**  Build: g++ -O2 -I src/sim tools/image_encoder.cpp -o image_encoder
+**  Usage: image_encoder picture.ppm name > name.hpp
+**  Most editors export binary PPM (P6). ImageMagick: convert logo.png logo.ppm
+****************************************************************************/
+
+/****************************************************************************
+**	INCLUDES
+****************************************************************************/
+
+//printf
+#include <stdio.h>
+//Pixel map and stream
+#include <vector>
+//RLE565 encoder
+#include "image_rle565.hpp"
+
+/****************************************************************************
+**	FUNCTIONS
+****************************************************************************/
+
+/****************************************************************************
+**	@brief function
+**	read_ppm_field | FILE * | int & |
+****************************************************************************/
+//! @param file_ptr | FILE * | PPM file
+//! @param value | int & | decimal field of the header
+//! @return bool | false = OK | true = ERR
+//! @details Skip white spaces and comments of the PPM header and read a decimal field
+/***************************************************************************/
+
+static bool read_ppm_field( FILE *file_ptr, int &value )
+{
+    int c = fgetc( file_ptr );
+    //While: white space or comment
+    while ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') || (c == '#'))
+    {
+        //If: comment runs to the end of the line
+        if (c == '#')
+        {
+            while ((c != '\n') && (c != EOF))
+            {
+                c = fgetc( file_ptr );
+            }
+        }
+        c = fgetc( file_ptr );
+    }
+    //If: not a number
+    if ((c < '0') || (c > '9'))
+    {
+        return true;
+    }
+    value = 0;
+    while ((c >= '0') && (c <= '9'))
+    {
+        value = value *10 +(c -'0');
+        c = fgetc( file_ptr );
+    }
+    //The single white space after the field is consumed
+    return false;
+}	//End function: read_ppm_field | FILE * | int & |
+
+/****************************************************************************
+**	@brief main
+**	main | int | char ** |
+****************************************************************************/
+//! @return int | 0 = OK | 1 = ERR
+//! @details Read a P6 PPM with 8b channels and print the C++ flash array of its RLE565 stream
+/***************************************************************************/
+
+int main( int argc, char **argv )
+{
+    //----------------------------------------------------------------
+    //	CHECK
+    //----------------------------------------------------------------
+
+    if (argc != 3)
+    {
+        fprintf( stderr, "usage: %s picture.ppm name > name.hpp\n", argv[0] );
+        return 1;
+    }
+
+    //----------------------------------------------------------------
+    //	VARS
+    //----------------------------------------------------------------
+
+    FILE *file_ptr = fopen( argv[1], "rb" );
+    int size_w, size_h, max_value;
+
+    //----------------------------------------------------------------
+    //	BODY
+    //----------------------------------------------------------------
+
+    //If: not a binary PPM with 8b channels
+    if ((file_ptr == nullptr) || (fgetc( file_ptr ) != 'P') || (fgetc( file_ptr ) != '6') ||
+        (read_ppm_field( file_ptr, size_w ) == true) || (read_ppm_field( file_ptr, size_h ) == true) || (read_ppm_field( file_ptr, max_value ) == true) ||
+        (size_w < 1) || (size_h < 1) || (size_w > 0xFFFF) || (size_h > 0xFFFF) || (max_value != 255))
+    {
+        fprintf( stderr, "%s: not a P6 PPM with 8b channels\n", argv[1] );
+        return 1;
+    }
+    //Convert the picture to RGB565
+    std::vector<uint16_t> pixel( (size_t)size_h *size_w );
+    for (size_t t = 0;t < pixel.size();t++)
+    {
+        int r = fgetc( file_ptr );
+        int g = fgetc( file_ptr );
+        int b = fgetc( file_ptr );
+        if (b == EOF)
+        {
+            fprintf( stderr, "%s: truncated\n", argv[1] );
+            return 1;
+        }
+        pixel[t] = Rle565::color( (uint8_t)r, (uint8_t)g, (uint8_t)b );
+    }
+    fclose( file_ptr );
+    std::vector<uint8_t> stream = Rle565::encode( pixel.data(), (uint16_t)size_h, (uint16_t)size_w );
+    //Print the flash array
+    printf( "//! @brief RLE565 image %s. %dx%d pixels, %u bytes, %.1f%% of RGB565. Generated by tools/image_encoder\n",
+        argv[2], size_h, size_w, (unsigned)stream.size(), 100.0 *stream.size() /(2.0 *pixel.size()) );
+    printf( "const uint8_t g_image_%s[] =\n{", argv[2] );
+    for (size_t t = 0;t < stream.size();t++)
+    {
+        printf( "%s0x%02X,", ((t %16) == 0)?("\n    "):(" "), stream[t] );
+    }
+    printf( "\n};\n" );
+
+    //----------------------------------------------------------------
+    //	RETURN
+    //----------------------------------------------------------------
+
+    return 0;
+}	//end function: main | int | char ** |